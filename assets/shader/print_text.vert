@@ -9,7 +9,8 @@ attribute vec2 a_positionScreen;
 attribute float a_textIndice;
 varying vec2 v_texCoord;
 
-const float glyphHeight = 32.0 / 256.0;
+// the texture of RendererGlyphCache: 256x512
+const float glyphHeight = 32.0 / 512.0;
 const float glyphWidth = 18.0 / 256.0;
 const float indicesPerLine = floor(1. / glyphWidth) + 1.;
 
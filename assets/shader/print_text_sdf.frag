@@ -0,0 +1,26 @@
+#version 100
+#ifdef GL_OES_standard_derivatives
+#extension GL_OES_standard_derivatives : enable
+#endif
+
+/*
+ * Same as "print_texture.frag" for the font, a signed distance field: the texture holds the distance to the edges of
+ * the glyphs, 0.5 on the edges. They are smoothed over about 1 pixel of the screen whatever the size of the text
+ */
+
+precision mediump float;
+varying vec2 v_texCoord;
+uniform sampler2D s_texture;
+
+void main()
+{
+    float distance = texture2D(s_texture, v_texCoord).r;
+#ifdef GL_OES_standard_derivatives
+    float smoothing = 0.7 * fwidth(distance);
+#else
+    // about 1 pixel for the text sizes of the screens
+    float smoothing = 0.1;
+#endif
+    // red, like the other textures
+    gl_FragColor = vec4(1.0, 0.0, 0.0, smoothstep(0.5 - smoothing, 0.5 + smoothing, distance));
+}
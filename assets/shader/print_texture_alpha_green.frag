@@ -0,0 +1,15 @@
+#version 100
+
+/*
+ * Same as "print_texture.frag" for the red sprites compressed in ETC1, which has no alpha: the alpha is in green
+ */
+
+precision mediump float;
+varying vec2 v_texCoord;
+uniform sampler2D s_texture;
+
+void main()
+{
+    vec4 color = texture2D(s_texture, v_texCoord);
+    gl_FragColor = vec4(color.r, 0.0, 0.0, color.g);
+}
@@ -11,13 +11,13 @@ struct Alarm::Impl
 {
     static constexpr auto kInvalidTime = Clock::time_point::max();
 
-    explicit Impl(const Config &config, Audio &audio)
+    explicit Impl(const Config &config, Audio *audio)
         : config{config},
           audio{audio}
     {
     }
     const Config &config;
-    Audio &audio;
+    Audio *const audio;
 
     const ConfigAlarm *nextAlarm = nullptr;
     Clock::time_point timeStartNextAlarm = kInvalidTime;
@@ -82,7 +82,7 @@ std::pair<const ConfigAlarm *, Clock::time_point> getNextAlarm(const std::list<C
 
 } // namespace
 
-Alarm::Alarm(const Config &config, Audio &audio)
+Alarm::Alarm(const Config &config, Audio *audio)
     : pimpl{std::make_unique<Impl>(config, audio)}
 {
 }
@@ -121,12 +121,15 @@ void Alarm::run(const Clock::time_point &time)
             const auto filename = pimpl->config.getMusic(configFilename);
 
             std::cerr << "Start music: " << filename << std::endl;
-            pimpl->audio.stopStream();
-            if (pimpl->audio.loadStream(filename.c_str()) == false)
+            if (pimpl->audio)
             {
-                std::cerr << "Could not load the stream" << std::endl;
+                pimpl->audio->stopStream();
+                if (pimpl->audio->loadStream(filename.c_str()) == false)
+                {
+                    std::cerr << "Could not load the stream" << std::endl;
+                }
+                pimpl->audio->playStream();
             }
-            pimpl->audio.playStream();
 
             pimpl->timeStopMusic = pimpl->timeStartNextAlarm + std::chrono::minutes(pimpl->nextAlarm->getDurationMinutes());
             pimpl->timeStartNextAlarm = Impl::kInvalidTime;
@@ -137,12 +140,16 @@ void Alarm::run(const Clock::time_point &time)
     // the time to stop the alarm has been reached
     if (time >= pimpl->timeStopMusic)
     {
-        pimpl->audio.stopStream();
+        if (pimpl->audio)
+        {
+            pimpl->audio->stopStream();
+        }
         pimpl->timeStopMusic = Impl::kInvalidTime;
     }
 
     // not running and next alarm not programmed
-    if (pimpl->audio.run() == false && isActive() == false)
+    const bool playing = pimpl->audio && pimpl->audio->run();
+    if (playing == false && isActive() == false)
     {
         if (const auto &alarms = pimpl->config.getAlarms(); alarms.empty() == false)
         {
@@ -17,9 +17,11 @@ public:
     struct Impl;
 
     /**
+     * @param audio nullptr without any audio device: the alarms are scheduled, but silent
+     *
      * @attention the object keeps a reference to constructor's arguments. Make sure they stay valid
      */
-    Alarm(const Config &config, Audio &audio);
+    Alarm(const Config &config, Audio *audio);
     ~Alarm();
 
     bool isActive() const;
@@ -1,19 +1,197 @@
 #include "app.hpp"
 
+#include "audio.hpp"
 #include "config.hpp"
 #include "context.hpp"
 #include "event.hpp"
+#include "gl_counters.hpp"
 #include "renderer.hpp"
+#include "renderer_software.hpp"
+#include "renderer_thread.hpp"
 #include "screen.hpp"
+#include "sensor_factory.hpp"
 #include "serializer_rapidjson.hpp"
+#include "toolbox_assets.hpp"
 #include "toolbox_i18n.hpp"
 #include "toolbox_time.hpp"
 #include "window.hpp"
 #include "window_factory.hpp"
 #include "windowevent.hpp"
 
+#include <time.h>
+
+#include <exception>
+#include <future>
+#include <iomanip>
 #include <iostream>
+#include <mutex>
+#include <optional>
+#include <sstream>
 #include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace
+{
+
+/**
+ * @brief Average and worst OpenGL calls of the frames, printed every kFrames
+ */
+class FrameCounters
+{
+public:
+    static constexpr size_t kFrames = 100;
+
+    ~FrameCounters()
+    {
+        print();
+    }
+
+    /**
+     * To be called after each frame by the thread owning the OpenGL context
+     */
+    void add()
+    {
+        const GlCounters &total = GlCounters::get();
+        const GlCounters frame = total - previous;
+        previous = total;
+
+        sum += frame;
+        max = GlCounters::max(max, frame);
+        if (++frames == kFrames)
+        {
+            print();
+        }
+    }
+
+private:
+    void print()
+    {
+        if (frames == 0)
+        {
+            return;
+        }
+        const GlCounters average{sum.calls / frames,
+                                 sum.draws / frames,
+                                 sum.binds / frames,
+                                 sum.stateChanges / frames,
+                                 sum.uploads / frames,
+                                 sum.uploadedBytes / frames,
+                                 sum.textureUploads / frames,
+                                 sum.textureBytes / frames};
+        std::cerr << "OpenGL per frame over " << frames << " frames:\n\taverage: " << average << "\n\tmax: " << max
+                  << std::endl;
+        frames = 0;
+        sum = GlCounters{};
+        max = GlCounters{};
+    }
+
+    GlCounters previous = GlCounters::get();
+    GlCounters sum;
+    GlCounters max;
+    size_t frames = 0;
+};
+
+/**
+ * @brief Duration of the startup phases, printed with the 1st frame to track the time to first frame
+ */
+class StartupReport
+{
+public:
+    /**
+     * End of a phase of the main thread, started at the end of the previous one
+     */
+    void endPhase(const char *name)
+    {
+        const auto now = Clock::now();
+        phases.push_back(Phase{name, now - previous, false});
+        previous = now;
+    }
+
+    /**
+     * Phase run by a worker thread, in parallel with the main thread
+     */
+    void addWorker(const char *name, Clock::duration duration)
+    {
+        phases.push_back(Phase{name, duration, true});
+    }
+
+    void print(std::ostream &str) const
+    {
+        str << "Startup:\n";
+        for (const Phase &phase : phases)
+        {
+            str << " - " << phase.name << ": " << getMs(phase.duration) << " ms" << (phase.worker ? " (worker)" : "") << '\n';
+        }
+        str << "First frame " << getMs(previous - start) << " ms after the start";
+        // CLOCK_BOOTTIME includes the suspended time, like the user waiting for the screen
+        if (timespec boot; clock_gettime(CLOCK_BOOTTIME, &boot) == 0)
+        {
+            str << ", " << std::fixed << std::setprecision(3) << boot.tv_sec + boot.tv_nsec * 1e-9 << std::defaultfloat
+                << " s after the boot";
+        }
+        str << std::endl;
+    }
+
+private:
+    /**
+     * @brief Duration of a phase
+     */
+    struct Phase
+    {
+        const char *name;
+        Clock::duration duration;
+        bool worker;
+    };
+
+    static long getMs(Clock::duration duration)
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+    }
+
+    Clock::time_point start = Clock::now();
+    Clock::time_point previous = start;
+    std::vector<Phase> phases;
+};
+
+/**
+ * @brief Result of a worker thread during the startup
+ */
+template <typename T>
+struct StartupTask
+{
+    T result;
+    Clock::duration duration;
+    std::string log; ///< printed by the main thread, not interleaved with its own log
+};
+
+/**
+ * Run create(std::ostream &log) in a worker thread. Its exceptions are thrown by joinTask()
+ */
+template <typename Create, typename T = std::invoke_result_t<Create, std::ostream &>>
+std::future<StartupTask<T>> startTask(Create create)
+{
+    return std::async(std::launch::async, [create] {
+        const auto start = Clock::now();
+        std::ostringstream log;
+        T result = create(log);
+        return StartupTask<T>{std::move(result), Clock::now() - start, log.str()};
+    });
+}
+
+/**
+ * Wait for the task, then print its log
+ */
+template <typename T>
+T joinTask(std::future<StartupTask<T>> &future, const char *name, StartupReport &report)
+{
+    StartupTask<T> task = future.get();
+    std::cerr << task.log;
+    report.addWorker(name, task.duration);
+    return std::move(task.result);
+}
+
+} // namespace
 
 struct App::Impl
 {
@@ -22,17 +200,40 @@ struct App::Impl
     {
     }
 
+    /**
+     * To be called after each displayed frame by the thread owning the OpenGL context
+     */
+    void frameDisplayed()
+    {
+        if (startupReport)
+        {
+            startupReport->endPhase("first frame");
+            startupReport->print(std::cerr);
+            startupReport.reset();
+        }
+        if (frameCounters)
+        {
+            frameCounters->add();
+        }
+    }
+
     /**
      * must be at the 1st position
      * @sa test_app.cpp
      */
     WindowFactory windowFactory;
     std::unique_ptr<Renderer> renderer;
+    // destroyed after the context: the screens are released right away
+    std::unique_ptr<RendererThread> renderThread;
     std::unique_ptr<Context> context;
 
     Config config;
     FileSerializationHandlerRapidJSON configPersistence;
     Internationalization i18n;
+    // only with --stats
+    std::optional<FrameCounters> frameCounters;
+    // until the 1st frame
+    std::optional<StartupReport> startupReport{std::in_place};
 };
 
 namespace
@@ -63,31 +264,202 @@ Clock::time_point getNextComputedLoop(const Clock::time_point &time, int fps)
     return time - (time.time_since_epoch() % loopDuration) + loopDuration;
 }
 
+/**
+ * The logic thread handles the events and records the frames, this thread displays them
+ */
+void runWithRenderThread(App::Impl &pimpl)
+{
+    Window &window = pimpl.windowFactory.get();
+    WindowEvent &windowEvent = pimpl.windowFactory.getEvent();
+    RendererThread &renderThread = *pimpl.renderThread;
+
+    // popped by this thread, handled by the logic thread
+    std::mutex eventsMutex;
+    std::vector<Event> events;
+    events.reserve(16);
+    std::exception_ptr logicError;
+
+    std::thread logic{[&] {
+        std::vector<Event> pendingEvents;
+        pendingEvents.reserve(16);
+        try
+        {
+            for (bool loop = true; loop;)
+            {
+                const auto startLoop = Clock::now();
+
+                {
+                    std::lock_guard lock{eventsMutex};
+                    pendingEvents.swap(events);
+                }
+                for (size_t i = 0; loop && i < pendingEvents.size(); ++i)
+                {
+                    loop = handleEvent(pimpl, pendingEvents[i]);
+                }
+                pendingEvents.clear();
+
+                if (!loop || !renderThread.beginFrame())
+                {
+                    break;
+                }
+                pimpl.renderer->begin();
+                pimpl.context->run(startLoop);
+                pimpl.renderer->end();
+                renderThread.endFrame(pimpl.renderer->getDamagedRect());
+
+                if (const auto fps = pimpl.config.getFramesPerSecond())
+                {
+                    std::this_thread::sleep_until(getNextComputedLoop(startLoop, fps));
+                }
+            }
+        }
+        catch (...)
+        {
+            logicError = std::current_exception();
+        }
+        renderThread.stop();
+    }};
+
+    try
+    {
+        // after a quit, the frames are dropped until the logic thread has handled the previous events
+        for (bool quit = false; quit ? renderThread.dropFrame() : renderThread.renderFrame(window);)
+        {
+            if (quit)
+            {
+                continue;
+            }
+            pimpl.frameDisplayed();
+
+            std::lock_guard lock{eventsMutex};
+            while (const auto event = windowEvent.popEvent())
+            {
+                events.push_back(*event);
+                if (event->type == EventType::Quit)
+                {
+                    quit = true;
+                    break;
+                }
+            }
+        }
+    }
+    catch (...)
+    {
+        renderThread.stop();
+        logic.join();
+        throw;
+    }
+
+    logic.join();
+    if (logicError)
+    {
+        std::rethrow_exception(logicError);
+    }
+}
+
+/**
+ * The events, the logic and the display of each frame one after the other
+ */
+void runSingleThread(App::Impl &pimpl)
+{
+    Window &window = pimpl.windowFactory.get();
+    WindowEvent &windowEvent = pimpl.windowFactory.getEvent();
+
+    for (bool loop = true; loop;)
+    {
+        const auto startLoop = Clock::now();
+
+        window.begin();
+
+        pimpl.renderer->begin();
+        pimpl.context->run(startLoop);
+        pimpl.renderer->end();
+
+        window.setDamage(pimpl.renderer->getDamagedRect());
+        window.end();
+        pimpl.frameDisplayed();
+
+        while (const auto event = windowEvent.popEvent())
+        {
+            loop &= handleEvent(pimpl, *event);
+        }
+
+        if (const auto fps = pimpl.config.getFramesPerSecond())
+        {
+            std::this_thread::sleep_until(getNextComputedLoop(startLoop, fps));
+        }
+    }
+}
+
 } // namespace
 
-App::App(const char *configurationFile)
+App::App(const char *configurationFile, bool statistics)
     : pimpl{std::make_unique<Impl>(configurationFile)}
 {
+    StartupReport &report = *pimpl->startupReport;
     if (!pimpl->configPersistence.load(pimpl->config))
     {
         std::cerr << "Configuration file doesn't exist. Creating " << configurationFile << std::endl;
         pimpl->config.setDisplayDriver(pimpl->windowFactory.getDriver(0));
         pimpl->configPersistence.save(pimpl->config);
     }
+    report.endPhase("configuration");
+
+    // the work without OpenGL is done while the window and the renderer are created. The configuration is not
+    // modified until the workers are joined
+    const Config &config = pimpl->config;
+    auto audioTask = startTask([&config](std::ostream &log) {
+        return std::make_unique<Audio>(config.getAlsaDevice(), log);
+    });
+    auto sensorsTask = startTask([](std::ostream &) {
+        return std::make_unique<SensorFactory>();
+    });
+    auto assetsTask = startTask([folders = std::vector<std::string>{config.getShader(), config.getTexture()}](std::ostream &log) {
+        log << "Prefetched assets: " << prefetchAssets(folders) << " bytes" << std::endl;
+        return true;
+    });
 
     pimpl->i18n.setMessagesFolder(pimpl->config.getMessages().c_str());
     std::cerr << "Internationalization: " << pimpl->i18n << std::endl;
+    report.endPhase("internationalization");
 
     std::cerr << "Windows: " << pimpl->windowFactory << std::endl;
     pimpl->windowFactory.create(pimpl->config.getDisplayDriver(),
                                 pimpl->config.getEventDriver(),
                                 pimpl->config.getDisplayWidth(),
-                                pimpl->config.getDisplayHeight());
+                                pimpl->config.getDisplayHeight(),
+                                pimpl->config.getDisplayRotation());
     std::cerr << "Created window: " << pimpl->windowFactory.get() << std::endl;
     std::cerr << "Created event: " << pimpl->windowFactory.getEvent() << std::endl;
-    pimpl->renderer = std::make_unique<Renderer>(pimpl->config);
+    report.endPhase("window");
+
+    Window &window = pimpl->windowFactory.get();
+    pimpl->renderer = std::make_unique<Renderer>(pimpl->config, window.isSoftware());
+    if (RendererSoftware *const software = pimpl->renderer->getSoftware())
+    {
+        window.setSoftwareFrame(software->getCanvas().data());
+    }
     std::cerr << "Created renderer: " << *pimpl->renderer;
-    pimpl->context = std::make_unique<Context>(pimpl->config, pimpl->configPersistence, *pimpl->renderer);
+    if (pimpl->config.isRenderThread() && !window.isSoftware())
+    {
+        // the software frame is read by the window while the next one is drawn: single thread only
+        pimpl->renderThread = std::make_unique<RendererThread>();
+        pimpl->renderer->setRenderThread(pimpl->renderThread.get());
+        std::cerr << "Render thread enabled" << std::endl;
+    }
+    report.endPhase("renderer");
+
+    std::unique_ptr<Audio> audio = joinTask(audioTask, "audio", report);
+    std::unique_ptr<SensorFactory> sensors = joinTask(sensorsTask, "sensors", report);
+    joinTask(assetsTask, "assets prefetch", report);
+    report.endPhase("wait for the workers");
+
+    pimpl->context = std::make_unique<Context>(pimpl->config, pimpl->configPersistence, *pimpl->renderer, std::move(audio), std::move(sensors));
+    report.endPhase("context");
+    if (statistics)
+    {
+        pimpl->frameCounters.emplace();
+    }
 
     std::cerr << "Initialization OK" << std::endl;
 }
@@ -96,29 +468,18 @@ App::~App() = default;
 
 void App::run()
 {
-    Window &window = pimpl->windowFactory.get();
-    WindowEvent &windowEvent = pimpl->windowFactory.getEvent();
-
-    for (bool loop = true; loop;)
+    if (pimpl->renderThread)
     {
-        const auto startLoop = Clock::now();
-
-        window.begin();
-
-        pimpl->renderer->begin();
-        pimpl->context->run(startLoop);
-        pimpl->renderer->end();
-
-        window.end();
-
-        while (const auto event = windowEvent.popEvent())
-        {
-            loop &= handleEvent(*pimpl, *event);
-        }
+        runWithRenderThread(*pimpl);
+    }
+    else
+    {
+        runSingleThread(*pimpl);
+    }
 
-        if (const auto fps = pimpl->config.getFramesPerSecond())
-        {
-            std::this_thread::sleep_until(getNextComputedLoop(startLoop, fps));
-        }
+    if (pimpl->frameCounters)
+    {
+        // e.g. the timings and the golden images of the headless window
+        std::cerr << pimpl->windowFactory.get() << std::endl;
     }
 }
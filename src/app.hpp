@@ -11,9 +11,10 @@ public:
     struct Impl;
 
     /**
+     * @param statistics print the OpenGL calls of the frames, see GlCounters, then the statistics of the window at the end of run()
      * @attention the class keeps a reference to constructor's arguments. Make sure they stay valid
      */
-    explicit App(const char *configurationFile);
+    explicit App(const char *configurationFile, bool statistics = false);
     ~App();
 
     /**
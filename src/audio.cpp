@@ -1,11 +1,14 @@
 #include "audio.hpp"
 
+#include "audio_formats.hpp"
 #include "audio_read.hpp"
 #include "audio_read_mod.hpp"
 #include "audio_read_mp3.hpp"
 #include "audio_read_ogg.hpp"
+#include "audio_read_wav.hpp"
 #include "error.hpp"
 #include "toolbox_io.hpp"
+#include "toolbox_time.hpp"
 
 #include <alsa/asoundlib.h>
 
@@ -24,56 +27,11 @@ constexpr int64_t kBufferTimeUs = 1000 * 1000;
 constexpr int64_t kBufferSamples = kChannels * kRate * kBufferTimeUs / (1000 * 1000);
 constexpr int64_t kAlsaBufferSamples = kBufferSamples * 2;
 
-struct AudioEnd;
-
-/**
- * This class is used to initialize the AudioRead* classes and run open the audio files in a recursive way computed a compile time
- */
-template <typename... T>
-struct AudioFormats;
-
-/**
- * End of recursion
- */
-template <>
-struct AudioFormats<AudioEnd>
-{
-    static void loadLib() {}
-    static void unloadLib() {}
-    static std::unique_ptr<AudioRead> create(FILEUnique &, const char *) { return nullptr; }
-};
-
-/**
- * Load/unload lib and perform recursion to the next class
- */
-template <typename T, typename... Tn>
-struct AudioFormats<T, Tn...>
-{
-    static void loadLib()
-    {
-        T::loadLib(std::cerr);
-        AudioFormats<Tn...>::loadLib();
-    }
-    static void unloadLib()
-    {
-        AudioFormats<Tn...>::unloadLib();
-        T::unloadLib();
-    }
-    static std::unique_ptr<AudioRead> create(FILEUnique &file, const char *extension)
-    {
-        std::unique_ptr<AudioRead> result = T::create(file, extension);
-        if (result == nullptr)
-        {
-            result = AudioFormats<Tn...>::create(file, extension);
-        }
-        return result;
-    }
-};
-
 /**
- * Definition of the recursions (OGG, then MOD, then MP3)
+ * Definition of the recursions (WAVE, then OGG, then MOD, then MP3)
  */
 using AllFormats = AudioFormats<
+    AudioReadWav,
 #ifndef NO_AUDIO_READ_OGG
     AudioReadOgg,
 #endif
@@ -125,7 +83,10 @@ using AlsaUnique = std::unique_ptr<T, AlsaDeleter>;
 /**
  * Fetch PCM frames from audio_read_* and feed Alsa
  */
-void readMusic(snd_pcm_t *handle, AudioRead &audio)
+/**
+ * @return false if the stream has ended: the buffers of Alsa are still played
+ */
+bool readMusic(snd_pcm_t *handle, AudioRead &audio)
 {
     snd_pcm_sframes_t avail = snd_pcm_avail_update(handle);
     while (avail >= kBufferReadSizeBytes)
@@ -134,7 +95,7 @@ void readMusic(snd_pcm_t *handle, AudioRead &audio)
         const size_t readBytes = audio.readBuffer(buf, sizeof(buf), true);
         if (readBytes == 0)
         {
-            return;
+            return false;
         }
 
         const snd_pcm_sframes_t frames = readBytes / snd_pcm_frames_to_bytes(handle, 1);
@@ -147,23 +108,23 @@ void readMusic(snd_pcm_t *handle, AudioRead &audio)
         }
         avail -= readBytes;
     }
+    return true;
 }
 
 } // namespace
 
 struct Audio::Impl
 {
+    AllFormats formats;
     AlsaUnique<snd_pcm_t> handle;
     std::unique_ptr<AudioRead> music;
 };
 
-Audio::Audio(const char *deviceName)
+Audio::Audio(const char *deviceName, std::ostream &log)
     : pimpl{std::make_unique<Impl>()}
 {
-    AllFormats::loadLib();
-
     {
-        std::cerr << "Alsa: open audio device " << deviceName << std::endl;
+        log << "Alsa: open audio device " << deviceName << std::endl;
         snd_pcm_t *handle;
         if (const int err = snd_pcm_open(&handle, deviceName, SND_PCM_STREAM_PLAYBACK, 0); err < 0)
         {
@@ -228,18 +189,18 @@ Audio::Audio(const char *deviceName)
     bufferFrames = 0;
     snd_pcm_hw_params_get_buffer_size(hwParams, &bufferFrames);
 
-    std::cerr << "Alsa: channels=" << channels << " rate=" << rate << " format=" << snd_pcm_format_name(format) << " buffer=" << bufferFrames << std::endl;
-    std::cerr << "Alsa PCM name: " << snd_pcm_name(pimpl->handle.get()) << std::endl;
-    std::cerr << "Alsa PCM state: " << snd_pcm_state_name(snd_pcm_state(pimpl->handle.get())) << std::endl;
+    log << "Alsa: channels=" << channels << " rate=" << rate << " format=" << snd_pcm_format_name(format) << " buffer=" << bufferFrames << std::endl;
+    log << "Alsa PCM name: " << snd_pcm_name(pimpl->handle.get()) << std::endl;
+    log << "Alsa PCM state: " << snd_pcm_state_name(snd_pcm_state(pimpl->handle.get())) << std::endl;
 }
 
-Audio::~Audio()
-{
-    AllFormats::unloadLib();
-}
+Audio::~Audio() = default;
 
 bool Audio::loadStream(const char *filename)
 {
+    // even if the new one cannot be loaded: its decoder may be unloaded
+    pimpl->music.reset();
+
     FILEUnique file{std::fopen(filename, "rb")};
     if (file == nullptr)
     {
@@ -251,7 +212,7 @@ bool Audio::loadStream(const char *filename)
     {
         ++extension;
     }
-    if (auto music = AllFormats::create(file, extension))
+    if (auto music = pimpl->formats.create(file, extension, Clock::now()))
     {
         pimpl->music = std::move(music);
         return true;
@@ -262,10 +223,16 @@ bool Audio::loadStream(const char *filename)
 
 bool Audio::run()
 {
+    pimpl->formats.unloadIdle(Clock::now());
+
     if (const snd_pcm_state_t state = snd_pcm_state(pimpl->handle.get());
         state == SND_PCM_STATE_RUNNING || state == SND_PCM_STATE_PAUSED)
     {
-        readMusic(pimpl->handle.get(), *pimpl->music);
+        // the decoder and its library are released as soon as the stream has ended
+        if (pimpl->music && readMusic(pimpl->handle.get(), *pimpl->music) == false)
+        {
+            pimpl->music.reset();
+        }
         return true;
     }
     else if (state == SND_PCM_STATE_XRUN)
@@ -299,7 +266,10 @@ void Audio::playStream()
         if (pimpl->music)
         {
             snd_pcm_start(pimpl->handle.get());
-            readMusic(pimpl->handle.get(), *pimpl->music);
+            if (readMusic(pimpl->handle.get(), *pimpl->music) == false)
+            {
+                pimpl->music.reset();
+            }
         }
         break;
     }
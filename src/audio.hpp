@@ -1,5 +1,6 @@
 #pragma once
 
+#include <iosfwd>
 #include <memory>
 
 /**
@@ -10,7 +11,12 @@ class Audio
 public:
     struct Impl;
 
-    explicit Audio(const char *deviceName);
+    /**
+     * Open the device. The decoders are loaded by loadStream(), on first use of their format
+     *
+     * @param log where the device is described, e.g. to print it later when created by another thread
+     */
+    Audio(const char *deviceName, std::ostream &log);
     ~Audio();
 
     /**
@@ -20,6 +26,8 @@ public:
      * @arg If an error occurred, try to recover
      * @arg Else (not playing) do nothing
      *
+     * The decoders without any stream for a minute are unloaded
+     *
      * @return true if the audio is playing or paused
      */
     bool run();
@@ -30,9 +38,9 @@ public:
     bool isPlaying() const;
 
     /**
-     * Cancel the current stream and load a new one
+     * Cancel the current stream and load a new one. The library of the format is loaded if needed
      *
-     * @return true in case of success
+     * @return true in case of success, false if the format is not supported or its library is missing
      */
     bool loadStream(const char *filename);
 
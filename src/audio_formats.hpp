@@ -0,0 +1,99 @@
+#pragma once
+
+#include "audio_read.hpp"
+#include "toolbox_io.hpp"
+#include "toolbox_time.hpp"
+
+#include <chrono>
+#include <exception>
+#include <iostream>
+#include <memory>
+
+/// the decoders without any stream are unloaded after this time
+constexpr auto kDecoderIdleTime = std::chrono::minutes(1);
+
+/// last type of AudioFormats
+struct AudioEnd;
+
+/**
+ * This class loads the libraries of the AudioRead* classes on first use, and opens the audio files in a recursive way
+ * computed at compile time
+ *
+ * Each type provides Library, loadLib(), isSupported() and create(), like AudioReadOgg
+ */
+template <typename... T>
+class AudioFormats;
+
+/**
+ * End of recursion
+ */
+template <>
+class AudioFormats<AudioEnd>
+{
+public:
+    std::unique_ptr<AudioRead> create(FILEUnique &, const char *, const Clock::time_point &) { return nullptr; }
+    void unloadIdle(const Clock::time_point &) {}
+};
+
+/**
+ * Load the library of T if it supports the file, and perform recursion to the next class
+ */
+template <typename T, typename... Tn>
+class AudioFormats<T, Tn...>
+{
+public:
+    std::unique_ptr<AudioRead> create(FILEUnique &file, const char *extension, const Clock::time_point &now)
+    {
+        if (T::isSupported(file, extension) && loadLib(now))
+        {
+            if (std::unique_ptr<AudioRead> result = T::create(library, file, extension))
+            {
+                return result;
+            }
+        }
+        return next.create(file, extension, now);
+    }
+
+    /**
+     * Unload the libraries without any stream since kDecoderIdleTime
+     */
+    void unloadIdle(const Clock::time_point &now)
+    {
+        // the streams hold a reference too
+        if (library.use_count() > 1)
+        {
+            lastUse = now;
+        }
+        else if (library && now - lastUse >= kDecoderIdleTime)
+        {
+            std::cerr << "Unload an idle decoder" << std::endl;
+            library.reset();
+        }
+        next.unloadIdle(now);
+    }
+
+private:
+    /**
+     * @return false if the library is missing: the other formats are still supported
+     */
+    bool loadLib(const Clock::time_point &now)
+    {
+        lastUse = now;
+        if (library == nullptr)
+        {
+            try
+            {
+                library = T::loadLib(std::cerr);
+            }
+            catch (const std::exception &e)
+            {
+                std::cerr << "Could not load the decoder: " << e.what() << std::endl;
+            }
+        }
+        return library != nullptr;
+    }
+
+    std::shared_ptr<typename T::Library> library;
+    Clock::time_point lastUse;
+    AudioFormats<Tn...> next;
+};
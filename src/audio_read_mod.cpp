@@ -2,6 +2,7 @@
 
 #ifndef NO_AUDIO_READ_MOD
 
+#include "toolbox_dl.hpp"
 #include "toolbox_io.hpp"
 
 #include <libmodplug/modplug.h>
@@ -12,12 +13,17 @@
 
 namespace
 {
+
+/**
+ * Functor to unload the MOD with the function of the library
+ */
 struct ModDeleter
 {
     void operator()(ModPlugFile *obj) const
     {
-        ModPlug_Unload(obj);
+        unload(obj);
     }
+    decltype(&::ModPlug_Unload) unload;
 };
 
 template <typename T>
@@ -73,8 +79,25 @@ constexpr char kExtensions[][4] = {
     "xm",
 };
 
+struct AudioReadMod::Library
+{
+    SharedLibrary library{"libmodplug.so.1"};
+    SHARED_LIBRARY_SYMBOL(ModPlug_GetLength);
+    SHARED_LIBRARY_SYMBOL(ModPlug_GetModuleType);
+    SHARED_LIBRARY_SYMBOL(ModPlug_Load);
+    SHARED_LIBRARY_SYMBOL(ModPlug_NumChannels);
+    SHARED_LIBRARY_SYMBOL(ModPlug_NumInstruments);
+    SHARED_LIBRARY_SYMBOL(ModPlug_NumSamples);
+    SHARED_LIBRARY_SYMBOL(ModPlug_Read);
+    SHARED_LIBRARY_SYMBOL(ModPlug_Seek);
+    SHARED_LIBRARY_SYMBOL(ModPlug_SetSettings);
+    SHARED_LIBRARY_SYMBOL(ModPlug_Unload);
+};
+
 struct AudioReadMod::Impl
 {
+    // destroyed after the MOD
+    std::shared_ptr<Library> library;
     ModUnique<ModPlugFile> mod;
 };
 
@@ -85,25 +108,32 @@ AudioReadMod::AudioReadMod(Impl impl)
 
 AudioReadMod::~AudioReadMod() = default;
 
-void AudioReadMod::loadLib(std::ostream &)
+std::shared_ptr<AudioReadMod::Library> AudioReadMod::loadLib(std::ostream &)
+{
+    auto library = std::make_shared<Library>();
+    library->ModPlug_SetSettings(&kSettings);
+    return library;
+}
+
+bool AudioReadMod::isSupported(FILEUnique &file, const char *extension)
 {
-    ModPlug_SetSettings(&kSettings);
+    return file != nullptr && extension != nullptr &&
+           std::binary_search(kExtensions, kExtensions + sizeof(kExtensions) / sizeof(*kExtensions), extension,
+                              [](const char *a, const char *b) { return strcasecmp(a, b) < 0; });
 }
 
-std::unique_ptr<AudioRead> AudioReadMod::create(FILEUnique &file, const char *extension)
+std::unique_ptr<AudioRead> AudioReadMod::create(const std::shared_ptr<Library> &library, FILEUnique &file, const char *extension)
 {
-    if (file == nullptr || extension == nullptr ||
-        std::binary_search(kExtensions, kExtensions + sizeof(kExtensions) / sizeof(*kExtensions), extension,
-                           [](const char *a, const char *b) { return strcasecmp(a, b) < 0; }) == false)
+    if (isSupported(file, extension) == false)
     {
         return nullptr;
     }
 
-    Impl impl;
+    Impl impl{library, ModUnique<ModPlugFile>{nullptr, ModDeleter{library->ModPlug_Unload}}};
     try
     {
         const MmapFile mmapFile{file.get()};
-        impl.mod.reset(ModPlug_Load(mmapFile.content, mmapFile.size));
+        impl.mod.reset(library->ModPlug_Load(mmapFile.content, mmapFile.size));
     }
     catch (const std::exception &e)
     {
@@ -129,7 +159,7 @@ int AudioReadMod::getChannels() const
 
 uint64_t AudioReadMod::getSamples() const
 {
-    return ModPlug_GetLength(pimpl->mod.get()) * kSettings.mFrequency / 1000;
+    return pimpl->library->ModPlug_GetLength(pimpl->mod.get()) * kSettings.mFrequency / 1000;
 }
 
 int AudioReadMod::getRate() const
@@ -142,7 +172,7 @@ size_t AudioReadMod::readBuffer(char *buffer, size_t bufferSize, bool loop)
     size_t totalRead = 0;
     while (totalRead < bufferSize)
     {
-        const int read = ModPlug_Read(pimpl->mod.get(), buffer + totalRead, bufferSize - totalRead);
+        const int read = pimpl->library->ModPlug_Read(pimpl->mod.get(), buffer + totalRead, bufferSize - totalRead);
         if (read <= 0)
         {
             break;
@@ -154,7 +184,7 @@ size_t AudioReadMod::readBuffer(char *buffer, size_t bufferSize, bool loop)
     if (totalRead < bufferSize && loop)
     {
         // EOF, loop
-        ModPlug_Seek(pimpl->mod.get(), 0);
+        pimpl->library->ModPlug_Seek(pimpl->mod.get(), 0);
         return totalRead + readBuffer(buffer + totalRead, bufferSize - totalRead, false);
     }
 
@@ -163,11 +193,11 @@ size_t AudioReadMod::readBuffer(char *buffer, size_t bufferSize, bool loop)
 
 std::ostream &AudioReadMod::toStream(std::ostream &str) const
 {
-    return str << "mod type" << ModPlug_GetModuleType(pimpl->mod.get())
-               << "instruments=" << ModPlug_NumInstruments(pimpl->mod.get())
-               << " samples=" << ModPlug_NumSamples(pimpl->mod.get())
-               << " channels=" << ModPlug_NumChannels(pimpl->mod.get())
-               << " duration_ms=" << ModPlug_GetLength(pimpl->mod.get());
+    return str << "mod type" << pimpl->library->ModPlug_GetModuleType(pimpl->mod.get())
+               << "instruments=" << pimpl->library->ModPlug_NumInstruments(pimpl->mod.get())
+               << " samples=" << pimpl->library->ModPlug_NumSamples(pimpl->mod.get())
+               << " channels=" << pimpl->library->ModPlug_NumChannels(pimpl->mod.get())
+               << " duration_ms=" << pimpl->library->ModPlug_GetLength(pimpl->mod.get());
 }
 
 #endif // NO_AUDIO_READ_MOD
@@ -16,6 +16,8 @@ class AudioReadMod : public AudioRead
 {
 public:
     struct Impl;
+    /// functions of libmodplug, loaded at runtime
+    struct Library;
 
     /**
      * This method cannot be called from outside. Create with create() method instead
@@ -24,10 +26,16 @@ public:
     ~AudioReadMod() override;
 
     /**
-     * library initialization
+     * Load and initialize libmodplug. It is unloaded with the last reference, held by the AudioReadMod objects too
+     *
+     * @throw std::runtime_error if the library is missing
+     */
+    static std::shared_ptr<Library> loadLib(std::ostream &str);
+
+    /**
+     * Check of the extension, without the library
      */
-    static void loadLib(std::ostream &str);
-    static void unloadLib() {}
+    static bool isSupported(FILEUnique &file, const char *extension);
 
     /**
      * Create a AudioReadMod object if the file is of right format
@@ -36,7 +44,7 @@ public:
      *
      * @return a valid unique_ptr in case of success, nullptr otherwise (this is not a MOD file for instance)
      */
-    static std::unique_ptr<AudioRead> create(FILEUnique &file, const char *extension);
+    static std::unique_ptr<AudioRead> create(const std::shared_ptr<Library> &library, FILEUnique &file, const char *extension);
 
     int getChannels() const override;
     uint64_t getSamples() const override;
@@ -3,6 +3,7 @@
 #ifndef NO_AUDIO_READ_MP3
 
 #include "error.hpp"
+#include "toolbox_dl.hpp"
 
 #include <mpg123.h>
 
@@ -16,18 +17,6 @@ constexpr long kRate = 44100;
 constexpr int kChannels = MPG123_STEREO;
 constexpr int kEncodings = MPG123_ENC_SIGNED_16;
 
-struct Mpg123Deleter
-{
-    void operator()(mpg123_handle *obj) const
-    {
-        mpg123_close(obj);
-        mpg123_delete(obj);
-    }
-};
-
-template <typename T>
-using Mpg123Unique = std::unique_ptr<T, Mpg123Deleter>;
-
 ssize_t mp3Read(void *fd, void *buf, size_t count)
 {
     const auto file = reinterpret_cast<FILE *>(fd);
@@ -51,8 +40,72 @@ off_t mp3Seek(void *fd, off_t offset, int whence)
 
 } // namespace
 
+struct AudioReadMp3::Library
+{
+    /**
+     * @throw std::runtime_error if the library is missing or cannot be initialized
+     */
+    Library()
+    {
+        if (const int err = mpg123_init(); err != MPG123_OK)
+        {
+            throw std::runtime_error{"Could not initialize mpg123"};
+        }
+    }
+
+    ~Library()
+    {
+        mpg123_exit();
+    }
+
+    SharedLibrary library{"libmpg123.so.0"};
+    SHARED_LIBRARY_SYMBOL(mpg123_close);
+    SHARED_LIBRARY_SYMBOL(mpg123_decoders);
+    SHARED_LIBRARY_SYMBOL(mpg123_delete);
+    SHARED_LIBRARY_SYMBOL(mpg123_encodings);
+    SHARED_LIBRARY_SYMBOL(mpg123_encsize);
+    SHARED_LIBRARY_SYMBOL(mpg123_exit);
+    SHARED_LIBRARY_SYMBOL(mpg123_format);
+    SHARED_LIBRARY_SYMBOL(mpg123_format_none);
+    SHARED_LIBRARY_SYMBOL(mpg123_getformat);
+    SHARED_LIBRARY_SYMBOL(mpg123_init);
+    SHARED_LIBRARY_SYMBOL(mpg123_length);
+    SHARED_LIBRARY_SYMBOL(mpg123_new);
+    SHARED_LIBRARY_SYMBOL(mpg123_open_handle);
+    SHARED_LIBRARY_SYMBOL(mpg123_plain_strerror);
+    SHARED_LIBRARY_SYMBOL(mpg123_rates);
+    SHARED_LIBRARY_SYMBOL(mpg123_read);
+    SHARED_LIBRARY_SYMBOL(mpg123_replace_reader_handle);
+    SHARED_LIBRARY_SYMBOL(mpg123_scan);
+    SHARED_LIBRARY_SYMBOL(mpg123_seek);
+    SHARED_LIBRARY_SYMBOL(mpg123_supported_decoders);
+};
+
+namespace
+{
+
+/**
+ * Functor to close the handle with the functions of the library
+ */
+struct Mpg123Deleter
+{
+    void operator()(mpg123_handle *obj) const
+    {
+        library->mpg123_close(obj);
+        library->mpg123_delete(obj);
+    }
+    const AudioReadMp3::Library *library;
+};
+
+template <typename T>
+using Mpg123Unique = std::unique_ptr<T, Mpg123Deleter>;
+
+} // namespace
+
 struct AudioReadMp3::Impl
 {
+    // destroyed after the handle
+    std::shared_ptr<Library> library;
     FILEUnique file;
     Mpg123Unique<mpg123_handle> handle;
 
@@ -68,21 +121,18 @@ AudioReadMp3::AudioReadMp3(Impl impl)
 
 AudioReadMp3::~AudioReadMp3() = default;
 
-void AudioReadMp3::loadLib(std::ostream &str)
+std::shared_ptr<AudioReadMp3::Library> AudioReadMp3::loadLib(std::ostream &str)
 {
-    if (const int err = mpg123_init(); err != MPG123_OK)
-    {
-        throw std::runtime_error{"Could not initialize mpg123"};
-    }
+    auto library = std::make_shared<Library>();
 
     str << "mpg123 decoders:";
-    for (const char **decoders = mpg123_decoders(); *decoders != nullptr; ++decoders)
+    for (const char **decoders = library->mpg123_decoders(); *decoders != nullptr; ++decoders)
     {
         str << "\n - " << *decoders;
     }
 
     str << "\nmpg123 supported decoders:";
-    for (const char **decoders = mpg123_supported_decoders(); *decoders != nullptr; ++decoders)
+    for (const char **decoders = library->mpg123_supported_decoders(); *decoders != nullptr; ++decoders)
     {
         str << "\n - " << *decoders;
     }
@@ -90,7 +140,7 @@ void AudioReadMp3::loadLib(std::ostream &str)
     str << "\nmpg123 supported rates:";
     const long *rates;
     size_t ratesSize = 0;
-    mpg123_rates(&rates, &ratesSize);
+    library->mpg123_rates(&rates, &ratesSize);
     for (size_t i = 0; i < ratesSize; ++i)
     {
         str << "\n - " << rates[i];
@@ -99,65 +149,66 @@ void AudioReadMp3::loadLib(std::ostream &str)
     str << "\nmpg123 supported encodings:";
     const int *encodings;
     size_t encodingsSize = 0;
-    mpg123_encodings(&encodings, &encodingsSize);
+    library->mpg123_encodings(&encodings, &encodingsSize);
     for (size_t i = 0; i < encodingsSize; ++i)
     {
-        str << "\n - " << encodings[i] << " (" << mpg123_encsize(encodings[i]) << "B)";
+        str << "\n - " << encodings[i] << " (" << library->mpg123_encsize(encodings[i]) << "B)";
     }
     str << '\n';
+    return library;
 }
 
-void AudioReadMp3::unloadLib()
+bool AudioReadMp3::isSupported(FILEUnique &file, const char *extension)
 {
-    mpg123_exit();
+    return file != nullptr && extension != nullptr && strcasecmp(extension, "mp3") == 0;
 }
 
-std::unique_ptr<AudioRead> AudioReadMp3::create(FILEUnique &file, const char *extension)
+std::unique_ptr<AudioRead> AudioReadMp3::create(const std::shared_ptr<Library> &library, FILEUnique &file, const char *extension)
 {
-    if (file == nullptr || extension == nullptr || strcasecmp(extension, "mp3"))
+    if (isSupported(file, extension) == false)
     {
         return nullptr;
     }
 
     std::fseek(file.get(), 0, SEEK_SET);
 
-    Impl impl;
+    Impl impl{library, nullptr, Mpg123Unique<mpg123_handle>{nullptr, Mpg123Deleter{library.get()}}, 0, 0, 0};
     int err;
-    impl.handle.reset(mpg123_new(nullptr, &err));
+    impl.handle.reset(library->mpg123_new(nullptr, &err));
     if (impl.handle == nullptr)
     {
-        std::cerr << "Could not create mpg123 handle: " << mpg123_plain_strerror(err) << std::endl;
+        std::cerr << "Could not create mpg123 handle: " << library->mpg123_plain_strerror(err) << std::endl;
         return nullptr;
     }
 
-    mpg123_format_none(impl.handle.get());
-    if (const int err = mpg123_format(impl.handle.get(), kRate, kChannels, kEncodings); err != MPG123_OK)
+    library->mpg123_format_none(impl.handle.get());
+    if (const int err = library->mpg123_format(impl.handle.get(), kRate, kChannels, kEncodings); err != MPG123_OK)
     {
-        std::cerr << "Could not set mpg123 format: " << mpg123_plain_strerror(err) << std::endl;
+        std::cerr << "Could not set mpg123 format: " << library->mpg123_plain_strerror(err) << std::endl;
         return nullptr;
     }
 
-    if (const int err = mpg123_replace_reader_handle(impl.handle.get(), mp3Read, mp3Seek, nullptr); err != MPG123_OK)
+    if (const int err = library->mpg123_replace_reader_handle(impl.handle.get(), mp3Read, mp3Seek, nullptr); err != MPG123_OK)
     {
-        std::cerr << "Could not replace mpg123 reader handle: " << mpg123_plain_strerror(err) << std::endl;
+        std::cerr << "Could not replace mpg123 reader handle: " << library->mpg123_plain_strerror(err) << std::endl;
         return nullptr;
     }
 
-    if (const int err = mpg123_open_handle(impl.handle.get(), file.get()); err != MPG123_OK)
+    if (const int err = library->mpg123_open_handle(impl.handle.get(), file.get()); err != MPG123_OK)
     {
-        std::cerr << "Could not open mpg123 handle: " << mpg123_plain_strerror(err) << std::endl;
+        std::cerr << "Could not open mpg123 handle: " << library->mpg123_plain_strerror(err) << std::endl;
         return nullptr;
     }
 
-    if (const int err = mpg123_scan(impl.handle.get()); err != MPG123_OK)
+    if (const int err = library->mpg123_scan(impl.handle.get()); err != MPG123_OK)
     {
-        std::cerr << "Could not scan mpg123 handle: " << mpg123_plain_strerror(err) << std::endl;
+        std::cerr << "Could not scan mpg123 handle: " << library->mpg123_plain_strerror(err) << std::endl;
         return nullptr;
     }
 
-    if (const int err = mpg123_getformat(impl.handle.get(), &impl.rate, &impl.channels, &impl.encoding); err != MPG123_OK)
+    if (const int err = library->mpg123_getformat(impl.handle.get(), &impl.rate, &impl.channels, &impl.encoding); err != MPG123_OK)
     {
-        std::cerr << "Could not get mpg123 format: " << mpg123_plain_strerror(err) << std::endl;
+        std::cerr << "Could not get mpg123 format: " << library->mpg123_plain_strerror(err) << std::endl;
         return nullptr;
     }
 
@@ -172,7 +223,7 @@ int AudioReadMp3::getChannels() const
 
 uint64_t AudioReadMp3::getSamples() const
 {
-    const auto length = mpg123_length(pimpl->handle.get());
+    const auto length = pimpl->library->mpg123_length(pimpl->handle.get());
     if (length > 0)
     {
         return length;
@@ -191,7 +242,7 @@ size_t AudioReadMp3::readBuffer(char *buffer, size_t bufferSize, bool loop)
     while (totalRead < bufferSize)
     {
         size_t read;
-        if (const int err = mpg123_read(pimpl->handle.get(),
+        if (const int err = pimpl->library->mpg123_read(pimpl->handle.get(),
                                         reinterpret_cast<unsigned char *>(buffer + totalRead),
                                         bufferSize - totalRead,
                                         &read);
@@ -206,7 +257,7 @@ size_t AudioReadMp3::readBuffer(char *buffer, size_t bufferSize, bool loop)
     if (totalRead < bufferSize && loop)
     {
         // EOF, loop
-        mpg123_seek(pimpl->handle.get(), 0, SEEK_SET);
+        pimpl->library->mpg123_seek(pimpl->handle.get(), 0, SEEK_SET);
         return totalRead + readBuffer(buffer + totalRead, bufferSize - totalRead, false);
     }
 
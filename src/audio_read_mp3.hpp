@@ -16,6 +16,8 @@ class AudioReadMp3 : public AudioRead
 {
 public:
     struct Impl;
+    /// functions of libmpg123, loaded at runtime
+    struct Library;
 
     /**
      * This method cannot be called from outside. Create with create() method instead
@@ -24,14 +26,17 @@ public:
     ~AudioReadMp3() override;
 
     /**
-     * library initialization
+     * Load and initialize libmpg123, then describe its decoders. It is cleaned up and unloaded with the last
+     * reference, held by the AudioReadMp3 objects too
+     *
+     * @throw std::runtime_error if the library is missing
      */
-    static void loadLib(std::ostream &str);
+    static std::shared_ptr<Library> loadLib(std::ostream &str);
 
     /**
-     * library cleanup
+     * Check of the extension, without the library
      */
-    static void unloadLib();
+    static bool isSupported(FILEUnique &file, const char *extension);
 
     /**
      * Create a AudioReadMp3 object if the file is of right format
@@ -40,7 +45,7 @@ public:
      *
      * @return a valid unique_ptr in case of success, nullptr otherwise (this is not an MP3 for instance)
      */
-    static std::unique_ptr<AudioRead> create(FILEUnique &file, const char *extension);
+    static std::unique_ptr<AudioRead> create(const std::shared_ptr<Library> &library, FILEUnique &file, const char *extension);
 
     int getChannels() const override;
     uint64_t getSamples() const override;
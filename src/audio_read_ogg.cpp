@@ -2,20 +2,36 @@
 
 #ifndef NO_AUDIO_READ_OGG
 
+#include "toolbox_dl.hpp"
+
 #include <vorbis/vorbisfile.h>
 
 #include <cstring>
 #include <iostream>
 
+struct AudioReadOgg::Library
+{
+    SharedLibrary library{"libvorbisfile.so.3"};
+    SHARED_LIBRARY_SYMBOL(ov_clear);
+    SHARED_LIBRARY_SYMBOL(ov_info);
+    SHARED_LIBRARY_SYMBOL(ov_pcm_seek);
+    SHARED_LIBRARY_SYMBOL(ov_pcm_total);
+    SHARED_LIBRARY_SYMBOL(ov_read);
+    SHARED_LIBRARY_SYMBOL(ov_test_callbacks);
+    SHARED_LIBRARY_SYMBOL(ov_test_open);
+};
+
 struct AudioReadOgg::Impl
 {
     ~Impl()
     {
         if (vf.datasource)
         {
-            ov_clear(&vf);
+            library->ov_clear(&vf);
         }
     }
+    // destroyed after the stream
+    std::shared_ptr<Library> library;
     FILEUnique file;
     OggVorbis_File vf = {};
     vorbis_info *vi = nullptr;
@@ -29,7 +45,28 @@ AudioReadOgg::AudioReadOgg(std::unique_ptr<Impl> impl)
 
 AudioReadOgg::~AudioReadOgg() = default;
 
-std::unique_ptr<AudioRead> AudioReadOgg::create(FILEUnique &file, const char *)
+std::shared_ptr<AudioReadOgg::Library> AudioReadOgg::loadLib(std::ostream &)
+{
+    return std::make_shared<Library>();
+}
+
+bool AudioReadOgg::isSupported(FILEUnique &file, const char *)
+{
+    if (file == nullptr)
+    {
+        return false;
+    }
+    std::fseek(file.get(), 0, SEEK_SET);
+
+    // capture pattern of the 1st page
+    char magic[4] = {};
+    const bool result = std::fread(magic, 1, sizeof(magic), file.get()) == sizeof(magic) &&
+                        std::memcmp(magic, "OggS", sizeof(magic)) == 0;
+    std::fseek(file.get(), 0, SEEK_SET);
+    return result;
+}
+
+std::unique_ptr<AudioRead> AudioReadOgg::create(const std::shared_ptr<Library> &library, FILEUnique &file, const char *)
 {
     if (file == nullptr)
     {
@@ -39,20 +76,21 @@ std::unique_ptr<AudioRead> AudioReadOgg::create(FILEUnique &file, const char *)
 
     // early failure if this is not an Ogg Vorbis
     OggVorbis_File vf;
-    if (ov_test_callbacks(file.get(), &vf, nullptr, 0, OV_CALLBACKS_NOCLOSE))
+    if (library->ov_test_callbacks(file.get(), &vf, nullptr, 0, OV_CALLBACKS_NOCLOSE))
     {
         return nullptr;
     }
-    if (ov_test_open(&vf))
+    if (library->ov_test_open(&vf))
     {
         std::cerr << "Ogg Vorbis could not load the file" << std::endl;
-        ov_clear(&vf);
+        library->ov_clear(&vf);
         return nullptr;
     }
     auto pimpl = std::make_unique<Impl>();
+    pimpl->library = library;
     std::memcpy(&pimpl->vf, &vf, sizeof(vf));
 
-    if (pimpl->vi = ov_info(&pimpl->vf, -1); pimpl->vi == nullptr)
+    if (pimpl->vi = library->ov_info(&pimpl->vf, -1); pimpl->vi == nullptr)
     {
         std::cerr << "Ogg Vorbis could not get info about the file" << std::endl;
         return nullptr;
@@ -69,7 +107,7 @@ int AudioReadOgg::getChannels() const
 
 uint64_t AudioReadOgg::getSamples() const
 {
-    return ov_pcm_total(&pimpl->vf, -1);
+    return pimpl->library->ov_pcm_total(&pimpl->vf, -1);
 }
 
 int AudioReadOgg::getRate() const
@@ -82,7 +120,7 @@ size_t AudioReadOgg::readBuffer(char *buffer, size_t bufferSize, bool loop)
     size_t totalRead = 0;
     while (totalRead < bufferSize)
     {
-        const long read = ov_read(&pimpl->vf, buffer + totalRead, bufferSize - totalRead, BYTE_ORDER == BIG_ENDIAN, 2, 1, &pimpl->currentSection);
+        const long read = pimpl->library->ov_read(&pimpl->vf, buffer + totalRead, bufferSize - totalRead, BYTE_ORDER == BIG_ENDIAN, 2, 1, &pimpl->currentSection);
         if (read <= 0)
         {
             break;
@@ -94,7 +132,7 @@ size_t AudioReadOgg::readBuffer(char *buffer, size_t bufferSize, bool loop)
     if (totalRead < bufferSize && loop)
     {
         // EOF, loop
-        ov_pcm_seek(&pimpl->vf, 0);
+        pimpl->library->ov_pcm_seek(&pimpl->vf, 0);
         return totalRead + readBuffer(buffer + totalRead, bufferSize - totalRead, false);
     }
 
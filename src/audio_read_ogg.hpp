@@ -16,6 +16,8 @@ class AudioReadOgg : public AudioRead
 {
 public:
     struct Impl;
+    /// functions of libvorbisfile, loaded at runtime
+    struct Library;
 
     /**
      * This method cannot be called from outside. Create with create() method instead
@@ -23,9 +25,17 @@ public:
     explicit AudioReadOgg(std::unique_ptr<Impl> impl);
     ~AudioReadOgg() override;
 
-    // no static library initialization / cleanup
-    static void loadLib(std::ostream &) {}
-    static void unloadLib() {}
+    /**
+     * Load libvorbisfile. It is unloaded with the last reference, held by the AudioReadOgg objects too
+     *
+     * @throw std::runtime_error if the library is missing
+     */
+    static std::shared_ptr<Library> loadLib(std::ostream &str);
+
+    /**
+     * Fast check of the Ogg container, without the library. There is no check on extension
+     */
+    static bool isSupported(FILEUnique &file, const char *extension);
 
     /**
      * Create a AudioReadOgg object if the file is of right format
@@ -34,7 +44,7 @@ public:
      *
      * @return a valid unique_ptr in case of success, nullptr otherwise (this is not an OGG/Vorbis file for instance)
      */
-    static std::unique_ptr<AudioRead> create(FILEUnique &file, const char *extension);
+    static std::unique_ptr<AudioRead> create(const std::shared_ptr<Library> &library, FILEUnique &file, const char *extension);
 
     int getChannels() const override;
     uint64_t getSamples() const override;
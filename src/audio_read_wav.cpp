@@ -0,0 +1,154 @@
+#include "audio_read_wav.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+
+constexpr uint16_t kFormatPcm = 1;
+constexpr uint16_t kBitsPerSample = 16;
+
+/**
+ * Little endian integer of the header
+ */
+template <typename T>
+T readInteger(const unsigned char *data)
+{
+    T result = 0;
+    for (size_t i = sizeof(T); i--;)
+    {
+        result = static_cast<T>(result << 8 | data[i]);
+    }
+    return result;
+}
+
+} // namespace
+
+struct AudioReadWav::Impl
+{
+    std::shared_ptr<Library> library;
+    FILEUnique file;
+    int channels = 0;
+    int rate = 0;
+    long dataStart = 0;
+    uint32_t dataSize = 0;
+    uint32_t dataRead = 0;
+};
+
+AudioReadWav::AudioReadWav(std::unique_ptr<Impl> impl)
+    : pimpl{std::move(impl)}
+{
+}
+
+AudioReadWav::~AudioReadWav() = default;
+
+std::shared_ptr<AudioReadWav::Library> AudioReadWav::loadLib(std::ostream &)
+{
+    return std::make_shared<Library>();
+}
+
+bool AudioReadWav::isSupported(FILEUnique &file, const char *)
+{
+    if (file == nullptr)
+    {
+        return false;
+    }
+    std::fseek(file.get(), 0, SEEK_SET);
+
+    char header[12] = {};
+    const bool result = std::fread(header, 1, sizeof(header), file.get()) == sizeof(header) &&
+                        std::memcmp(header, "RIFF", 4) == 0 &&
+                        std::memcmp(header + 8, "WAVE", 4) == 0;
+    std::fseek(file.get(), 0, SEEK_SET);
+    return result;
+}
+
+std::unique_ptr<AudioRead> AudioReadWav::create(const std::shared_ptr<Library> &library, FILEUnique &file, const char *extension)
+{
+    if (!isSupported(file, extension))
+    {
+        return nullptr;
+    }
+    std::fseek(file.get(), 12, SEEK_SET);
+
+    auto pimpl = std::make_unique<Impl>();
+    pimpl->library = library;
+
+    // the chunks are read up to the data: the format chunk comes first
+    unsigned char chunk[8];
+    while (std::fread(chunk, 1, sizeof(chunk), file.get()) == sizeof(chunk))
+    {
+        const uint32_t chunkSize = readInteger<uint32_t>(chunk + 4);
+        if (std::memcmp(chunk, "fmt ", 4) == 0)
+        {
+            unsigned char format[16];
+            if (chunkSize < sizeof(format) || std::fread(format, 1, sizeof(format), file.get()) != sizeof(format))
+            {
+                return nullptr;
+            }
+            if (readInteger<uint16_t>(format) != kFormatPcm || readInteger<uint16_t>(format + 14) != kBitsPerSample)
+            {
+                std::cerr << "WAVE format is not 16 bits PCM" << std::endl;
+                return nullptr;
+            }
+            pimpl->channels = readInteger<uint16_t>(format + 2);
+            pimpl->rate = static_cast<int>(readInteger<uint32_t>(format + 4));
+            std::fseek(file.get(), chunkSize - sizeof(format) + chunkSize % 2, SEEK_CUR);
+        }
+        else if (std::memcmp(chunk, "data", 4) == 0)
+        {
+            if (pimpl->channels == 0)
+            {
+                return nullptr;
+            }
+            pimpl->dataStart = std::ftell(file.get());
+            pimpl->dataSize = chunkSize - chunkSize % (pimpl->channels * sizeof(int16_t));
+            pimpl->file = std::move(file);
+            return std::make_unique<AudioReadWav>(std::move(pimpl));
+        }
+        else
+        {
+            std::fseek(file.get(), chunkSize + chunkSize % 2, SEEK_CUR);
+        }
+    }
+    return nullptr;
+}
+
+int AudioReadWav::getChannels() const
+{
+    return pimpl->channels;
+}
+
+uint64_t AudioReadWav::getSamples() const
+{
+    return pimpl->dataSize / (pimpl->channels * sizeof(int16_t));
+}
+
+int AudioReadWav::getRate() const
+{
+    return pimpl->rate;
+}
+
+size_t AudioReadWav::readBuffer(char *buffer, size_t bufferSize, bool loop)
+{
+    const size_t toRead = std::min<size_t>(bufferSize, pimpl->dataSize - pimpl->dataRead);
+    const size_t totalRead = std::fread(buffer, 1, toRead, pimpl->file.get());
+    pimpl->dataRead += totalRead;
+
+    if (totalRead < bufferSize && loop)
+    {
+        // EOF, loop
+        std::fseek(pimpl->file.get(), pimpl->dataStart, SEEK_SET);
+        pimpl->dataRead = 0;
+        return totalRead + readBuffer(buffer + totalRead, bufferSize - totalRead, false);
+    }
+
+    return totalRead;
+}
+
+std::ostream &AudioReadWav::toStream(std::ostream &str) const
+{
+    return str << "WAVE rate=" << getRate() << " channels=" << getChannels();
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "audio_read.hpp"
+#include "toolbox_io.hpp"
+
+#include <memory>
+
+/**
+ * @brief Read WAVE files of 16 bits PCM samples
+ *
+ * There is no library to load: the samples are copied as they are, like the other formats decode them
+ */
+class AudioReadWav : public AudioRead
+{
+public:
+    struct Impl;
+    /// nothing to load, only to fit in AudioFormats
+    struct Library
+    {
+    };
+
+    /**
+     * This method cannot be called from outside. Create with create() method instead
+     */
+    explicit AudioReadWav(std::unique_ptr<Impl> impl);
+    ~AudioReadWav() override;
+
+    static std::shared_ptr<Library> loadLib(std::ostream &str);
+
+    /**
+     * Fast check of the RIFF / WAVE header. There is no check on extension
+     */
+    static bool isSupported(FILEUnique &file, const char *extension);
+
+    /**
+     * Create a AudioReadWav object if the file has a 16 bits PCM format chunk and a data chunk
+     *
+     * In case of success, takes the ownership of file
+     *
+     * @return a valid unique_ptr in case of success, nullptr otherwise
+     */
+    static std::unique_ptr<AudioRead> create(const std::shared_ptr<Library> &library, FILEUnique &file, const char *extension);
+
+    int getChannels() const override;
+    uint64_t getSamples() const override;
+    int getRate() const override;
+
+    size_t readBuffer(char *buffer, size_t bufferSize, bool loop) override;
+
+private:
+    std::ostream &toStream(std::ostream &str) const override;
+
+    std::unique_ptr<Impl> pimpl;
+};
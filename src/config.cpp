@@ -2,7 +2,9 @@
 
 #include "config_alarm.hpp"
 #include "serializer.hpp"
+#include "toolbox_assets.hpp"
 #include "toolbox_filesystem.hpp"
+#include "toolbox_io.hpp"
 
 #ifndef ALARM_ASSETS_DIR
 #define ALARM_ASSETS_DIR "/usr/share/alarm"
@@ -15,10 +17,15 @@ constexpr char kKeyAssetsFolder[] = "assets_folder";
 constexpr char kKeyDisplayDriver[] = "display_driver";
 constexpr char kKeyDisplayWidth[] = "display_width";
 constexpr char kKeyDisplayHeight[] = "display_height";
+constexpr char kKeyDisplayRotation[] = "display_rotation";
 constexpr char kKeyDisplaySeconds[] = "display_seconds";
 constexpr char kKeyEventDriver[] = "event_driver";
 constexpr char kKeyFramesPerSecond[] = "frames_per_second";
+constexpr char kKeyRenderThread[] = "render_thread";
 constexpr char kKeySensorThermal[] = "sensor_thermal";
+constexpr char kKeyShaderCacheFolder[] = "shader_cache_folder";
+constexpr char kKeyScreenCacheGpuKb[] = "screen_cache_gpu_kb";
+constexpr int kDefaultScreenCacheGpuKb = 4096;
 constexpr char kKeyHandClockColor[] = "hand_clock_color";
 constexpr char kKeyAlarms[] = "alarms";
 
@@ -33,6 +40,30 @@ std::string getAssetFile(std::string_view assetFolder, std::string_view assetTyp
     return path.native();
 }
 
+/**
+ * Embedded copy of the asset, empty if it must be read from the assets folder
+ */
+std::string_view findEmbeddedAsset(std::string_view assetType, std::string_view assetFile)
+{
+    if (hasEmbeddedAssets() == false)
+    {
+        return {};
+    }
+    std::string name{assetType};
+    name += '/';
+    name += assetFile;
+    return getEmbeddedAsset(name);
+}
+
+MmapFile openAsset(std::string_view assetFolder, std::string_view assetType, std::string_view assetFile)
+{
+    if (const std::string_view content = findEmbeddedAsset(assetType, assetFile); !content.empty())
+    {
+        return MmapFile::fromMemory(content);
+    }
+    return MmapFile{getAssetFile(assetFolder, assetType, assetFile).c_str()};
+}
+
 } // namespace
 
 struct Config::Impl
@@ -44,8 +75,12 @@ struct Config::Impl
     std::string eventDriver = "default";
     int displayWidth = 320;
     int displayHeight = 240;
+    int displayRotation = 0;
     int framesPerSecond = 20; // same as fbtft
+    bool renderThread = true;
     std::string temperatureSensor;
+    std::string shaderCacheFolder;
+    int screenCacheGpuKb = kDefaultScreenCacheGpuKb;
     uint8_t clockHandColor[3] = {255, 0, 0};
     std::list<ConfigAlarm> alarms;
 };
@@ -127,6 +162,16 @@ void Config::setDisplayHeight(int h)
     pimpl->displayHeight = h;
 }
 
+int Config::getDisplayRotation() const
+{
+    return pimpl->displayRotation;
+}
+
+void Config::setDisplayRotation(int degree)
+{
+    pimpl->displayRotation = degree;
+}
+
 const uint8_t (&Config::getClockHandColor() const)[3]
 {
     return pimpl->clockHandColor;
@@ -147,6 +192,16 @@ void Config::setFramesPerSecond(int fps)
     pimpl->framesPerSecond = fps;
 }
 
+bool Config::isRenderThread() const
+{
+    return pimpl->renderThread;
+}
+
+void Config::setRenderThread(bool enabled)
+{
+    pimpl->renderThread = enabled;
+}
+
 std::string_view Config::getSensorThermal() const
 {
     return pimpl->temperatureSensor;
@@ -157,6 +212,26 @@ void Config::setSensorThermal(std::string_view name)
     pimpl->temperatureSensor = name;
 }
 
+std::string_view Config::getShaderCacheFolder() const
+{
+    return pimpl->shaderCacheFolder;
+}
+
+void Config::setShaderCacheFolder(std::string_view folder)
+{
+    pimpl->shaderCacheFolder = folder;
+}
+
+int Config::getScreenCacheGpuKb() const
+{
+    return pimpl->screenCacheGpuKb;
+}
+
+void Config::setScreenCacheGpuKb(int kb)
+{
+    pimpl->screenCacheGpuKb = kb;
+}
+
 const std::list<ConfigAlarm> &Config::getAlarms() const
 {
     return pimpl->alarms;
@@ -189,6 +264,10 @@ void Config::load(const Deserializer &deserializer)
     {
         setDisplayHeight(*displayHeight);
     }
+    if (const auto displayRotation = deserializer.getInt(kKeyDisplayRotation))
+    {
+        setDisplayRotation(*displayRotation);
+    }
     if (const auto displaySeconds = deserializer.getBool(kKeyDisplaySeconds))
     {
         setDisplaySeconds(*displaySeconds);
@@ -201,10 +280,22 @@ void Config::load(const Deserializer &deserializer)
     {
         setFramesPerSecond(*fps);
     }
+    if (const auto renderThread = deserializer.getBool(kKeyRenderThread))
+    {
+        setRenderThread(*renderThread);
+    }
     if (const auto temperatureSensor = deserializer.getString(kKeySensorThermal))
     {
         setSensorThermal(*temperatureSensor);
     }
+    if (const auto shaderCacheFolder = deserializer.getString(kKeyShaderCacheFolder))
+    {
+        setShaderCacheFolder(*shaderCacheFolder);
+    }
+    if (const auto gpuKb = deserializer.getInt(kKeyScreenCacheGpuKb))
+    {
+        setScreenCacheGpuKb(*gpuKb);
+    }
 
     if (const auto r = deserializer.getIntFromArrayAt(kKeyHandClockColor, 0),
         g = deserializer.getIntFromArrayAt(kKeyHandClockColor, 1),
@@ -235,16 +326,32 @@ void Config::save(Serializer &serializer) const
     }
     serializer.setInt(kKeyDisplayWidth, getDisplayWidth());
     serializer.setInt(kKeyDisplayHeight, getDisplayHeight());
+    if (const auto rotation = getDisplayRotation(); rotation != 0)
+    {
+        serializer.setInt(kKeyDisplayRotation, rotation);
+    }
     serializer.setBool(kKeyDisplaySeconds, displaySeconds());
     if (const auto driver = getEventDriver(); !driver.empty())
     {
         serializer.setString(kKeyEventDriver, driver);
     }
     serializer.setInt(kKeyFramesPerSecond, getFramesPerSecond());
+    if (!isRenderThread())
+    {
+        serializer.setBool(kKeyRenderThread, false);
+    }
     if (const auto name = getSensorThermal(); !name.empty())
     {
         serializer.setString(kKeySensorThermal, name);
     }
+    if (const auto folder = getShaderCacheFolder(); !folder.empty())
+    {
+        serializer.setString(kKeyShaderCacheFolder, folder);
+    }
+    if (const auto gpuKb = getScreenCacheGpuKb(); gpuKb != kDefaultScreenCacheGpuKb)
+    {
+        serializer.setInt(kKeyScreenCacheGpuKb, gpuKb);
+    }
 
     for (const int rgb : getClockHandColor())
     {
@@ -276,3 +383,18 @@ std::string Config::getMessages() const
 {
     return getAssetFile(getAssetsFolder(), "messages", "");
 }
+
+MmapFile Config::openShader(std::string_view filename) const
+{
+    return openAsset(getAssetsFolder(), "shader", filename);
+}
+
+MmapFile Config::openTexture(std::string_view filename) const
+{
+    return openAsset(getAssetsFolder(), "textures", filename);
+}
+
+bool Config::hasTexture(std::string_view filename) const
+{
+    return !findEmbeddedAsset("textures", filename).empty() || fs::exists(getTexture(filename));
+}
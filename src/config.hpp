@@ -7,6 +7,7 @@
 #include <string_view>
 
 class ConfigAlarm;
+class MmapFile;
 
 /**
  * @brief holds the configuration
@@ -26,8 +27,12 @@ public:
      * @arg display_driver is not defined
      * @arg display_width is 320
      * @arg display_height is 240
+     * @arg display_rotation is 0 (clockwise, in degrees: 0, 90, 180 or 270)
      * @arg frames_per_second is 25 (main screen consumes ~2% CPU on a Raspberry PI 1B)
+     * @arg render_thread is true (the frames are recorded by a logic thread, then drawn by the OpenGL one)
      * @arg sensor_thermal is not defined
+     * @arg shader_cache_folder is not defined (the compiled shaders are not stored on disk)
+     * @arg screen_cache_gpu_kb is 4096 (GPU memory of the inactive screens kept warm)
      * @arg display_seconds is true (display second hand on the clock)
      * @arg hand_clock_color is red
      * @arg alarms is empty (no default alarm)
@@ -56,15 +61,30 @@ public:
     int getDisplayHeight() const;
     void setDisplayHeight(int h);
 
+    int getDisplayRotation() const;
+    void setDisplayRotation(int degree);
+
     const uint8_t (&getClockHandColor() const)[3];
     uint8_t (&getClockHandColor())[3];
 
     int getFramesPerSecond() const;
     void setFramesPerSecond(int fps);
 
+    bool isRenderThread() const;
+    void setRenderThread(bool enabled);
+
     std::string_view getSensorThermal() const;
     void setSensorThermal(std::string_view name);
 
+    std::string_view getShaderCacheFolder() const;
+    void setShaderCacheFolder(std::string_view folder);
+
+    /**
+     * GPU memory budget in kB of the warm screens: 0 releases every inactive screen
+     */
+    int getScreenCacheGpuKb() const;
+    void setScreenCacheGpuKb(int kb);
+
     const std::list<ConfigAlarm> &getAlarms() const;
     std::list<ConfigAlarm> &getAlarms();
 
@@ -77,6 +97,21 @@ public:
     std::string getTexture(std::string_view filename = {}) const;
     std::string getMessages() const;
 
+    /**
+     * Content of a shader or a texture: the copy embedded in the executable (USE_EMBEDDED_ASSETS=1 in the Makefile),
+     * otherwise the file of getShader() / getTexture(). The environment variable ALARM_ASSETS_FROM_DISK forces the
+     * files, e.g. to edit a shader without linking again
+     *
+     * @throw std::runtime_error if there is no such asset
+     */
+    MmapFile openShader(std::string_view filename) const;
+    MmapFile openTexture(std::string_view filename) const;
+
+    /**
+     * Is there such a texture, embedded or in the assets folder? e.g. the ETC variants are optional
+     */
+    bool hasTexture(std::string_view filename) const;
+
 private:
     std::unique_ptr<Impl> pimpl;
 };
@@ -12,15 +12,18 @@
 
 #include <cassert>
 #include <iostream>
+#include <utility>
 
 struct Context::Impl
 {
-    Impl(Context &ctx, Config &config, SerializationHandler &configPersistence, Renderer &renderer)
+    Impl(Context &ctx, Config &config, SerializationHandler &configPersistence, Renderer &renderer,
+         std::unique_ptr<Audio> &&audio, std::unique_ptr<SensorFactory> &&sensorFactory)
         : config{config},
           configPersistence{configPersistence},
           renderer{renderer},
-          audio{config.getAlsaDevice()},
-          alarm{config, audio},
+          audio{std::move(audio)},
+          alarm{config, this->audio.get()},
+          sensorFactory{std::move(sensorFactory)},
           screenFactory{ctx}
     {
     }
@@ -28,13 +31,12 @@ struct Context::Impl
     Config &config;
     SerializationHandler &configPersistence;
     Renderer &renderer;
-    Audio audio;
+    std::unique_ptr<Audio> audio;
 
     Alarm alarm;
-    SensorFactory sensorFactory;
+    std::unique_ptr<SensorFactory> sensorFactory;
     ScreenFactory screenFactory;
 
-    ScreenType screenType = ScreenType::Main;
     size_t thermalSensor = -1;
 };
 
@@ -43,16 +45,7 @@ namespace
 
 void setScreen(Context::Impl &pimpl, ScreenType newType)
 {
-    if (Screen *newScreen = pimpl.screenFactory.get(newType))
-    {
-        if (Screen *oldScreen = pimpl.screenFactory.get(pimpl.screenType))
-        {
-            oldScreen->leave();
-        }
-        newScreen->enter();
-        pimpl.screenType = newType;
-    }
-    else
+    if (!pimpl.screenFactory.setCurrent(newType))
     {
         std::cerr << "Unknown screen: " << static_cast<int>(newType) << std::endl;
     }
@@ -61,7 +54,13 @@ void setScreen(Context::Impl &pimpl, ScreenType newType)
 } // namespace
 
 Context::Context(Config &config, SerializationHandler &configPersistence, Renderer &renderer)
-    : pimpl{std::make_unique<Impl>(*this, config, configPersistence, renderer)}
+    : Context{config, configPersistence, renderer, std::make_unique<Audio>(config.getAlsaDevice(), std::cerr), std::make_unique<SensorFactory>()}
+{
+}
+
+Context::Context(Config &config, SerializationHandler &configPersistence, Renderer &renderer,
+                 std::unique_ptr<Audio> audio, std::unique_ptr<SensorFactory> sensorFactory)
+    : pimpl{std::make_unique<Impl>(*this, config, configPersistence, renderer, std::move(audio), std::move(sensorFactory))}
 {
     resetSensors();
     std::cerr << getSensorFactory();
@@ -77,16 +76,19 @@ Context::Context(Config &config, SerializationHandler &configPersistence, Render
     setScreen(*pimpl, ScreenType::Main);
 }
 
-Context::~Context() = default;
+Context::~Context()
+{
+    std::cerr << pimpl->screenFactory;
+}
 
 Renderer &Context::getRenderer()
 {
     return pimpl->renderer;
 }
 
-Audio &Context::getAudio()
+Audio *Context::getAudio()
 {
-    return pimpl->audio;
+    return pimpl->audio.get();
 }
 
 Config &Context::getConfig()
@@ -110,6 +112,8 @@ void Context::loadConfig()
     std::cerr << "Load config" << std::endl;
     getAlarm().reset();
     pimpl->configPersistence.load(pimpl->config);
+    // the warm screens were built from the previous config
+    pimpl->screenFactory.clear();
 }
 
 Alarm &Context::getAlarm()
@@ -139,28 +143,28 @@ void Context::deleteAlarm(ConfigAlarm &alarm)
 
 Screen &Context::getScreen()
 {
-    Screen *const screen = pimpl->screenFactory.get(pimpl->screenType);
+    Screen *const screen = pimpl->screenFactory.get(pimpl->screenFactory.getCurrent());
     assert(screen);
     return *screen;
 }
 
 void Context::previousScreen()
 {
-    setScreen(*pimpl, ScreenType{static_cast<int>(pimpl->screenType) - 1});
+    setScreen(*pimpl, ScreenType{static_cast<int>(pimpl->screenFactory.getCurrent()) - 1});
 }
 
 void Context::nextScreen()
 {
-    setScreen(*pimpl, ScreenType{static_cast<int>(pimpl->screenType) + 1});
+    setScreen(*pimpl, ScreenType{static_cast<int>(pimpl->screenFactory.getCurrent()) + 1});
 }
 
 void Context::resetSensors()
 {
     pimpl->thermalSensor = -1;
     const auto thermalSensor = getConfig().getSensorThermal();
-    for (size_t i = pimpl->sensorFactory.getSize(SensorFactory::Type::Temperature); i--;)
+    for (size_t i = pimpl->sensorFactory->getSize(SensorFactory::Type::Temperature); i--;)
     {
-        if (const auto sensor = pimpl->sensorFactory.get(SensorFactory::Type::Temperature, i))
+        if (const auto sensor = pimpl->sensorFactory->get(SensorFactory::Type::Temperature, i))
         {
             if (sensor->getName() == thermalSensor)
             {
@@ -172,7 +176,7 @@ void Context::resetSensors()
 
 SensorFactory &Context::getSensorFactory()
 {
-    return pimpl->sensorFactory;
+    return *pimpl->sensorFactory;
 }
 
 Sensor *Context::getTemperatureSensor()
@@ -26,6 +26,14 @@ public:
      * @attention the object keeps a reference to constructor's arguments. Make sure they stay valid
      */
     Context(Config &config, SerializationHandler &configPersistence, Renderer &renderer);
+
+    /**
+     * With the audio and the sensors already created, e.g. by other threads during the startup
+     *
+     * @param audio nullptr without any audio device, e.g. in the tests: the alarms are silent
+     */
+    Context(Config &config, SerializationHandler &configPersistence, Renderer &renderer,
+            std::unique_ptr<Audio> audio, std::unique_ptr<SensorFactory> sensorFactory);
     ~Context();
 
     /**
@@ -35,8 +43,10 @@ public:
 
     /**
      * Get the audio system
+     *
+     * @return nullptr without any audio device
      */
-    Audio &getAudio();
+    Audio *getAudio();
 
     Config &getConfig();
     const Config &getConfig() const;
@@ -2,7 +2,7 @@
 
 #include "error.hpp"
 
-#if USE_WINDOW_FRAMEBUFFER || USE_WINDOW_WAYLAND || USE_WINDOW_DISPMANX
+#if USE_WINDOW_FRAMEBUFFER || USE_WINDOW_DRM || USE_WINDOW_HEADLESS || USE_WINDOW_WAYLAND || USE_WINDOW_DISPMANX
 
 #define USE_EGL_ERROR
 
@@ -15,4 +15,4 @@ public:
                       int line = __builtin_LINE());
 };
 
-#endif // USE_WINDOW_FRAMEBUFFER || USE_WINDOW_WAYLAND || USE_WINDOW_DISPMANX
+#endif // USE_WINDOW_FRAMEBUFFER || USE_WINDOW_DRM || USE_WINDOW_HEADLESS || USE_WINDOW_WAYLAND || USE_WINDOW_DISPMANX
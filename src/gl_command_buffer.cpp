@@ -0,0 +1,257 @@
+#include "gl_command_buffer.hpp"
+
+#include "gl_counters.hpp"
+#include "toolbox_gl.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+
+enum class Op : uint8_t
+{
+    UseProgram,
+    BindBuffer,
+    BufferSubData,
+    VertexAttribPointer,
+    BindTexture,
+    TexSubImage2D,
+    DrawElements,
+    Uniform,
+    ClearColor,
+    SetBlend,
+    BindFramebuffer,
+};
+
+/**
+ * @brief 1 OpenGL call. The fields are only meaningful for some operations
+ */
+struct Command
+{
+    Op op;
+    GLboolean flag;                    ///< normalized, blend enabled
+    GLenum glEnum;                     ///< target, type
+    GLuint name;                       ///< program, VBO, texture, framebuffer, attribute index, texture y
+    GLint location;                    ///< uniform location, attribute size, texture x
+    GLsizei count;                     ///< stride, number of indices, number of uniform values, data size
+    size_t offset;                     ///< in bytes, in the OpenGL buffer, texture width
+    size_t data;                       ///< in bytes, in GlCommandBuffer::Impl::data
+    std::array<GLfloat, 3> values;     ///< uniform
+};
+
+// buffer of the current thread
+thread_local GlCommandBuffer *recording = nullptr;
+
+/**
+ * Call OpenGL, counted in GlCounters
+ */
+void execute(const Command &command, const char *data)
+{
+    switch (command.op)
+    {
+    case Op::UseProgram:
+        GlCounters::count(GlCounters::Call::Bind);
+        glUseProgram(command.name);
+        break;
+    case Op::BindBuffer:
+        GlCounters::count(GlCounters::Call::Bind);
+        glBindBuffer(command.glEnum, command.name);
+        break;
+    case Op::BufferSubData:
+        GlCounters::count(GlCounters::Call::Upload, command.count);
+        glBufferSubData(command.glEnum, command.offset, command.count, data);
+        break;
+    case Op::VertexAttribPointer:
+        GlCounters::count(GlCounters::Call::State);
+        glVertexAttribPointer(command.name, command.location, command.glEnum, command.flag, command.count, reinterpret_cast<void *>(command.offset));
+        break;
+    case Op::BindTexture:
+        GlCounters::count(GlCounters::Call::Bind);
+        glBindTexture(GL_TEXTURE_2D, command.name);
+        break;
+    case Op::TexSubImage2D:
+        GlCounters::count(GlCounters::Call::TextureUpload, command.count);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, command.location, command.name, command.offset, command.count / command.offset,
+                        GL_LUMINANCE, GL_UNSIGNED_BYTE, data);
+        break;
+    case Op::DrawElements:
+        GlCounters::count(GlCounters::Call::Draw);
+        glDrawElements(GL_TRIANGLES, command.count, command.glEnum, reinterpret_cast<void *>(command.offset));
+        break;
+    case Op::Uniform:
+        GlCounters::count(GlCounters::Call::State);
+        switch (command.count)
+        {
+        case 1:
+            glUniform1f(command.location, command.values[0]);
+            break;
+        case 2:
+            glUniform2f(command.location, command.values[0], command.values[1]);
+            break;
+        default:
+            glUniform3f(command.location, command.values[0], command.values[1], command.values[2]);
+            break;
+        }
+        break;
+    case Op::ClearColor:
+        GlCounters::count(GlCounters::Call::Other);
+        glClear(GL_COLOR_BUFFER_BIT);
+        break;
+    case Op::SetBlend:
+        GlCounters::count(GlCounters::Call::State);
+        if (command.flag)
+        {
+            glEnable(GL_BLEND);
+        }
+        else
+        {
+            glDisable(GL_BLEND);
+        }
+        break;
+    case Op::BindFramebuffer:
+        GlCounters::count(GlCounters::Call::Bind);
+        glBindFramebuffer(GL_FRAMEBUFFER, command.name);
+        break;
+    }
+}
+
+} // namespace
+
+struct GlCommandBuffer::Impl
+{
+    /**
+     * Record the command in the buffer of the thread, or call OpenGL
+     *
+     * @param data copied when recorded, command.count bytes
+     */
+    static void dispatch(Command command, const void *data = nullptr)
+    {
+        if (!recording)
+        {
+            execute(command, static_cast<const char *>(data));
+            return;
+        }
+
+        Impl &impl = *recording->pimpl;
+        if (data)
+        {
+            command.data = impl.data.size();
+            impl.data.resize(command.data + command.count);
+            std::memcpy(impl.data.data() + command.data, data, command.count);
+        }
+        impl.commands.push_back(command);
+    }
+
+    std::vector<Command> commands;
+    std::vector<char> data;
+};
+
+GlCommandBuffer::Recording::Recording(GlCommandBuffer &buffer)
+    : previous{recording}
+{
+    recording = &buffer;
+}
+
+GlCommandBuffer::Recording::~Recording()
+{
+    recording = previous;
+}
+
+GlCommandBuffer::GlCommandBuffer()
+    : pimpl{std::make_unique<Impl>()}
+{
+}
+
+GlCommandBuffer::~GlCommandBuffer() = default;
+
+GlCommandBuffer *GlCommandBuffer::getRecording()
+{
+    return recording;
+}
+
+void GlCommandBuffer::replay() const
+{
+    for (const Command &command : pimpl->commands)
+    {
+        execute(command, pimpl->data.data() + command.data);
+    }
+}
+
+void GlCommandBuffer::clear()
+{
+    pimpl->commands.clear();
+    pimpl->data.clear();
+}
+
+size_t GlCommandBuffer::size() const
+{
+    return pimpl->commands.size();
+}
+
+void GlCommandBuffer::useProgram(unsigned int program)
+{
+    Impl::dispatch(Command{Op::UseProgram, GL_FALSE, 0, program, 0, 0, 0, 0, {}});
+}
+
+void GlCommandBuffer::bindBuffer(unsigned int glTarget, unsigned int vbo)
+{
+    Impl::dispatch(Command{Op::BindBuffer, GL_FALSE, glTarget, vbo, 0, 0, 0, 0, {}});
+}
+
+void GlCommandBuffer::bufferSubData(unsigned int glTarget, size_t offset, size_t size, const void *data)
+{
+    Impl::dispatch(Command{Op::BufferSubData, GL_FALSE, glTarget, 0, 0, static_cast<GLsizei>(size), offset, 0, {}}, data);
+}
+
+void GlCommandBuffer::vertexAttribPointer(unsigned int index, int size, unsigned int glType, bool normalized, int stride, size_t offset)
+{
+    Impl::dispatch(Command{Op::VertexAttribPointer, normalized, glType, index, size, stride, offset, 0, {}});
+}
+
+void GlCommandBuffer::bindTexture(unsigned int texture)
+{
+    Impl::dispatch(Command{Op::BindTexture, GL_FALSE, 0, texture, 0, 0, 0, 0, {}});
+}
+
+void GlCommandBuffer::texSubImage2D(int x, int y, int width, int height, const void *data)
+{
+    Impl::dispatch(Command{Op::TexSubImage2D, GL_FALSE, 0, static_cast<GLuint>(y), x, width * height, static_cast<size_t>(width), 0, {}}, data);
+}
+
+void GlCommandBuffer::drawElements(int count, unsigned int glType, size_t offset)
+{
+    Impl::dispatch(Command{Op::DrawElements, GL_FALSE, glType, 0, 0, count, offset, 0, {}});
+}
+
+void GlCommandBuffer::uniform(int location, float x)
+{
+    Impl::dispatch(Command{Op::Uniform, GL_FALSE, 0, 0, location, 1, 0, 0, {x, 0, 0}});
+}
+
+void GlCommandBuffer::uniform(int location, float x, float y)
+{
+    Impl::dispatch(Command{Op::Uniform, GL_FALSE, 0, 0, location, 2, 0, 0, {x, y, 0}});
+}
+
+void GlCommandBuffer::uniform(int location, float x, float y, float z)
+{
+    Impl::dispatch(Command{Op::Uniform, GL_FALSE, 0, 0, location, 3, 0, 0, {x, y, z}});
+}
+
+void GlCommandBuffer::clearColor()
+{
+    Impl::dispatch(Command{Op::ClearColor, GL_FALSE, 0, 0, 0, 0, 0, 0, {}});
+}
+
+void GlCommandBuffer::setBlend(bool enabled)
+{
+    Impl::dispatch(Command{Op::SetBlend, enabled, 0, 0, 0, 0, 0, 0, {}});
+}
+
+void GlCommandBuffer::bindFramebuffer(unsigned int framebuffer)
+{
+    Impl::dispatch(Command{Op::BindFramebuffer, GL_FALSE, 0, framebuffer, 0, 0, 0, 0, {}});
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+/**
+ * @brief OpenGL calls of a frame, recorded by a thread then replayed by the thread owning the OpenGL context
+ *
+ * While a Recording is alive on the current thread, the static functions append a command to its buffer instead of
+ * calling OpenGL. Without any, they call OpenGL right away.
+ *
+ * Only the calls drawing a frame can be recorded: the creation and the destruction of the OpenGL objects still need the
+ * context, see Renderer::runOnContext(). The data of bufferSubData() and texSubImage2D() is copied, the other arguments
+ * are plain values.
+ * clear() keeps the memory: recording the same frame again does not allocate.
+ *
+ * @sa RendererThread
+ */
+class GlCommandBuffer
+{
+public:
+    struct Impl;
+
+    /**
+     * @brief Record the calls of the current thread into a buffer during its lifetime
+     */
+    class Recording
+    {
+    public:
+        explicit Recording(GlCommandBuffer &buffer);
+        ~Recording();
+
+        Recording(const Recording &) = delete;
+        Recording &operator=(const Recording &) = delete;
+
+    private:
+        GlCommandBuffer *previous;
+    };
+
+    GlCommandBuffer();
+    ~GlCommandBuffer();
+
+    /**
+     * Buffer recording the calls of the current thread, nullptr if they call OpenGL
+     */
+    static GlCommandBuffer *getRecording();
+
+    /**
+     * Call OpenGL with the recorded commands, in order. To be called by the thread owning the context
+     */
+    void replay() const;
+
+    /**
+     * Remove all the recorded commands
+     */
+    void clear();
+
+    /**
+     * Number of recorded commands
+     */
+    size_t size() const;
+
+    // glUseProgram()
+    static void useProgram(unsigned int program);
+    // glBindBuffer()
+    static void bindBuffer(unsigned int glTarget, unsigned int vbo);
+    // glBufferSubData(), offset and size in bytes
+    static void bufferSubData(unsigned int glTarget, size_t offset, size_t size, const void *data);
+    // glVertexAttribPointer() from the bound GL_ARRAY_BUFFER, offset in bytes
+    static void vertexAttribPointer(unsigned int index, int size, unsigned int glType, bool normalized, int stride, size_t offset);
+    // glBindTexture(GL_TEXTURE_2D, texture)
+    static void bindTexture(unsigned int texture);
+    // glTexSubImage2D(GL_TEXTURE_2D, 0, ..., GL_LUMINANCE, GL_UNSIGNED_BYTE) of the bound texture, 1 byte per pixel
+    static void texSubImage2D(int x, int y, int width, int height, const void *data);
+    // glDrawElements(GL_TRIANGLES) from the bound GL_ELEMENT_ARRAY_BUFFER, offset in bytes
+    static void drawElements(int count, unsigned int glType, size_t offset);
+    // glUniform1f(), glUniform2f(), glUniform3f()
+    static void uniform(int location, float x);
+    static void uniform(int location, float x, float y);
+    static void uniform(int location, float x, float y, float z);
+    // glClear(GL_COLOR_BUFFER_BIT)
+    static void clearColor();
+    // glEnable(GL_BLEND) / glDisable(GL_BLEND)
+    static void setBlend(bool enabled);
+    // glBindFramebuffer(GL_FRAMEBUFFER, framebuffer)
+    static void bindFramebuffer(unsigned int framebuffer);
+
+private:
+    std::unique_ptr<Impl> pimpl;
+};
@@ -0,0 +1,90 @@
+#include "gl_counters.hpp"
+
+#include <algorithm>
+#include <ostream>
+
+namespace
+{
+
+GlCounters processCounters;
+
+} // namespace
+
+const GlCounters &GlCounters::get()
+{
+    return processCounters;
+}
+
+void GlCounters::count(Call call, size_t bytes)
+{
+    ++processCounters.calls;
+    switch (call)
+    {
+    case Call::Draw:
+        ++processCounters.draws;
+        break;
+    case Call::Bind:
+        ++processCounters.binds;
+        break;
+    case Call::State:
+        ++processCounters.stateChanges;
+        break;
+    case Call::Upload:
+        ++processCounters.uploads;
+        processCounters.uploadedBytes += bytes;
+        break;
+    case Call::TextureUpload:
+        ++processCounters.textureUploads;
+        processCounters.textureBytes += bytes;
+        break;
+    case Call::Other:
+        break;
+    }
+}
+
+GlCounters GlCounters::operator-(const GlCounters &other) const
+{
+    return GlCounters{calls - other.calls,
+                      draws - other.draws,
+                      binds - other.binds,
+                      stateChanges - other.stateChanges,
+                      uploads - other.uploads,
+                      uploadedBytes - other.uploadedBytes,
+                      textureUploads - other.textureUploads,
+                      textureBytes - other.textureBytes};
+}
+
+GlCounters &GlCounters::operator+=(const GlCounters &other)
+{
+    calls += other.calls;
+    draws += other.draws;
+    binds += other.binds;
+    stateChanges += other.stateChanges;
+    uploads += other.uploads;
+    uploadedBytes += other.uploadedBytes;
+    textureUploads += other.textureUploads;
+    textureBytes += other.textureBytes;
+    return *this;
+}
+
+GlCounters GlCounters::max(const GlCounters &a, const GlCounters &b)
+{
+    return GlCounters{std::max(a.calls, b.calls),
+                      std::max(a.draws, b.draws),
+                      std::max(a.binds, b.binds),
+                      std::max(a.stateChanges, b.stateChanges),
+                      std::max(a.uploads, b.uploads),
+                      std::max(a.uploadedBytes, b.uploadedBytes),
+                      std::max(a.textureUploads, b.textureUploads),
+                      std::max(a.textureBytes, b.textureBytes)};
+}
+
+std::ostream &operator<<(std::ostream &str, const GlCounters &counters)
+{
+    return str << counters.calls << " calls, "
+               << counters.draws << " draws, "
+               << counters.binds << " binds, "
+               << counters.stateChanges << " state changes, "
+               << counters.uploads << " uploads of " << counters.uploadedBytes << " bytes, "
+               << counters.textureUploads << " texture uploads of " << counters.textureBytes << " bytes";
+}
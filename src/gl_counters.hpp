@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <iosfwd>
+
+/**
+ * @brief Number of OpenGL calls and uploaded bytes
+ *
+ * Counted since the start of the process by the wrappers of GlCommandBuffer, GlTexture and GlVbo, on the thread owning
+ * the OpenGL context. The difference of 2 snapshots is the cost of a frame, e.g. to check a budget in a test.
+ */
+struct GlCounters
+{
+    enum class Call
+    {
+        Draw,          ///< glDrawElements()
+        Bind,          ///< glUseProgram(), glBindBuffer(), glBindTexture(), glBindFramebuffer()
+        State,         ///< glVertexAttribPointer(), glUniform*(), glEnable(), glDisable()
+        Upload,        ///< glBufferData(), glBufferSubData()
+        TextureUpload, ///< glTexImage2D(), glTexSubImage2D(), glCompressedTexImage2D()
+        Other,         ///< e.g. glClear()
+    };
+
+    size_t calls = 0; ///< all of them
+    size_t draws = 0;
+    size_t binds = 0;
+    size_t stateChanges = 0;
+    size_t uploads = 0;
+    size_t uploadedBytes = 0;
+    size_t textureUploads = 0;
+    size_t textureBytes = 0;
+
+    /**
+     * Counters of the process
+     */
+    static const GlCounters &get();
+
+    /**
+     * Count 1 call of the process
+     *
+     * @param bytes uploaded by Call::Upload or Call::TextureUpload
+     */
+    static void count(Call call, size_t bytes = 0);
+
+    GlCounters operator-(const GlCounters &other) const;
+    GlCounters &operator+=(const GlCounters &other);
+
+    /**
+     * Maximum of each counter
+     */
+    static GlCounters max(const GlCounters &a, const GlCounters &b);
+};
+
+std::ostream &operator<<(std::ostream &str, const GlCounters &counters);
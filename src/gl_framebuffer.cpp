@@ -0,0 +1,59 @@
+#include "gl_framebuffer.hpp"
+
+#include "gl_command_buffer.hpp"
+#include "gl_texture.hpp"
+#include "toolbox_gl.hpp"
+
+#include <utility>
+
+GlFramebuffer::Guard::~Guard()
+{
+    if (framebuffer)
+    {
+        glDeleteFramebuffers(1, &framebuffer);
+    }
+}
+
+GlFramebuffer::GlFramebuffer(GlTexture &texture)
+{
+    glGenFramebuffers(1, &guard.framebuffer);
+    bind();
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture.get(), 0);
+    complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    unbind();
+}
+
+GlFramebuffer::GlFramebuffer(GlFramebuffer &&other)
+{
+    std::swap(guard.framebuffer, other.guard.framebuffer);
+    std::swap(complete, other.complete);
+}
+
+GlFramebuffer &GlFramebuffer::operator=(GlFramebuffer &&other)
+{
+    std::swap(guard.framebuffer, other.guard.framebuffer);
+    std::swap(complete, other.complete);
+    return *this;
+}
+
+GlFramebuffer::~GlFramebuffer() = default;
+
+bool GlFramebuffer::isComplete() const
+{
+    return complete;
+}
+
+void GlFramebuffer::bind()
+{
+    GlCommandBuffer::bindFramebuffer(get());
+}
+
+void GlFramebuffer::unbind()
+{
+    GlCommandBuffer::bindFramebuffer(0);
+}
+
+unsigned int GlFramebuffer::get() const
+{
+    return guard.framebuffer;
+}
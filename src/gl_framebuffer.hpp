@@ -0,0 +1,60 @@
+#pragma once
+
+class GlTexture;
+
+/**
+ * @brief stores an OpenGL Framebuffer Object (FBO) rendering into a texture
+ *
+ * As it is a link to OpenGL resource, there is no copy, only move
+ */
+class GlFramebuffer
+{
+    explicit GlFramebuffer(const GlFramebuffer &) = delete;
+    GlFramebuffer &operator=(const GlFramebuffer &) = delete;
+
+public:
+    /**
+     * Create a FBO whose color attachment is the texture
+     *
+     * @attention the texture must outlive the FBO
+     */
+    explicit GlFramebuffer(GlTexture &texture);
+
+    explicit GlFramebuffer(GlFramebuffer &&other);
+    GlFramebuffer &operator=(GlFramebuffer &&other);
+
+    ~GlFramebuffer();
+
+    /**
+     * Whether the driver accepts to render into the FBO (glCheckFramebufferStatus())
+     */
+    bool isComplete() const;
+
+    /**
+     * Bind the FBO: the next draw calls render into the texture
+     */
+    void bind();
+
+    /**
+     * Bind the default framebuffer: the next draw calls render on screen
+     */
+    static void unbind();
+
+    /**
+     * Get the OpenGL identifier for the FBO
+     */
+    unsigned int get() const;
+
+private:
+    /**
+     * @brief Destroy the FBO on OpenGL side in the destructor
+     */
+    struct Guard
+    {
+        ~Guard();
+        unsigned int framebuffer = 0;
+    };
+
+    Guard guard;
+    bool complete = false;
+};
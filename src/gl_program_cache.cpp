@@ -0,0 +1,210 @@
+#include "gl_program_cache.hpp"
+
+#include "error.hpp"
+#include "gl_shader.hpp"
+#include "toolbox_filesystem.hpp"
+#include "toolbox_gl.hpp"
+#include "toolbox_io.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+
+namespace
+{
+
+constexpr std::array<char, 8> kMagic{'A', 'L', 'A', 'R', 'M', 'P', 'G', 'M'};
+
+/**
+ * @brief Start of a file of the disk cache, followed by the binary
+ */
+struct BinaryHeader
+{
+    std::array<char, 8> magic;
+    uint64_t key;
+    uint32_t format;
+    uint32_t size;
+};
+
+/**
+ * FNV-1a, continued from hash
+ */
+uint64_t getHash(std::string_view data, uint64_t hash = 14695981039346656037ULL)
+{
+    for (const char c : data)
+    {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211ULL;
+    }
+    // the separator, so that "ab" + "c" differs from "a" + "bc"
+    hash ^= 0xff;
+    hash *= 1099511628211ULL;
+    return hash;
+}
+
+std::string_view getGlString(GLenum name)
+{
+    const auto value = reinterpret_cast<const char *>(glGetString(name));
+    return value ? value : "";
+}
+
+} // namespace
+
+struct GlProgramCache::Impl
+{
+    std::string getFilename(uint64_t key) const
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+        return (fs::path{folder} / name).native();
+    }
+
+    std::unique_ptr<GlProgram> load(uint64_t key)
+    {
+        std::string content;
+        try
+        {
+            content = readFile(getFilename(key));
+        }
+        catch (const Error &)
+        {
+            // not in the cache yet
+            return {};
+        }
+
+        BinaryHeader header;
+        if (content.size() < sizeof(header))
+        {
+            return {};
+        }
+        std::memcpy(&header, content.data(), sizeof(header));
+        if (header.magic != kMagic || header.key != key || header.size != content.size() - sizeof(header))
+        {
+            return {};
+        }
+
+        try
+        {
+            return std::make_unique<GlProgram>(header.format, content.data() + sizeof(header), header.size);
+        }
+        catch (const Error &)
+        {
+            // rejected by the driver: compiled again
+            glGetError();
+            return {};
+        }
+    }
+
+    void store(uint64_t key, GlProgram &program)
+    {
+        unsigned int format = 0;
+        const auto binary = program.getBinary(format);
+        if (binary.empty())
+        {
+            return;
+        }
+
+        const BinaryHeader header{kMagic, key, format, static_cast<uint32_t>(binary.size())};
+        const std::string filename = getFilename(key);
+        // written aside, then renamed: another process never reads half a file
+        const std::string temporary = filename + ".tmp";
+        FILEUnique file{std::fopen(temporary.c_str(), "wb")};
+        if (!file)
+        {
+            return;
+        }
+        const bool written = std::fwrite(&header, sizeof(header), 1, file.get()) == 1 &&
+                             std::fwrite(binary.data(), binary.size(), 1, file.get()) == 1;
+        // closed here to check the flush of the buffer too
+        const bool closed = std::fclose(file.release()) == 0;
+
+        std::error_code error;
+        if (written && closed)
+        {
+            fs::rename(temporary, filename, error);
+            if (!error)
+            {
+                ++statistics.stored;
+                return;
+            }
+        }
+        // a partial file is never left in the cache
+        fs::remove(temporary, error);
+    }
+
+    std::string folder;
+    // hash of the driver, the start of every key
+    uint64_t driver = 0;
+    std::unordered_map<uint64_t, std::unique_ptr<GlProgram>> programs;
+    Statistics statistics;
+};
+
+GlProgramCache::GlProgramCache(std::string_view folder)
+    : pimpl{std::make_unique<Impl>()}
+{
+    pimpl->driver = getHash(getGlString(GL_VENDOR));
+    pimpl->driver = getHash(getGlString(GL_RENDERER), pimpl->driver);
+    pimpl->driver = getHash(getGlString(GL_VERSION), pimpl->driver);
+
+    if (!folder.empty() && GlProgram::isBinarySupported())
+    {
+        std::error_code error;
+        fs::create_directories(fs::path{folder}, error);
+        if (!error)
+        {
+            pimpl->folder = folder;
+        }
+    }
+}
+
+GlProgramCache::~GlProgramCache() = default;
+
+GlProgram &GlProgramCache::get(const std::string &vertexSource, const std::string &fragmentSource)
+{
+    const uint64_t key = getHash(fragmentSource, getHash(vertexSource, pimpl->driver));
+    auto &program = pimpl->programs[key];
+    if (program)
+    {
+        ++pimpl->statistics.hits;
+        return *program;
+    }
+
+    if (isDiskCacheEnabled())
+    {
+        program = pimpl->load(key);
+        if (program)
+        {
+            ++pimpl->statistics.loaded;
+            return *program;
+        }
+    }
+
+    try
+    {
+        program = std::make_unique<GlProgram>(vertexSource, fragmentSource);
+    }
+    catch (...)
+    {
+        pimpl->programs.erase(key);
+        throw;
+    }
+    ++pimpl->statistics.compiled;
+
+    if (isDiskCacheEnabled())
+    {
+        pimpl->store(key, *program);
+    }
+    return *program;
+}
+
+bool GlProgramCache::isDiskCacheEnabled() const
+{
+    return !pimpl->folder.empty();
+}
+
+const GlProgramCache::Statistics &GlProgramCache::getStatistics() const
+{
+    return pimpl->statistics;
+}
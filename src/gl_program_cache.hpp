@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+
+class GlProgram;
+
+/**
+ * @brief Compile each shader program only once
+ *
+ * The programs are identified by a hash of their sources and of the driver (GL_VENDOR, GL_RENDERER and GL_VERSION).
+ * In the process, the same sources give the same program. With a folder, the linked programs are also stored there
+ * with OES_get_program_binary when the driver supports it: the next runs load them instead of compiling them.
+ * A binary rejected by the driver (e.g. after an update) is compiled again and replaced.
+ *
+ * The disk is only a cache: nothing is thrown if it cannot be read or written.
+ *
+ * @attention the programs belong to the OpenGL context which was current at creation time
+ */
+class GlProgramCache
+{
+public:
+    struct Impl;
+
+    /**
+     * @brief What happened since the creation
+     */
+    struct Statistics
+    {
+        size_t compiled = 0; ///< programs compiled from their sources
+        size_t loaded = 0;   ///< programs loaded from their binary on disk
+        size_t stored = 0;   ///< binaries written on disk
+        size_t hits = 0;     ///< programs already in the process
+    };
+
+    /**
+     * @param folder where the binaries are stored, created if needed. Empty: no disk cache
+     */
+    explicit GlProgramCache(std::string_view folder = {});
+    ~GlProgramCache();
+
+    /**
+     * Get the program, compiled (or loaded from the disk) at the 1st call
+     *
+     * @attention the program is shared by all the callers with the same sources. It lives as long as the cache
+     */
+    GlProgram &get(const std::string &vertexSource, const std::string &fragmentSource);
+
+    /**
+     * Are the binaries stored on disk? Needs a folder and OES_get_program_binary
+     */
+    bool isDiskCacheEnabled() const;
+
+    const Statistics &getStatistics() const;
+
+private:
+    std::unique_ptr<Impl> pimpl;
+};
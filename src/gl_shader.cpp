@@ -1,10 +1,18 @@
 #include "gl_shader.hpp"
 
 #include "error.hpp"
+#include "gl_command_buffer.hpp"
 #include "toolbox_gl.hpp"
 
+#include <cstring>
 #include <sstream>
 
+// the windows which link EGL
+#if defined(USE_WINDOW_DISPMANX) || defined(USE_WINDOW_DRM) || defined(USE_WINDOW_FRAMEBUFFER) || defined(USE_WINDOW_HEADLESS)
+#define USE_PROGRAM_BINARY
+#include <EGL/egl.h>
+#endif
+
 namespace
 {
 
@@ -114,6 +122,29 @@ constexpr GLenum getShaderType(GlShaderType type)
     }
 }
 
+/**
+ * @brief Entry points of OES_get_program_binary, which are not exported by every libGLESv2
+ */
+struct ProgramBinaryFunctions
+{
+    ProgramBinaryFunctions()
+    {
+#ifdef USE_PROGRAM_BINARY
+        getProgramBinary = reinterpret_cast<PFNGLGETPROGRAMBINARYOESPROC>(eglGetProcAddress("glGetProgramBinaryOES"));
+        programBinary = reinterpret_cast<PFNGLPROGRAMBINARYOESPROC>(eglGetProcAddress("glProgramBinaryOES"));
+#endif
+    }
+
+    PFNGLGETPROGRAMBINARYOESPROC getProgramBinary = nullptr;
+    PFNGLPROGRAMBINARYOESPROC programBinary = nullptr;
+};
+
+const ProgramBinaryFunctions &getProgramBinaryFunctions()
+{
+    static const ProgramBinaryFunctions functions;
+    return functions;
+}
+
 } // namespace
 
 std::ostream &operator<<(std::ostream &str, GlShaderType type)
@@ -165,6 +196,8 @@ unsigned int GlShader::get()
 
 // GlVertexShader
 
+GlVertexShader::GlVertexShader() = default;
+
 GlVertexShader::GlVertexShader(const char *source)
     : GlShader{source, GlShaderType::Vertex}
 {
@@ -183,6 +216,8 @@ GlVertexShader &GlVertexShader::operator=(GlVertexShader &&other)
 
 // GlFragmentShader
 
+GlFragmentShader::GlFragmentShader() = default;
+
 GlFragmentShader::GlFragmentShader(const char *source)
     : GlShader{source, GlShaderType::Fragment}
 {
@@ -233,6 +268,29 @@ GlProgram::GlProgram(const char *vertexSource,
     }
 }
 
+GlProgram::GlProgram(unsigned int binaryFormat, const void *binary, size_t size)
+    : guard{glCreateProgram()}
+{
+    if (get() == 0)
+    {
+        throw GLError("Cannot create GL program");
+    }
+
+    const auto programBinary = getProgramBinaryFunctions().programBinary;
+    if (!programBinary)
+    {
+        throw GLError("No glProgramBinaryOES");
+    }
+
+    programBinary(get(), binaryFormat, binary, size);
+    GLint linked;
+    glGetProgramiv(get(), GL_LINK_STATUS, &linked);
+    if (!linked)
+    {
+        throw GlProgramLinkError{"Could not load the program binary", get()};
+    }
+}
+
 GlProgram::GlProgram(GlProgram &&other)
     : vertexShader{std::move(other.vertexShader)},
       fragmentShader{std::move(fragmentShader)}
@@ -252,7 +310,7 @@ GlProgram::~GlProgram() = default;
 
 void GlProgram::use()
 {
-    glUseProgram(get());
+    GlCommandBuffer::useProgram(get());
 }
 
 unsigned int GlProgram::get()
@@ -283,6 +341,53 @@ int GlProgram::getUniformLocation(const char *name)
     return result;
 }
 
+bool GlProgram::isBinarySupported()
+{
+    const auto &functions = getProgramBinaryFunctions();
+    if (!functions.getProgramBinary || !functions.programBinary)
+    {
+        return false;
+    }
+
+    const auto extensions = reinterpret_cast<const char *>(glGetString(GL_EXTENSIONS));
+    if (!extensions || !std::strstr(extensions, "GL_OES_get_program_binary"))
+    {
+        return false;
+    }
+
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS_OES, &formats);
+    return formats > 0;
+}
+
+std::vector<char> GlProgram::getBinary(unsigned int &binaryFormat)
+{
+    const auto getProgramBinary = getProgramBinaryFunctions().getProgramBinary;
+    if (!getProgramBinary)
+    {
+        return {};
+    }
+
+    GLint size = 0;
+    glGetProgramiv(get(), GL_PROGRAM_BINARY_LENGTH_OES, &size);
+    if (size <= 0)
+    {
+        return {};
+    }
+
+    std::vector<char> result(size);
+    GLsizei length = 0;
+    GLenum format = 0;
+    getProgramBinary(get(), size, &length, &format, result.data());
+    if (glGetError() != GL_NO_ERROR || length <= 0)
+    {
+        return {};
+    }
+    result.resize(length);
+    binaryFormat = format;
+    return result;
+}
+
 std::ostream &GlProgram::toStream(std::ostream &str) const
 {
     char buf[256];
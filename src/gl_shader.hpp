@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
+#include <vector>
 
 /**
  * Type of shader
@@ -53,6 +55,10 @@ protected:
 class GlVertexShader : public GlShader
 {
 public:
+    /**
+     * No shader, like in a program loaded from its binary
+     */
+    explicit GlVertexShader();
     explicit GlVertexShader(const char *source);
     GlVertexShader(GlVertexShader &&other);
     GlVertexShader &operator=(GlVertexShader &&other);
@@ -64,6 +70,10 @@ public:
 class GlFragmentShader : public GlShader
 {
 public:
+    /**
+     * No shader, like in a program loaded from its binary
+     */
+    explicit GlFragmentShader();
     explicit GlFragmentShader(const char *source);
     GlFragmentShader(GlFragmentShader &&other);
     GlFragmentShader &operator=(GlFragmentShader &&other);
@@ -88,6 +98,14 @@ public:
     {
     }
 
+    /**
+     * Load a program linked before, from GlProgram::getBinary()
+     *
+     * @throw GLError if OES_get_program_binary is not supported, or if the driver rejects the binary (e.g. after an
+     * update of the driver)
+     */
+    explicit GlProgram(unsigned int binaryFormat, const void *binary, size_t size);
+
     explicit GlProgram(GlProgram &&other);
     GlProgram &operator=(GlProgram &&other);
 
@@ -114,6 +132,22 @@ public:
      * Needed due to OpenGLES 2
      */
     int getUniformLocation(const char *name);
+
+    /**
+     * Does the driver support OES_get_program_binary with at least 1 format?
+     *
+     * @attention needs a current OpenGL context
+     */
+    static bool isBinarySupported();
+
+    /**
+     * Get the linked program to load it later, with the same driver
+     *
+     * @param[out] binaryFormat to give back to the constructor
+     * @return empty if not supported
+     */
+    std::vector<char> getBinary(unsigned int &binaryFormat);
+
     friend std::ostream &operator<<(std::ostream &str, const GlProgram &program)
     {
         return program.toStream(str);
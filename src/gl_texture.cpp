@@ -1,22 +1,35 @@
 #include "gl_texture.hpp"
 
+#include "gl_command_buffer.hpp"
+#include "gl_counters.hpp"
 #include "gl_texture_loader.hpp"
 #include "toolbox_gl.hpp"
 
+#include <utility>
+
+namespace
+{
+
+// sum of the Guard::size
+size_t allocatedBytes = 0;
+
+} // namespace
+
 GlTexture::Guard::~Guard()
 {
     if (texture)
     {
         glDeleteTextures(1, &texture);
     }
+    allocatedBytes -= size;
 }
 
-GlTexture::GlTexture(const char *filename)
-    : GlTexture{GlTextureLoader{filename}}
+GlTexture::GlTexture(const char *filename, bool mipmaps)
+    : GlTexture{GlTextureLoader{filename, mipmaps ? GlTextureLoader::kAllMipmaps : 1}, mipmaps}
 {
 }
 
-GlTexture::GlTexture(const GlTextureLoader &loader)
+GlTexture::GlTexture(const GlTextureLoader &loader, bool mipmaps)
 {
     glGenTextures(1, &guard.texture);
     glBindTexture(GL_TEXTURE_2D, get());
@@ -25,44 +38,71 @@ GlTexture::GlTexture(const GlTextureLoader &loader)
     const GLenum glFormat = loader.getGlFormat();
     const GLenum glType = loader.getGlType();
 
-    for (uint32_t level = 0; level < loader.getMipmapCount(); ++level)
+    const uint32_t mipmapCount = mipmaps ? loader.getMipmapCount() : 1;
+    for (uint32_t level = 0; level < mipmapCount; ++level)
     {
         const char *data = loader.getMipmap(level);
         const uint32_t size = loader.getMipmapSize(level);
         const uint32_t width = loader.getMipmapWidth(level);
         const uint32_t height = loader.getMipmapHeight(level);
 
-        switch (glFormat)
+        if (loader.isCompressed())
         {
-#ifdef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
-        case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
-#endif
-#ifdef GL_COMPRESSED_RGBA_S3TC_DXT3_EXT
-        case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
-#endif
-#ifdef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
-        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
-#endif
             glCompressedTexImage2D(GL_TEXTURE_2D, level, glFormat, width, height, 0, size, data);
-            break;
-
-        default:
+        }
+        else
+        {
             glTexImage2D(GL_TEXTURE_2D, level, glFormat, width, height, 0, glFormat, glType, data);
-            break;
         }
+        GlCounters::count(GlCounters::Call::TextureUpload, size);
+        guard.size += size;
     }
+    allocatedBytes += guard.size;
 
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    // the compressed textures cannot generate their mipmaps
+    if (!mipmaps || (mipmapCount == 1 && loader.isCompressed()))
+    {
+        // OpenGL ES 2 has no GL_TEXTURE_MAX_LEVEL: a single level is only complete without mipmap filtering
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        return;
+    }
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_LINEAR);
-    if (loader.getMipmapCount() == 1)
+    if (mipmapCount == 1)
     {
         glGenerateMipmap(GL_TEXTURE_2D);
+        // each mipmap is 1/4 of the previous one
+        allocatedBytes += guard.size / 3;
+        guard.size += guard.size / 3;
     }
 }
 
+GlTexture::GlTexture(unsigned int width, unsigned int height)
+    : GlTexture{width, height, GL_RGBA}
+{
+}
+
+GlTexture::GlTexture(unsigned int width, unsigned int height, int glFormat)
+{
+    glGenTextures(1, &guard.texture);
+    glBindTexture(GL_TEXTURE_2D, get());
+    glTexImage2D(GL_TEXTURE_2D, 0, glFormat, width, height, 0, glFormat, GL_UNSIGNED_BYTE, nullptr);
+    // allocated, nothing uploaded
+    GlCounters::count(GlCounters::Call::TextureUpload);
+    guard.size = static_cast<size_t>(width) * height * (glFormat == GL_LUMINANCE ? 1 : 4);
+    allocatedBytes += guard.size;
+
+    // no mipmap + clamp: needed by OpenGL ES 2 for non power of 2 textures
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
 GlTexture::GlTexture(GlTexture &&other)
 {
     std::swap(guard.texture, other.guard.texture);
+    std::swap(guard.size, other.guard.size);
 }
 
 GlTexture::~GlTexture() = default;
@@ -70,15 +110,21 @@ GlTexture::~GlTexture() = default;
 GlTexture &GlTexture::operator=(GlTexture &&other)
 {
     std::swap(guard.texture, other.guard.texture);
+    std::swap(guard.size, other.guard.size);
     return *this;
 }
 
 void GlTexture::bind()
 {
-    glBindTexture(GL_TEXTURE_2D, get());
+    GlCommandBuffer::bindTexture(get());
 }
 
 unsigned int GlTexture::get() const
 {
     return guard.texture;
 }
+
+size_t GlTexture::getAllocatedBytes()
+{
+    return allocatedBytes;
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+
 class GlTextureLoader;
 
 /**
@@ -12,8 +14,33 @@ class GlTexture
 
 public:
     explicit GlTexture() = default;
-    explicit GlTexture(const char *filename);
-    explicit GlTexture(const GlTextureLoader &loader);
+
+    /**
+     * @param mipmaps false for a texture never drawn smaller than its size: only the 1st mipmap is loaded, the
+     * others are neither read nor generated
+     */
+    explicit GlTexture(const char *filename, bool mipmaps = true);
+
+    /**
+     * Upload the mipmaps of the loader, or generate them if there is only 1
+     *
+     * @param mipmaps false to upload only the 1st mipmap, without generating the others
+     */
+    explicit GlTexture(const GlTextureLoader &loader, bool mipmaps = true);
+
+    /**
+     * Create an empty RGBA texture without mipmap, to be rendered into
+     *
+     * @sa GlFramebuffer
+     */
+    explicit GlTexture(unsigned int width, unsigned int height);
+
+    /**
+     * Create an empty texture without mipmap, e.g. filled later with GlCommandBuffer::texSubImage2D()
+     *
+     * @param glFormat GL_RGBA or GL_LUMINANCE
+     */
+    explicit GlTexture(unsigned int width, unsigned int height, int glFormat);
 
     explicit GlTexture(GlTexture &&other);
     GlTexture &operator=(GlTexture &&other);
@@ -30,6 +57,11 @@ public:
      */
     unsigned int get() const;
 
+    /**
+     * Bytes of all the textures alive in the process, mipmaps included. The generated mipmaps are estimated
+     */
+    static size_t getAllocatedBytes();
+
 private:
     /**
      * @brief Destroy the texture on OpenGL side in the destructor
@@ -38,6 +70,7 @@ private:
     {
         ~Guard();
         unsigned int texture = 0;
+        size_t size = 0; ///< in bytes
     };
 
     Guard guard;
@@ -6,30 +6,30 @@
 #include <byteswap.h>
 #include <endian.h>
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <utility>
 #include <vector>
 
 struct GlTextureLoader::Impl
 {
     /**
-     * @brief Stores the mipmap's raw data
+     * @brief Where a mipmap is in the mapped file
      */
     struct MipMap
     {
-        MipMap(std::vector<char> data,
-               uint32_t width,
-               uint32_t height)
-            : data{std::move(data)},
-              width{width},
-              height{height}
-        {
-        }
-        std::vector<char> data;
+        const char *data;
+        uint32_t size;
         uint32_t width;
         uint32_t height;
     };
 
-    GLenum glFormat;
-    GLenum glType;
+    // the mipmaps point there
+    MmapFile file;
+    GLenum glFormat = 0;
+    GLenum glType = 0;
+    bool compressed = false;
     std::vector<MipMap> mipMaps;
 };
 
@@ -105,6 +105,7 @@ constexpr uint32_t DDPF_ALPHAPIXELS = 0x1;
 constexpr uint32_t DDPF_ALPHA = 0x2;
 constexpr uint32_t DDPF_FOURCC = 0x4;
 constexpr uint32_t DDPF_RGB = 0x40;
+constexpr uint32_t DDPF_LUMINANCE = 0x20000;
 
 constexpr GLenum fourccToGlInternalFormat(uint32_t fourcc)
 {
@@ -135,22 +136,33 @@ std::tuple<GLenum, GLenum, uint32_t, uint32_t, uint32_t> masksToGlInternalFormat
                                                                                  uint32_t bMask,
                                                                                  uint32_t aMask)
 {
+    if (bitCount == 8)
+    {
+        // L8, e.g. the distance field of the font
+        if (rMask == 0xff000000 && gMask == 0x00000000 && bMask == 0x00000000 && aMask == 0x00000000)
+        {
+            return {GL_LUMINANCE, GL_UNSIGNED_BYTE, 0, 0, 0};
+        }
+    }
     if (bitCount == 16)
     {
+        // the file is in little endian, OpenGL reads native shorts
+        constexpr uint32_t reorder = BYTE_ORDER == BIG_ENDIAN ? 2 : 0;
+        constexpr uint32_t jump = BYTE_ORDER == BIG_ENDIAN ? 2 : 0;
         // R5G6B5
         if (rMask == 0xf8000000 && gMask == 0x07e00000 && bMask == 0x001f0000 && aMask == 0x00000000)
         {
-            return {GL_RGB, GL_UNSIGNED_SHORT_5_6_5, 0, 0, 0};
+            return {GL_RGB, GL_UNSIGNED_SHORT_5_6_5, reorder, 0, jump};
         }
         // RGBA4
         if (rMask == 0xf0000000 && gMask == 0x0f000000 && bMask == 0x00f00000 && aMask == 0x000f0000)
         {
-            return {GL_RGBA, GL_UNSIGNED_SHORT_4_4_4_4, 0, 0, 0};
+            return {GL_RGBA, GL_UNSIGNED_SHORT_4_4_4_4, reorder, 0, jump};
         }
         // RGB5A1
         if (rMask == 0xf8000000 && gMask == 0x07c00000 && bMask == 0x003e0000 && aMask == 0x00010000)
         {
-            return {GL_RGBA, GL_UNSIGNED_SHORT_5_5_5_1, 0, 0, 0};
+            return {GL_RGBA, GL_UNSIGNED_SHORT_5_5_5_1, reorder, 0, jump};
         }
     }
     if (bitCount == 24)
@@ -213,9 +225,23 @@ void reorder4(char *ptr, uint32_t size, uint32_t jumpBytes)
     }
 }
 
+/**
+ * Pixels of a mipmap, after the header
+ *
+ * @param offset from the 1st mipmap
+ * @throw std::runtime_error if the file is too small
+ */
+char *getMipmapBuffer(const MmapFile &file, size_t offset, size_t size)
+{
+    if (sizeof(DdsFileHeader) + offset + size > file.size)
+    {
+        throw std::runtime_error{"Not a DDS file: truncated"};
+    }
+    return reinterpret_cast<char *>(file.content) + sizeof(DdsFileHeader) + offset;
+}
+
 // only support DXT1, DXT3, DXT5
 void loadFourcc(GlTextureLoader::Impl &impl,
-                const char *buffer,
                 uint32_t width,
                 uint32_t height,
                 uint32_t mipMapCount,
@@ -223,14 +249,14 @@ void loadFourcc(GlTextureLoader::Impl &impl,
 {
     impl.mipMaps.reserve(mipMapCount);
     impl.glFormat = fourccToGlInternalFormat(fourcc);
+    impl.compressed = true;
     const uint32_t blockSize = (impl.glFormat == GL_COMPRESSED_RGBA_S3TC_DXT1_EXT) ? 8 : 16;
 
-    uint32_t offset = 0;
+    size_t offset = 0;
     for (uint32_t level = 0; level < mipMapCount; ++level)
     {
-        const char *ptr = buffer + offset;
         const uint32_t size = (width / 4) * (height / 4) * blockSize;
-        impl.mipMaps.emplace_back(std::vector<char>{ptr, ptr + size}, width, height);
+        impl.mipMaps.push_back(MipMap{getMipmapBuffer(impl.file, offset, size), size, width, height});
 
         offset += size;
         width >>= 1;
@@ -239,7 +265,6 @@ void loadFourcc(GlTextureLoader::Impl &impl,
 }
 
 void loadRgba(GlTextureLoader::Impl &impl,
-              const char *buffer,
               uint32_t width,
               uint32_t height,
               uint32_t mipMapCount,
@@ -255,24 +280,29 @@ void loadRgba(GlTextureLoader::Impl &impl,
     impl.glType = glType;
     const uint32_t blockSize = bitCount >> 3;
 
-    uint32_t offset = 0;
+    if (reorderBytes)
+    {
+        // reordered in place: only the pages of the loaded mipmaps are copied
+        impl.file.setCopyOnWrite();
+    }
+
+    size_t offset = 0;
     for (uint32_t level = 0; level < mipMapCount; ++level)
     {
-        const char *const mipmapBuffer = buffer + offset;
         const uint32_t mipmapSize = width * height * blockSize;
-        impl.mipMaps.emplace_back(std::vector<char>{mipmapBuffer, mipmapBuffer + mipmapSize}, width, height);
-        auto &data = impl.mipMaps.back().data;
+        char *const data = getMipmapBuffer(impl.file, offset, mipmapSize);
+        impl.mipMaps.push_back(MipMap{data, mipmapSize, width, height});
 
         switch (reorderBytes)
         {
         case 2:
-            reorder2(data.data() + reorderOffset, data.size() - reorderOffset, reorderJump);
+            reorder2(data + reorderOffset, mipmapSize - reorderOffset, reorderJump);
             break;
         case 3:
-            reorder3(data.data() + reorderOffset, data.size() - reorderOffset, reorderJump);
+            reorder3(data + reorderOffset, mipmapSize - reorderOffset, reorderJump);
             break;
         case 4:
-            reorder4(data.data() + reorderOffset, data.size() - reorderOffset, reorderJump);
+            reorder4(data + reorderOffset, mipmapSize - reorderOffset, reorderJump);
             break;
         default:
             break;
@@ -284,12 +314,114 @@ void loadRgba(GlTextureLoader::Impl &impl,
     }
 }
 
+// https://registry.khronos.org/KTX/specs/1.0/ktxspec.v1.html
+struct KtxHeader
+{
+    std::array<uint8_t, 12> identifier;
+    uint32_t endianness;
+    uint32_t glType;
+    uint32_t glTypeSize;
+    uint32_t glFormat;
+    uint32_t glInternalFormat;
+    uint32_t glBaseInternalFormat;
+    uint32_t pixelWidth;
+    uint32_t pixelHeight;
+    uint32_t pixelDepth;
+    uint32_t numberOfArrayElements;
+    uint32_t numberOfFaces;
+    uint32_t numberOfMipmapLevels;
+    uint32_t bytesOfKeyValueData;
+};
+static_assert(sizeof(KtxHeader) == 64);
+
+constexpr std::array<uint8_t, 12> kKtxIdentifier{0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+constexpr uint32_t kKtxEndianness = 0x04030201;
+
+bool isKtx(const MmapFile &file)
+{
+    return file.size >= sizeof(KtxHeader) && std::memcmp(file.content, kKtxIdentifier.data(), kKtxIdentifier.size()) == 0;
+}
+
+/**
+ * Only the compressed 2D textures, typically ETC1 / ETC2: they are uploaded as is
+ */
+void loadKtx(GlTextureLoader::Impl &impl, uint32_t maxMipmapCount)
+{
+    const char *const content = reinterpret_cast<const char *>(impl.file.content);
+    KtxHeader header;
+    std::memcpy(&header, content, sizeof(header));
+
+    // written by a machine of the other endianness
+    const bool swap = header.endianness != kKtxEndianness;
+    if (swap && header.endianness != bswap_32(kKtxEndianness))
+    {
+        throw std::runtime_error{"Not a KTX file: Wrong endianness"};
+    }
+    const auto get = [swap](uint32_t value) {
+        return swap ? bswap_32(value) : value;
+    };
+
+    if (get(header.glType) != 0 || get(header.glFormat) != 0)
+    {
+        throw std::runtime_error{"KTX: only the compressed textures are supported"};
+    }
+    if (get(header.pixelDepth) > 1 || get(header.numberOfArrayElements) > 0 || get(header.numberOfFaces) != 1)
+    {
+        throw std::runtime_error{"KTX: only the 2D textures are supported"};
+    }
+
+    impl.glFormat = get(header.glInternalFormat);
+    impl.compressed = true;
+
+    uint32_t width = get(header.pixelWidth);
+    uint32_t height = get(header.pixelHeight);
+    // 0: the mipmaps are to be generated
+    const uint32_t mipMapCount = std::max<uint32_t>(std::min(get(header.numberOfMipmapLevels), maxMipmapCount), 1);
+    impl.mipMaps.reserve(mipMapCount);
+
+    size_t offset = sizeof(header) + get(header.bytesOfKeyValueData);
+    for (uint32_t level = 0; level < mipMapCount; ++level)
+    {
+        uint32_t size;
+        if (offset + sizeof(size) > impl.file.size)
+        {
+            throw std::runtime_error{"Not a KTX file: truncated"};
+        }
+        std::memcpy(&size, content + offset, sizeof(size));
+        size = get(size);
+        offset += sizeof(size);
+        if (offset + size > impl.file.size)
+        {
+            throw std::runtime_error{"Not a KTX file: truncated"};
+        }
+
+        impl.mipMaps.push_back(MipMap{content + offset, size, std::max<uint32_t>(width, 1), std::max<uint32_t>(height, 1)});
+
+        // mipPadding
+        offset += (size + 3) & ~3;
+        width >>= 1;
+        height >>= 1;
+    }
+}
+
 } // namespace
 
-GlTextureLoader::GlTextureLoader(const char *filename)
+GlTextureLoader::GlTextureLoader(const char *filename, uint32_t maxMipmapCount)
+    : GlTextureLoader{MmapFile{filename}, maxMipmapCount}
+{
+}
+
+GlTextureLoader::GlTextureLoader(MmapFile &&file, uint32_t maxMipmapCount)
     : pimpl{std::make_unique<Impl>()}
 {
-    MmapFile mmap{filename};
+    pimpl->file = std::move(file);
+    if (isKtx(pimpl->file))
+    {
+        loadKtx(*pimpl, maxMipmapCount);
+        return;
+    }
+
+    const MmapFile &mmap = pimpl->file;
     if (mmap.size < sizeof(DdsFileHeader))
     {
         throw std::runtime_error{"Not a DDS file: too small"};
@@ -327,17 +459,18 @@ GlTextureLoader::GlTextureLoader(const char *filename)
 
     const uint32_t ddpfFlags = le32toh(ddspf.dwFlags);
 
-    const uint32_t mipMapCount = (ddsdFlags & DDSD_MIPMAPCOUNT) ? le32toh(header.dwMipMapCount) : 1;
+    const uint32_t fileMipMapCount = (ddsdFlags & DDSD_MIPMAPCOUNT) ? le32toh(header.dwMipMapCount) : 1;
+    // the smaller mipmaps are never read from the disk
+    const uint32_t mipMapCount = std::max<uint32_t>(std::min(fileMipMapCount, maxMipmapCount), 1);
 
-    const char *buffer = reinterpret_cast<const char *>(mmap.content) + sizeof(DdsFileHeader);
     if (ddpfFlags & DDPF_FOURCC)
     {
-        loadFourcc(*pimpl, buffer, width, height, mipMapCount,
+        loadFourcc(*pimpl, width, height, mipMapCount,
                    ddspf.dwFourCC);
     }
-    else if (ddpfFlags & DDPF_RGB)
+    else if (ddpfFlags & (DDPF_RGB | DDPF_LUMINANCE))
     {
-        loadRgba(*pimpl, buffer, width, height, mipMapCount,
+        loadRgba(*pimpl, width, height, mipMapCount,
                  le32toh(ddspf.dwRGBBitCount),
                  be32toh(ddspf.dwRBitMask),
                  be32toh(ddspf.dwGBitMask),
@@ -357,7 +490,7 @@ uint32_t GlTextureLoader::getMipmapSize(uint32_t mipmap) const
 {
     if (mipmap < pimpl->mipMaps.size())
     {
-        return pimpl->mipMaps[mipmap].data.size();
+        return pimpl->mipMaps[mipmap].size;
     }
     return 0;
 }
@@ -366,7 +499,7 @@ const char *GlTextureLoader::getMipmap(uint32_t mipmap) const
 {
     if (mipmap < pimpl->mipMaps.size())
     {
-        return pimpl->mipMaps[mipmap].data.data();
+        return pimpl->mipMaps[mipmap].data;
     }
     return nullptr;
 }
@@ -395,6 +528,11 @@ unsigned int GlTextureLoader::getGlFormat() const
     return pimpl->glFormat;
 }
 
+bool GlTextureLoader::isCompressed() const
+{
+    return pimpl->compressed;
+}
+
 unsigned int GlTextureLoader::getGlType() const
 {
     static_assert(std::is_same_v<decltype(pimpl->glType), decltype(getGlType())>);
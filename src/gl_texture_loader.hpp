@@ -1,19 +1,40 @@
 #pragma once
 
+#include <cstdint>
+#include <limits>
 #include <memory>
 
+class MmapFile;
+
 /**
- * @brief Load a .DDS file (Direct Draw Surface)
+ * @brief Load a .DDS file (Direct Draw Surface), or a .KTX file with a compressed texture (e.g. ETC1 / ETC2)
+ *
+ * The file stays mapped in memory as long as the loader: the mipmaps point into it, without any copy. The pixels
+ * which must be reordered for OpenGL (e.g. BGRA) are reordered in place, in private copies of the pages
+ *
+ * @sa MmapFile::setCopyOnWrite()
  */
 class GlTextureLoader
 {
 public:
     struct Impl;
 
-    explicit GlTextureLoader(const char *filename);
+    static constexpr uint32_t kAllMipmaps = std::numeric_limits<uint32_t>::max();
+
+    /**
+     * @param maxMipmapCount to load only the largest mipmaps, e.g. 1 for a texture never drawn smaller than its size.
+     * The others are not even read
+     * @throw std::runtime_error if the file is not a supported DDS
+     */
+    explicit GlTextureLoader(const char *filename, uint32_t maxMipmapCount = kAllMipmaps);
+
+    /**
+     * Load a file already in memory, e.g. Config::openTexture()
+     */
+    explicit GlTextureLoader(MmapFile &&file, uint32_t maxMipmapCount = kAllMipmaps);
     ~GlTextureLoader();
 
-    // mipmap data
+    // mipmap data, valid as long as the loader
     uint32_t getMipmapCount() const;
     uint32_t getMipmapSize(uint32_t mipmap) const;
     const char *getMipmap(uint32_t mipmap) const;
@@ -28,6 +49,11 @@ public:
      */
     unsigned int getGlFormat() const;
 
+    /**
+     * Is the texture to be uploaded with glCompressedTexImage2D()?
+     */
+    bool isCompressed() const;
+
     /**
      * Get the type to be used in:
      *
@@ -1,10 +1,181 @@
 #include "gl_vbo.hpp"
 
+#include "gl_command_buffer.hpp"
+#include "gl_counters.hpp"
 #include "toolbox_gl.hpp"
 
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+// GlVboPool
+
+namespace
+{
+
+size_t getAligned(size_t size)
+{
+    return (size + GlVboPool::kAlignment - 1) / GlVboPool::kAlignment * GlVboPool::kAlignment;
+}
+
+} // namespace
+
+struct GlVboPool::Impl
+{
+    /**
+     * @brief 1 OpenGL buffer
+     */
+    struct Block
+    {
+        unsigned int vbo = 0;
+        int glTarget = 0;
+        int glUsage = 0;
+        size_t size = 0;
+        // free ranges: offset => size
+        std::map<size_t, size_t> holes;
+    };
+
+    Block &createBlock(size_t size, int glTarget, int glUsage)
+    {
+        Block &block = blocks.emplace_back();
+        block.glTarget = glTarget;
+        block.glUsage = glUsage;
+        block.size = size;
+        block.holes.emplace(0, size);
+
+        glGenBuffers(1, &block.vbo);
+        glBindBuffer(glTarget, block.vbo);
+        glBufferData(glTarget, size, nullptr, glUsage);
+        GlCounters::count(GlCounters::Call::Upload);
+        return block;
+    }
+
+    size_t blockSize;
+    std::vector<Block> blocks;
+    // vbo => index in blocks
+    std::unordered_map<unsigned int, size_t> blockIndices;
+    size_t ranges = 0;
+};
+
+float GlVboPool::Statistics::getFragmentation() const
+{
+    const size_t available = capacity - used;
+    return available ? 1.f - static_cast<float>(contiguous) / available : 0.f;
+}
+
+GlVboPool::GlVboPool(size_t blockSize)
+    : pimpl{std::make_unique<Impl>()}
+{
+    pimpl->blockSize = getAligned(blockSize);
+}
+
+GlVboPool::~GlVboPool()
+{
+    for (const Impl::Block &block : pimpl->blocks)
+    {
+        glDeleteBuffers(1, &block.vbo);
+    }
+}
+
+GlVboPool::Range GlVboPool::allocate(const void *data, size_t bufferSize, int glTarget, int glUsage)
+{
+    const size_t size = getAligned(std::max<size_t>(bufferSize, 1));
+
+    Impl::Block *found = nullptr;
+    std::map<size_t, size_t>::iterator hole;
+    for (Impl::Block &block : pimpl->blocks)
+    {
+        if (block.glTarget != glTarget || block.glUsage != glUsage)
+        {
+            continue;
+        }
+        // first fit
+        hole = std::find_if(block.holes.begin(), block.holes.end(), [size](const auto &item) {
+            return item.second >= size;
+        });
+        if (hole != block.holes.end())
+        {
+            found = &block;
+            break;
+        }
+    }
+
+    if (found == nullptr)
+    {
+        found = &pimpl->createBlock(std::max(size, pimpl->blockSize), glTarget, glUsage);
+        pimpl->blockIndices[found->vbo] = pimpl->blocks.size() - 1;
+        hole = found->holes.begin();
+    }
+
+    const Range range{found->vbo, hole->first, size};
+    if (hole->second > size)
+    {
+        found->holes.emplace_hint(std::next(hole), hole->first + size, hole->second - size);
+    }
+    found->holes.erase(hole);
+    ++pimpl->ranges;
+
+    glBindBuffer(glTarget, range.vbo);
+    glBufferSubData(glTarget, range.offset, bufferSize, data);
+    GlCounters::count(GlCounters::Call::Upload, bufferSize);
+    return range;
+}
+
+void GlVboPool::release(const Range &range)
+{
+    Impl::Block &block = pimpl->blocks[pimpl->blockIndices.at(range.vbo)];
+    auto hole = block.holes.emplace(range.offset, range.size).first;
+    --pimpl->ranges;
+
+    // merge with the next hole, then with the previous one
+    if (const auto next = std::next(hole); next != block.holes.end() && hole->first + hole->second == next->first)
+    {
+        hole->second += next->second;
+        block.holes.erase(next);
+    }
+    if (hole != block.holes.begin())
+    {
+        if (const auto previous = std::prev(hole); previous->first + previous->second == hole->first)
+        {
+            previous->second += hole->second;
+            block.holes.erase(hole);
+        }
+    }
+}
+
+GlVboPool::Statistics GlVboPool::getStatistics() const
+{
+    Statistics statistics;
+    statistics.blocks = pimpl->blocks.size();
+    statistics.ranges = pimpl->ranges;
+    for (const Impl::Block &block : pimpl->blocks)
+    {
+        statistics.capacity += block.size;
+        statistics.used += block.size;
+        statistics.holes += block.holes.size();
+        size_t largest = 0;
+        for (const auto &[offset, size] : block.holes)
+        {
+            statistics.used -= size;
+            largest = std::max(largest, size);
+        }
+        statistics.largestHole = std::max(statistics.largestHole, largest);
+        statistics.contiguous += largest;
+    }
+    return statistics;
+}
+
+// GlVbo
+
 GlVbo::Guard::~Guard()
 {
-    if (vbo)
+    if (pool)
+    {
+        pool->release(range);
+    }
+    else if (vbo)
     {
         glDeleteBuffers(1, &vbo);
     }
@@ -17,11 +188,24 @@ GlVbo::GlVbo(const void *data, size_t bufferSize, int glType, int glTarget, int
     glGenBuffers(1, &guard.vbo);
     glBindBuffer(glTarget, get());
     glBufferData(glTarget, bufferSize, data, glUsage);
+    GlCounters::count(GlCounters::Call::Upload, data ? bufferSize : 0);
+}
+
+GlVbo::GlVbo(GlVboPool &pool, const void *data, size_t bufferSize, int glType, int glTarget, int glUsage)
+{
+    guard.glType = glType;
+    guard.range = pool.allocate(data, bufferSize, glTarget, glUsage);
+    guard.vbo = guard.range.vbo;
+    guard.pool = &pool;
 }
 
 void GlVbo::swap(GlVbo &other)
 {
-    std::swap(guard, other.guard);
+    // member by member: a temporary Guard would release the VBO in its destructor
+    std::swap(guard.vbo, other.guard.vbo);
+    std::swap(guard.glType, other.guard.glType);
+    std::swap(guard.pool, other.guard.pool);
+    std::swap(guard.range, other.guard.range);
 }
 
 GlVbo::~GlVbo() = default;
@@ -49,6 +233,16 @@ unsigned int GlVbo::get() const
     return guard.vbo;
 }
 
+int GlVbo::getGlType() const
+{
+    return guard.glType;
+}
+
+size_t GlVbo::getOffset() const
+{
+    return guard.range.offset;
+}
+
 // GlVboArray
 
 GlVboArray::GlVboArray(GlVboArray &&other)
@@ -66,12 +260,17 @@ GlVboArray &GlVboArray::operator=(GlVboArray &&other)
 
 void GlVboArray::bind()
 {
-    glBindBuffer(getTarget(), get());
+    GlCommandBuffer::bindBuffer(getTarget(), get());
 }
 
 void GlVboArray::draw(int index, int size, int offset, int stride)
 {
-    glVertexAttribPointer(index, size, guard.glType, normalized, stride, reinterpret_cast<void *>(offset));
+    GlCommandBuffer::vertexAttribPointer(index, size, guard.glType, normalized, stride, getOffset() + offset);
+}
+
+bool GlVboArray::isNormalized() const
+{
+    return normalized;
 }
 
 int GlVboArray::getTarget()
@@ -90,7 +289,7 @@ int GlVboArrayStatic::getUsage()
 
 void GlVboArrayDynamic::set(const void *indices, size_t bufferSize)
 {
-    glBufferSubData(getTarget(), 0, bufferSize, indices);
+    GlCommandBuffer::bufferSubData(getTarget(), getOffset(), bufferSize, indices);
 }
 
 int GlVboArrayDynamic::getUsage()
@@ -115,8 +314,8 @@ GlVboElementArray &GlVboElementArray::operator=(GlVboElementArray &&other)
 
 void GlVboElementArray::draw()
 {
-    glBindBuffer(getTarget(), get());
-    glDrawElements(GL_TRIANGLES, numberVertex, guard.glType, nullptr);
+    GlCommandBuffer::bindBuffer(getTarget(), get());
+    GlCommandBuffer::drawElements(numberVertex, guard.glType, getOffset());
 }
 
 int GlVboElementArray::getTarget()
@@ -1,6 +1,79 @@
 #pragma once
 
 #include <cstddef>
+#include <memory>
+
+/**
+ * @brief Sub-allocator of a few large OpenGL buffers
+ *
+ * Each glGenBuffers() + glBufferData() is an allocation in the driver, in the small GPU memory of the Raspberry PI.
+ * The pool hands out ranges of blocks of blockSize bytes instead (a larger VBO gets a block of its own size).
+ * A released range is merged with its free neighbours and reused by the next VBOs: the blocks are only deleted with
+ * the pool, so that the elements of the next screen fit in the blocks of the previous one.
+ *
+ * There are separate blocks for each target (GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER) and usage.
+ *
+ * @attention the pool must outlive its VBOs. It belongs to the OpenGL context which was current at creation time
+ */
+class GlVboPool
+{
+public:
+    struct Impl;
+
+    static constexpr size_t kDefaultBlockSize = 64 * 1024;
+    /// of the ranges, in bytes: enough for any vertex attribute type
+    static constexpr size_t kAlignment = 16;
+
+    /**
+     * @brief Part of a block
+     */
+    struct Range
+    {
+        unsigned int vbo = 0;
+        size_t offset = 0; ///< in bytes
+        size_t size = 0;   ///< in bytes, aligned
+    };
+
+    /**
+     * @brief Occupation of the blocks
+     */
+    struct Statistics
+    {
+        size_t blocks = 0;      ///< OpenGL buffers created
+        size_t capacity = 0;    ///< bytes in all the blocks
+        size_t used = 0;        ///< bytes handed out
+        size_t ranges = 0;      ///< ranges handed out
+        size_t holes = 0;       ///< free ranges
+        size_t largestHole = 0; ///< bytes of the largest free range
+        size_t contiguous = 0;  ///< sum of the largest free range of each block, in bytes
+
+        /**
+         * 0 when the free bytes of each block are contiguous, close to 1 when they are scattered in many small holes
+         */
+        float getFragmentation() const;
+    };
+
+    explicit GlVboPool(size_t blockSize = kDefaultBlockSize);
+    ~GlVboPool();
+
+    /**
+     * Get a range and copy the data there
+     *
+     * @param glTarget GL_ARRAY_BUFFER or GL_ELEMENT_ARRAY_BUFFER. The buffer stays bound to it
+     * @param glUsage GL_STATIC_DRAW or GL_DYNAMIC_DRAW
+     */
+    Range allocate(const void *data, size_t bufferSize, int glTarget, int glUsage);
+
+    /**
+     * Give back a range from allocate()
+     */
+    void release(const Range &range);
+
+    Statistics getStatistics() const;
+
+private:
+    std::unique_ptr<Impl> pimpl;
+};
 
 /**
  * @brief Base class for OpenGL Vertex Buffer Object (VBO)
@@ -16,9 +89,20 @@ public:
      */
     unsigned int get() const;
 
+    /**
+     * Get the OpenGL type of the elements stored in the VBO (GL_FLOAT, GL_UNSIGNED_SHORT...)
+     */
+    int getGlType() const;
+
+    /**
+     * Start of the data in the VBO, in bytes. Not 0 when it comes from a GlVboPool
+     */
+    size_t getOffset() const;
+
 protected:
     explicit GlVbo() = default;
     GlVbo(const void *data, size_t bufferSize, int glType, int glTarget, int glUsage);
+    GlVbo(GlVboPool &pool, const void *data, size_t bufferSize, int glType, int glTarget, int glUsage);
 
     ~GlVbo();
 
@@ -35,13 +119,15 @@ protected:
     void swap(GlVbo &other);
 
     /**
-     * @brief Destroy the VBO on OpenGL side in the destructor
+     * @brief Destroy the VBO on OpenGL side (or give it back to its pool) in the destructor
      */
     struct Guard
     {
         ~Guard();
         unsigned int vbo = 0;
         int glType = 0;
+        GlVboPool *pool = nullptr;
+        GlVboPool::Range range;
     };
 
     Guard guard;
@@ -98,12 +184,22 @@ public:
         return draw(index, size, offset * sizeof(T), stride * sizeof(T));
     }
 
+    /**
+     * Whether the fixed-point values are normalized when accessed by glVertexAttribPointer()
+     */
+    bool isNormalized() const;
+
 protected:
     GlVboArray(const void *data, size_t bufferSize, int glType, int glUsage, bool normalized)
         : GlVbo{data, bufferSize, glType, getTarget(), glUsage},
           normalized{normalized}
     {
     }
+    GlVboArray(GlVboPool &pool, const void *data, size_t bufferSize, int glType, int glUsage, bool normalized)
+        : GlVbo{pool, data, bufferSize, glType, getTarget(), glUsage},
+          normalized{normalized}
+    {
+    }
 
     /**
      * GL_ARRAY_BUFFER
@@ -129,6 +225,15 @@ public:
     {
     }
 
+    /**
+     * In a range of the pool
+     */
+    template <typename T>
+    GlVboArrayStatic(GlVboPool &pool, const T *indices, size_t numberElements, bool normalized = false)
+        : GlVboArray{pool, &indices[0], numberElements * sizeof(T), getType<T>(), getUsage(), normalized}
+    {
+    }
+
 private:
     /**
      * GL_STATIC_DRAW
@@ -152,7 +257,16 @@ public:
     }
 
     /**
-     * Change the value in the VBO
+     * In a range of the pool
+     */
+    template <typename T>
+    GlVboArrayDynamic(GlVboPool &pool, const T *indices, size_t numberElements, bool normalized = false)
+        : GlVboArray{pool, &indices[0], numberElements * sizeof(T), getType<T>(), getUsage(), normalized}
+    {
+    }
+
+    /**
+     * Change the value in the VBO, which must be bound
      */
     template <typename T>
     void set(const T *indices, size_t numberElements)
@@ -184,6 +298,14 @@ public:
         : GlVbo{&indices[0], numberVertex * sizeof(T), getType<T>(), getTarget(), getUsage()},
           numberVertex{static_cast<int>(numberVertex)} {}
 
+    /**
+     * In a range of the pool
+     */
+    template <typename T>
+    GlVboElementArray(GlVboPool &pool, const T *indices, size_t numberVertex)
+        : GlVbo{pool, &indices[0], numberVertex * sizeof(T), getType<T>(), getTarget(), getUsage()},
+          numberVertex{static_cast<int>(numberVertex)} {}
+
     explicit GlVboElementArray(GlVboElementArray &&other);
     GlVboElementArray &operator=(GlVboElementArray &&other);
 
@@ -200,6 +322,14 @@ public:
         return numberVertex / 3;
     }
 
+    /**
+     * Number of vertices given to glDrawElements()
+     */
+    int getNumberVertex() const
+    {
+        return numberVertex;
+    }
+
 private:
     /**
      * GL_ELEMENT_ARRAY_BUFFER
@@ -1,3 +1,4 @@
+#include <cstring>
 #include <iostream>
 
 #include "app.hpp"
@@ -5,16 +6,18 @@
 
 int main(int argc, char *argv[])
 {
-    if (argc != 2)
+    const bool statistics = argc == 3 && std::strcmp(argv[1], "--stats") == 0;
+    if (argc != 2 && !statistics)
     {
-        std::cout << "Usage:\n\t" << argv[0] << " configuration_file.json" << std::endl;
+        std::cout << "Usage:\n\t" << argv[0] << " [--stats] configuration_file.json" << std::endl;
         std::cout << "The configuration_file.json is created with default values if it does not exist" << std::endl;
+        std::cout << "--stats prints the OpenGL calls and uploads per frame" << std::endl;
         return 0;
     }
 
     try
     {
-        App{argv[1]}.run();
+        App{argv[argc - 1], statistics}.run();
         return 0;
     }
     catch (Error &e)
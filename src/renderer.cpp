@@ -2,15 +2,22 @@
 
 #include "config.hpp"
 #include "error.hpp"
+#include "gl_command_buffer.hpp"
+#include "gl_program_cache.hpp"
 #include "gl_shader.hpp"
 #include "gl_texture.hpp"
 #include "gl_texture_loader.hpp"
 #include "gl_vbo.hpp"
+#include "renderer_damage.hpp"
+#include "renderer_glyph_cache.hpp"
+#include "renderer_layer.hpp"
+#include "renderer_software.hpp"
 #include "renderer_sprite.hpp"
 #include "renderer_text.hpp"
-#include "toolbox_filesystem.hpp"
+#include "renderer_thread.hpp"
 #include "toolbox_gl.hpp"
 #include "toolbox_io.hpp"
+#include "toolbox_utf8.hpp"
 
 #include <algorithm>
 #include <array>
@@ -22,20 +29,88 @@
 namespace
 {
 
+/**
+ * @brief Logical size of an asset on screen. Its texture is a larger square
+ */
+struct AssetSize
+{
+    unsigned int width;
+    unsigned int height;
+    unsigned int textureSize;
+};
+
+constexpr AssetSize kClockSize{240, 240, 256};
+constexpr AssetSize kArrowSize{50, 50, 64};
+
+const AssetSize &getAssetSize(Asset asset)
+{
+    switch (asset)
+    {
+    case Asset::Clock:
+        return kClockSize;
+    case Asset::Arrow:
+        return kArrowSize;
+    default:
+        break;
+    }
+    throw std::runtime_error{"No such asset"};
+}
+
+/**
+ * @brief Texture file of a sprite
+ */
+struct AssetFile
+{
+    std::string filename; ///< in the textures of the assets
+    bool alphaInGreen = false; ///< ETC1 has no alpha. The sprites are red: their alpha is stored in green
+};
+
+/**
+ * The most compressed variant of a sprite supported by the driver: ETC2, ETC1 or the uncompressed DDS
+ *
+ * @param name without extension, e.g. "clock"
+ */
+AssetFile getAssetFile(const Config &config, const std::string &name)
+{
+    if (glIsCompressedFormatSupported(GL_COMPRESSED_RGBA8_ETC2_EAC))
+    {
+        if (std::string filename = name + "_etc2.ktx"; config.hasTexture(filename))
+        {
+            return {filename, false};
+        }
+    }
+    if (glIsCompressedFormatSupported(GL_ETC1_RGB8_OES))
+    {
+        if (std::string filename = name + "_etc1.ktx"; config.hasTexture(filename))
+        {
+            return {filename, true};
+        }
+    }
+    return {name + ".dds", false};
+}
+
 /**
  * @brief Texture + position on screen
  */
 struct GraphicalAsset
 {
-    GraphicalAsset(const std::string &filename, unsigned int width, unsigned int height, unsigned textureSize)
-        : texture{filename.c_str()},
-          screenWidth{static_cast<GLfloat>(width * (2. / Renderer::getWidth()))},
-          screenHeight{static_cast<GLfloat>(height * (2. / Renderer::getHeight()))},
-          cropWidth{static_cast<GLfloat>(1. * width / textureSize)},
-          cropHeight{static_cast<GLfloat>(1. * height / textureSize)}
+    GraphicalAsset(const Config &config, const AssetFile &file, const AssetSize &size, bool mipmaps)
+        : texture{GlTextureLoader{config.openTexture(file.filename), mipmaps ? GlTextureLoader::kAllMipmaps : 1}, mipmaps},
+          filename{file.filename},
+          alphaInGreen{file.alphaInGreen},
+          width{static_cast<int>(size.width)},
+          height{static_cast<int>(size.height)},
+          screenWidth{static_cast<GLfloat>(size.width * (2. / Renderer::getWidth()))},
+          screenHeight{static_cast<GLfloat>(size.height * (2. / Renderer::getHeight()))},
+          cropWidth{static_cast<GLfloat>(1. * size.width / size.textureSize)},
+          cropHeight{static_cast<GLfloat>(1. * size.height / size.textureSize)}
     {
     }
     GlTexture texture;
+    std::string filename;
+    bool alphaInGreen = false;
+    int width = 0;
+    int height = 0;
     GLfloat screenWidth = 0;
     GLfloat screenHeight = 0;
     GLfloat cropWidth = 0;
@@ -97,116 +172,301 @@ static_assert(getVAlign(Position::DownLeft) == 0 && getVAlign(Position::Down) ==
 static_assert(getVAlign(Position::Left) == 1 && getVAlign(Position::Center) == 1 && getVAlign(Position::Right) == 1);
 static_assert(getVAlign(Position::UpLeft) == 2 && getVAlign(Position::Up) == 2 && getVAlign(Position::UpRight) == 2);
 
+/**
+ * Logical rectangle covering a box, rounded outward
+ */
+Rect getLogicalRect(GLfloat left, GLfloat bottom, GLfloat width, GLfloat height)
+{
+    const int x = std::floor(left);
+    const int y = std::floor(bottom);
+    return Rect{x, y, static_cast<int>(std::ceil(left + width)) - x, static_cast<int>(std::ceil(bottom + height)) - y};
+}
+
 constexpr GLushort kDrawSquareIndices[] = {0, 1, 2, 0, 2, 3};
 constexpr int kFontWidth = 18;
 constexpr int kFontHeight = 32;
 constexpr GLfloat kFontHeightToWidth = static_cast<GLfloat>(kFontWidth) / static_cast<GLfloat>(kFontHeight);
-constexpr int kGlyphsPerLine = 256 / kFontWidth;
+constexpr int kGlyphsPerLine = RendererGlyphCache::kGlyphsPerLine;
 
-} // namespace
+/**
+ * The sprites are drawn at their logical size: they need mipmaps only when the surface is smaller
+ */
+bool isMinified(const Config &config)
+{
+    return config.getDisplayWidth() < static_cast<int>(Renderer::getWidth()) ||
+           config.getDisplayHeight() < static_cast<int>(Renderer::getHeight());
+}
 
-struct Renderer::Impl
+/**
+ * @brief Everything to render with OpenGL
+ */
+struct RendererGl
 {
-    explicit Impl(const Config &config)
-        : printTextureElementArray{kDrawSquareIndices},
-          printTexture{readFile(config.getShader("print_texture.vert")), readFile(config.getShader("print_texture.frag"))},
-          printText{readFile(config.getShader("print_text.vert")), readFile(config.getShader("print_texture.frag"))},
-          analogClockTexture{config.getTexture("clock.dds"), 240, 240, 256},
-          arrowTexture{config.getTexture("arrow.dds"), 50, 50, 64},
-          fontTexture{config.getTexture("font.dds").c_str()}
+    explicit RendererGl(const Config &config)
+        : config{config},
+          programs{config.getShaderCacheFolder()},
+          printTextureElementArray{kDrawSquareIndices},
+          printTexture{getProgram("print_texture.vert", "print_texture.frag")},
+          printText{getProgram("print_text.vert", "print_text_sdf.frag")},
+          analogClockTexture{config, getAssetFile(config, "clock"), kClockSize, isMinified(config)},
+          arrowTexture{config, getAssetFile(config, "arrow"), kArrowSize, isMinified(config)},
+          glyphs{config}
     {
-        fontTexture.bind();
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glClearColor(0., 0., 0., 1.);
+
+        glActiveTexture(GL_TEXTURE0);
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        glViewport(0, 0, config.getDisplayWidth(), config.getDisplayHeight());
+
+        // shader printTexture
+        initPrintTexture(printTexture, printTexturePosition, printTextureCoord);
+
+        // shader printTextureAlphaInGreen, only for the ETC1 sprites
+        if (analogClockTexture.alphaInGreen || arrowTexture.alphaInGreen)
+        {
+            printTextureAlphaInGreen = &getProgram("print_texture.vert", "print_texture_alpha_green.frag");
+            initPrintTexture(*printTextureAlphaInGreen, printTextureAlphaInGreenPosition, printTextureAlphaInGreenCoord);
+        }
+
+        // shader printText
+        printText.use();
+        printTextPosition = printText.getAttribLocation("a_positionScreen");
+        printTextIndices = printText.getAttribLocation("a_textIndice");
+        glUniform1i(printText.getUniformLocation("s_texture"), 0);
+        glEnableVertexAttribArray(printTextPosition);
+        glEnableVertexAttribArray(printTextIndices);
     }
+
+    /**
+     * Get the locations of a program using print_texture.vert
+     */
+    static void initPrintTexture(GlProgram &program, GLint &position, GLint &coord)
+    {
+        program.use();
+        position = program.getAttribLocation("a_positionScreen");
+        coord = program.getAttribLocation("a_texCoord");
+        glUniform1i(program.getUniformLocation("s_texture"), 0);
+        glEnableVertexAttribArray(position);
+        glEnableVertexAttribArray(coord);
+    }
+
+    /**
+     * Program from the shader files, compiled once
+     */
+    GlProgram &getProgram(std::string_view vertexFilename, std::string_view fragmentFilename)
+    {
+        const MmapFile vertex = config.openShader(vertexFilename);
+        const MmapFile fragment = config.openShader(fragmentFilename);
+        return programs.get(std::string{static_cast<const char *>(vertex.content), vertex.size},
+                            std::string{static_cast<const char *>(fragment.content), fragment.size});
+    }
+
+    const Config &config;
+    GlProgramCache programs;
+    // destroyed after the VBOs of the elements
+    GlVboPool vbos;
+
     GlVboElementArray printTextureElementArray;
 
     // GlProgram printTexture
-    GlProgram printTexture;
+    GlProgram &printTexture;
     GLint printTexturePosition = -1;
     GLint printTextureCoord = -1;
 
     // GlProgram printText
-    GlProgram printText;
+    GlProgram &printText;
     GLint printTextPosition = -1;
     GLint printTextIndices = -1;
 
+    // GlProgram printTextureAlphaInGreen
+    GlProgram *printTextureAlphaInGreen = nullptr;
+    GLint printTextureAlphaInGreenPosition = -1;
+    GLint printTextureAlphaInGreenCoord = -1;
+
     // textures
     GraphicalAsset analogClockTexture;
     GraphicalAsset arrowTexture;
-    GlTexture fontTexture;
+    // signed distance fields: any text size from 1 texture, any code point from a bounded cache
+    RendererGlyphCache glyphs;
+
+    GraphicalAsset &getAsset(Asset asset)
+    {
+        return asset == Asset::Clock ? analogClockTexture : arrowTexture;
+    }
+};
+
+} // namespace
 
-    GraphicalAsset *getAsset(Asset asset)
+struct Renderer::Impl
+{
+    Impl(const Config &config, bool software)
+        : displayWidth{config.getDisplayWidth()},
+          displayHeight{config.getDisplayHeight()},
+          damage{static_cast<int>(getWidth()), static_cast<int>(getHeight()), displayWidth, displayHeight}
     {
-        switch (asset)
+        if (software)
         {
-        case Asset::Clock:
-            return &analogClockTexture;
-        case Asset::Arrow:
-            return &arrowTexture;
-        default:
-            break;
+            this->software = std::make_unique<RendererSoftware>(config);
         }
-        return nullptr;
+        else
+        {
+            gl = std::make_unique<RendererGl>(config);
+        }
+    }
+
+    /**
+     * From logical coordinates to pixels of the surface
+     */
+    SoftwareBox getPixels(GLfloat left, GLfloat bottom, GLfloat width, GLfloat height) const
+    {
+        const GLfloat scaleX = static_cast<GLfloat>(displayWidth) / getWidth();
+        const GLfloat scaleY = static_cast<GLfloat>(displayHeight) / getHeight();
+        return SoftwareBox{left * scaleX, bottom * scaleY, width * scaleX, height * scaleY};
     }
+
+    // size of the surface
+    int displayWidth;
+    int displayHeight;
+
+    RendererDamage damage;
+    Rect damagedRect;
+    RendererThread *thread = nullptr;
+
+    // only 1 of them
+    std::unique_ptr<RendererGl> gl;
+    std::unique_ptr<RendererSoftware> software;
 };
 
-Renderer::Renderer(const Config &config)
-    : pimpl{std::make_unique<Impl>(config)}
+Renderer::Renderer(const Config &config, bool software)
+    : pimpl{std::make_unique<Impl>(config, software)}
 {
-    glClearColor(0., 0., 0., 1.);
-
-    glActiveTexture(GL_TEXTURE0);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glViewport(0, 0, config.getDisplayWidth(), config.getDisplayHeight());
-
-    // shader printTexture
-    pimpl->printTexture.use();
-    pimpl->printTexturePosition = pimpl->printTexture.getAttribLocation("a_positionScreen");
-    pimpl->printTextureCoord = pimpl->printTexture.getAttribLocation("a_texCoord");
-    glUniform1i(pimpl->printTexture.getUniformLocation("s_texture"), 0);
-    glEnableVertexAttribArray(pimpl->printTexturePosition);
-    glEnableVertexAttribArray(pimpl->printTextureCoord);
-
-    // shader printText
-    pimpl->printText.use();
-    pimpl->printTextPosition = pimpl->printText.getAttribLocation("a_positionScreen");
-    pimpl->printTextIndices = pimpl->printText.getAttribLocation("a_textIndice");
-    glUniform1i(pimpl->printText.getUniformLocation("s_texture"), 0);
-    glEnableVertexAttribArray(pimpl->printTextPosition);
-    glEnableVertexAttribArray(pimpl->printTextIndices);
 }
 
 Renderer::~Renderer() = default;
 
 void Renderer::begin()
 {
-    glClear(GL_COLOR_BUFFER_BIT);
+    pimpl->damage.begin();
+    if (pimpl->software)
+    {
+        pimpl->software->begin();
+        return;
+    }
+    GlCommandBuffer::clearColor();
 }
 
 void Renderer::end()
 {
-    glCheckError();
+    if (pimpl->software)
+    {
+        pimpl->damagedRect = pimpl->damage.end();
+        // only the damaged part is actually drawn
+        pimpl->software->end(pimpl->damagedRect);
+        return;
+    }
+    // recorded: checked by the thread which replays the frame
+    if (!GlCommandBuffer::getRecording())
+    {
+        glCheckError();
+    }
+    pimpl->damagedRect = pimpl->damage.end();
 }
 
-RendererSprite Renderer::renderSprite(Asset asset, int x, int y, Position align, int rotation90Degree)
+const Rect &Renderer::getDamagedRect() const
 {
-    const auto graphicalAsset = pimpl->getAsset(asset);
-    if (graphicalAsset == nullptr)
+    return pimpl->damagedRect;
+}
+
+void Renderer::setRenderThread(RendererThread *thread)
+{
+    pimpl->thread = thread;
+}
+
+void Renderer::runOnContext(const std::function<void()> &task)
+{
+    if (pimpl->thread)
     {
-        throw std::runtime_error{"No such asset"};
+        pimpl->thread->invoke(task);
     }
+    else
+    {
+        task();
+    }
+}
+
+RendererDamage &Renderer::getDamage()
+{
+    return pimpl->damage;
+}
 
-    const GLfloat printX = x * (2. / getWidth()) - getHAlign(align) * graphicalAsset->screenWidth * .5 - 1;
-    const GLfloat printY = y * (2. / getHeight()) - getVAlign(align) * graphicalAsset->screenHeight * .5 - 1;
+RendererSoftware *Renderer::getSoftware()
+{
+    return pimpl->software.get();
+}
 
-    const auto vertices = getVertices2D(*graphicalAsset, printX, printY, rotation90Degree);
-    return RendererSprite{pimpl->printTexture,
-                          graphicalAsset->texture,
-                          pimpl->printTextureElementArray,
-                          pimpl->printTexturePosition,
-                          pimpl->printTextureCoord,
-                          GlVboArrayStatic{vertices.data(), vertices.size()}};
+GlProgram &Renderer::getProgram(std::string_view vertexFilename, std::string_view fragmentFilename)
+{
+    if (!pimpl->gl)
+    {
+        throw std::runtime_error{"No GL program with the software renderer"};
+    }
+    return pimpl->gl->getProgram(vertexFilename, fragmentFilename);
+}
+
+GlVboPool &Renderer::getVboPool()
+{
+    if (!pimpl->gl)
+    {
+        throw std::runtime_error{"No VBO with the software renderer"};
+    }
+    return pimpl->gl->vbos;
+}
+
+size_t Renderer::getGpuMemory() const
+{
+    if (!pimpl->gl)
+    {
+        return 0;
+    }
+    return GlTexture::getAllocatedBytes() + pimpl->gl->vbos.getStatistics().used;
+}
+
+RendererSprite Renderer::renderSprite(Asset asset, int x, int y, Position align, int rotation90Degree)
+{
+    const AssetSize &size = getAssetSize(asset);
+    const GLfloat left = x - getHAlign(align) * size.width * .5;
+    const GLfloat bottom = y - getVAlign(align) * size.height * .5;
+    const Rect rect = getLogicalRect(left, bottom, size.width, size.height);
+
+    if (RendererSoftware *const software = pimpl->software.get())
+    {
+        const SoftwareImage &image = software->getImage(asset);
+        const SoftwareBox source{0, 0, static_cast<float>(image.width) * size.width / size.textureSize, static_cast<float>(image.height) * size.height / size.textureSize};
+        return RendererSprite{*software,
+                              image,
+                              source,
+                              pimpl->getPixels(left, bottom, size.width, size.height),
+                              rotation90Degree,
+                              pimpl->damage,
+                              pimpl->damage.createItem(rect)};
+    }
+
+    RendererGl &gl = *pimpl->gl;
+    GraphicalAsset &graphicalAsset = gl.getAsset(asset);
+    const GLfloat printX = x * (2. / getWidth()) - getHAlign(align) * graphicalAsset.screenWidth * .5 - 1;
+    const GLfloat printY = y * (2. / getHeight()) - getVAlign(align) * graphicalAsset.screenHeight * .5 - 1;
+
+    const auto vertices = getVertices2D(graphicalAsset, printX, printY, rotation90Degree);
+    const bool alphaInGreen = graphicalAsset.alphaInGreen;
+    return RendererSprite{alphaInGreen ? *gl.printTextureAlphaInGreen : gl.printTexture,
+                          graphicalAsset.texture,
+                          gl.printTextureElementArray,
+                          alphaInGreen ? gl.printTextureAlphaInGreenPosition : gl.printTexturePosition,
+                          alphaInGreen ? gl.printTextureAlphaInGreenCoord : gl.printTextureCoord,
+                          GlVboArrayStatic{gl.vbos, vertices.data(), vertices.size()},
+                          pimpl->damage,
+                          pimpl->damage.createItem(rect)};
 }
 
 RendererText Renderer::renderText(int x, int y, int numCol, int numRow, Position align, int size)
@@ -221,6 +481,23 @@ RendererText Renderer::renderText(int x, int y, int numCol, int numRow, Position
     const GLfloat glPrintY = (y - getVAlign(align) * numRow * fontHeight * .5) * kYFactor - 1;
     const GLfloat glGlyphW = fontWidth * kXFactor;
     const GLfloat glGlyphH = fontHeight * kYFactor;
+    const Rect rect = getLogicalRect(x - getHAlign(align) * numCol * fontWidth * .5,
+                                     y - getVAlign(align) * numRow * fontHeight * .5,
+                                     numCol * fontWidth,
+                                     numRow * fontHeight);
+
+    if (RendererSoftware *const software = pimpl->software.get())
+    {
+        return RendererText{*software,
+                            pimpl->getPixels(x - getHAlign(align) * numCol * fontWidth * .5,
+                                             y - getVAlign(align) * numRow * fontHeight * .5 + (numRow - 1) * fontHeight,
+                                             fontWidth,
+                                             fontHeight),
+                            numCol,
+                            numRow,
+                            pimpl->damage,
+                            pimpl->damage.createItem(rect)};
+    }
 
     std::vector<GLfloat> vertices;
     std::vector<GLushort> indices;
@@ -252,13 +529,19 @@ RendererText Renderer::renderText(int x, int y, int numCol, int numRow, Position
         }
     }
 
-    return RendererText{pimpl->printText,
-                        pimpl->fontTexture,
-                        pimpl->printTextPosition,
-                        pimpl->printTextIndices,
-                        kGlyphsPerLine,
-                        GlVboArrayStatic{vertices.data(), vertices.size()},
-                        GlVboElementArray{indices.data(), indices.size()}};
+    // 1 font index per vertex, set by RendererText::set()
+    const std::vector<GLubyte> textIndices(numCol * numRow * 4);
+
+    RendererGl &gl = *pimpl->gl;
+    return RendererText{gl.printText,
+                        gl.glyphs,
+                        gl.printTextPosition,
+                        gl.printTextIndices,
+                        GlVboArrayStatic{gl.vbos, vertices.data(), vertices.size()},
+                        GlVboElementArray{gl.vbos, indices.data(), indices.size()},
+                        GlVboArrayDynamic{gl.vbos, textIndices.data(), textIndices.size()},
+                        pimpl->damage,
+                        pimpl->damage.createItem(rect)};
 }
 
 RendererTextStatic Renderer::renderStaticText(int x, int y, const char *text, Position align, int size)
@@ -267,8 +550,9 @@ RendererTextStatic Renderer::renderStaticText(int x, int y, const char *text, Po
     const GLfloat fontHeight = size;
     const size_t textLen = std::strlen(text);
 
+    // 1 column per code point
     const int numRow = std::count(text, text + textLen, '\n') + 1;
-    const int numCol = numRow > 1 ? (std::strchr(text, '\n') - text) : textLen;
+    const int numCol = getUtf8Length(std::string_view{text, numRow > 1 ? static_cast<size_t>(std::strchr(text, '\n') - text) : textLen});
 
     static constexpr auto kXFactor = (2. / getWidth());
     static constexpr auto kYFactor = (2. / getHeight());
@@ -277,6 +561,22 @@ RendererTextStatic Renderer::renderStaticText(int x, int y, const char *text, Po
     const GLfloat glPrintY = (y - getVAlign(align) * numRow * fontHeight * .5) * kYFactor - 1;
     const GLfloat glGlyphW = fontWidth * kXFactor;
     const GLfloat glGlyphH = fontHeight * kYFactor;
+    const Rect rect = getLogicalRect(x - getHAlign(align) * numCol * fontWidth * .5,
+                                     y - getVAlign(align) * numRow * fontHeight * .5,
+                                     numCol * fontWidth,
+                                     numRow * fontHeight);
+
+    if (RendererSoftware *const software = pimpl->software.get())
+    {
+        return RendererTextStatic{*software,
+                                  pimpl->getPixels(x - getHAlign(align) * numCol * fontWidth * .5,
+                                                   y - getVAlign(align) * numRow * fontHeight * .5 + (numRow - 1) * fontHeight,
+                                                   fontWidth,
+                                                   fontHeight),
+                                  text,
+                                  pimpl->damage,
+                                  pimpl->damage.createItem(rect)};
+    }
 
     std::vector<GLfloat> vertices;
     std::vector<GLushort> indices;
@@ -287,17 +587,20 @@ RendererTextStatic Renderer::renderStaticText(int x, int y, const char *text, Po
     // start top top to bottom
     GLfloat yf = glPrintY + (numRow - 1) * glGlyphH;
     GLfloat xf = glPrintX;
-    for (auto c = reinterpret_cast<const unsigned char *>(text); *c; ++c)
+    RendererGl &gl = *pimpl->gl;
+    std::vector<int> cells;
+    for (std::string_view remaining{text, textLen}; !remaining.empty();)
     {
-        if (*c == '\n')
+        const char32_t codePoint = popUtf8(remaining);
+        if (codePoint == '\n')
         {
             yf -= glGlyphH;
             xf = glPrintX;
         }
         else
         {
-            const int glyphNumber = *c - 0x20;
-            const int fontIndex = glyphNumber + glyphNumber / kGlyphsPerLine;
+            cells.push_back(gl.glyphs.acquire(codePoint));
+            const int fontIndex = RendererGlyphCache::getTextIndex(cells.back());
 
             const GLfloat glyph[] = {
                 xf, yf + glGlyphH,                                      // Position 0
@@ -321,22 +624,64 @@ RendererTextStatic Renderer::renderStaticText(int x, int y, const char *text, Po
         }
     }
 
-    return RendererTextStatic{pimpl->printText,
-                              pimpl->fontTexture,
-                              pimpl->printTextPosition,
-                              pimpl->printTextIndices,
-                              GlVboArrayStatic{vertices.data(), vertices.size()},
-                              GlVboElementArray{indices.data(), indices.size()}};
+    return RendererTextStatic{gl.printText,
+                              gl.glyphs,
+                              std::move(cells),
+                              gl.printTextPosition,
+                              gl.printTextIndices,
+                              GlVboArrayStatic{gl.vbos, vertices.data(), vertices.size()},
+                              GlVboElementArray{gl.vbos, indices.data(), indices.size()},
+                              pimpl->damage,
+                              pimpl->damage.createItem(rect)};
+}
+
+RendererLayer Renderer::renderLayer(RendererDisplayList &content)
+{
+    if (pimpl->software)
+    {
+        return RendererLayer{*pimpl->software, content, pimpl->damage};
+    }
+
+    RendererGl &gl = *pimpl->gl;
+    return RendererLayer{gl.printTexture,
+                         gl.printTextureElementArray,
+                         gl.printTexturePosition,
+                         gl.printTextureCoord,
+                         pimpl->displayWidth,
+                         pimpl->displayHeight,
+                         content,
+                         pimpl->damage};
 }
 
 std::ostream &Renderer::toStream(std::ostream &str) const
 {
+    if (pimpl->software)
+    {
+        str << "Software\n - Frame: " << pimpl->displayWidth << 'x' << pimpl->displayHeight << " RGBA8888, drawn by the CPU\n";
+        return str;
+    }
+
     str << "OpenGL\n - Vendor: " << glGetString(GL_VENDOR)
         << "\n - Renderer: " << glGetString(GL_RENDERER)
         << "\n - Version: " << glGetString(GL_VERSION)
         << "\n - Shading language version: " << glGetString(GL_SHADING_LANGUAGE_VERSION)
         << "\n - Extensions: " << glGetString(GL_EXTENSIONS)
-        << "\nGL Programs:\n - printTexture: " << pimpl->printTexture
-        << " - printText: " << pimpl->printText;
+        << "\nGL Programs:\n - printTexture: " << pimpl->gl->printTexture
+        << " - printText: " << pimpl->gl->printText
+        << "Sprites: " << pimpl->gl->analogClockTexture.filename << ", " << pimpl->gl->arrowTexture.filename << '\n';
+
+    const GlProgramCache &programs = pimpl->gl->programs;
+    const GlProgramCache::Statistics &statistics = programs.getStatistics();
+    str << "GL Program cache: " << (programs.isDiskCacheEnabled() ? "disk" : "process only")
+        << ", compiled " << statistics.compiled
+        << ", loaded " << statistics.loaded
+        << ", stored " << statistics.stored
+        << ", hits " << statistics.hits << '\n';
+
+    const GlVboPool::Statistics vbos = pimpl->gl->vbos.getStatistics();
+    str << "GL VBO pool: " << vbos.blocks << " blocks, " << vbos.used << '/' << vbos.capacity << " bytes in "
+        << vbos.ranges << " ranges, " << vbos.holes << " holes, fragmentation " << vbos.getFragmentation() << '\n';
+
+    str << "Glyph cache: " << pimpl->gl->glyphs.getStatistics() << '\n';
     return str;
 }
@@ -1,14 +1,25 @@
 #pragma once
 
 #include "toolbox_position.hpp"
+#include "toolbox_rect.hpp"
 
+#include <cstddef>
+#include <functional>
 #include <iosfwd>
 #include <memory>
+#include <string_view>
 
 class Config;
+class GlProgram;
+class GlVboPool;
+class RendererDamage;
+class RendererDisplayList;
+class RendererLayer;
+class RendererSoftware;
 class RendererSprite;
 class RendererText;
 class RendererTextStatic;
+class RendererThread;
 
 #define DEGREE "\x82"
 
@@ -28,7 +39,11 @@ public:
 
     static constexpr int kDefaultCharSize = 32;
 
-    Renderer(const Config &config);
+    /**
+     * @param software draw with the CPU (RendererSoftware) instead of OpenGL, for the windows without any OpenGL
+     * context
+     */
+    Renderer(const Config &config, bool software = false);
     ~Renderer();
 
     /**
@@ -50,17 +65,71 @@ public:
     /**
      * Method to be called before any drawing on screen
      *
-     * Clears the OpenGL buffer
+     * Clears the OpenGL buffer. The software renderer only clears the damaged part, at end()
      */
     void begin();
 
     /**
      * Method to be called after all drawing on screen
      *
-     * Check for OpenGL errors
+     * Check for OpenGL errors and compute the damaged part of the surface
      */
     void end();
 
+    /**
+     * Part of the OpenGL surface (in pixels) which has changed during the last frame
+     *
+     * Computed by end(). Empty if nothing has changed
+     */
+    const Rect &getDamagedRect() const;
+
+    /**
+     * The frames are recorded by another thread than the one owning the OpenGL context. nullptr by default
+     *
+     * @sa runOnContext()
+     */
+    void setRenderThread(RendererThread *thread);
+
+    /**
+     * Run the task on the thread owning the OpenGL context, e.g. to create or destroy elements, and wait for it
+     *
+     * Right away without any RendererThread
+     */
+    void runOnContext(const std::function<void()> &task);
+
+    /**
+     * To track the elements which are not created by the Renderer
+     */
+    RendererDamage &getDamage();
+
+    /**
+     * To draw the elements which are not created by the Renderer. The frame is drawn there at end()
+     *
+     * @return nullptr when rendering with OpenGL
+     */
+    RendererSoftware *getSoftware();
+
+    /**
+     * Program from 2 files of the shader folder. The programs are compiled once, then shared
+     *
+     * @attention the program lives as long as the renderer. Set its uniforms before each use
+     * @throw std::runtime_error with the software renderer
+     */
+    GlProgram &getProgram(std::string_view vertexFilename, std::string_view fragmentFilename);
+
+    /**
+     * Where the VBOs of the elements are allocated. They are recycled when the elements are destroyed
+     *
+     * @attention the elements must be destroyed before the renderer
+     * @throw std::runtime_error with the software renderer
+     */
+    GlVboPool &getVboPool();
+
+    /**
+     * Bytes held on the GPU by the textures and the VBO ranges in use, 0 with the software renderer
+     */
+    size_t getGpuMemory() const;
+
     /**
      * Render a sprite at a given position
      *
@@ -82,6 +151,13 @@ public:
      */
     RendererTextStatic renderStaticText(int x, int y, const char *text, Position align, int size = kDefaultCharSize);
 
+    /**
+     * Create a full-screen layer caching the content in a texture. To be printed before any other element
+     *
+     * @attention the content must outlive the layer
+     */
+    RendererLayer renderLayer(RendererDisplayList &content);
+
     friend std::ostream &operator<<(std::ostream &str, const Renderer &renderer)
     {
         return renderer.toStream(str);
@@ -1,11 +1,15 @@
 #include "renderer_clock.hpp"
 
 #include "config.hpp"
+#include "gl_command_buffer.hpp"
 #include "gl_shader.hpp"
 #include "gl_vbo.hpp"
+#include "renderer.hpp"
+#include "renderer_damage.hpp"
+#include "renderer_software.hpp"
 #include "toolbox_gl.hpp"
-#include "toolbox_io.hpp"
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <vector>
@@ -41,28 +45,153 @@ constexpr GLfloat secToUnit = 1;
 constexpr GLfloat minToUnit = 60;
 constexpr GLfloat hourToUnit = 3600;
 
+/**
+ * Distance from the rotation axis of the furthest corner of a hand
+ */
+float getRadius(float length, float width)
+{
+    return std::hypot(length, width / 2);
+}
+
 } // namespace
 
 struct RendererClock::Impl
 {
-    explicit Impl(GlProgram &&program,
-                  GlVboArrayStatic &&vertices,
-                  GlVboElementArray &&indices)
-        : program{std::move(program)},
+    Impl(RendererDamage &damage, const Rect &rect)
+        : damage{damage},
+          damageItem{damage.createItem(rect)}
+    {
+    }
+    virtual ~Impl() = default;
+
+    virtual void draw(GLfloat rotation) = 0;
+
+    RendererDamage &damage;
+    RendererDamage::Item damageItem;
+    GLfloat rotation = -1;
+};
+
+namespace
+{
+
+struct ClockGl : RendererClock::Impl
+{
+    ClockGl(RendererDamage &damage,
+            const Rect &rect,
+            GlProgram &program,
+            GlVboArrayStatic &&vertices,
+            GlVboElementArray &&indices,
+            const std::array<GLfloat, 2> &rotationAxis,
+            const std::array<GLfloat, 2> &squareScreenFactor,
+            const std::array<GLfloat, 3> &color)
+        : Impl{damage, rect},
+          program{program},
           vertices{std::move(vertices)},
-          indices{std::move(indices)}
+          indices{std::move(indices)},
+          rotationAxis{rotationAxis},
+          squareScreenFactor{squareScreenFactor},
+          color{color},
+          u_rotation{program.getUniformLocation("u_rotation")},
+          u_rotationAxis{program.getUniformLocation("u_rotationAxis")},
+          u_squareScreenFactor{program.getUniformLocation("u_squareScreenFactor")},
+          u_color{program.getUniformLocation("u_color")},
+          a_positionScreen{program.getAttribLocation("a_positionScreen")},
+          a_rotationFactor{program.getAttribLocation("a_rotationFactor")}
+    {
+    }
+
+    void draw(GLfloat rotation) override
     {
+        program.use();
+
+        // the program is shared with the clocks of the other screens
+        GlCommandBuffer::uniform(u_rotationAxis, rotationAxis[0], rotationAxis[1]);
+        GlCommandBuffer::uniform(u_squareScreenFactor, squareScreenFactor[0], squareScreenFactor[1]);
+        GlCommandBuffer::uniform(u_color, color[0], color[1], color[2]);
+        GlCommandBuffer::uniform(u_rotation, rotation);
+        vertices.bind();
+        vertices.draw<GLfloat>(a_positionScreen, 2, 0, 3);
+        vertices.draw<GLfloat>(a_rotationFactor, 1, 2, 3);
+
+        indices.draw();
     }
 
-    GlProgram program;
+    // owned by the Renderer
+    GlProgram &program;
     GlVboArrayStatic vertices;
     GlVboElementArray indices;
+    std::array<GLfloat, 2> rotationAxis;
+    std::array<GLfloat, 2> squareScreenFactor;
+    std::array<GLfloat, 3> color;
     GLint u_rotation = -1;
+    GLint u_rotationAxis = -1;
+    GLint u_squareScreenFactor = -1;
+    GLint u_color = -1;
     GLint a_positionScreen = -1;
     GLint a_rotationFactor = -1;
 };
 
+/**
+ * Same computation as print_clock_hand.vert, on the CPU
+ */
+struct ClockSoftware : RendererClock::Impl
+{
+    ClockSoftware(RendererDamage &damage,
+                  const Rect &rect,
+                  RendererSoftware &software,
+                  std::vector<GLfloat> &&vertices,
+                  const std::array<GLfloat, 2> &rotationAxis,
+                  const std::array<GLfloat, 2> &squareScreenFactor,
+                  const SoftwareColor &color)
+        : Impl{damage, rect},
+          software{software},
+          vertices{std::move(vertices)},
+          rotationAxis{rotationAxis},
+          squareScreenFactor{squareScreenFactor},
+          color{color}
+    {
+    }
+
+    void draw(GLfloat rotation) override
+    {
+        static constexpr GLfloat k2Pi = 2 * 3.14159265359;
+        const GLfloat surfaceWidth = software.getCanvas().getWidth();
+        const GLfloat surfaceHeight = software.getCanvas().getHeight();
+
+        // 4 vertices of 3 floats per hand
+        for (size_t hand = 0; hand < vertices.size(); hand += 12)
+        {
+            const GLfloat factor = rotation * vertices[hand + 2];
+            const GLfloat angle = (factor - std::floor(factor)) * k2Pi;
+            const GLfloat c = std::cos(angle) * squareScreenFactor[0];
+            const GLfloat s = std::sin(angle) * squareScreenFactor[1];
+
+            std::array<float, 8> corners;
+            for (size_t i = 0; i < 4; ++i)
+            {
+                const GLfloat x = vertices[hand + i * 3];
+                const GLfloat y = vertices[hand + i * 3 + 1];
+                // from OpenGL coordinates to pixels
+                corners[i * 2] = (c * x + s * y + rotationAxis[0] + 1) * .5f * surfaceWidth;
+                corners[i * 2 + 1] = (-s * x + c * y + rotationAxis[1] + 1) * .5f * surfaceHeight;
+            }
+            software.drawQuad(corners, color);
+        }
+    }
+
+    // not owned
+    RendererSoftware &software;
+
+    std::vector<GLfloat> vertices;
+    std::array<GLfloat, 2> rotationAxis;
+    std::array<GLfloat, 2> squareScreenFactor;
+    SoftwareColor color;
+};
+
+} // namespace
+
 RendererClock::RendererClock(const Config &config,
+                             Renderer &renderer,
                              int screenWidth, int screenHeight,
                              int x, int y,
                              float lengthHour, float widthHour,
@@ -95,22 +224,44 @@ RendererClock::RendererClock(const Config &config,
         indices.insert(indices.end(), secIndices.begin(), secIndices.end());
     }
 
-    pimpl = std::make_unique<Impl>(GlProgram{readFile(config.getShader("print_clock_hand.vert")), readFile(config.getShader("print_color.frag"))},
-                                   GlVboArrayStatic{vertices.data(), vertices.size()},
-                                   GlVboElementArray{indices.data(), indices.size()});
-
-    pimpl->program.use();
-    glUniform2f(pimpl->program.getUniformLocation("u_rotationAxis"), x * 2. / screenWidth - 1, y * 2. / screenHeight - 1);
-    glUniform2f(pimpl->program.getUniformLocation("u_squareScreenFactor"),
-                screenWidth / std::max<GLfloat>(screenWidth, screenHeight),
-                screenHeight / std::max<GLfloat>(screenWidth, screenHeight));
+    // the hands rotate inside a square (on a physical screen) around the axis
+    const GLfloat squareScreenFactorW = screenWidth / std::max<GLfloat>(screenWidth, screenHeight);
+    const GLfloat squareScreenFactorH = screenHeight / std::max<GLfloat>(screenWidth, screenHeight);
+    float radius = std::max(getRadius(lengthHour, widthHour), getRadius(lengthMin, widthMin));
+    if (config.displaySeconds())
+    {
+        radius = std::max(radius, getRadius(lengthSec, widthSec));
+    }
+    // in OpenGL coordinates, which are [-1, 1]
+    const float extent = radius * (squareScreenFactorW + squareScreenFactorH);
+    const int extentW = std::ceil(extent * screenWidth / 2);
+    const int extentH = std::ceil(extent * screenHeight / 2);
+    const Rect rect{x - extentW, y - extentH, 2 * extentW, 2 * extentH};
 
+    const GLfloat rotationAxisX = x * 2. / screenWidth - 1;
+    const GLfloat rotationAxisY = y * 2. / screenHeight - 1;
     const auto &clockHandColor = config.getClockHandColor();
-    glUniform3f(pimpl->program.getUniformLocation("u_color"), clockHandColor[0] / 255., clockHandColor[1] / 255., clockHandColor[2] / 255.);
 
-    pimpl->u_rotation = pimpl->program.getUniformLocation("u_rotation");
-    pimpl->a_positionScreen = pimpl->program.getAttribLocation("a_positionScreen");
-    pimpl->a_rotationFactor = pimpl->program.getAttribLocation("a_rotationFactor");
+    if (RendererSoftware *const software = renderer.getSoftware())
+    {
+        pimpl = std::make_unique<ClockSoftware>(renderer.getDamage(),
+                                                rect,
+                                                *software,
+                                                std::move(vertices),
+                                                std::array<GLfloat, 2>{rotationAxisX, rotationAxisY},
+                                                std::array<GLfloat, 2>{squareScreenFactorW, squareScreenFactorH},
+                                                SoftwareColor{clockHandColor[0], clockHandColor[1], clockHandColor[2]});
+        return;
+    }
+
+    pimpl = std::make_unique<ClockGl>(renderer.getDamage(),
+                                      rect,
+                                      renderer.getProgram("print_clock_hand.vert", "print_color.frag"),
+                                      GlVboArrayStatic{renderer.getVboPool(), vertices.data(), vertices.size()},
+                                      GlVboElementArray{renderer.getVboPool(), indices.data(), indices.size()},
+                                      std::array<GLfloat, 2>{rotationAxisX, rotationAxisY},
+                                      std::array<GLfloat, 2>{squareScreenFactorW, squareScreenFactorH},
+                                      std::array<GLfloat, 3>{clockHandColor[0] / 255.f, clockHandColor[1] / 255.f, clockHandColor[2] / 255.f});
 }
 
 RendererClock::~RendererClock() = default;
@@ -122,12 +273,11 @@ void RendererClock::draw(int hour, int min, int sec, int millis)
         hour -= 12;
     }
     const GLfloat rotation = hour * hourToUnit + min * minToUnit + sec * secToUnit + millis * millisToUnit;
-    pimpl->program.use();
-
-    glUniform1f(pimpl->u_rotation, rotation);
-    pimpl->vertices.bind();
-    pimpl->vertices.draw<GLfloat>(pimpl->a_positionScreen, 2, 0, 3);
-    pimpl->vertices.draw<GLfloat>(pimpl->a_rotationFactor, 1, 2, 3);
-
-    pimpl->indices.draw();
+    if (rotation != pimpl->rotation)
+    {
+        pimpl->rotation = rotation;
+        ++pimpl->damageItem.version;
+    }
+    pimpl->damage.add(pimpl->damageItem);
+    pimpl->draw(rotation);
 }
@@ -3,6 +3,7 @@
 #include <memory>
 
 class Config;
+class Renderer;
 
 /**
  * @brief Render the analog clock's hands
@@ -17,6 +18,8 @@ public:
     /**
      * Constructor
      *
+     * @param renderer where the area covered by the hands is tracked. The hands are drawn by the CPU with the software
+     * renderer
      * @param screenWidth used for the heigth / width ratio to have a round clock
      * @param screenHeight used for the heigth / width ratio to have a round clock
      * @param x position on screen of the center of the clock
@@ -29,6 +32,7 @@ public:
      * @param widthSec width of the second hand. Max is 1. Only displayed if enabled in config
      */
     RendererClock(const Config &config,
+                  Renderer &renderer,
                   int screenWidth, int screenHeight,
                   int x, int y,
                   float lengthHour, float widthHour,
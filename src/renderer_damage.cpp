@@ -0,0 +1,142 @@
+#include "renderer_damage.hpp"
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+
+/**
+ * Items per frame without any allocation, more than any screen has
+ */
+constexpr size_t kReservedItems = 64;
+
+/**
+ * @brief Copy of the Item as it was displayed
+ */
+using Drawn = RendererDamage::Item;
+
+const Drawn *findDrawn(const std::vector<Drawn> &drawn, unsigned int id)
+{
+    for (const Drawn &item : drawn)
+    {
+        if (item.id == id)
+        {
+            return &item;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+struct RendererDamage::Impl
+{
+    /**
+     * Convert a logical rectangle into pixels, rounding outward.
+     * 1 more pixel on each side for the linear filtering of the textures
+     */
+    Rect toSurface(const Rect &rect) const
+    {
+        const int left = static_cast<int>(std::floor(rect.x * scaleX)) - 1;
+        const int bottom = static_cast<int>(std::floor(rect.y * scaleY)) - 1;
+        const int right = static_cast<int>(std::ceil((rect.x + rect.width) * scaleX)) + 1;
+        const int top = static_cast<int>(std::ceil((rect.y + rect.height) * scaleY)) + 1;
+        return Rect{left, bottom, right - left, top - bottom}.intersected(surface);
+    }
+
+    Rect logical;
+    Rect surface;
+    double scaleX;
+    double scaleY;
+
+    std::vector<Drawn> previous;
+    std::vector<Drawn> current;
+    unsigned int lastId = 0;
+    bool tracking = true;
+    bool invalid = true;
+};
+
+RendererDamage::RendererDamage(int logicalWidth, int logicalHeight, int surfaceWidth, int surfaceHeight)
+    : pimpl{std::make_unique<Impl>()}
+{
+    pimpl->logical = Rect{0, 0, logicalWidth, logicalHeight};
+    pimpl->surface = Rect{0, 0, surfaceWidth, surfaceHeight};
+    pimpl->scaleX = static_cast<double>(surfaceWidth) / logicalWidth;
+    pimpl->scaleY = static_cast<double>(surfaceHeight) / logicalHeight;
+    pimpl->previous.reserve(kReservedItems);
+    pimpl->current.reserve(kReservedItems);
+}
+
+RendererDamage::~RendererDamage() = default;
+
+RendererDamage::Item RendererDamage::createItem(const Rect &rect)
+{
+    return Item{++pimpl->lastId, rect, 0};
+}
+
+RendererDamage::Item RendererDamage::createScreenItem()
+{
+    return createItem(pimpl->logical);
+}
+
+void RendererDamage::begin()
+{
+    // keep the capacity of both vectors
+    std::swap(pimpl->previous, pimpl->current);
+    pimpl->current.clear();
+}
+
+void RendererDamage::add(const Item &item)
+{
+    if (pimpl->tracking)
+    {
+        pimpl->current.push_back(item);
+    }
+}
+
+void RendererDamage::setTracking(bool tracking)
+{
+    pimpl->tracking = tracking;
+}
+
+void RendererDamage::invalidate()
+{
+    pimpl->invalid = true;
+}
+
+Rect RendererDamage::end()
+{
+    if (pimpl->invalid)
+    {
+        pimpl->invalid = false;
+        return pimpl->surface;
+    }
+
+    Rect damage;
+    for (const Drawn &item : pimpl->current)
+    {
+        const Drawn *const before = findDrawn(pimpl->previous, item.id);
+        if (before == nullptr)
+        {
+            damage = damage.united(item.rect);
+        }
+        else if (before->version != item.version || before->rect != item.rect)
+        {
+            damage = damage.united(item.rect).united(before->rect);
+        }
+    }
+    for (const Drawn &item : pimpl->previous)
+    {
+        if (findDrawn(pimpl->current, item.id) == nullptr)
+        {
+            damage = damage.united(item.rect);
+        }
+    }
+
+    if (damage.empty())
+    {
+        return {};
+    }
+    return pimpl->toSurface(damage);
+}
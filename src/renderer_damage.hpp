@@ -0,0 +1,86 @@
+#pragma once
+
+#include "toolbox_rect.hpp"
+
+#include <memory>
+
+/**
+ * @brief Compute which part of the screen has changed since the previous frame
+ *
+ * Each element of the screen owns an Item. When it is displayed, the Item is added to the current frame.
+ * At the end of the frame, the Items are compared to the ones of the previous frame:
+ *
+ * @arg new Item (element which has appeared)
+ * @arg missing Item (element which has disappeared)
+ * @arg Item whose version has changed (the content has changed, like a text)
+ *
+ * The result is the union of the rectangles of all these Items, which is what the Window has to refresh.
+ *
+ * created by Renderer
+ *
+ * @sa Renderer
+ */
+class RendererDamage
+{
+public:
+    struct Impl;
+
+    /**
+     * @brief Element of the screen whose display is tracked
+     */
+    struct Item
+    {
+        unsigned int id = 0;      ///< unique identifier, given by createItem()
+        Rect rect;                ///< logical position on screen
+        unsigned int version = 0; ///< to be incremented at each change of the content
+    };
+
+    /**
+     * @param logicalWidth logical width to place elements on screen
+     * @param logicalHeight logical height to place elements on screen
+     * @param surfaceWidth size of the OpenGL surface in pixels
+     * @param surfaceHeight size of the OpenGL surface in pixels
+     */
+    RendererDamage(int logicalWidth, int logicalHeight, int surfaceWidth, int surfaceHeight);
+    ~RendererDamage();
+
+    /**
+     * Create an Item with a new identifier
+     */
+    Item createItem(const Rect &rect);
+
+    /**
+     * Create an Item covering the whole screen
+     */
+    Item createScreenItem();
+
+    /**
+     * Start a new frame
+     */
+    void begin();
+
+    /**
+     * Add an element displayed in the current frame
+     */
+    void add(const Item &item);
+
+    /**
+     * Turn on/off the tracking (for instance when rendering offscreen)
+     */
+    void setTracking(bool tracking);
+
+    /**
+     * The whole surface is damaged at the next end()
+     */
+    void invalidate();
+
+    /**
+     * End the current frame
+     *
+     * @return the damaged part of the surface in pixels. Empty if nothing has changed
+     */
+    Rect end();
+
+private:
+    std::unique_ptr<Impl> pimpl;
+};
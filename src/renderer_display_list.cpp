@@ -0,0 +1,134 @@
+#include "renderer_display_list.hpp"
+
+#include "gl_command_buffer.hpp"
+#include "gl_shader.hpp"
+#include "gl_texture.hpp"
+#include "gl_vbo.hpp"
+#include "toolbox_gl.hpp"
+
+#include <array>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+/**
+ * @brief Everything needed to replay 1 draw call
+ */
+struct Command
+{
+    GLuint program;
+    GLuint texture;
+    std::array<RendererDisplayList::Attrib, 2> attribs;
+    GLuint indices;
+    size_t indicesOffset; ///< in bytes
+    GLenum indicesType;
+    GLsizei count;
+    RendererDamage *damage;
+    const RendererDamage::Item *damageItem;
+};
+
+} // namespace
+
+struct RendererDisplayList::Impl
+{
+    std::vector<Command> commands;
+    std::vector<std::function<void()>> softwareCommands;
+};
+
+RendererDisplayList::RendererDisplayList()
+    : pimpl{std::make_unique<Impl>()}
+{
+}
+
+RendererDisplayList::~RendererDisplayList() = default;
+
+RendererDisplayList::Attrib RendererDisplayList::attrib(const GlVboArray &vbo, int index, int size, int offset, int stride)
+{
+    return Attrib{vbo.get(), index, size, vbo.getGlType(), vbo.isNormalized(), static_cast<int>(vbo.getOffset()) + offset, stride};
+}
+
+void RendererDisplayList::add(GlProgram &program,
+                              const GlTexture &texture,
+                              const GlVboElementArray &indices,
+                              const Attrib &attrib0,
+                              const Attrib &attrib1,
+                              RendererDamage &damage,
+                              const RendererDamage::Item &damageItem)
+{
+    pimpl->commands.push_back(Command{program.get(),
+                                      texture.get(),
+                                      {attrib0, attrib1},
+                                      indices.get(),
+                                      indices.getOffset(),
+                                      static_cast<GLenum>(indices.getGlType()),
+                                      indices.getNumberVertex(),
+                                      &damage,
+                                      &damageItem});
+}
+
+void RendererDisplayList::add(std::function<void()> print)
+{
+    pimpl->softwareCommands.push_back(std::move(print));
+}
+
+void RendererDisplayList::clear()
+{
+    pimpl->commands.clear();
+    pimpl->softwareCommands.clear();
+}
+
+size_t RendererDisplayList::size() const
+{
+    return pimpl->commands.size() + pimpl->softwareCommands.size();
+}
+
+void RendererDisplayList::submit()
+{
+    for (const auto &print : pimpl->softwareCommands)
+    {
+        print();
+    }
+
+    // the state is unknown when entering: the first command binds everything
+    GLuint currentProgram = 0;
+    GLuint currentTexture = 0;
+    GLuint currentArray = 0;
+    GLuint currentIndices = 0;
+
+    for (const Command &command : pimpl->commands)
+    {
+        command.damage->add(*command.damageItem);
+
+        if (command.program != currentProgram)
+        {
+            GlCommandBuffer::useProgram(command.program);
+            currentProgram = command.program;
+        }
+
+        for (const Attrib &attrib : command.attribs)
+        {
+            if (attrib.vbo != currentArray)
+            {
+                GlCommandBuffer::bindBuffer(GL_ARRAY_BUFFER, attrib.vbo);
+                currentArray = attrib.vbo;
+            }
+            GlCommandBuffer::vertexAttribPointer(attrib.index, attrib.size, attrib.glType, attrib.normalized, attrib.stride, attrib.offset);
+        }
+
+        if (command.texture != currentTexture)
+        {
+            GlCommandBuffer::bindTexture(command.texture);
+            currentTexture = command.texture;
+        }
+
+        // with a GlVboPool, the indices of several elements share the same buffer
+        if (command.indices != currentIndices)
+        {
+            GlCommandBuffer::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, command.indices);
+            currentIndices = command.indices;
+        }
+        GlCommandBuffer::drawElements(command.count, command.indicesType, command.indicesOffset);
+    }
+}
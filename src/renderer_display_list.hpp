@@ -0,0 +1,95 @@
+#pragma once
+
+#include "renderer_damage.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+class GlProgram;
+class GlTexture;
+class GlVboArray;
+class GlVboElementArray;
+
+/**
+ * @brief Retained list of draw calls
+ *
+ * The elements (RendererSprite, RendererText, RendererTextStatic) are recorded once, usually in Screen::enter().
+ * submit() then replays the raw OpenGL calls without going through the elements, and skips the redundant
+ * glUseProgram() / glBindTexture() / glBindBuffer().
+ *
+ * Only the OpenGL identifiers are stored: the recorded elements must outlive the list.
+ * The content of a RendererText may still change after it has been recorded.
+ *
+ * With the software renderer, there is no OpenGL call to replay: the elements are recorded as they are.
+ *
+ * @sa Renderer
+ */
+class RendererDisplayList
+{
+public:
+    struct Impl;
+
+    /**
+     * @brief Vertex attribute read from a GL_ARRAY_BUFFER
+     */
+    struct Attrib
+    {
+        unsigned int vbo = 0;
+        int index = -1;
+        int size = 0;
+        int glType = 0;
+        bool normalized = false;
+        int offset = 0; ///< in bytes, from the start of the OpenGL buffer
+        int stride = 0; ///< in bytes
+    };
+
+    RendererDisplayList();
+    ~RendererDisplayList();
+
+    /**
+     * Helper to build an Attrib from a VBO
+     *
+     * @param offset in bytes, from the start of the data of the VBO
+     * @param stride in bytes
+     */
+    static Attrib attrib(const GlVboArray &vbo, int index, int size, int offset = 0, int stride = 0);
+
+    /**
+     * Record a draw call (2 attributes + 1 texture + GL_TRIANGLES from indices)
+     *
+     * The damageItem is added to damage at each submit()
+     */
+    void add(GlProgram &program,
+             const GlTexture &texture,
+             const GlVboElementArray &indices,
+             const Attrib &attrib0,
+             const Attrib &attrib1,
+             RendererDamage &damage,
+             const RendererDamage::Item &damageItem);
+
+    /**
+     * Record an element drawn by the CPU (RendererSoftware)
+     *
+     * @param print called at each submit()
+     */
+    void add(std::function<void()> print);
+
+    /**
+     * Remove all the recorded draw calls
+     */
+    void clear();
+
+    /**
+     * Number of draw calls issued by submit()
+     */
+    size_t size() const;
+
+    /**
+     * Actually display all the recorded elements (call OpenGL to perform the display)
+     */
+    void submit();
+
+private:
+    std::unique_ptr<Impl> pimpl;
+};
@@ -0,0 +1,274 @@
+#include "renderer_glyph_cache.hpp"
+
+#include "config.hpp"
+#include "gl_command_buffer.hpp"
+#include "gl_counters.hpp"
+#include "gl_texture.hpp"
+#include "gl_texture_loader.hpp"
+#include "toolbox_gl.hpp"
+#include "toolbox_io.hpp"
+#include "toolbox_sdf.hpp"
+
+#ifndef NO_FREETYPE
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <ostream>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+
+// cells of font_sdf.dds, see the Makefile
+constexpr int kGlyphWidth = 18;
+constexpr int kGlyphHeight = 32;
+constexpr int kAsciiCells = 0x7f - 0x20;
+constexpr int kFallbackCell = '?' - 0x20;
+
+// font_sdf.dds fills the top half: 8 rows of kGlyphsPerLine cells, the ASCII glyphs then empty cells. The cache starts
+// right after the ASCII cells: the end of the top half (cells 95 to 111), then the whole bottom half (cells 112 to 223)
+constexpr int kTextureWidth = 256;
+constexpr int kAsciiHeight = 256;
+constexpr int kRows = 16;
+constexpr int kTextureHeight = kRows * kGlyphHeight;
+constexpr int kCells = kRows * RendererGlyphCache::kGlyphsPerLine;
+static_assert(kCells - kAsciiCells == RendererGlyphCache::kCapacity);
+// the texts store the indices of print_text.vert in bytes
+static_assert(RendererGlyphCache::getTextIndex(kCells - 1) + RendererGlyphCache::kGlyphsPerLine + 2 <= 255);
+
+// the rasterization of font_sdf.dds, see the Makefile
+constexpr int kScale = 4;
+constexpr double kSpread = 4;
+
+} // namespace
+
+struct RendererGlyphCache::Impl
+{
+    /**
+     * @brief Cell of the cache
+     */
+    struct Slot
+    {
+        char32_t codePoint = 0;
+        int refs = 0;
+        uint64_t lastUse = 0;
+        bool used = false;
+    };
+
+    Impl(const Config &config, size_t capacity)
+        : texture{kTextureWidth, kTextureHeight, GL_LUMINANCE},
+          slots(std::min(capacity, kCapacity))
+    {
+        const GlTextureLoader loader{config.openTexture("font_sdf.dds"), 1};
+        if (loader.getGlFormat() != GL_LUMINANCE || loader.getMipmapWidth(0) != kTextureWidth ||
+            loader.getMipmapHeight(0) != kAsciiHeight)
+        {
+            throw std::runtime_error{"font_sdf.dds: expected 256x256 luminance"};
+        }
+
+        // the texture is still bound
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, kTextureWidth, kAsciiHeight, GL_LUMINANCE, GL_UNSIGNED_BYTE, loader.getMipmap(0));
+        GlCounters::count(GlCounters::Call::TextureUpload, loader.getMipmapSize(0));
+        // distance field: interpolated
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+
+#ifndef NO_FREETYPE
+        FT_Library newLibrary = nullptr;
+        if (config.hasTexture("font.ttf") && FT_Init_FreeType(&newLibrary) == 0)
+        {
+            library.reset(newLibrary);
+            // the font stays in memory as long as the face
+            fontFile = config.openTexture("font.ttf");
+            FT_Face newFace = nullptr;
+            if (FT_New_Memory_Face(library.get(), static_cast<const FT_Byte *>(fontFile.content), fontFile.size, 0, &newFace) == 0)
+            {
+                face.reset(newFace);
+                FT_Set_Pixel_Sizes(face.get(), 0, kGlyphHeight * kScale);
+            }
+        }
+#endif
+    }
+
+    /**
+     * Signed distance field of the glyph, like font_sdf.dds
+     *
+     * @return false if the font has no glyph for it
+     */
+    bool rasterize(char32_t codePoint, std::vector<uint8_t> &sdf)
+    {
+#ifndef NO_FREETYPE
+        if (!face)
+        {
+            return false;
+        }
+        const FT_UInt glyphIndex = FT_Get_Char_Index(face.get(), codePoint);
+        if (glyphIndex == 0 || FT_Load_Glyph(face.get(), glyphIndex, FT_LOAD_RENDER | FT_LOAD_NO_BITMAP) != 0)
+        {
+            return false;
+        }
+
+        // the baseline is at the ascender, like ImageMagick's label
+        constexpr int width = kGlyphWidth * kScale;
+        constexpr int height = kGlyphHeight * kScale;
+        const FT_GlyphSlot glyph = face->glyph;
+        const FT_Bitmap &bitmap = glyph->bitmap;
+        const int left = glyph->bitmap_left;
+        const int top = static_cast<int>(face->size->metrics.ascender >> 6) - glyph->bitmap_top;
+
+        std::vector<uint8_t> pixels(width * height);
+        for (int y = std::max(0, -top); y < static_cast<int>(bitmap.rows) && top + y < height; ++y)
+        {
+            for (int x = std::max(0, -left); x < static_cast<int>(bitmap.width) && left + x < width; ++x)
+            {
+                pixels[(top + y) * width + left + x] = bitmap.buffer[y * bitmap.pitch + x];
+            }
+        }
+        sdf = getSignedDistanceField(pixels.data(), width, height, kScale, kSpread);
+        return true;
+#else
+        static_cast<void>(codePoint);
+        static_cast<void>(sdf);
+        return false;
+#endif
+    }
+
+    /**
+     * The unused slot, or the least recently used one which is not pinned. nullptr if all of them are pinned
+     */
+    Slot *getFreeSlot()
+    {
+        Slot *result = nullptr;
+        for (Slot &slot : slots)
+        {
+            if (!slot.used)
+            {
+                return &slot;
+            }
+            if (slot.refs == 0 && (!result || slot.lastUse < result->lastUse))
+            {
+                result = &slot;
+            }
+        }
+        return result;
+    }
+
+    GlTexture texture;
+
+    std::vector<Slot> slots;
+    // code point => cell
+    std::unordered_map<char32_t, int> cells;
+    uint64_t clock = 0;
+    Statistics statistics;
+
+#ifndef NO_FREETYPE
+    struct FreeTypeDeleter
+    {
+        void operator()(FT_Library library) const
+        {
+            FT_Done_FreeType(library);
+        }
+        void operator()(FT_Face face) const
+        {
+            FT_Done_Face(face);
+        }
+    };
+    // destroyed after the face
+    MmapFile fontFile;
+    std::unique_ptr<FT_LibraryRec_, FreeTypeDeleter> library;
+    std::unique_ptr<FT_FaceRec_, FreeTypeDeleter> face;
+#endif
+};
+
+RendererGlyphCache::RendererGlyphCache(const Config &config, size_t capacity)
+    : pimpl{std::make_unique<Impl>(config, capacity)}
+{
+}
+
+RendererGlyphCache::~RendererGlyphCache() = default;
+
+GlTexture &RendererGlyphCache::getTexture()
+{
+    return pimpl->texture;
+}
+
+int RendererGlyphCache::acquire(char32_t codePoint)
+{
+    // fast path, nothing pinned
+    if (codePoint >= 0x20 && codePoint < 0x7f)
+    {
+        return codePoint - 0x20;
+    }
+    // control characters
+    if (codePoint < 0x20)
+    {
+        return 0;
+    }
+
+    if (const auto found = pimpl->cells.find(codePoint); found != pimpl->cells.end())
+    {
+        Impl::Slot &slot = pimpl->slots[found->second - kAsciiCells];
+        ++slot.refs;
+        slot.lastUse = ++pimpl->clock;
+        ++pimpl->statistics.hits;
+        return found->second;
+    }
+
+    Impl::Slot *const slot = pimpl->getFreeSlot();
+    std::vector<uint8_t> sdf;
+    if (!slot || !pimpl->rasterize(codePoint, sdf))
+    {
+        ++pimpl->statistics.fallbacks;
+        return kFallbackCell;
+    }
+
+    if (slot->used)
+    {
+        pimpl->cells.erase(slot->codePoint);
+        ++pimpl->statistics.evictions;
+    }
+    const int cell = kAsciiCells + static_cast<int>(slot - pimpl->slots.data());
+    *slot = Impl::Slot{codePoint, 1, ++pimpl->clock, true};
+    pimpl->cells.emplace(codePoint, cell);
+    ++pimpl->statistics.misses;
+
+    // recorded with the frame when called by RendererText::set()
+    pimpl->texture.bind();
+    GlCommandBuffer::texSubImage2D(cell % kGlyphsPerLine * kGlyphWidth, cell / kGlyphsPerLine * kGlyphHeight,
+                                   kGlyphWidth, kGlyphHeight, sdf.data());
+    return cell;
+}
+
+void RendererGlyphCache::release(int cell)
+{
+    if (cell < kAsciiCells)
+    {
+        return;
+    }
+    Impl::Slot &slot = pimpl->slots[cell - kAsciiCells];
+    --slot.refs;
+    slot.lastUse = ++pimpl->clock;
+}
+
+RendererGlyphCache::Statistics RendererGlyphCache::getStatistics() const
+{
+    Statistics result = pimpl->statistics;
+    result.used = pimpl->cells.size();
+    result.capacity = pimpl->slots.size();
+    return result;
+}
+
+std::ostream &operator<<(std::ostream &str, const RendererGlyphCache::Statistics &statistics)
+{
+    return str << statistics.used << '/' << statistics.capacity << " glyphs cached, "
+               << statistics.hits << " hits, "
+               << statistics.misses << " misses, "
+               << statistics.evictions << " evictions, "
+               << statistics.fallbacks << " fallbacks";
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <iosfwd>
+#include <memory>
+
+class Config;
+class GlTexture;
+
+/**
+ * @brief Atlas of the glyphs of the OpenGL texts, as signed distance fields
+ *
+ * The texture is a grid of cells of kGlyphsPerLine columns:
+ * - the first cells hold the ASCII glyphs of font_sdf.dds: the cell of a character is c - 0x20, without any lookup
+ * - the next cells, up to the bottom of the texture, are a cache for the other code points: the first ones are still in
+ *   the rows of font_sdf.dds. They are rasterized from font.ttf on first use, then uploaded with glTexSubImage2D().
+ *   Each text pins its glyphs: when the cache is full, the least recently used glyph which is not displayed is replaced
+ *
+ * The memory is bounded by the texture, whatever the script. Without FreeType, without the glyph in the font, or when
+ * every cell is pinned, the glyph is replaced by '?'.
+ *
+ * Used by the thread recording the frames (RendererText::set()) and the thread owning the OpenGL context (creation of
+ * the texts), never at the same time
+ *
+ * @sa Renderer::runOnContext()
+ */
+class RendererGlyphCache
+{
+public:
+    struct Impl;
+
+    struct Statistics
+    {
+        size_t hits = 0;      ///< glyphs of the cache already rasterized
+        size_t misses = 0;    ///< glyphs rasterized and uploaded
+        size_t evictions = 0; ///< glyphs replaced by a miss
+        size_t fallbacks = 0; ///< glyphs drawn as '?'
+        size_t used = 0;      ///< cells of the cache holding a glyph
+        size_t capacity = 0;  ///< cells of the cache
+    };
+
+    static constexpr int kGlyphsPerLine = 14;
+    /// cells of the texture after the ASCII ones
+    static constexpr size_t kCapacity = 129;
+
+    /**
+     * @param capacity cells of the cache, at most kCapacity
+     * @throw std::runtime_error if font_sdf.dds is missing or invalid
+     */
+    explicit RendererGlyphCache(const Config &config, size_t capacity = kCapacity);
+    ~RendererGlyphCache();
+
+    GlTexture &getTexture();
+
+    /**
+     * Cell of the code point in the texture, rasterized and uploaded if needed. The glyph is pinned until release()
+     */
+    int acquire(char32_t codePoint);
+
+    /**
+     * The cell is not displayed anymore by the caller of acquire()
+     */
+    void release(int cell);
+
+    /**
+     * Index of the top left corner of the cell, as expected by print_text.vert. The other corners are +1 on the right
+     * and +kGlyphsPerLine + 1 below
+     */
+    static constexpr int getTextIndex(int cell)
+    {
+        return cell + cell / kGlyphsPerLine;
+    }
+
+    Statistics getStatistics() const;
+
+private:
+    std::unique_ptr<Impl> pimpl;
+};
+
+std::ostream &operator<<(std::ostream &str, const RendererGlyphCache::Statistics &statistics);
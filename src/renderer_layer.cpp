@@ -0,0 +1,198 @@
+#include "renderer_layer.hpp"
+
+#include "gl_command_buffer.hpp"
+#include "gl_framebuffer.hpp"
+#include "gl_shader.hpp"
+#include "gl_texture.hpp"
+#include "gl_vbo.hpp"
+#include "renderer_damage.hpp"
+#include "renderer_display_list.hpp"
+#include "renderer_software.hpp"
+#include "toolbox_gl.hpp"
+
+namespace
+{
+
+// the FBO's 1st line is at the bottom, unlike the DDS sprites
+constexpr GLfloat kFullScreenVertices[] = {
+    -1, 1, 0, 1,  // Position 0 + TexCoord 0
+    -1, -1, 0, 0, // Position 1 + TexCoord 1
+    1, -1, 1, 0,  // Position 2 + TexCoord 2
+    1, 1, 1, 1,   // Position 3 + TexCoord 3
+};
+
+} // namespace
+
+struct RendererLayer::Impl
+{
+    Impl(RendererDisplayList &content, RendererDamage &damage)
+        : content{content},
+          damage{damage},
+          damageItem{damage.createScreenItem()}
+    {
+    }
+    virtual ~Impl() = default;
+
+    virtual void print() = 0;
+
+    // not owned
+    RendererDisplayList &content;
+    RendererDamage &damage;
+
+    // owned
+    RendererDamage::Item damageItem;
+    bool valid = false;
+};
+
+namespace
+{
+
+struct LayerGl : RendererLayer::Impl
+{
+    LayerGl(GlProgram &program,
+            GlVboElementArray &vboIndices,
+            GLint position,
+            GLint textureCoord,
+            int width,
+            int height,
+            RendererDisplayList &content,
+            RendererDamage &damage)
+        : Impl{content, damage},
+          program{program},
+          vboIndices{vboIndices},
+          position{position},
+          textureCoord{textureCoord},
+          texture{static_cast<unsigned int>(width), static_cast<unsigned int>(height)},
+          framebuffer{texture},
+          vboVertices{kFullScreenVertices}
+    {
+    }
+
+    /**
+     * Render the content into the texture.
+     * The texture has the size of the screen so there is no need to change the viewport
+     */
+    void render()
+    {
+        framebuffer.bind();
+        GlCommandBuffer::clearColor();
+        // offscreen: only the layer itself is visible
+        damage.setTracking(false);
+        content.submit();
+        damage.setTracking(true);
+        GlFramebuffer::unbind();
+        valid = true;
+    }
+
+    void print() override
+    {
+        if (framebuffer.isComplete() == false)
+        {
+            content.submit();
+            return;
+        }
+
+        if (valid == false)
+        {
+            render();
+        }
+        damage.add(damageItem);
+
+        // opaque: no need to blend with the cleared screen
+        GlCommandBuffer::setBlend(false);
+        program.use();
+
+        vboVertices.bind();
+        vboVertices.draw<GLfloat>(position, 2, 0, 4);
+        vboVertices.draw<GLfloat>(textureCoord, 2, 2, 4);
+
+        texture.bind();
+        vboIndices.draw();
+        GlCommandBuffer::setBlend(true);
+    }
+
+    // not owned
+    GlProgram &program;
+    GlVboElementArray &vboIndices;
+    GLint position;
+    GLint textureCoord;
+
+    // owned
+    GlTexture texture;
+    GlFramebuffer framebuffer;
+    GlVboArrayStatic vboVertices;
+};
+
+struct LayerSoftware : RendererLayer::Impl
+{
+    LayerSoftware(RendererSoftware &software, RendererDisplayList &content, RendererDamage &damage)
+        : Impl{content, damage},
+          software{software},
+          canvas{software.getCanvas().getWidth(), software.getCanvas().getHeight()}
+    {
+    }
+
+    /**
+     * Draw the content into the canvas right now, out of the queue of the frame
+     */
+    void render()
+    {
+        const size_t first = software.getQueueSize();
+        // offscreen: only the layer itself is visible
+        damage.setTracking(false);
+        content.submit();
+        damage.setTracking(true);
+        software.render(first, canvas);
+        valid = true;
+    }
+
+    void print() override
+    {
+        if (valid == false)
+        {
+            render();
+        }
+        damage.add(damageItem);
+        software.drawCanvas(canvas);
+    }
+
+    // not owned
+    RendererSoftware &software;
+
+    // owned
+    SoftwareCanvas canvas;
+};
+
+} // namespace
+
+RendererLayer::RendererLayer(GlProgram &program,
+                             GlVboElementArray &vboIndices,
+                             int position,
+                             int textureCoord,
+                             int width,
+                             int height,
+                             RendererDisplayList &content,
+                             RendererDamage &damage)
+    : pimpl{std::make_unique<LayerGl>(program, vboIndices, position, textureCoord, width, height, content, damage)}
+{
+}
+
+RendererLayer::RendererLayer(RendererSoftware &software,
+                             RendererDisplayList &content,
+                             RendererDamage &damage)
+    : pimpl{std::make_unique<LayerSoftware>(software, content, damage)}
+{
+}
+
+RendererLayer::~RendererLayer() = default;
+
+void RendererLayer::invalidate()
+{
+    pimpl->valid = false;
+    ++pimpl->damageItem.version;
+}
+
+void RendererLayer::print()
+{
+    pimpl->print();
+}
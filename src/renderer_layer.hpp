@@ -0,0 +1,64 @@
+#pragma once
+
+#include <memory>
+
+class GlProgram;
+class GlVboElementArray;
+class RendererDamage;
+class RendererDisplayList;
+class RendererSoftware;
+
+/**
+ * @brief Static layer cached in a texture
+ *
+ * The content of a RendererDisplayList is rendered once into an offscreen texture (FBO), then each frame the
+ * texture is copied as a single full-screen quad. It replaces the clear of the screen: it must be printed 1st,
+ * under all the other elements.
+ *
+ * The layer is tracked as a single full-screen element, damaged at each invalidate().
+ *
+ * If the driver cannot render into a texture, the display list is submitted at each frame instead.
+ * With the software renderer, the content is cached in a SoftwareCanvas.
+ *
+ * created from Renderer
+ *
+ * @sa Renderer
+ */
+class RendererLayer
+{
+public:
+    struct Impl;
+    RendererLayer(GlProgram &program,
+                  GlVboElementArray &vboIndices,
+                  int position,
+                  int textureCoord,
+                  int width,
+                  int height,
+                  RendererDisplayList &content,
+                  RendererDamage &damage);
+
+    /**
+     * Drawn by the CPU
+     */
+    RendererLayer(RendererSoftware &software,
+                  RendererDisplayList &content,
+                  RendererDamage &damage);
+    ~RendererLayer();
+
+    /**
+     * Request to render again the content at the next print()
+     *
+     * To be called when an element of the content has changed
+     */
+    void invalidate();
+
+    /**
+     * Actually display the layer (call OpenGL to perform the display)
+     *
+     * The content is rendered into the texture (or the canvas) at the 1st call or after invalidate()
+     */
+    void print();
+
+private:
+    std::unique_ptr<Impl> pimpl;
+};
@@ -0,0 +1,459 @@
+#include "renderer_software.hpp"
+
+#include "config.hpp"
+#include "gl_texture_loader.hpp"
+#include "toolbox_gl.hpp"
+#include "toolbox_io.hpp"
+#include "toolbox_utf8.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+
+// same layout as in print_text.vert
+constexpr float kGlyphWidth = 18. / 256;
+constexpr float kGlyphHeight = 32. / 256;
+constexpr int kGlyphsPerLine = 256 / 18;
+constexpr int kIndicesPerLine = kGlyphsPerLine + 1;
+
+/**
+ * Pixels covered by a box, rounded outward
+ */
+Rect getCoveredRect(const SoftwareBox &box)
+{
+    const int x = std::floor(box.x);
+    const int y = std::floor(box.y);
+    return Rect{x, y, static_cast<int>(std::ceil(box.x + box.width)) - x, static_cast<int>(std::ceil(box.y + box.height)) - y};
+}
+
+/**
+ * Texture coordinates (s, t) of the normalized position (u, w) in the destination, w going down.
+ * s = s0 + su * u + sw * w, t = t0 + tu * u + tw * w
+ */
+struct Rotation
+{
+    float s0, su, sw;
+    float t0, tu, tw;
+};
+
+// clockwise, same corners as getVertices2D() in renderer.cpp
+constexpr Rotation kRotations[] = {
+    {0, 1, 0, 0, 0, 1},
+    {0, 0, 1, 1, -1, 0},
+    {1, -1, 0, 1, 0, -1},
+    {1, 0, -1, 0, 1, 0},
+};
+
+/**
+ * dst = src * alpha + dst * (1 - alpha), on each channel including the alpha, like OpenGL
+ */
+void blendSpan(uint8_t *dst, const uint8_t *src, size_t count)
+{
+    for (size_t i = 0; i < count; ++i, dst += 4, src += 4)
+    {
+        const unsigned int alpha = src[3];
+        for (int channel = 0; channel < 4; ++channel)
+        {
+            // exact round(value / 255)
+            const unsigned int value = src[channel] * alpha + dst[channel] * (255 - alpha) + 128;
+            dst[channel] = (value + (value >> 8)) >> 8;
+        }
+    }
+}
+
+/**
+ * Size in bytes of a canvas
+ */
+size_t getCanvasSize(int width, int height)
+{
+    if (width <= 0 || height <= 0)
+    {
+        throw std::runtime_error{"SoftwareCanvas: invalid size " + std::to_string(width) + 'x' + std::to_string(height)};
+    }
+    return width * height * 4;
+}
+
+void fillSpan(uint8_t *dst, const std::array<uint8_t, 4> &pixel, size_t count)
+{
+    for (size_t i = 0; i < count; ++i, dst += 4)
+    {
+        std::memcpy(dst, pixel.data(), pixel.size());
+    }
+}
+
+} // namespace
+
+SoftwareImage loadSoftwareImage(const Config &config, const char *filename)
+{
+    const GlTextureLoader loader{config.openTexture(filename), 1};
+    const GLenum format = loader.getGlFormat();
+    if (loader.getGlType() != GL_UNSIGNED_BYTE || (format != GL_RGB && format != GL_RGBA))
+    {
+        throw std::runtime_error{std::string{filename} + ": only the uncompressed RGB888 and RGBA8888 textures can be drawn by the CPU"};
+    }
+
+    SoftwareImage image;
+    image.width = loader.getMipmapWidth(0);
+    image.height = loader.getMipmapHeight(0);
+    image.pixels.resize(image.width * image.height * 4);
+
+    const auto src = reinterpret_cast<const uint8_t *>(loader.getMipmap(0));
+    if (format == GL_RGBA)
+    {
+        std::copy_n(src, image.pixels.size(), image.pixels.data());
+        return image;
+    }
+    for (int i = 0, imax = image.width * image.height; i < imax; ++i)
+    {
+        std::copy_n(src + i * 3, 3, &image.pixels[i * 4]);
+        image.pixels[i * 4 + 3] = 255;
+    }
+    return image;
+}
+
+// SoftwareCanvas
+
+SoftwareCanvas::SoftwareCanvas(int width, int height)
+    : width{width},
+      height{height},
+      pixels(getCanvasSize(width, height)),
+      span(width * 4)
+{
+}
+
+int SoftwareCanvas::getWidth() const
+{
+    return width;
+}
+
+int SoftwareCanvas::getHeight() const
+{
+    return height;
+}
+
+Rect SoftwareCanvas::getRect() const
+{
+    return Rect{0, 0, width, height};
+}
+
+const uint8_t *SoftwareCanvas::data() const
+{
+    return pixels.data();
+}
+
+std::array<uint8_t, 4> SoftwareCanvas::getPixel(int x, int y) const
+{
+    std::array<uint8_t, 4> pixel;
+    std::copy_n(&pixels[(y * width + x) * 4], pixel.size(), pixel.data());
+    return pixel;
+}
+
+void SoftwareCanvas::fill(const SoftwareColor &color, const Rect &clip)
+{
+    const Rect area = clip.intersected(getRect());
+    const std::array<uint8_t, 4> pixel{color[0], color[1], color[2], 255};
+    for (int y = area.y; y < area.y + area.height; ++y)
+    {
+        fillSpan(&pixels[(y * width + area.x) * 4], pixel, area.width);
+    }
+}
+
+void SoftwareCanvas::blit(const SoftwareImage &image, const SoftwareBox &source, const SoftwareBox &destination, int rotation90Degree, const Rect &clip)
+{
+    const Rect area = getCoveredRect(destination).intersected(clip).intersected(getRect());
+    if (area.empty() || image.width <= 0 || image.height <= 0)
+    {
+        return;
+    }
+
+    // the texel of a pixel is an affine function of its position: walk it in 16.16 fixed point
+    const Rotation &rotation = kRotations[rotation90Degree & 3];
+    const float dsdx = rotation.su / destination.width * source.width;
+    const float dtdx = rotation.tu / destination.width * source.height;
+    const float dsdy = -rotation.sw / destination.height * source.width;
+    const float dtdy = -rotation.tw / destination.height * source.height;
+    // texel of the center of the 1st pixel of area
+    const float u = (area.x + .5f - destination.x) / destination.width;
+    const float w = (destination.y + destination.height - (area.y + .5f)) / destination.height;
+    const float s = source.x + (rotation.s0 + rotation.su * u + rotation.sw * w) * source.width;
+    const float t = source.y + (rotation.t0 + rotation.tu * u + rotation.tw * w) * source.height;
+
+    static constexpr float kOne = 1 << 16;
+    const int32_t stepX[] = {static_cast<int32_t>(dsdx * kOne), static_cast<int32_t>(dtdx * kOne)};
+    const int32_t maxS = (image.width << 16) - 1;
+    const int32_t maxT = (image.height << 16) - 1;
+
+    for (int y = area.y; y < area.y + area.height; ++y)
+    {
+        const int line = y - area.y;
+        int32_t texelS = (s + line * dsdy) * kOne;
+        int32_t texelT = (t + line * dtdy) * kOne;
+
+        // gather the texels of the line, then blend them at once
+        uint8_t *texels = span.data();
+        for (int x = 0; x < area.width; ++x, texels += 4, texelS += stepX[0], texelT += stepX[1])
+        {
+            const int32_t texelX = std::clamp(texelS, 0, maxS) >> 16;
+            const int32_t texelY = std::clamp(texelT, 0, maxT) >> 16;
+            std::memcpy(texels, &image.pixels[(texelY * image.width + texelX) * 4], 4);
+        }
+        blendSpan(&pixels[(y * width + area.x) * 4], span.data(), area.width);
+    }
+}
+
+void SoftwareCanvas::fillQuad(const std::array<float, 8> &corners, const SoftwareColor &color, const Rect &clip)
+{
+    float left = corners[0];
+    float right = corners[0];
+    float bottom = corners[1];
+    float top = corners[1];
+    for (size_t i = 2; i < corners.size(); i += 2)
+    {
+        left = std::min(left, corners[i]);
+        right = std::max(right, corners[i]);
+        bottom = std::min(bottom, corners[i + 1]);
+        top = std::max(top, corners[i + 1]);
+    }
+    const Rect area = getCoveredRect(SoftwareBox{left, bottom, right - left, top - bottom}).intersected(clip).intersected(getRect());
+
+    const std::array<uint8_t, 4> pixel{color[0], color[1], color[2], 255};
+    for (int y = area.y; y < area.y + area.height; ++y)
+    {
+        // the quad is convex: the edges crossing the center of the line bound a single span
+        const float center = y + .5f;
+        float spanLeft = std::numeric_limits<float>::max();
+        float spanRight = std::numeric_limits<float>::lowest();
+        for (size_t i = 0; i < corners.size(); i += 2)
+        {
+            const size_t next = (i + 2) % corners.size();
+            const float x0 = corners[i];
+            const float y0 = corners[i + 1];
+            const float x1 = corners[next];
+            const float y1 = corners[next + 1];
+            if ((y0 <= center) != (y1 <= center))
+            {
+                const float x = x0 + (center - y0) * (x1 - x0) / (y1 - y0);
+                spanLeft = std::min(spanLeft, x);
+                spanRight = std::max(spanRight, x);
+            }
+        }
+
+        const int begin = std::max<int>(area.x, std::ceil(spanLeft - .5f));
+        const int end = std::min<int>(area.x + area.width, std::ceil(spanRight - .5f));
+        if (begin < end)
+        {
+            fillSpan(&pixels[(y * width + begin) * 4], pixel, end - begin);
+        }
+    }
+}
+
+void SoftwareCanvas::copy(const SoftwareCanvas &canvas, const Rect &clip)
+{
+    if (canvas.width != width || canvas.height != height)
+    {
+        throw std::runtime_error{"SoftwareCanvas: cannot copy a canvas of another size"};
+    }
+    const Rect area = clip.intersected(getRect());
+    for (int y = area.y; y < area.y + area.height; ++y)
+    {
+        const size_t offset = (y * width + area.x) * 4;
+        std::memcpy(&pixels[offset], &canvas.pixels[offset], area.width * 4);
+    }
+}
+
+// RendererSoftware
+
+namespace
+{
+
+/**
+ * Drawings per frame without any allocation: 1 per glyph, the main screen has less than 100
+ */
+constexpr size_t kReservedCommands = 256;
+
+/**
+ * @brief 1 queued drawing
+ */
+struct Command
+{
+    enum class Type
+    {
+        Image,
+        Quad,
+        Canvas,
+    };
+
+    Type type;
+    const SoftwareImage *image;
+    SoftwareBox source;
+    SoftwareBox destination;
+    int rotation90Degree;
+    std::array<float, 8> corners;
+    SoftwareColor color;
+    const SoftwareCanvas *canvas;
+};
+
+} // namespace
+
+struct RendererSoftware::Impl
+{
+    explicit Impl(const Config &config)
+        : clock{loadSoftwareImage(config, "clock.dds")},
+          arrow{loadSoftwareImage(config, "arrow.dds")},
+          font{loadSoftwareImage(config, "font.dds")},
+          frame{config.getDisplayWidth(), config.getDisplayHeight()}
+    {
+        commands.reserve(kReservedCommands);
+    }
+
+    void execute(const Command &command, SoftwareCanvas &canvas, const Rect &clip)
+    {
+        switch (command.type)
+        {
+        case Command::Type::Image:
+            canvas.blit(*command.image, command.source, command.destination, command.rotation90Degree, clip);
+            break;
+        case Command::Type::Quad:
+            canvas.fillQuad(command.corners, command.color, clip);
+            break;
+        case Command::Type::Canvas:
+            canvas.copy(*command.canvas, clip);
+            break;
+        }
+    }
+
+    SoftwareImage clock;
+    SoftwareImage arrow;
+    SoftwareImage font;
+    SoftwareCanvas frame;
+    // kept between the frames: no allocation once the largest frame has been queued
+    std::vector<Command> commands;
+};
+
+RendererSoftware::RendererSoftware(const Config &config)
+    : pimpl{std::make_unique<Impl>(config)}
+{
+}
+
+RendererSoftware::~RendererSoftware() = default;
+
+const SoftwareImage &RendererSoftware::getImage(Asset asset) const
+{
+    switch (asset)
+    {
+    case Asset::Clock:
+        return pimpl->clock;
+    case Asset::Arrow:
+        return pimpl->arrow;
+    default:
+        break;
+    }
+    throw std::runtime_error{"No such asset"};
+}
+
+const SoftwareCanvas &RendererSoftware::getCanvas() const
+{
+    return pimpl->frame;
+}
+
+void RendererSoftware::begin()
+{
+    pimpl->commands.clear();
+}
+
+void RendererSoftware::drawImage(const SoftwareImage &image, const SoftwareBox &source, const SoftwareBox &destination, int rotation90Degree)
+{
+    pimpl->commands.push_back(Command{Command::Type::Image, &image, source, destination, rotation90Degree, {}, {}, nullptr});
+}
+
+void RendererSoftware::drawText(const SoftwareBox &glyph, int numCol, int numRow, std::string_view text)
+{
+    const SoftwareImage &font = pimpl->font;
+    const float glyphWidth = font.width * kGlyphWidth;
+    const float glyphHeight = font.height * kGlyphHeight;
+
+    int col = 0;
+    int row = 0;
+    for (std::string_view remaining = text; !remaining.empty();)
+    {
+        // the font only has the ASCII glyphs
+        char32_t c = popUtf8(remaining);
+        if (c > 0x7e)
+        {
+            c = '?';
+        }
+        if (c == '\n' || col == numCol)
+        {
+            col = 0;
+            if (++row == numRow)
+            {
+                break;
+            }
+            if (c == '\n')
+            {
+                continue;
+            }
+        }
+
+        // the space is empty
+        if (c > 0x20)
+        {
+            const int glyphNumber = c - 0x20;
+            const int index = glyphNumber + glyphNumber / kGlyphsPerLine;
+            const SoftwareBox source{(index % kIndicesPerLine) * glyphWidth, (index / kIndicesPerLine) * glyphHeight, glyphWidth, glyphHeight};
+            const SoftwareBox destination{glyph.x + col * glyph.width, glyph.y - row * glyph.height, glyph.width, glyph.height};
+            drawImage(font, source, destination, 0);
+        }
+        ++col;
+    }
+}
+
+void RendererSoftware::drawQuad(const std::array<float, 8> &corners, const SoftwareColor &color)
+{
+    pimpl->commands.push_back(Command{Command::Type::Quad, nullptr, {}, {}, 0, corners, color, nullptr});
+}
+
+void RendererSoftware::drawCanvas(const SoftwareCanvas &canvas)
+{
+    pimpl->commands.push_back(Command{Command::Type::Canvas, nullptr, {}, {}, 0, {}, {}, &canvas});
+}
+
+size_t RendererSoftware::getQueueSize() const
+{
+    return pimpl->commands.size();
+}
+
+void RendererSoftware::render(size_t first, SoftwareCanvas &canvas)
+{
+    const Rect clip = canvas.getRect();
+    canvas.fill(SoftwareColor{}, clip);
+    for (size_t i = first; i < pimpl->commands.size(); ++i)
+    {
+        pimpl->execute(pimpl->commands[i], canvas, clip);
+    }
+    if (first < pimpl->commands.size())
+    {
+        pimpl->commands.erase(pimpl->commands.begin() + first, pimpl->commands.end());
+    }
+}
+
+void RendererSoftware::end(const Rect &damage)
+{
+    // outside of the damage, the frame is the same as the previous one
+    const Rect clip = damage.intersected(pimpl->frame.getRect());
+    if (clip.empty())
+    {
+        return;
+    }
+    pimpl->frame.fill(SoftwareColor{}, clip);
+    for (const Command &command : pimpl->commands)
+    {
+        pimpl->execute(command, pimpl->frame, clip);
+    }
+}
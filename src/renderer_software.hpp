@@ -0,0 +1,198 @@
+#pragma once
+
+#include "renderer.hpp"
+#include "toolbox_rect.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+class Config;
+
+/**
+ * @brief Opaque color of the software renderer: red, green, blue
+ */
+using SoftwareColor = std::array<uint8_t, 3>;
+
+/**
+ * @brief Rectangle in pixels, with sub-pixel precision. The origin is down left, like Rect
+ */
+struct SoftwareBox
+{
+    float x = 0;
+    float y = 0;
+    float width = 0;
+    float height = 0;
+};
+
+/**
+ * @brief RGBA8888 image read by the CPU. The 1st line is at the top, like in the DDS textures
+ */
+struct SoftwareImage
+{
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> pixels;
+};
+
+/**
+ * Decode the 1st mipmap of an uncompressed RGB888 or RGBA8888 DDS texture
+ *
+ * @param filename in the textures of the assets, see Config::openTexture()
+ * @throw std::runtime_error if the texture is in another format
+ */
+SoftwareImage loadSoftwareImage(const Config &config, const char *filename);
+
+/**
+ * @brief RGBA8888 pixels drawn by the CPU
+ *
+ * The 1st line is at the bottom, like the OpenGL surface read by glReadPixels(): the windows convert it with the
+ * same code. Every drawing is restricted to a clip rectangle, so that only the damaged part of the frame is drawn.
+ *
+ * The spans are plain loops over contiguous pixels, without any branch: the compiler vectorizes them.
+ */
+class SoftwareCanvas
+{
+public:
+    SoftwareCanvas(int width, int height);
+
+    int getWidth() const;
+    int getHeight() const;
+
+    /**
+     * The whole canvas
+     */
+    Rect getRect() const;
+
+    /**
+     * Width * height RGBA8888 pixels, 1st line at the bottom
+     */
+    const uint8_t *data() const;
+
+    /**
+     * RGBA of the pixel (x, y)
+     */
+    std::array<uint8_t, 4> getPixel(int x, int y) const;
+
+    /**
+     * Replace the pixels of clip with an opaque color
+     */
+    void fill(const SoftwareColor &color, const Rect &clip);
+
+    /**
+     * Draw a part of an image, blended with its alpha like glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA).
+     * The texels are sampled at the center of each pixel (nearest): same as OpenGL at the logical size, sharper
+     * when upscaled
+     *
+     * @param source part of the image, in texels from the top left corner
+     * @param destination where the source is stretched on the canvas
+     * @param rotation90Degree is in range [0,3]. Clockwise rotation of the source inside destination, like the
+     * texture coordinates of Renderer::renderSprite()
+     */
+    void blit(const SoftwareImage &image, const SoftwareBox &source, const SoftwareBox &destination, int rotation90Degree, const Rect &clip);
+
+    /**
+     * Fill a convex quad with an opaque color. The pixels whose center is inside are filled
+     *
+     * @param corners x0, y0, x1, y1... in pixels, in any winding order
+     */
+    void fillQuad(const std::array<float, 8> &corners, const SoftwareColor &color, const Rect &clip);
+
+    /**
+     * Copy the pixels of another canvas of the same size
+     */
+    void copy(const SoftwareCanvas &canvas, const Rect &clip);
+
+private:
+    int width;
+    int height;
+    std::vector<uint8_t> pixels;
+    // 1 line of texels to be blended
+    std::vector<uint8_t> span;
+};
+
+/**
+ * @brief Renderer without any GPU
+ *
+ * The elements created by Renderer draw themselves here instead of calling OpenGL. The drawings of a frame are
+ * queued, then executed by end() once the damaged part of the frame is known: the rest of the frame is kept as is.
+ *
+ * created by Renderer when the Window has no OpenGL context
+ *
+ * @sa Renderer
+ */
+class RendererSoftware
+{
+public:
+    struct Impl;
+
+    /**
+     * @param config for the assets and the size of the frame
+     */
+    explicit RendererSoftware(const Config &config);
+    ~RendererSoftware();
+
+    const SoftwareImage &getImage(Asset asset) const;
+
+    /**
+     * The frame: RGBA8888 display width * display height, 1st line at the bottom
+     */
+    const SoftwareCanvas &getCanvas() const;
+
+    /**
+     * Start a new frame
+     */
+    void begin();
+
+    /**
+     * Queue an image. @sa SoftwareCanvas::blit()
+     *
+     * @attention the image must outlive the frame
+     */
+    void drawImage(const SoftwareImage &image, const SoftwareBox &source, const SoftwareBox &destination, int rotation90Degree);
+
+    /**
+     * Queue a UTF-8 text, 1 glyph of the font per code point, '?' if not ASCII. The text continues on the next line
+     * after numCol code points, or at each '\n'
+     *
+     * @param glyph position of the 1st glyph, on the top left
+     */
+    void drawText(const SoftwareBox &glyph, int numCol, int numRow, std::string_view text);
+
+    /**
+     * Queue a convex quad. @sa SoftwareCanvas::fillQuad()
+     */
+    void drawQuad(const std::array<float, 8> &corners, const SoftwareColor &color);
+
+    /**
+     * Queue a copy of a canvas of the size of the frame
+     *
+     * @attention the canvas must outlive the frame
+     */
+    void drawCanvas(const SoftwareCanvas &canvas);
+
+    /**
+     * Number of drawings queued since begin()
+     */
+    size_t getQueueSize() const;
+
+    /**
+     * Execute the drawings queued after the 1st ones into another canvas instead of the frame
+     *
+     * @param first number of drawings which stay in the queue
+     */
+    void render(size_t first, SoftwareCanvas &canvas);
+
+    /**
+     * Execute the drawings of the frame, only inside the damaged part
+     *
+     * @param damage in pixels, like Renderer::getDamagedRect()
+     */
+    void end(const Rect &damage);
+
+private:
+    std::unique_ptr<Impl> pimpl;
+};
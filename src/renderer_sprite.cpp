@@ -3,17 +3,41 @@
 #include "gl_shader.hpp"
 #include "gl_texture.hpp"
 #include "gl_vbo.hpp"
+#include "renderer_display_list.hpp"
+#include "renderer_software.hpp"
 #include "toolbox_gl.hpp"
 
 struct RendererSprite::Impl
 {
-    Impl(GlProgram &program,
-         GlTexture &texture,
-         GlVboElementArray &vboIndices,
-         GLint position,
-         GLint textureCoord,
-         GlVboArrayStatic &&vboVertices)
-        : program{program},
+    Impl(RendererDamage &damage, const RendererDamage::Item &damageItem)
+        : damage{damage},
+          damageItem{damageItem}
+    {
+    }
+    virtual ~Impl() = default;
+
+    virtual void print() = 0;
+    virtual void record(RendererDisplayList &displayList) = 0;
+
+    RendererDamage &damage;
+    RendererDamage::Item damageItem;
+};
+
+namespace
+{
+
+struct SpriteGl : RendererSprite::Impl
+{
+    SpriteGl(GlProgram &program,
+             GlTexture &texture,
+             GlVboElementArray &vboIndices,
+             GLint position,
+             GLint textureCoord,
+             GlVboArrayStatic &&vboVertices,
+             RendererDamage &damage,
+             const RendererDamage::Item &damageItem)
+        : Impl{damage, damageItem},
+          program{program},
           texture{texture},
           vboIndices{vboIndices},
           position{position},
@@ -21,6 +45,31 @@ struct RendererSprite::Impl
           vboVertices{std::move(vboVertices)}
     {
     }
+
+    void print() override
+    {
+        damage.add(damageItem);
+        program.use();
+
+        vboVertices.bind();
+        vboVertices.draw<GLfloat>(position, 2, 0, 4);
+        vboVertices.draw<GLfloat>(textureCoord, 2, 2, 4);
+
+        texture.bind();
+        vboIndices.draw();
+    }
+
+    void record(RendererDisplayList &displayList) override
+    {
+        displayList.add(program,
+                        texture,
+                        vboIndices,
+                        RendererDisplayList::attrib(vboVertices, position, 2, 0, 4 * sizeof(GLfloat)),
+                        RendererDisplayList::attrib(vboVertices, textureCoord, 2, 2 * sizeof(GLfloat), 4 * sizeof(GLfloat)),
+                        damage,
+                        damageItem);
+    }
+
     // not owned
     GlProgram &program;
     GlTexture &texture;
@@ -32,13 +81,66 @@ struct RendererSprite::Impl
     GlVboArrayStatic vboVertices;
 };
 
+struct SpriteSoftware : RendererSprite::Impl
+{
+    SpriteSoftware(RendererSoftware &software,
+                   const SoftwareImage &image,
+                   const SoftwareBox &source,
+                   const SoftwareBox &destination,
+                   int rotation90Degree,
+                   RendererDamage &damage,
+                   const RendererDamage::Item &damageItem)
+        : Impl{damage, damageItem},
+          software{software},
+          image{image},
+          source{source},
+          destination{destination},
+          rotation90Degree{rotation90Degree}
+    {
+    }
+
+    void print() override
+    {
+        damage.add(damageItem);
+        software.drawImage(image, source, destination, rotation90Degree);
+    }
+
+    void record(RendererDisplayList &displayList) override
+    {
+        displayList.add([this] { print(); });
+    }
+
+    // not owned
+    RendererSoftware &software;
+    const SoftwareImage &image;
+
+    SoftwareBox source;
+    SoftwareBox destination;
+    int rotation90Degree;
+};
+
+} // namespace
+
 RendererSprite::RendererSprite(GlProgram &program,
                                GlTexture &texture,
                                GlVboElementArray &vboIndices,
                                int position,
                                int textureCoord,
-                               GlVboArrayStatic &&vboVertices)
-    : pimpl{std::make_unique<Impl>(program, texture, vboIndices, position, textureCoord, std::move(vboVertices))}
+                               GlVboArrayStatic &&vboVertices,
+                               RendererDamage &damage,
+                               const RendererDamage::Item &damageItem)
+    : pimpl{std::make_unique<SpriteGl>(program, texture, vboIndices, position, textureCoord, std::move(vboVertices), damage, damageItem)}
+{
+}
+
+RendererSprite::RendererSprite(RendererSoftware &software,
+                               const SoftwareImage &image,
+                               const SoftwareBox &source,
+                               const SoftwareBox &destination,
+                               int rotation90Degree,
+                               RendererDamage &damage,
+                               const RendererDamage::Item &damageItem)
+    : pimpl{std::make_unique<SpriteSoftware>(software, image, source, destination, rotation90Degree, damage, damageItem)}
 {
 }
 
@@ -46,12 +148,10 @@ RendererSprite::~RendererSprite() = default;
 
 void RendererSprite::print()
 {
-    pimpl->program.use();
-
-    pimpl->vboVertices.bind();
-    pimpl->vboVertices.draw<GLfloat>(pimpl->position, 2, 0, 4);
-    pimpl->vboVertices.draw<GLfloat>(pimpl->textureCoord, 2, 2, 4);
+    pimpl->print();
+}
 
-    pimpl->texture.bind();
-    pimpl->vboIndices.draw();
+void RendererSprite::record(RendererDisplayList &displayList)
+{
+    pimpl->record(displayList);
 }
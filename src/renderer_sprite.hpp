@@ -1,11 +1,17 @@
 #pragma once
 
+#include "renderer_damage.hpp"
+
 #include <memory>
 
 class GlProgram;
 class GlTexture;
 class GlVboArrayStatic;
 class GlVboElementArray;
+class RendererDisplayList;
+class RendererSoftware;
+struct SoftwareBox;
+struct SoftwareImage;
 
 /**
  * @brief Sprite to be displayed
@@ -23,7 +29,23 @@ public:
                    GlVboElementArray &vboIndices,
                    int position,
                    int textureCoord,
-                   GlVboArrayStatic &&vboVertices);
+                   GlVboArrayStatic &&vboVertices,
+                   RendererDamage &damage,
+                   const RendererDamage::Item &damageItem);
+
+    /**
+     * Drawn by the CPU
+     *
+     * @param source part of the image, in texels
+     * @param destination in pixels
+     */
+    RendererSprite(RendererSoftware &software,
+                   const SoftwareImage &image,
+                   const SoftwareBox &source,
+                   const SoftwareBox &destination,
+                   int rotation90Degree,
+                   RendererDamage &damage,
+                   const RendererDamage::Item &damageItem);
     ~RendererSprite();
 
     /**
@@ -31,6 +53,11 @@ public:
      */
     void print();
 
+    /**
+     * Record the display in a RendererDisplayList instead of calling OpenGL at each frame
+     */
+    void record(RendererDisplayList &displayList);
+
 private:
     std::unique_ptr<Impl> pimpl;
 };
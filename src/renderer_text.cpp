@@ -3,8 +3,14 @@
 #include "gl_shader.hpp"
 #include "gl_texture.hpp"
 #include "gl_vbo.hpp"
+#include "renderer_display_list.hpp"
+#include "renderer_glyph_cache.hpp"
+#include "renderer_software.hpp"
 #include "toolbox_gl.hpp"
+#include "toolbox_utf8.hpp"
 
+#include <limits>
+#include <string>
 #include <vector>
 
 namespace
@@ -36,8 +42,10 @@ struct RendererTextBase
     GlVboElementArray vboIndices;
 };
 
-void addGlyph(unsigned char *textIndices, int index, int nextLine)
+void addGlyph(unsigned char *textIndices, int cell)
 {
+    const int index = RendererGlyphCache::getTextIndex(cell);
+    const int nextLine = RendererGlyphCache::kGlyphsPerLine + 1;
     textIndices[0] = index;
     textIndices[1] = index + nextLine;
     textIndices[2] = index + nextLine + 1;
@@ -46,47 +54,298 @@ void addGlyph(unsigned char *textIndices, int index, int nextLine)
 
 } // namespace
 
-struct RendererText::Impl : RendererTextBase
-{
-    Impl(GlProgram &program,
-         GlTexture &texture,
-         GLint attribPositionOnScreen,
-         GLint attribTextIndice,
-         int glyphsPerLine,
-         GlVboArrayStatic &&vboVertices,
-         GlVboElementArray &&vboIndices)
-        : RendererTextBase{program, texture, attribPositionOnScreen, attribTextIndice, std::move(vboVertices), std::move(vboIndices)},
-          glyphsPerLine{glyphsPerLine},
+struct RendererText::Impl
+{
+    /**
+     * @param glyphs number of characters displayed: set() does not allocate up to this length
+     */
+    Impl(RendererDamage &damage, const RendererDamage::Item &damageItem, size_t glyphs)
+        : damage{damage},
+          damageItem{damageItem}
+    {
+        text.reserve(glyphs);
+    }
+    virtual ~Impl() = default;
+
+    /**
+     * The text has changed
+     */
+    virtual void update() = 0;
+    virtual void print() = 0;
+    virtual void record(RendererDisplayList &displayList) = 0;
+
+    RendererDamage &damage;
+    RendererDamage::Item damageItem;
+
+    // to avoid rebuilding
+    std::string text;
+};
+
+struct RendererTextStatic::Impl
+{
+    Impl(RendererDamage &damage, const RendererDamage::Item &damageItem)
+        : damage{damage},
+          damageItem{damageItem}
+    {
+    }
+    virtual ~Impl() = default;
+
+    virtual void print() = 0;
+    virtual void record(RendererDisplayList &displayList) = 0;
+
+    RendererDamage &damage;
+    RendererDamage::Item damageItem;
+};
+
+namespace
+{
+
+// RendererText
+
+struct TextGl : RendererText::Impl, RendererTextBase
+{
+    TextGl(GlProgram &program,
+           RendererGlyphCache &glyphCache,
+           GLint attribPositionOnScreen,
+           GLint attribTextIndice,
+           GlVboArrayStatic &&vboVertices,
+           GlVboElementArray &&vboIndices,
+           GlVboArrayDynamic &&vboTextIndices,
+           RendererDamage &damage,
+           const RendererDamage::Item &damageItem)
+        : Impl{damage, damageItem, static_cast<size_t>(vboIndices.triangles() / 2)},
+          RendererTextBase{program, glyphCache.getTexture(), attribPositionOnScreen, attribTextIndice, std::move(vboVertices), std::move(vboIndices)},
+          glyphCache{glyphCache},
           textIndices(this->vboIndices.triangles() * 2),
-          vboTextIndices{textIndices.data(), textIndices.size()}
+          cells(this->vboIndices.triangles() / 2),
+          previousCells(cells.size()),
+          vboTextIndices{std::move(vboTextIndices)}
+    {
+    }
+
+    ~TextGl() override
     {
-        textIndices.resize(this->vboIndices.triangles() * 2);
+        for (const int cell : cells)
+        {
+            glyphCache.release(cell);
+        }
+    }
+
+    void update() override
+    {
+        unsigned char *const indices = &textIndices.front();
+
+        // the glyphs still displayed are acquired before being released: they stay in the cache
+        cells.swap(previousCells);
+        std::string_view remaining = text;
+        for (size_t i = 0; i < cells.size(); ++i)
+        {
+            cells[i] = remaining.empty() ? 0 : glyphCache.acquire(popUtf8(remaining));
+            addGlyph(indices + (i << 2), cells[i]);
+        }
+        for (const int cell : previousCells)
+        {
+            glyphCache.release(cell);
+        }
+
+        vboTextIndices.bind();
+        vboTextIndices.set(textIndices.data(), textIndices.size());
+    }
+
+    void print() override
+    {
+        damage.add(damageItem);
+        program.use();
+
+        vboTextIndices.bind();
+        vboTextIndices.draw(attribTextIndice, 1);
+
+        vboVertices.bind();
+        vboVertices.draw(attribPositionOnScreen, 2);
+
+        texture.bind();
+        vboIndices.draw();
+    }
+
+    void record(RendererDisplayList &displayList) override
+    {
+        displayList.add(program,
+                        texture,
+                        vboIndices,
+                        RendererDisplayList::attrib(vboTextIndices, attribTextIndice, 1),
+                        RendererDisplayList::attrib(vboVertices, attribPositionOnScreen, 2),
+                        damage,
+                        damageItem);
     }
 
     // pimpl->vertices == 8x size of text (2 coord * 4 points)
     // pimpl->indices == 6x size of text (2 triangles)
     // pimpl->textIndices == 4x size of text  (4 points)
 
-    const int glyphsPerLine;
+    RendererGlyphCache &glyphCache;
 
-    // to avoid rebuilding
-    std::string text;
     std::vector<unsigned char> textIndices;
+    // 1 per glyph, pinned in glyphCache. The previous ones are only kept to avoid allocating
+    std::vector<int> cells;
+    std::vector<int> previousCells;
 
     // owned
     GlVboArrayDynamic vboTextIndices;
 };
 
+struct TextSoftware : RendererText::Impl
+{
+    TextSoftware(RendererSoftware &software,
+                 const SoftwareBox &glyph,
+                 int numCol,
+                 int numRow,
+                 RendererDamage &damage,
+                 const RendererDamage::Item &damageItem)
+        : Impl{damage, damageItem, static_cast<size_t>(numCol * numRow)},
+          software{software},
+          glyph{glyph},
+          numCol{numCol},
+          numRow{numRow}
+    {
+    }
+
+    void update() override
+    {
+    }
+
+    void print() override
+    {
+        damage.add(damageItem);
+        software.drawText(glyph, numCol, numRow, text);
+    }
+
+    void record(RendererDisplayList &displayList) override
+    {
+        displayList.add([this] { print(); });
+    }
+
+    // not owned
+    RendererSoftware &software;
+
+    SoftwareBox glyph;
+    int numCol;
+    int numRow;
+};
+
+// RendererTextStatic
+
+struct TextStaticGl : RendererTextStatic::Impl, RendererTextBase
+{
+    TextStaticGl(GlProgram &program,
+                 RendererGlyphCache &glyphCache,
+                 std::vector<int> &&cells,
+                 GLint attribPositionOnScreen,
+                 GLint attribTextIndice,
+                 GlVboArrayStatic &&vboVertices,
+                 GlVboElementArray &&vboIndices,
+                 RendererDamage &damage,
+                 const RendererDamage::Item &damageItem)
+        : Impl{damage, damageItem},
+          RendererTextBase{program, glyphCache.getTexture(), attribPositionOnScreen, attribTextIndice, std::move(vboVertices), std::move(vboIndices)},
+          glyphCache{glyphCache},
+          cells{std::move(cells)}
+    {
+    }
+
+    ~TextStaticGl() override
+    {
+        for (const int cell : cells)
+        {
+            glyphCache.release(cell);
+        }
+    }
+
+    void print() override
+    {
+        damage.add(damageItem);
+        program.use();
+
+        vboVertices.bind();
+        vboVertices.draw<GLfloat>(attribPositionOnScreen, 2, 0, 3);
+        vboVertices.draw<GLfloat>(attribTextIndice, 1, 2, 3);
+
+        texture.bind();
+        vboIndices.draw();
+    }
+
+    void record(RendererDisplayList &displayList) override
+    {
+        displayList.add(program,
+                        texture,
+                        vboIndices,
+                        RendererDisplayList::attrib(vboVertices, attribPositionOnScreen, 2, 0, 3 * sizeof(GLfloat)),
+                        RendererDisplayList::attrib(vboVertices, attribTextIndice, 1, 2 * sizeof(GLfloat), 3 * sizeof(GLfloat)),
+                        damage,
+                        damageItem);
+    }
+
+    RendererGlyphCache &glyphCache;
+    // pinned in glyphCache
+    std::vector<int> cells;
+};
+
+struct TextStaticSoftware : RendererTextStatic::Impl
+{
+    TextStaticSoftware(RendererSoftware &software,
+                       const SoftwareBox &glyph,
+                       const char *text,
+                       RendererDamage &damage,
+                       const RendererDamage::Item &damageItem)
+        : Impl{damage, damageItem},
+          software{software},
+          glyph{glyph},
+          text{text}
+    {
+    }
+
+    void print() override
+    {
+        damage.add(damageItem);
+        // only '\n' starts a new line
+        software.drawText(glyph, std::numeric_limits<int>::max(), std::numeric_limits<int>::max(), text);
+    }
+
+    void record(RendererDisplayList &displayList) override
+    {
+        displayList.add([this] { print(); });
+    }
+
+    // not owned
+    RendererSoftware &software;
+
+    SoftwareBox glyph;
+    std::string text;
+};
+
+} // namespace
+
 // RendererText
 
 RendererText::RendererText(GlProgram &program,
-                           GlTexture &texture,
+                           RendererGlyphCache &glyphCache,
                            int attribPositionOnScreen,
                            int attribTextIndice,
-                           int glyphsPerLine,
                            GlVboArrayStatic vboVertices,
-                           GlVboElementArray vboIndices)
-    : pimpl{std::make_unique<Impl>(program, texture, attribPositionOnScreen, attribTextIndice, glyphsPerLine, std::move(vboVertices), std::move(vboIndices))}
+                           GlVboElementArray vboIndices,
+                           GlVboArrayDynamic vboTextIndices,
+                           RendererDamage &damage,
+                           const RendererDamage::Item &damageItem)
+    : pimpl{std::make_unique<TextGl>(program, glyphCache, attribPositionOnScreen, attribTextIndice, std::move(vboVertices), std::move(vboIndices), std::move(vboTextIndices), damage, damageItem)}
+{
+}
+
+RendererText::RendererText(RendererSoftware &software,
+                           const SoftwareBox &glyph,
+                           int numCol,
+                           int numRow,
+                           RendererDamage &damage,
+                           const RendererDamage::Item &damageItem)
+    : pimpl{std::make_unique<TextSoftware>(software, glyph, numCol, numRow, damage, damageItem)}
 {
 }
 
@@ -94,61 +353,45 @@ RendererText::~RendererText() = default;
 
 void RendererText::set(const char *text)
 {
-    pimpl->vboTextIndices.bind();
     if (const std::string_view textView{text}; textView != pimpl->text)
     {
-        unsigned char *const textIndices = &pimpl->textIndices.front();
-
-        const int glyphsPerLine = pimpl->glyphsPerLine;
-        const int nextLine = glyphsPerLine + 1;
-        const auto uText = reinterpret_cast<const unsigned char *>(text);
-
-        unsigned int i = 0;
-        for (unsigned int imax = std::min<unsigned>(textView.size(), pimpl->textIndices.size() / 4); i < imax; ++i)
-        {
-            const int glyphNumber = uText[i] - 0x20;
-            const int index = glyphNumber + glyphNumber / glyphsPerLine;
-            addGlyph(textIndices + (i << 2), index, nextLine);
-        }
-
-        for (unsigned int imax = pimpl->textIndices.size() / 4; i < imax; ++i)
-        {
-            addGlyph(textIndices + (i << 2), 0, nextLine);
-        }
-
         pimpl->text = textView;
-        pimpl->vboTextIndices.set(pimpl->textIndices.data(), pimpl->textIndices.size());
+        ++pimpl->damageItem.version;
+        pimpl->update();
     }
 }
 
 void RendererText::print()
 {
-    pimpl->program.use();
-
-    pimpl->vboTextIndices.bind();
-    pimpl->vboTextIndices.draw(pimpl->attribTextIndice, 1);
-
-    pimpl->vboVertices.bind();
-    pimpl->vboVertices.draw(pimpl->attribPositionOnScreen, 2);
+    pimpl->print();
+}
 
-    pimpl->texture.bind();
-    pimpl->vboIndices.draw();
+void RendererText::record(RendererDisplayList &displayList)
+{
+    pimpl->record(displayList);
 }
 
 // RendererTextStatic
 
-struct RendererTextStatic::Impl : RendererTextBase
-{
-    using RendererTextBase::RendererTextBase;
-};
-
 RendererTextStatic::RendererTextStatic(GlProgram &program,
-                                       GlTexture &texture,
+                                       RendererGlyphCache &glyphCache,
+                                       std::vector<int> cells,
                                        int attribPositionOnScreen,
                                        int attribTextIndice,
                                        GlVboArrayStatic vboVertices,
-                                       GlVboElementArray vboIndices)
-    : pimpl{std::make_unique<Impl>(program, texture, attribPositionOnScreen, attribTextIndice, std::move(vboVertices), std::move(vboIndices))}
+                                       GlVboElementArray vboIndices,
+                                       RendererDamage &damage,
+                                       const RendererDamage::Item &damageItem)
+    : pimpl{std::make_unique<TextStaticGl>(program, glyphCache, std::move(cells), attribPositionOnScreen, attribTextIndice, std::move(vboVertices), std::move(vboIndices), damage, damageItem)}
+{
+}
+
+RendererTextStatic::RendererTextStatic(RendererSoftware &software,
+                                       const SoftwareBox &glyph,
+                                       const char *text,
+                                       RendererDamage &damage,
+                                       const RendererDamage::Item &damageItem)
+    : pimpl{std::make_unique<TextStaticSoftware>(software, glyph, text, damage, damageItem)}
 {
 }
 
@@ -156,12 +399,10 @@ RendererTextStatic::~RendererTextStatic() = default;
 
 void RendererTextStatic::print()
 {
-    pimpl->program.use();
-
-    pimpl->vboVertices.bind();
-    pimpl->vboVertices.draw<GLfloat>(pimpl->attribPositionOnScreen, 2, 0, 3);
-    pimpl->vboVertices.draw<GLfloat>(pimpl->attribTextIndice, 1, 2, 3);
+    pimpl->print();
+}
 
-    pimpl->texture.bind();
-    pimpl->vboIndices.draw();
+void RendererTextStatic::record(RendererDisplayList &displayList)
+{
+    pimpl->record(displayList);
 }
@@ -1,16 +1,23 @@
 #pragma once
 
+#include "renderer_damage.hpp"
+
 #include <memory>
+#include <vector>
 
 class GlProgram;
-class GlTexture;
+class GlVboArrayDynamic;
 class GlVboArrayStatic;
 class GlVboElementArray;
+class RendererDisplayList;
+class RendererGlyphCache;
+class RendererSoftware;
+struct SoftwareBox;
 
 /**
  * @brief Text box whose content may change
  *
- * created from Renderer
+ * The text is UTF-8, 1 glyph per code point. created from Renderer
  *
  * @sa Renderer
  */
@@ -19,16 +26,30 @@ class RendererText
 public:
     struct Impl;
     RendererText(GlProgram &program,
-                 GlTexture &texture,
+                 RendererGlyphCache &glyphCache,
                  int attribPositionOnScreen,
                  int attribTextIndice,
-                 int glyphsPerLine,
                  GlVboArrayStatic vboVertices,
-                 GlVboElementArray vboIndices);
+                 GlVboElementArray vboIndices,
+                 GlVboArrayDynamic vboTextIndices,
+                 RendererDamage &damage,
+                 const RendererDamage::Item &damageItem);
+
+    /**
+     * Drawn by the CPU
+     *
+     * @param glyph position of the top left glyph, in pixels
+     */
+    RendererText(RendererSoftware &software,
+                 const SoftwareBox &glyph,
+                 int numCol,
+                 int numRow,
+                 RendererDamage &damage,
+                 const RendererDamage::Item &damageItem);
     ~RendererText();
 
     /**
-     * Update the text in the textbox
+     * Update the text in the textbox. The glyphs missing from the atlas are rasterized
      */
     void set(const char *text);
 
@@ -37,6 +58,13 @@ public:
      */
     void print();
 
+    /**
+     * Record the display in a RendererDisplayList instead of calling OpenGL at each frame
+     *
+     * The text may still be updated with set() afterwards
+     */
+    void record(RendererDisplayList &displayList);
+
 private:
     std::unique_ptr<Impl> pimpl;
 };
@@ -44,7 +72,7 @@ private:
 /**
  * @brief Unmutable text box
  *
- * created from Renderer
+ * The text is UTF-8, 1 glyph per code point. created from Renderer
  *
  * @sa Renderer
  */
@@ -52,12 +80,29 @@ class RendererTextStatic
 {
 public:
     struct Impl;
+    /**
+     * @param cells of the glyphs, acquired from the cache: released at destruction time
+     */
     RendererTextStatic(GlProgram &program,
-                       GlTexture &texture,
+                       RendererGlyphCache &glyphCache,
+                       std::vector<int> cells,
                        int attribPositionOnScreen,
                        int attribTextIndice,
                        GlVboArrayStatic vboVertices,
-                       GlVboElementArray vboIndices);
+                       GlVboElementArray vboIndices,
+                       RendererDamage &damage,
+                       const RendererDamage::Item &damageItem);
+
+    /**
+     * Drawn by the CPU
+     *
+     * @param glyph position of the top left glyph, in pixels
+     */
+    RendererTextStatic(RendererSoftware &software,
+                       const SoftwareBox &glyph,
+                       const char *text,
+                       RendererDamage &damage,
+                       const RendererDamage::Item &damageItem);
     ~RendererTextStatic();
 
     /**
@@ -65,6 +110,11 @@ public:
      */
     void print();
 
+    /**
+     * Record the display in a RendererDisplayList instead of calling OpenGL at each frame
+     */
+    void record(RendererDisplayList &displayList);
+
 private:
     std::unique_ptr<Impl> pimpl;
 };
@@ -0,0 +1,179 @@
+#include "renderer_thread.hpp"
+
+#include "gl_command_buffer.hpp"
+#include "toolbox_gl.hpp"
+#include "window.hpp"
+
+#include <array>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+struct RendererThread::Impl
+{
+    /**
+     * @brief Recorded by the logic thread, then displayed by the render thread
+     */
+    struct Frame
+    {
+        GlCommandBuffer commands;
+        Rect damage;
+        bool ready = false;
+    };
+
+    /**
+     * Display (or drop if window is nullptr) the next frame, running the tasks meanwhile
+     */
+    bool next(Window *window)
+    {
+        std::unique_lock lock{mutex};
+        for (;;)
+        {
+            Frame &frame = frames[displayIdx];
+            condition.wait(lock, [&] { return stopped || frame.ready || task; });
+
+            // the frames recorded before the task may use the objects it destroys
+            if (frame.ready)
+            {
+                lock.unlock();
+                if (window)
+                {
+                    window->begin();
+                    frame.commands.replay();
+                    glCheckError();
+                    window->setDamage(frame.damage);
+                    window->end();
+                }
+                lock.lock();
+                frame.ready = false;
+                displayIdx = (displayIdx + 1) % frames.size();
+                condition.notify_all();
+                return true;
+            }
+
+            if (task && !running)
+            {
+                running = true;
+                lock.unlock();
+                try
+                {
+                    (*task)();
+                }
+                catch (...)
+                {
+                    taskError = std::current_exception();
+                }
+                lock.lock();
+                running = false;
+                task = nullptr;
+                condition.notify_all();
+                continue;
+            }
+
+            return false;
+        }
+    }
+
+    const std::thread::id renderThread = std::this_thread::get_id();
+
+    std::array<Frame, 2> frames;
+    size_t recordIdx = 0;
+    size_t displayIdx = 0;
+    // only used by the logic thread
+    std::optional<GlCommandBuffer::Recording> recording;
+
+    const std::function<void()> *task = nullptr;
+    std::exception_ptr taskError;
+    bool running = false;
+    bool stopped = false;
+
+    std::mutex mutex;
+    std::condition_variable condition;
+};
+
+RendererThread::RendererThread()
+    : pimpl{std::make_unique<Impl>()}
+{
+}
+
+RendererThread::~RendererThread() = default;
+
+bool RendererThread::beginFrame()
+{
+    std::unique_lock lock{pimpl->mutex};
+    Impl::Frame &frame = pimpl->frames[pimpl->recordIdx];
+    pimpl->condition.wait(lock, [&] { return pimpl->stopped || !frame.ready; });
+    if (pimpl->stopped)
+    {
+        return false;
+    }
+
+    frame.commands.clear();
+    pimpl->recording.emplace(frame.commands);
+    return true;
+}
+
+void RendererThread::endFrame(const Rect &damage)
+{
+    pimpl->recording.reset();
+    {
+        std::lock_guard lock{pimpl->mutex};
+        Impl::Frame &frame = pimpl->frames[pimpl->recordIdx];
+        frame.damage = damage;
+        frame.ready = true;
+        pimpl->recordIdx = (pimpl->recordIdx + 1) % pimpl->frames.size();
+    }
+    pimpl->condition.notify_all();
+}
+
+void RendererThread::invoke(const std::function<void()> &task)
+{
+    if (std::this_thread::get_id() == pimpl->renderThread)
+    {
+        task();
+        return;
+    }
+
+    std::unique_lock lock{pimpl->mutex};
+    if (pimpl->stopped)
+    {
+        throw std::runtime_error{"The render thread is stopped"};
+    }
+    pimpl->task = &task;
+    pimpl->condition.notify_all();
+    // the task is never abandoned while it runs: it refers to the caller's stack
+    pimpl->condition.wait(lock, [&] { return pimpl->task == nullptr || (pimpl->stopped && !pimpl->running); });
+
+    if (pimpl->task)
+    {
+        pimpl->task = nullptr;
+        throw std::runtime_error{"The render thread is stopped"};
+    }
+    if (pimpl->taskError)
+    {
+        std::rethrow_exception(std::exchange(pimpl->taskError, nullptr));
+    }
+}
+
+bool RendererThread::renderFrame(Window &window)
+{
+    return pimpl->next(&window);
+}
+
+bool RendererThread::dropFrame()
+{
+    return pimpl->next(nullptr);
+}
+
+void RendererThread::stop()
+{
+    {
+        std::lock_guard lock{pimpl->mutex};
+        pimpl->stopped = true;
+    }
+    pimpl->condition.notify_all();
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "toolbox_rect.hpp"
+
+#include <functional>
+#include <memory>
+
+class Window;
+
+/**
+ * @brief Double buffered frames between a logic thread, which records them, and the render thread, which owns the
+ * OpenGL context and the Window
+ *
+ * The render thread is the one which created the RendererThread. The logic thread records frame N+1 in a
+ * GlCommandBuffer while the render thread replays frame N and waits for the Window: a slow glFinish() or buffer swap
+ * does not delay the logic (events, audio, sensors).
+ *
+ * @sa GlCommandBuffer
+ */
+class RendererThread
+{
+public:
+    struct Impl;
+
+    RendererThread();
+    ~RendererThread();
+
+    /**
+     * Wait for a free frame, then record the OpenGL calls of the current thread in it until endFrame()
+     *
+     * To be called by the logic thread
+     * @return false if stopped: nothing is recorded
+     */
+    bool beginFrame();
+
+    /**
+     * The frame is ready to be displayed with this damage
+     *
+     * To be called by the logic thread
+     */
+    void endFrame(const Rect &damage);
+
+    /**
+     * Run the task on the render thread once the recorded frames are displayed, and wait for it. The exceptions are
+     * forwarded. Run right away when called by the render thread
+     *
+     * @throw std::runtime_error if stopped
+     */
+    void invoke(const std::function<void()> &task);
+
+    /**
+     * Wait for the next recorded frame and display it, running the invoked tasks meanwhile
+     *
+     * To be called by the render thread
+     * @return false if stopped
+     */
+    bool renderFrame(Window &window);
+
+    /**
+     * Same as renderFrame(), but the frame is not displayed, e.g. while quitting
+     */
+    bool dropFrame();
+
+    /**
+     * Wake up both threads: beginFrame() and invoke() fail from now on, renderFrame() returns false once the pending
+     * frames and task are done
+     */
+    void stop();
+
+private:
+    std::unique_ptr<Impl> pimpl;
+};
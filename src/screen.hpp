@@ -31,17 +31,24 @@ public:
     virtual ~Screen() = 0;
 
     /**
-     * Allocate all the data needed for the display.
-     * This method is called when the Screen becomes active
+     * Allocate all the data needed for the display, unless it is still warm.
+     * This method is called when the Screen becomes active. The state of the interface (selected alarm, field...)
+     * starts over, even when the data is warm
      */
     virtual void enter() = 0;
 
     /**
-     * Deallocate all the data needed for the display.
-     * This method is called when the Screen becomes inactive
+     * This method is called when the Screen becomes inactive.
+     * The data is kept warm for the next enter(), until release()
      */
     virtual void leave() = 0;
 
+    /**
+     * Deallocate all the data needed for the display.
+     * This method is called on an inactive Screen, by the ScreenFactory when over its memory budget
+     */
+    virtual void release() = 0;
+
     /**
      * Called at each frame on the active screen
      */
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Usage of the warm screens
+ */
+struct ScreenCacheStatistics
+{
+    size_t hits = 0;      ///< enter() on a warm screen
+    size_t misses = 0;    ///< enter() which allocated the screen
+    size_t evictions = 0; ///< screens released over the budget
+    size_t warm = 0;      ///< allocated screens, the current one included
+    size_t gpuMemory = 0; ///< bytes held on the GPU by the warm inactive screens
+
+    float getHitRate() const
+    {
+        const size_t total = hits + misses;
+        return total ? static_cast<float>(hits) / total : 0;
+    }
+};
+
+/**
+ * @brief Keeps the inactive screens warm, the least recently used first released over the GPU memory budget
+ *
+ * T provides enter(), leave() and release(), like Screen. enter() and release() are called through runOnContext, on
+ * the thread of the rendering context. The GPU memory of a screen is measured there, as the growth of getGpuMemory()
+ * during its first enter()
+ */
+template <typename T>
+class ScreenCache
+{
+public:
+    /// run a task on the thread of the rendering context, like Renderer::runOnContext()
+    using RunOnContext = std::function<void(const std::function<void()> &)>;
+    /// bytes allocated on the GPU, like Renderer::getGpuMemory()
+    using GetGpuMemory = std::function<size_t()>;
+
+    /**
+     * @attention the screens are not owned. Make sure they stay valid
+     */
+    ScreenCache(std::vector<T *> screens, RunOnContext runOnContext, GetGpuMemory getGpuMemory)
+        : screens{std::move(screens)},
+          entries(this->screens.size()),
+          runOnContext{std::move(runOnContext)},
+          getGpuMemory{std::move(getGpuMemory)}
+    {
+    }
+
+    /**
+     * Leave the current screen and enter screens[idx]. Then the least recently used inactive screens are released
+     * until the budget, in bytes, is met. A budget of 0 releases every inactive screen
+     */
+    void setCurrent(size_t idx, size_t gpuBudget)
+    {
+        if (current)
+        {
+            screens[*current]->leave();
+        }
+
+        Entry &entry = entries[idx];
+        T *const screen = screens[idx];
+        runOnContext([&] {
+            const size_t gpuMemory = getGpuMemory();
+            screen->enter();
+            if (entry.warm)
+            {
+                ++statistics.hits;
+            }
+            else
+            {
+                ++statistics.misses;
+                entry.warm = true;
+                entry.gpuMemory = getGrowth(gpuMemory, getGpuMemory());
+            }
+        });
+        entry.lastUse = ++uses;
+        current = idx;
+
+        evict(gpuBudget);
+    }
+
+    std::optional<size_t> getCurrent() const
+    {
+        return current;
+    }
+
+    /**
+     * Release all the inactive screens
+     */
+    void clear()
+    {
+        for (size_t idx = 0; idx < entries.size(); ++idx)
+        {
+            if (isInactive(idx))
+            {
+                release(idx);
+            }
+        }
+    }
+
+    ScreenCacheStatistics getStatistics() const
+    {
+        ScreenCacheStatistics result = statistics;
+        for (size_t idx = 0; idx < entries.size(); ++idx)
+        {
+            const Entry &entry = entries[idx];
+            result.warm += entry.warm;
+            if (isInactive(idx))
+            {
+                result.gpuMemory += entry.gpuMemory;
+            }
+        }
+        return result;
+    }
+
+private:
+    /**
+     * @brief Cache state of a screen
+     */
+    struct Entry
+    {
+        bool warm = false;
+        uint64_t lastUse = 0;
+        size_t gpuMemory = 0; ///< measured at the allocation
+    };
+
+    static size_t getGrowth(size_t before, size_t after)
+    {
+        return after > before ? after - before : 0;
+    }
+
+    bool isInactive(size_t idx) const
+    {
+        return entries[idx].warm && current != idx;
+    }
+
+    void release(size_t idx)
+    {
+        T *const screen = screens[idx];
+        runOnContext([screen] { screen->release(); });
+        entries[idx] = Entry{};
+    }
+
+    void evict(size_t gpuBudget)
+    {
+        for (;;)
+        {
+            const ScreenCacheStatistics held = getStatistics();
+            if (held.warm <= 1 || (gpuBudget != 0 && held.gpuMemory <= gpuBudget))
+            {
+                return;
+            }
+
+            size_t oldest = entries.size();
+            for (size_t idx = 0; idx < entries.size(); ++idx)
+            {
+                if (isInactive(idx) && (oldest == entries.size() || entries[idx].lastUse < entries[oldest].lastUse))
+                {
+                    oldest = idx;
+                }
+            }
+            release(oldest);
+            ++statistics.evictions;
+        }
+    }
+
+    std::vector<T *> screens;
+    std::vector<Entry> entries;
+    RunOnContext runOnContext;
+    GetGpuMemory getGpuMemory;
+    std::optional<size_t> current;
+    uint64_t uses = 0;
+    ScreenCacheStatistics statistics;
+};
@@ -9,24 +9,50 @@
 #include "screen_set_date.hpp"
 #include "screen_set_sensor.hpp"
 
+#include "config.hpp"
+#include "context.hpp"
+#include "renderer.hpp"
+
+#include <algorithm>
+#include <ostream>
+
+namespace
+{
+
+size_t getBudget(int kb)
+{
+    return static_cast<size_t>(std::max(kb, 0)) * 1024;
+}
+
+} // namespace
+
 struct ScreenFactory::Impl
 {
     explicit Impl(Context &context)
-        : main{context},
+        : context{context},
+          main{context},
           setAlarm{context},
           setAlarmFile{context},
           setSensor{context},
           setDate{context},
-          handleConfig{context}
+          handleConfig{context},
+          // in the order of ScreenType. The context is not fully built yet: the renderer is got at each call
+          cache{{&main, &setAlarm, &setAlarmFile, &setDate, &setSensor, &handleConfig},
+                [&context](const std::function<void()> &task) { context.getRenderer().runOnContext(task); },
+                [&context] { return context.getRenderer().getGpuMemory(); }}
     {
     }
 
+    Context &context;
+
     ScreenMain main;
     ScreenSetAlarm setAlarm;
     ScreenSetAlarmFile setAlarmFile;
     ScreenSetSensor setSensor;
     ScreenSetDate setDate;
     ScreenHandleConfig handleConfig;
+
+    ScreenCache<Screen> cache;
 };
 
 ScreenFactory::ScreenFactory(Context &context)
@@ -59,3 +85,42 @@ Screen *ScreenFactory::get(ScreenType type)
 
     return nullptr;
 }
+
+bool ScreenFactory::setCurrent(ScreenType type)
+{
+    if (!get(type))
+    {
+        return false;
+    }
+
+    const Config &config = pimpl->context.getConfig();
+    pimpl->cache.setCurrent(static_cast<size_t>(type), getBudget(config.getScreenCacheGpuKb()));
+    return true;
+}
+
+ScreenType ScreenFactory::getCurrent() const
+{
+    return ScreenType(pimpl->cache.getCurrent().value_or(static_cast<size_t>(ScreenType::Main)));
+}
+
+void ScreenFactory::clear()
+{
+    pimpl->cache.clear();
+}
+
+ScreenFactory::Statistics ScreenFactory::getStatistics() const
+{
+    return pimpl->cache.getStatistics();
+}
+
+std::ostream &ScreenFactory::toStream(std::ostream &str) const
+{
+    const Config &config = pimpl->context.getConfig();
+    const Statistics statistics = getStatistics();
+    str << "Screen cache: " << statistics.warm << " warm, hits " << statistics.hits
+        << ", misses " << statistics.misses
+        << ", evictions " << statistics.evictions
+        << ", hit rate " << static_cast<int>(statistics.getHitRate() * 100) << "%"
+        << ", held GPU " << statistics.gpuMemory / 1024 << '/' << config.getScreenCacheGpuKb() << " kB\n";
+    return str;
+}
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "screen_cache.hpp"
+
+#include <iosfwd>
 #include <memory>
 
 class Context;
@@ -18,18 +21,47 @@ enum class ScreenType
 /**
  * @brief Factory for Screen. All screens are pre-allocated at startup
  *
+ * The inactive screens keep their data warm, least recently used first released, within the budget of
+ * Config::getScreenCacheGpuKb()
+ *
  * @sa Screen
+ * @sa ScreenCache
  */
 class ScreenFactory
 {
 public:
     struct Impl;
 
+    using Statistics = ScreenCacheStatistics;
+
     ScreenFactory(Context &context);
     ~ScreenFactory();
 
     Screen *get(ScreenType type);
 
+    /**
+     * Leave the current screen, then enter the new one. The inactive screens are released over the budget
+     *
+     * @return false if the type is unknown, the current screen is unchanged
+     */
+    bool setCurrent(ScreenType type);
+
+    ScreenType getCurrent() const;
+
+    /**
+     * Release all the inactive screens, e.g. when the config they are built from changes
+     */
+    void clear();
+
+    Statistics getStatistics() const;
+
+    friend std::ostream &operator<<(std::ostream &str, const ScreenFactory &factory)
+    {
+        return factory.toStream(str);
+    }
+
 private:
+    std::ostream &toStream(std::ostream &str) const;
+
     std::unique_ptr<Impl> pimpl;
 };
@@ -3,6 +3,8 @@
 #include "config.hpp"
 #include "context.hpp"
 #include "renderer.hpp"
+#include "renderer_display_list.hpp"
+#include "renderer_layer.hpp"
 #include "renderer_text.hpp"
 #include "toolbox_i18n.hpp"
 
@@ -11,13 +13,19 @@ struct ScreenHandleConfig::Impl
     explicit Impl(Renderer &renderer)
         : previousScreen{renderer.renderStaticText(kMargin, renderer.getHeight() - kMargin, _("Sensor"), Position::UpLeft, 16)},
           save{renderer.renderStaticText(kMargin, renderer.getHeight() / 2, _("Save  \nConfig"), Position::Left, 16)},
-          load{renderer.renderStaticText(renderer.getWidth() - kMargin, renderer.getHeight() / 2, _("  Load\nConfig"), Position::Right, 16)}
+          load{renderer.renderStaticText(renderer.getWidth() - kMargin, renderer.getHeight() / 2, _("  Load\nConfig"), Position::Right, 16)},
+          staticLayer{renderer.renderLayer(displayList)}
     {
+        previousScreen.record(displayList);
+        save.record(displayList);
+        load.record(displayList);
     }
 
     RendererTextStatic previousScreen;
     RendererTextStatic save;
     RendererTextStatic load;
+    RendererDisplayList displayList;
+    RendererLayer staticLayer;
 };
 
 ScreenHandleConfig::ScreenHandleConfig(Context &ctx)
@@ -29,19 +37,24 @@ ScreenHandleConfig::~ScreenHandleConfig() = default;
 
 void ScreenHandleConfig::enter()
 {
-    pimpl = std::make_unique<Impl>(ctx.getRenderer());
+    if (!pimpl)
+    {
+        pimpl = std::make_unique<Impl>(ctx.getRenderer());
+    }
 }
 
 void ScreenHandleConfig::leave()
+{
+}
+
+void ScreenHandleConfig::release()
 {
     pimpl = nullptr;
 }
 
 void ScreenHandleConfig::run(const Clock::time_point &)
 {
-    pimpl->previousScreen.print();
-    pimpl->save.print();
-    pimpl->load.print();
+    pimpl->staticLayer.print();
 }
 
 void ScreenHandleConfig::handleClick(Position position)
@@ -5,6 +5,8 @@
 #include "context.hpp"
 #include "renderer.hpp"
 #include "renderer_clock.hpp"
+#include "renderer_display_list.hpp"
+#include "renderer_layer.hpp"
 #include "renderer_sprite.hpp"
 #include "renderer_text.hpp"
 #include "sensor.hpp"
@@ -32,7 +34,7 @@ constexpr int kThermalSize = 7;
 struct ScreenMain::Impl
 {
     explicit Impl(const Config &config, Renderer &renderer)
-        : clock{config, Renderer::getWidth(), Renderer::getHeight(), 120, 120,
+        : clock{config, renderer, Renderer::getWidth(), Renderer::getHeight(), 120, 120,
                 .7, .04,
                 .87, .025,
                 .87, .015},
@@ -41,11 +43,15 @@ struct ScreenMain::Impl
           timeText{renderer.renderText(kClockPosX, kClockPosY - 25, config.displaySeconds() ? 8 : 5, 1, Position::Up)},
           alarmText{renderer.renderText(Renderer::getWidth() - kTextMargin, kTextMargin, 8, 2, Position::DownRight, 16)},
           thermalText{renderer.renderText(Renderer::getWidth() - kTextMargin, Renderer::getHeight() - kTextMargin, kThermalSize, 1, Position::UpRight, 16)},
+          staticLayer{renderer.renderLayer(staticDisplayList)},
           dow{_("Sun"), _("Mon"), _("Tue"), _("Wed"), _("Thu"), _("Fri"), _("Sat")},
           mon{_("Jan"), _("Feb"), _("Mar"), _("Apr"), _("May"), _("Jun"), _("Jul"), _("Aug"), _("Sep"), _("Oct"), _("Nov"), _("Dec")},
           alarmHHMM{_("   Alarm   %02d:%02d")},
           alarmRunning{_("   Alarmrunning")}
     {
+        clockSprite.record(staticDisplayList);
+        dateText.record(displayList);
+        timeText.record(displayList);
     }
 
     void refreshTime(time_t timeSinceEpoch, bool displaySeconds)
@@ -111,6 +117,9 @@ struct ScreenMain::Impl
     RendererText timeText;
     RendererText alarmText;
     RendererText thermalText;
+    RendererDisplayList staticDisplayList;
+    RendererLayer staticLayer;
+    RendererDisplayList displayList;
     time_t savedTimeSinceEpoch = 0;
     std::optional<Clock::time_point> savedNextAlarm = Clock::from_time_t(0);
     float savedThermalValue = -1000;
@@ -130,11 +139,18 @@ ScreenMain::~ScreenMain() = default;
 
 void ScreenMain::enter()
 {
-    pimpl = std::make_unique<Impl>(ctx.getConfig(),
-                                   ctx.getRenderer());
+    if (!pimpl)
+    {
+        pimpl = std::make_unique<Impl>(ctx.getConfig(),
+                                       ctx.getRenderer());
+    }
 }
 
 void ScreenMain::leave()
+{
+}
+
+void ScreenMain::release()
 {
     pimpl = nullptr;
 }
@@ -143,6 +159,9 @@ void ScreenMain::run(const Clock::time_point &time)
 {
     pimpl->refreshTime(getTimeSinceEpoch(time), ctx.getConfig().displaySeconds());
 
+    pimpl->staticLayer.print();
+    pimpl->displayList.submit();
+
     if (const auto &alarm = ctx.getAlarm(); alarm.isActive())
     {
         pimpl->refreshAlarm(alarm);
@@ -155,10 +174,6 @@ void ScreenMain::run(const Clock::time_point &time)
         pimpl->thermalText.print();
     }
 
-    pimpl->clockSprite.print();
-    pimpl->dateText.print();
-    pimpl->timeText.print();
-
     const struct tm localTime = getLocalTime(time);
     pimpl->clock.draw(localTime.tm_hour,
                       localTime.tm_min,
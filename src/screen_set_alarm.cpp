@@ -5,6 +5,8 @@
 #include "config_alarm.hpp"
 #include "context.hpp"
 #include "renderer.hpp"
+#include "renderer_display_list.hpp"
+#include "renderer_layer.hpp"
 #include "renderer_sprite.hpp"
 #include "renderer_text.hpp"
 #include "toolbox_i18n.hpp"
@@ -33,8 +35,22 @@ struct ScreenSetAlarm::Impl
           underline{renderer.renderText(renderer.getWidth() / 2, renderer.getHeight() / 2, 5, 1, Position::Up)},
           alarmCounter{renderer.renderText(renderer.getWidth() / 2, renderer.getHeight() * 3 / 4, 20, 1, Position::Up, 16)},
           alarmTime{renderer.renderText(renderer.getWidth() / 2, renderer.getHeight() / 2, 5, 1, Position::Center)},
+          staticLayer{renderer.renderLayer(displayList)},
           active{_(" Alarm %d - Disabled"), _(" Alarm %d - Enabled")}
     {
+        previousScreen.record(displayList);
+        nextScreen.record(displayList);
+        addAlarm.record(displayList);
+
+        delAlarm.record(alarmDisplayList);
+        arrowUp.record(alarmDisplayList);
+        arrowDown.record(alarmDisplayList);
+        arrowLeft.record(alarmDisplayList);
+        arrowRight.record(alarmDisplayList);
+        underline.record(alarmDisplayList);
+        alarmCounter.record(alarmDisplayList);
+        alarmTime.record(alarmDisplayList);
+
         setSelected(selected);
     }
 
@@ -53,6 +69,12 @@ struct ScreenSetAlarm::Impl
     RendererText alarmCounter;
     RendererText alarmTime;
 
+    /// always displayed, cached in staticLayer
+    RendererDisplayList displayList;
+    /// displayed if there is an alarm
+    RendererDisplayList alarmDisplayList;
+    RendererLayer staticLayer;
+
     size_t alarmIdx = 0;
     Selected selected = Selected::Hour;
 
@@ -106,32 +128,32 @@ ScreenSetAlarm::~ScreenSetAlarm() = default;
 
 void ScreenSetAlarm::enter()
 {
-    pimpl = std::make_unique<Impl>(ctx.getRenderer());
+    if (!pimpl)
+    {
+        pimpl = std::make_unique<Impl>(ctx.getRenderer());
+    }
+    // a warm screen starts over like a new one
+    pimpl->alarmIdx = 0;
+    pimpl->setSelected(Impl::Selected::Hour);
 }
 
 void ScreenSetAlarm::leave()
+{
+}
+
+void ScreenSetAlarm::release()
 {
     pimpl = nullptr;
 }
 
 void ScreenSetAlarm::run(const Clock::time_point &)
 {
-    pimpl->previousScreen.print();
-    pimpl->nextScreen.print();
-    pimpl->addAlarm.print();
+    pimpl->staticLayer.print();
 
     if (const auto *currentAlarm = getAlarm(*pimpl, ctx))
     {
         pimpl->refreshAlarm(*currentAlarm);
-
-        pimpl->delAlarm.print();
-        pimpl->arrowUp.print();
-        pimpl->arrowDown.print();
-        pimpl->arrowLeft.print();
-        pimpl->arrowRight.print();
-        pimpl->underline.print();
-        pimpl->alarmCounter.print();
-        pimpl->alarmTime.print();
+        pimpl->alarmDisplayList.submit();
     }
     else
     {
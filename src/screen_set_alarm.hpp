@@ -18,6 +18,7 @@ public:
 private:
     void enter() override;
     void leave() override;
+    void release() override;
     void run(const Clock::time_point &time) override;
     void handleClick(Position position) override;
 
@@ -5,6 +5,8 @@
 #include "config_alarm.hpp"
 #include "context.hpp"
 #include "renderer.hpp"
+#include "renderer_display_list.hpp"
+#include "renderer_layer.hpp"
 #include "renderer_sprite.hpp"
 #include "renderer_text.hpp"
 #include "toolbox_filesystem.hpp"
@@ -79,6 +81,7 @@ struct ScreenSetAlarmFile::Impl
           arrowRight{renderer.renderSprite(Asset::Arrow, renderer.getWidth(), renderer.getHeight() / 2, Position::Right, 1)},
           previousScreen{renderer.renderStaticText(kMargin, renderer.getHeight() - kMargin, _("Alarm\nHour"), Position::UpLeft, 16)},
           nextScreen{renderer.renderStaticText(renderer.getWidth() - kMargin, renderer.getHeight() - kMargin, _("Config\n  Date"), Position::UpRight, 16)},
+          staticLayer{renderer.renderLayer(displayList)},
           errorText{renderer.renderText(renderer.getWidth() / 2, renderer.getHeight() / 2, 14, 1, Position::Center)},
           alarmFilenameText{renderer.renderText(renderer.getWidth() / 2, renderer.getHeight() / 2, kFilenameSize, 1, Position::Up, 16)},
           alarmNumberText{renderer.renderText(renderer.getWidth() / 2, renderer.getHeight() * 3 / 4, 9, 1, Position::Up)},
@@ -87,6 +90,8 @@ struct ScreenSetAlarmFile::Impl
           errorNoFile{_("   No File")},
           errorNoAlarm{_("   No Alarm")}
     {
+        previousScreen.record(displayList);
+        nextScreen.record(displayList);
     }
 
     void refreshAlarmNumberText(size_t idx)
@@ -130,6 +135,9 @@ struct ScreenSetAlarmFile::Impl
     RendererTextStatic previousScreen;
     RendererTextStatic nextScreen;
 
+    RendererDisplayList displayList;
+    RendererLayer staticLayer;
+
     RendererText errorText;
     RendererText alarmFilenameText;
     RendererText alarmNumberText;
@@ -153,7 +161,12 @@ ScreenSetAlarmFile::~ScreenSetAlarmFile() = default;
 
 void ScreenSetAlarmFile::enter()
 {
-    pimpl = std::make_unique<Impl>(ctx.getRenderer(), ctx.getConfig().getMusic());
+    if (!pimpl)
+    {
+        pimpl = std::make_unique<Impl>(ctx.getRenderer(), ctx.getConfig().getMusic());
+    }
+    // a warm screen starts over like a new one
+    pimpl->alarmIdx = 0;
 
     if (!pimpl->filenames.empty())
     {
@@ -169,14 +182,17 @@ void ScreenSetAlarmFile::enter()
 }
 
 void ScreenSetAlarmFile::leave()
+{
+}
+
+void ScreenSetAlarmFile::release()
 {
     pimpl = nullptr;
 }
 
 void ScreenSetAlarmFile::run(const Clock::time_point &)
 {
-    pimpl->previousScreen.print();
-    pimpl->nextScreen.print();
+    pimpl->staticLayer.print();
 
     if (const auto alarm = getAlarm(ctx, pimpl->alarmIdx))
     {
@@ -222,11 +238,11 @@ void ScreenSetAlarmFile::run(const Clock::time_point &)
 
 void ScreenSetAlarmFile::handleClick(Position position)
 {
-    Audio &audio = ctx.getAudio();
-    const bool stopAudio = audio.isPlaying();
+    Audio *const audio = ctx.getAudio();
+    const bool stopAudio = audio && audio->isPlaying();
     if (stopAudio)
     {
-        audio.stopStream();
+        audio->stopStream();
     }
 
     switch (position)
@@ -238,13 +254,13 @@ void ScreenSetAlarmFile::handleClick(Position position)
         ctx.nextScreen();
         break;
     case Position::Center:
-        if (const auto alarm = getAlarm(ctx, pimpl->alarmIdx); alarm != nullptr && stopAudio == false)
+        if (const auto alarm = getAlarm(ctx, pimpl->alarmIdx); alarm != nullptr && audio != nullptr && stopAudio == false)
         {
             if (const auto configFilename = alarm->getFile(); configFilename.empty() == false)
             {
                 const auto filename = ctx.getConfig().getMusic(configFilename);
-                audio.loadStream(filename.c_str());
-                audio.playStream();
+                audio->loadStream(filename.c_str());
+                audio->playStream();
             }
         }
         break;
@@ -2,6 +2,8 @@
 
 #include "context.hpp"
 #include "renderer.hpp"
+#include "renderer_display_list.hpp"
+#include "renderer_layer.hpp"
 #include "renderer_sprite.hpp"
 #include "renderer_text.hpp"
 #include "toolbox_i18n.hpp"
@@ -106,8 +108,17 @@ struct ScreenSetDate::Impl
           nextScreen{renderer.renderStaticText(renderer.getWidth() - kMargin, renderer.getHeight() - kMargin, _("Sensor"), Position::UpRight, 16)},
           errorText{renderer.renderStaticText(renderer.getWidth() / 2, renderer.getHeight() * 7 / 10, kErrCannotChangeDate, Position::Center, 16)},
           dateText{renderer.renderText(renderer.getWidth() / 2, renderer.getHeight() / 2, 19, 1, Position::Center, 16)},
-          dateUnderline{renderer.renderText(renderer.getWidth() / 2, renderer.getHeight() / 2, 19, 1, Position::Up, 16)}
+          dateUnderline{renderer.renderText(renderer.getWidth() / 2, renderer.getHeight() / 2, 19, 1, Position::Up, 16)},
+          staticLayer{renderer.renderLayer(displayList)}
     {
+        previousScreen.record(displayList);
+        nextScreen.record(displayList);
+
+        dateUnderline.record(dateDisplayList);
+        dateText.record(dateDisplayList);
+        arrowUp.record(dateDisplayList);
+        arrowDown.record(dateDisplayList);
+
         changeSelect(Select::Day);
     }
 
@@ -149,6 +160,12 @@ struct ScreenSetDate::Impl
     RendererText dateText;
     RendererText dateUnderline;
 
+    /// always displayed, cached in staticLayer
+    RendererDisplayList displayList;
+    /// displayed if the date is valid
+    RendererDisplayList dateDisplayList;
+    RendererLayer staticLayer;
+
     std::time_t secondsSinceEpoch = 0;
     bool error = false;
     Select select = Select::Day;
@@ -164,10 +181,20 @@ ScreenSetDate::~ScreenSetDate() = default;
 
 void ScreenSetDate::enter()
 {
-    pimpl = std::make_unique<Impl>(ctx.getRenderer());
+    if (!pimpl)
+    {
+        pimpl = std::make_unique<Impl>(ctx.getRenderer());
+    }
+    // a warm screen starts over like a new one
+    pimpl->changeSelect(Select::Day);
+    pimpl->error = false;
 }
 
 void ScreenSetDate::leave()
+{
+}
+
+void ScreenSetDate::release()
 {
     pimpl = nullptr;
 }
@@ -176,15 +203,11 @@ void ScreenSetDate::run(const Clock::time_point &time)
 {
     pimpl->refreshDate(time);
 
-    pimpl->previousScreen.print();
-    pimpl->nextScreen.print();
+    pimpl->staticLayer.print();
 
     if (pimpl->secondsSinceEpoch)
     {
-        pimpl->dateUnderline.print();
-        pimpl->dateText.print();
-        pimpl->arrowUp.print();
-        pimpl->arrowDown.print();
+        pimpl->dateDisplayList.submit();
         if (pimpl->select != Select::Day)
         {
             pimpl->arrowLeft.print();
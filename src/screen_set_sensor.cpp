@@ -3,6 +3,8 @@
 #include "config.hpp"
 #include "context.hpp"
 #include "renderer.hpp"
+#include "renderer_display_list.hpp"
+#include "renderer_layer.hpp"
 #include "renderer_sprite.hpp"
 #include "renderer_text.hpp"
 #include "sensor.hpp"
@@ -27,10 +29,13 @@ struct ScreenSetSensor::Impl
           arrowDown{renderer.renderSprite(Asset::Arrow, renderer.getWidth() / 2, 0, Position::Down, 2)},
           previousScreen{renderer.renderStaticText(kMargin, renderer.getHeight() - kMargin, _("Config\nDate"), Position::UpLeft, 16)},
           nextScreen{renderer.renderStaticText(renderer.getWidth() - kMargin, renderer.getHeight() - kMargin, _("Config"), Position::UpRight, 16)},
+          staticLayer{renderer.renderLayer(displayList)},
           thermalNameText{renderer.renderText(renderer.getWidth() / 2, renderer.getHeight() / 2, kSensorNameSize, 1, Position::Center)},
           thermalValueText{renderer.renderText(renderer.getWidth() / 2, renderer.getHeight() * 2 / 5, kThermalSize, 1, Position::Up, 16)},
           sensorNone{_("       <None>")}
     {
+        previousScreen.record(displayList);
+        nextScreen.record(displayList);
     }
 
     void refreshThermal(float value)
@@ -79,6 +84,9 @@ struct ScreenSetSensor::Impl
     RendererTextStatic previousScreen;
     RendererTextStatic nextScreen;
 
+    RendererDisplayList displayList;
+    RendererLayer staticLayer;
+
     RendererText thermalNameText;
     RendererText thermalValueText;
 
@@ -98,7 +106,10 @@ ScreenSetSensor::~ScreenSetSensor() = default;
 
 void ScreenSetSensor::enter()
 {
-    pimpl = std::make_unique<Impl>(ctx.getRenderer());
+    if (!pimpl)
+    {
+        pimpl = std::make_unique<Impl>(ctx.getRenderer());
+    }
 
     SensorFactory &factory = ctx.getSensorFactory();
     for (size_t i = factory.getSize(SensorFactory::Type::Temperature); i--;)
@@ -112,6 +123,10 @@ void ScreenSetSensor::enter()
 }
 
 void ScreenSetSensor::leave()
+{
+}
+
+void ScreenSetSensor::release()
 {
     pimpl = nullptr;
 }
@@ -120,8 +135,7 @@ void ScreenSetSensor::run(const Clock::time_point &)
 {
     SensorFactory &factory = ctx.getSensorFactory();
 
-    pimpl->previousScreen.print();
-    pimpl->nextScreen.print();
+    pimpl->staticLayer.print();
 
     if (Sensor *sensor = factory.get(SensorFactory::Type::Temperature, pimpl->sensorIdx))
     {
@@ -82,9 +82,14 @@ struct SensorFactory::Impl
 };
 
 SensorFactory::SensorFactory()
+    : SensorFactory{"/sys/class/thermal"}
+{
+}
+
+SensorFactory::SensorFactory(std::string_view thermalFolder)
     : pimpl{std::make_unique<Impl>()}
 {
-    pimpl->temperature = concat(SensorThermal::create(), SensorIio::create("temp"));
+    pimpl->temperature = concat(SensorThermal::create(thermalFolder), SensorIio::create("temp"));
     pimpl->humidity = concat(SensorIio::create("humidityrelative"));
 }
 
@@ -2,6 +2,7 @@
 
 #include <iosfwd>
 #include <memory>
+#include <string_view>
 
 class Sensor;
 
@@ -20,6 +21,13 @@ public:
     };
 
     SensorFactory();
+
+    /**
+     * With the thermal sensors of another folder than /sys/class/thermal, e.g. temporary files in the tests
+     *
+     * @sa SensorThermal::create()
+     */
+    explicit SensorFactory(std::string_view thermalFolder);
     ~SensorFactory();
 
     /**
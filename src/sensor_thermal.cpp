@@ -51,10 +51,10 @@ SensorThermal::SensorThermal(std::string_view path)
 
 SensorThermal::~SensorThermal() = default;
 
-std::vector<std::unique_ptr<Sensor>> SensorThermal::create()
+std::vector<std::unique_ptr<Sensor>> SensorThermal::create(std::string_view folder)
 {
     std::vector<std::unique_ptr<Sensor>> sensors;
-    const fs::path thermal = "/sys/class/thermal";
+    const fs::path thermal{folder};
     if (fs::is_directory(thermal))
     {
         for (auto &dirEntry : fs::directory_iterator{thermal})
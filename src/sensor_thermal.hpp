@@ -21,9 +21,9 @@ public:
     ~SensorThermal() override;
 
     /**
-     * Read from /sys/class/thermal/thermal_zoneXXX/(temp|type)
+     * Read from folder/thermal_zoneXXX/(temp|type), the folder being /sys/class/thermal on Linux
      */
-    static std::vector<std::unique_ptr<Sensor>> create();
+    static std::vector<std::unique_ptr<Sensor>> create(std::string_view folder);
 
     bool refresh(const Clock::time_point &time) override;
     float get() const override;
@@ -0,0 +1,110 @@
+#include "toolbox_assets.hpp"
+
+#include "toolbox_filesystem.hpp"
+#include "toolbox_io.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef USE_EMBEDDED_ASSETS
+// the blob, see the Makefile
+extern "C" const char alarm_assets[];
+#endif
+
+namespace
+{
+
+constexpr char kEnvironmentAssetsFromDisk[] = "ALARM_ASSETS_FROM_DISK";
+
+/**
+ * Ask the kernel to read the files of the folder in the background
+ *
+ * @return bytes to read
+ */
+size_t prefetchFolder(const std::string &folder)
+{
+    size_t size = 0;
+    // without exception: an unreadable entry does not fail the startup
+    std::error_code error;
+    for (fs::directory_iterator it{folder, error}; !error && it != fs::directory_iterator{}; it.increment(error))
+    {
+        if (const FileUnix file{open(it->path().c_str(), O_RDONLY)}; file.fd >= 0)
+        {
+            posix_fadvise(file.fd, 0, 0, POSIX_FADV_WILLNEED);
+            std::error_code sizeError;
+            if (const auto fileSize = it->file_size(sizeError); !sizeError)
+            {
+                size += fileSize;
+            }
+        }
+    }
+    return size;
+}
+
+} // namespace
+
+bool hasEmbeddedAssets()
+{
+#ifdef USE_EMBEDDED_ASSETS
+    return std::getenv(kEnvironmentAssetsFromDisk) == nullptr;
+#else
+    return false;
+#endif
+}
+
+std::string_view getEmbeddedAsset(std::string_view name)
+{
+#ifdef USE_EMBEDDED_ASSETS
+    const auto header = reinterpret_cast<const EmbeddedAssetsHeader *>(alarm_assets);
+    if (std::memcmp(header->magic, kEmbeddedAssetsMagic, sizeof(kEmbeddedAssetsMagic)) != 0)
+    {
+        return {};
+    }
+
+    const auto getName = [](const EmbeddedAssetsEntry &entry) {
+        return std::string_view{alarm_assets + entry.nameOffset, entry.nameSize};
+    };
+    const auto begin = reinterpret_cast<const EmbeddedAssetsEntry *>(header + 1);
+    const auto end = begin + header->count;
+    const auto found = std::lower_bound(begin, end, name, [&getName](const EmbeddedAssetsEntry &entry, std::string_view value) {
+        return getName(entry) < value;
+    });
+    if (found == end || getName(*found) != name)
+    {
+        return {};
+    }
+    return std::string_view{alarm_assets + found->offset, found->size};
+#else
+    static_cast<void>(name);
+    return {};
+#endif
+}
+
+size_t prefetchAssets(const std::vector<std::string> &folders)
+{
+#ifdef USE_EMBEDDED_ASSETS
+    if (hasEmbeddedAssets())
+    {
+        const auto header = reinterpret_cast<const EmbeddedAssetsHeader *>(alarm_assets);
+        const auto entries = reinterpret_cast<const EmbeddedAssetsEntry *>(header + 1);
+        size_t size = 0;
+        for (uint32_t i = 0; i < header->count; ++i)
+        {
+            size = std::max<size_t>(size, entries[i].offset + entries[i].size);
+        }
+        // page aligned, see the Makefile
+        madvise(const_cast<char *>(alarm_assets), size, MADV_WILLNEED);
+        return size;
+    }
+#endif
+    size_t size = 0;
+    for (const std::string &folder : folders)
+    {
+        size += prefetchFolder(folder);
+    }
+    return size;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+/**
+ * @file
+ *
+ * This file is to provide the assets embedded in the executable (USE_EMBEDDED_ASSETS=1 in the Makefile)
+ *
+ * The Makefile packs the compiled shaders and textures into a read only blob, linked into the executable:
+ * - EmbeddedAssetsHeader
+ * - 1 EmbeddedAssetsEntry per asset, sorted by name
+ * - the names
+ * - the contents, each one aligned on kEmbeddedAssetsAlignment from the start of the blob, itself page aligned
+ *
+ * The integers are in the native byte order, written by tools/assets_pack.cpp
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+constexpr char kEmbeddedAssetsMagic[8] = {'A', 'L', 'A', 'R', 'M', 'A', 'S', 'S'};
+constexpr uint32_t kEmbeddedAssetsAlignment = 4096;
+
+struct EmbeddedAssetsHeader
+{
+    char magic[8];
+    uint32_t count; ///< of EmbeddedAssetsEntry
+    uint32_t reserved;
+};
+
+struct EmbeddedAssetsEntry
+{
+    uint32_t nameOffset; ///< from the start of the blob
+    uint32_t nameSize;
+    uint32_t offset; ///< of the content, from the start of the blob
+    uint32_t size;
+};
+
+/**
+ * The shaders and the textures are read from the executable: built with USE_EMBEDDED_ASSETS=1, and the environment
+ * variable ALARM_ASSETS_FROM_DISK is not set
+ */
+bool hasEmbeddedAssets();
+
+/**
+ * Content of an asset embedded in the executable, without any I/O nor allocation
+ *
+ * @param name relative to the assets folder, e.g. "shader/print_text.vert"
+ * @return empty if the executable has no embedded assets, or not this one
+ */
+std::string_view getEmbeddedAsset(std::string_view name);
+
+/**
+ * Start reading the shaders and the textures, without waiting for them: the blob embedded in the executable if
+ * hasEmbeddedAssets(), otherwise the files of the folders. To be called early, e.g. while the window is created: the
+ * renderer finds them in memory
+ *
+ * @param folders of the files, e.g. Config::getShader() and Config::getTexture()
+ * @return bytes to read. The files which cannot be listed or opened are skipped
+ */
+size_t prefetchAssets(const std::vector<std::string> &folders);
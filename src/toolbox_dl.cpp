@@ -0,0 +1,33 @@
+#include "toolbox_dl.hpp"
+
+#include <dlfcn.h>
+
+#include <stdexcept>
+#include <string>
+
+SharedLibrary::SharedLibrary(const char *filename)
+    // RTLD_LOCAL: the symbols are only reached by getSymbol(), the library can be closed
+    : handle{dlopen(filename, RTLD_NOW | RTLD_LOCAL)}
+{
+    if (handle == nullptr)
+    {
+        throw std::runtime_error{std::string{"Cannot load "} + filename + ": " + dlerror()};
+    }
+}
+
+void *SharedLibrary::getAddress(const char *name) const
+{
+    dlerror();
+    void *const result = dlsym(handle.get(), name);
+    if (result == nullptr)
+    {
+        const char *error = dlerror();
+        throw std::runtime_error{std::string{"Cannot find "} + name + ": " + (error ? error : "null symbol")};
+    }
+    return result;
+}
+
+void SharedLibrary::Deleter::operator()(void *handle) const
+{
+    dlclose(handle);
+}
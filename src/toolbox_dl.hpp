@@ -0,0 +1,61 @@
+#pragma once
+
+/**
+ * @file
+ *
+ * This file is to provide the libraries loaded at runtime with dlopen(), instead of being linked to the executable
+ */
+
+#include <memory>
+
+/**
+ * @brief Library opened with dlopen(), closed at destruction time
+ *
+ * The functions are resolved with SHARED_LIBRARY_SYMBOL() in a struct which owns the library:
+ *
+ * @code
+ * struct Vorbisfile
+ * {
+ *     SharedLibrary library{"libvorbisfile.so.3"};
+ *     SHARED_LIBRARY_SYMBOL(ov_clear);
+ * };
+ * @endcode
+ */
+class SharedLibrary
+{
+public:
+    /**
+     * @param filename soname of the library, e.g. "libm.so.6", searched like the linker does
+     * @throw std::runtime_error if the library is missing
+     */
+    explicit SharedLibrary(const char *filename);
+
+    /**
+     * Function of the library, valid as long as this object
+     *
+     * @throw std::runtime_error if the symbol is missing
+     */
+    template <typename T>
+    T *getSymbol(const char *name) const
+    {
+        return reinterpret_cast<T *>(getAddress(name));
+    }
+
+private:
+    void *getAddress(const char *name) const;
+
+    struct Deleter
+    {
+        void operator()(void *handle) const;
+    };
+    std::unique_ptr<void, Deleter> handle;
+};
+
+/**
+ * Member of a struct with a SharedLibrary named library, declared before it: pointer to the function name of the
+ * library, declared by its header. The name is expanded first, like the calls are: the header may rename the function,
+ * e.g. mpg123_seek to mpg123_seek_64 with a 64 bits off_t on a 32 bits CPU
+ */
+#define SHARED_LIBRARY_SYMBOL(name) \
+    decltype(&::name) name = library.getSymbol<decltype(::name)>(SHARED_LIBRARY_STRINGIFY(name))
+#define SHARED_LIBRARY_STRINGIFY(name) #name
@@ -1,6 +1,8 @@
 #include "toolbox_gl.hpp"
 
+#include <algorithm>
 #include <ostream>
+#include <vector>
 
 namespace
 {
@@ -25,6 +27,19 @@ void glDebug(std::ostream &str)
     str << " - GL_EXTENSIONS: " << getValidString(glGetString(GL_EXTENSIONS)) << std::endl;
 }
 
+bool glIsCompressedFormatSupported(GLenum format)
+{
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, &count);
+    if (count <= 0)
+    {
+        return false;
+    }
+    std::vector<GLint> formats(count);
+    glGetIntegerv(GL_COMPRESSED_TEXTURE_FORMATS, formats.data());
+    return std::find(formats.begin(), formats.end(), static_cast<GLint>(format)) != formats.end();
+}
+
 void glCheckError(const char *func,
                   const char *file,
                   const int line)
@@ -14,11 +14,24 @@
 
 #include <iosfwd>
 
+// ETC2 is core in OpenGL ES 3, which may be behind an OpenGL ES 2 context
+#ifndef GL_COMPRESSED_RGB8_ETC2
+#define GL_COMPRESSED_RGB8_ETC2 0x9274
+#endif
+#ifndef GL_COMPRESSED_RGBA8_ETC2_EAC
+#define GL_COMPRESSED_RGBA8_ETC2_EAC 0x9278
+#endif
+
 /**
  * Print some info about the OpenGL driver
  */
 void glDebug(std::ostream &str);
 
+/**
+ * Is the format in GL_COMPRESSED_TEXTURE_FORMATS, i.e. can it be given to glCompressedTexImage2D()?
+ */
+bool glIsCompressedFormatSupported(GLenum format);
+
 /**
  * Throw a GLError in case of problem
  */
@@ -121,22 +121,36 @@ MmapFile::MmapFile(void *content, size_t size)
     }
 }
 
+MmapFile::MmapFile(std::string_view memory)
+    : content{const_cast<char *>(memory.data())},
+      size{memory.size()},
+      mapped{false}
+{
+}
+
+MmapFile MmapFile::fromMemory(std::string_view content)
+{
+    return MmapFile{content};
+}
+
 MmapFile::MmapFile(MmapFile &&other)
 {
     std::swap(content, other.content);
     std::swap(size, other.size);
+    std::swap(mapped, other.mapped);
 }
 
 MmapFile &MmapFile::operator=(MmapFile &&other)
 {
     std::swap(content, other.content);
     std::swap(size, other.size);
+    std::swap(mapped, other.mapped);
     return *this;
 }
 
 MmapFile::~MmapFile()
 {
-    if (content != nullptr && content != MAP_FAILED && size != 0)
+    if (mapped && content != nullptr && content != MAP_FAILED && size != 0)
     {
         munmap(content, size);
     }
@@ -144,6 +158,29 @@ MmapFile::~MmapFile()
     size = 0;
 }
 
+void MmapFile::setCopyOnWrite()
+{
+    if (!mapped)
+    {
+        // shared with the other users of the memory: private copy
+        void *const copy = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (copy == MAP_FAILED)
+        {
+            throw ErrorErrno{"Could not mmap a copy"};
+        }
+        std::memcpy(copy, content, size);
+        content = copy;
+        mapped = true;
+        return;
+    }
+
+    // the mapping is private: writing never needs the file to be writable
+    if (mprotect(content, size, PROT_READ | PROT_WRITE) != 0)
+    {
+        throw ErrorErrno{"Could not mprotect the file"};
+    }
+}
+
 size_t copyBuffer(void *dest, size_t destSize, const void *src, size_t srcSize)
 {
     const size_t sizeToCopy = std::min(destSize - 1, srcSize);
@@ -9,6 +9,7 @@
 #include <cstdio>
 #include <memory>
 #include <string>
+#include <string_view>
 
 /**
  * @brief Functor to close a C-like FILE
@@ -69,16 +70,31 @@ public:
      */
     MmapFile(void *content, size_t size);
 
+    /**
+     * Read only memory which is not mapped by this object, e.g. an asset embedded in the executable. It is neither
+     * written nor unmapped
+     */
+    static MmapFile fromMemory(std::string_view content);
+
     explicit MmapFile(MmapFile &&other);
     MmapFile &operator=(MmapFile &&other);
 
     ~MmapFile();
 
+    /**
+     * Allow to write into the content. Only the modified pages are copied (privately): the file is unchanged. The
+     * memory of fromMemory() is copied at once
+     */
+    void setCopyOnWrite();
+
     void *content = nullptr;
     size_t size = 0;
 
 private:
     MmapFile(int fd, const char *filenameDebug);
+    explicit MmapFile(std::string_view memory);
+
+    bool mapped = true; ///< false for fromMemory(): not unmapped
 };
 
 size_t copyBuffer(void *dest, size_t destSize, const void *src, size_t srcSize);
@@ -0,0 +1,536 @@
+#include "toolbox_pixel.hpp"
+
+#include <endian.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define PIXEL_X86
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define PIXEL_NEON
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+
+constexpr size_t kPixelSize = 4;
+// 16 * 16 * 4 bytes, fits easily in the L1 cache
+constexpr size_t kTileSize = 16;
+
+/**
+ * @brief 24 bpp pixel, copied as is
+ */
+struct Pixel24
+{
+    uint8_t bytes[3];
+};
+
+/**
+ * Write the converted pixels of a tile, rotated and upscaled
+ *
+ * @param tile converted pixels, kTileSize per line
+ * @param dst where to write the tile's 1st pixel
+ * @param stepLine bytes in dst between 2 lines of the tile
+ * @param stepColumn bytes in dst between 2 columns of the tile
+ */
+template <typename Pixel>
+void writeTile(const Pixel *tile, size_t tileWidth, size_t tileHeight, uint8_t *dst, ptrdiff_t stepLine, ptrdiff_t stepColumn, int scale, size_t dstStride)
+{
+    for (size_t i = 0; i < tileHeight; ++i, dst += stepLine)
+    {
+        uint8_t *dstPixel = dst;
+        for (size_t j = 0; j < tileWidth; ++j, dstPixel += stepColumn)
+        {
+            const Pixel pixel = tile[i * kTileSize + j];
+            uint8_t *dstBlock = dstPixel;
+            for (int row = 0; row < scale; ++row, dstBlock += dstStride)
+            {
+                std::fill_n(reinterpret_cast<Pixel *>(dstBlock), scale, pixel);
+            }
+        }
+    }
+}
+
+/*
+ * Portable version: 2 pixels per iteration
+ */
+
+void toRGB565Scalar(const uint8_t *src, uint8_t *dst, size_t count)
+{
+    auto dstPixel = reinterpret_cast<uint32_t *>(dst);
+    for (const uint8_t *const end = src + count * kPixelSize; src < end; src += kPixelSize * 2)
+    {
+        const uint32_t r = src[0] << 16 | src[kPixelSize];
+        const uint32_t g = src[1] << 16 | src[kPixelSize + 1];
+        const uint32_t b = src[2] << 16 | src[kPixelSize + 2];
+        *dstPixel = htobe32((r & 0x00f800f8) << 8 | ((g & 0x00fc00fc) << 3) | ((b & 0x00f800f8) >> 3));
+        ++dstPixel;
+    }
+}
+
+void toXRGB8888Scalar(const uint8_t *src, uint8_t *dst, size_t count)
+{
+    auto srcPixel = reinterpret_cast<const uint32_t *>(src);
+    auto dstPixel = reinterpret_cast<uint32_t *>(dst);
+    for (const uint32_t *const end = srcPixel + count; srcPixel < end; ++srcPixel)
+    {
+        *dstPixel = htobe32((*srcPixel) << 8);
+        ++dstPixel;
+    }
+}
+
+void fromRGB565Scalar(const uint8_t *src, uint8_t *dst, size_t count)
+{
+    auto srcPixel = reinterpret_cast<const uint16_t *>(src);
+    auto dstPixel = reinterpret_cast<uint16_t *>(dst);
+    for (const uint16_t *const end = srcPixel + count; srcPixel < end; ++srcPixel)
+    {
+        *dstPixel = htobe16(*srcPixel);
+        ++dstPixel;
+    }
+}
+
+/*
+ * Portable version specialized at compile time per layout
+ */
+
+/**
+ * @brief RGBA8888 source: the bytes are R, G, B, A
+ */
+struct SourceRGBA8888
+{
+    static constexpr PixelSource kSource = PixelSource::RGBA8888;
+    static constexpr size_t kSize = 4;
+
+    static void read(const uint8_t *src, uint32_t &r, uint32_t &g, uint32_t &b)
+    {
+        r = src[0];
+        g = src[1];
+        b = src[2];
+    }
+};
+
+/**
+ * @brief RGB565 source in the CPU's endianness. The channels are expanded to 8 bits by replicating their high bits
+ */
+struct SourceRGB565
+{
+    static constexpr PixelSource kSource = PixelSource::RGB565;
+    static constexpr size_t kSize = 2;
+
+    static void read(const uint8_t *src, uint32_t &r, uint32_t &g, uint32_t &b)
+    {
+        uint16_t pixel;
+        std::memcpy(&pixel, src, sizeof(pixel));
+        r = pixel >> 11;
+        g = (pixel >> 5) & 0x3f;
+        b = pixel & 0x1f;
+        r = r << 3 | r >> 2;
+        g = g << 2 | g >> 4;
+        b = b << 3 | b >> 2;
+    }
+};
+
+/**
+ * @brief Framebuffer layout known at compile time
+ */
+template <int BitsPerPixel, int RedOffset, int RedLength, int GreenOffset, int GreenLength, int BlueOffset, int BlueLength, bool BigEndian>
+struct Destination
+{
+    static_assert(BitsPerPixel == 16 || BitsPerPixel == 24 || BitsPerPixel == 32, "unsupported bpp");
+
+    static constexpr PixelLayout kLayout{BitsPerPixel, RedOffset, RedLength, GreenOffset, GreenLength, BlueOffset, BlueLength, BigEndian};
+    static constexpr size_t kSize = BitsPerPixel / 8;
+
+    static void write(uint8_t *dst, uint32_t r, uint32_t g, uint32_t b)
+    {
+        const uint32_t pixel = (r >> (8 - RedLength)) << RedOffset | (g >> (8 - GreenLength)) << GreenOffset | (b >> (8 - BlueLength)) << BlueOffset;
+        // constant shifts, unrolled by the compiler
+        for (size_t i = 0; i < kSize; ++i)
+        {
+            dst[i] = pixel >> (8 * (BigEndian ? kSize - 1 - i : i));
+        }
+    }
+};
+
+template <bool BigEndian>
+using RGB565 = Destination<16, 11, 5, 5, 6, 0, 5, BigEndian>;
+template <bool BigEndian>
+using BGR565 = Destination<16, 0, 5, 5, 6, 11, 5, BigEndian>;
+template <bool BigEndian>
+using RGB555 = Destination<16, 10, 5, 5, 5, 0, 5, BigEndian>;
+template <bool BigEndian>
+using RGB888 = Destination<24, 16, 8, 8, 8, 0, 8, BigEndian>;
+template <bool BigEndian>
+using BGR888 = Destination<24, 0, 8, 8, 8, 16, 8, BigEndian>;
+template <bool BigEndian>
+using XRGB8888 = Destination<32, 16, 8, 8, 8, 0, 8, BigEndian>;
+template <bool BigEndian>
+using XBGR8888 = Destination<32, 0, 8, 8, 8, 16, 8, BigEndian>;
+template <bool BigEndian>
+using RGBX8888 = Destination<32, 24, 8, 16, 8, 8, 8, BigEndian>;
+template <bool BigEndian>
+using BGRX8888 = Destination<32, 8, 8, 16, 8, 24, 8, BigEndian>;
+
+template <typename Source, typename Target>
+void convertSpecialized(const uint8_t *src, uint8_t *dst, size_t count)
+{
+    for (const uint8_t *const end = src + count * Source::kSize; src < end; src += Source::kSize, dst += Target::kSize)
+    {
+        uint32_t r, g, b;
+        Source::read(src, r, g, b);
+        Target::write(dst, r, g, b);
+    }
+}
+
+/**
+ * @brief 1 instantiation of convertSpecialized()
+ */
+struct Specialization
+{
+    PixelSource source;
+    PixelLayout layout;
+    PixelConverter::Kernel kernel;
+};
+
+template <typename... Destinations>
+std::vector<Specialization> instantiate()
+{
+    return {{PixelSource::RGBA8888, Destinations::kLayout, convertSpecialized<SourceRGBA8888, Destinations>}...,
+            {PixelSource::RGB565, Destinations::kLayout, convertSpecialized<SourceRGB565, Destinations>}...};
+}
+
+const std::vector<Specialization> &getSpecializations()
+{
+    static const auto specializations = instantiate<RGB565<false>, RGB565<true>, BGR565<false>, BGR565<true>, RGB555<false>, RGB555<true>,
+                                                    RGB888<false>, RGB888<true>, BGR888<false>, BGR888<true>, XRGB8888<false>, XRGB8888<true>,
+                                                    XBGR8888<false>, XBGR8888<true>, RGBX8888<false>, RGBX8888<true>, BGRX8888<false>, BGRX8888<true>>();
+    return specializations;
+}
+
+#ifdef PIXEL_X86
+
+/*
+ * SSE2: part of x86_64, so always available there
+ */
+
+/**
+ * 4 RGBA8888 pixels -> 4 RGB565 (big endian) in the low 16 bits of each 32 bits, sign extended for _mm_packs_epi32()
+ */
+__attribute__((target("sse2"))) __m128i toRGB565x4(__m128i pixels)
+{
+    const __m128i r = _mm_slli_epi32(_mm_and_si128(pixels, _mm_set1_epi32(0xf8)), 8);
+    const __m128i g = _mm_and_si128(_mm_srli_epi32(pixels, 5), _mm_set1_epi32(0x7e0));
+    const __m128i b = _mm_and_si128(_mm_srli_epi32(pixels, 19), _mm_set1_epi32(0x1f));
+    // swap the 2 bytes
+    const __m128i rgb565 = _mm_or_si128(r, _mm_or_si128(g, b));
+    const __m128i swapped = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(rgb565, _mm_set1_epi32(0xff)), 24),
+                                         _mm_slli_epi32(_mm_srli_epi32(rgb565, 8), 16));
+    return _mm_srai_epi32(swapped, 16);
+}
+
+__attribute__((target("sse2"))) void toRGB565Sse2(const uint8_t *src, uint8_t *dst, size_t count)
+{
+    const size_t vectorCount = count & ~size_t{7};
+    for (const uint8_t *const end = src + vectorCount * kPixelSize; src < end; src += 8 * kPixelSize, dst += 8 * 2)
+    {
+        const __m128i low = toRGB565x4(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src)));
+        const __m128i high = toRGB565x4(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 4 * kPixelSize)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_packs_epi32(low, high));
+    }
+    toRGB565Scalar(src, dst, count - vectorCount);
+}
+
+__attribute__((target("sse2"))) void toXRGB8888Sse2(const uint8_t *src, uint8_t *dst, size_t count)
+{
+    const size_t vectorCount = count & ~size_t{3};
+    for (const uint8_t *const end = src + vectorCount * kPixelSize; src < end; src += 4 * kPixelSize, dst += 4 * kPixelSize)
+    {
+        const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+        // R <-> B, A = 0
+        const __m128i r = _mm_slli_epi32(_mm_and_si128(pixels, _mm_set1_epi32(0xff)), 16);
+        const __m128i g = _mm_and_si128(pixels, _mm_set1_epi32(0xff00));
+        const __m128i b = _mm_and_si128(_mm_srli_epi32(pixels, 16), _mm_set1_epi32(0xff));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_or_si128(r, _mm_or_si128(g, b)));
+    }
+    toXRGB8888Scalar(src, dst, count - vectorCount);
+}
+
+__attribute__((target("sse2"))) void fromRGB565Sse2(const uint8_t *src, uint8_t *dst, size_t count)
+{
+    const size_t vectorCount = count & ~size_t{7};
+    for (const uint8_t *const end = src + vectorCount * 2; src < end; src += 8 * 2, dst += 8 * 2)
+    {
+        const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_or_si128(_mm_slli_epi16(pixels, 8), _mm_srli_epi16(pixels, 8)));
+    }
+    fromRGB565Scalar(src, dst, count - vectorCount);
+}
+
+/*
+ * AVX2: selected at runtime
+ */
+
+__attribute__((target("avx2"))) void toRGB565Avx2(const uint8_t *src, uint8_t *dst, size_t count)
+{
+    const __m256i swapBytes = _mm256_setr_epi8(1, 0, -1, -1, 5, 4, -1, -1, 9, 8, -1, -1, 13, 12, -1, -1,
+                                               1, 0, -1, -1, 5, 4, -1, -1, 9, 8, -1, -1, 13, 12, -1, -1);
+    const size_t vectorCount = count & ~size_t{15};
+    for (const uint8_t *const end = src + vectorCount * kPixelSize; src < end; src += 16 * kPixelSize, dst += 16 * 2)
+    {
+        __m256i rgb565[2];
+        for (int i = 0; i < 2; ++i)
+        {
+            const __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i * 8 * kPixelSize));
+            const __m256i r = _mm256_slli_epi32(_mm256_and_si256(pixels, _mm256_set1_epi32(0xf8)), 8);
+            const __m256i g = _mm256_and_si256(_mm256_srli_epi32(pixels, 5), _mm256_set1_epi32(0x7e0));
+            const __m256i b = _mm256_and_si256(_mm256_srli_epi32(pixels, 19), _mm256_set1_epi32(0x1f));
+            // the high 16 bits are cleared by the shuffle: no saturation by _mm256_packus_epi32()
+            rgb565[i] = _mm256_shuffle_epi8(_mm256_or_si256(r, _mm256_or_si256(g, b)), swapBytes);
+        }
+        // the pack works on each 128 bits lane: put back the 64 bits blocks in order
+        const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(rgb565[0], rgb565[1]), 0xd8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), packed);
+    }
+    toRGB565Sse2(src, dst, count - vectorCount);
+}
+
+__attribute__((target("avx2"))) void toXRGB8888Avx2(const uint8_t *src, uint8_t *dst, size_t count)
+{
+    const __m256i bgr0 = _mm256_setr_epi8(2, 1, 0, -1, 6, 5, 4, -1, 10, 9, 8, -1, 14, 13, 12, -1,
+                                          2, 1, 0, -1, 6, 5, 4, -1, 10, 9, 8, -1, 14, 13, 12, -1);
+    const size_t vectorCount = count & ~size_t{7};
+    for (const uint8_t *const end = src + vectorCount * kPixelSize; src < end; src += 8 * kPixelSize, dst += 8 * kPixelSize)
+    {
+        const __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), _mm256_shuffle_epi8(pixels, bgr0));
+    }
+    toXRGB8888Sse2(src, dst, count - vectorCount);
+}
+
+__attribute__((target("avx2"))) void fromRGB565Avx2(const uint8_t *src, uint8_t *dst, size_t count)
+{
+    const size_t vectorCount = count & ~size_t{15};
+    for (const uint8_t *const end = src + vectorCount * 2; src < end; src += 16 * 2, dst += 16 * 2)
+    {
+        const __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), _mm256_or_si256(_mm256_slli_epi16(pixels, 8), _mm256_srli_epi16(pixels, 8)));
+    }
+    fromRGB565Sse2(src, dst, count - vectorCount);
+}
+
+#endif // PIXEL_X86
+
+#ifdef PIXEL_NEON
+
+/*
+ * NEON: always there on aarch64, requires -mfpu=neon on 32 bits ARM (Raspberry PI 2 and more)
+ */
+
+void toRGB565Neon(const uint8_t *src, uint8_t *dst, size_t count)
+{
+    const size_t vectorCount = count & ~size_t{15};
+    for (const uint8_t *const end = src + vectorCount * kPixelSize; src < end; src += 16 * kPixelSize, dst += 16 * 2)
+    {
+        const uint8x16x4_t rgba = vld4q_u8(src);
+        uint8x16x2_t rgb565;
+        // big endian: RRRRRGGG GGGBBBBB
+        rgb565.val[0] = vsriq_n_u8(rgba.val[0], rgba.val[1], 5);
+        rgb565.val[1] = vsriq_n_u8(vshlq_n_u8(rgba.val[1], 3), rgba.val[2], 3);
+        vst2q_u8(dst, rgb565);
+    }
+    toRGB565Scalar(src, dst, count - vectorCount);
+}
+
+void toXRGB8888Neon(const uint8_t *src, uint8_t *dst, size_t count)
+{
+    const size_t vectorCount = count & ~size_t{15};
+    for (const uint8_t *const end = src + vectorCount * kPixelSize; src < end; src += 16 * kPixelSize, dst += 16 * kPixelSize)
+    {
+        const uint8x16x4_t rgba = vld4q_u8(src);
+        const uint8x16x4_t bgr0 = {rgba.val[2], rgba.val[1], rgba.val[0], vdupq_n_u8(0)};
+        vst4q_u8(dst, bgr0);
+    }
+    toXRGB8888Scalar(src, dst, count - vectorCount);
+}
+
+void fromRGB565Neon(const uint8_t *src, uint8_t *dst, size_t count)
+{
+    const size_t vectorCount = count & ~size_t{7};
+    for (const uint8_t *const end = src + vectorCount * 2; src < end; src += 8 * 2, dst += 8 * 2)
+    {
+        vst1q_u8(dst, vrev16q_u8(vld1q_u8(src)));
+    }
+    fromRGB565Scalar(src, dst, count - vectorCount);
+}
+
+#endif // PIXEL_NEON
+
+} // namespace
+
+std::vector<PixelConverter> getPixelConverters()
+{
+    std::vector<PixelConverter> converters{{"scalar", toRGB565Scalar, toXRGB8888Scalar, fromRGB565Scalar}};
+#ifdef PIXEL_X86
+    if (__builtin_cpu_supports("sse2"))
+    {
+        converters.push_back({"sse2", toRGB565Sse2, toXRGB8888Sse2, fromRGB565Sse2});
+    }
+    if (__builtin_cpu_supports("avx2"))
+    {
+        converters.push_back({"avx2", toRGB565Avx2, toXRGB8888Avx2, fromRGB565Avx2});
+    }
+#endif // PIXEL_X86
+#ifdef PIXEL_NEON
+    converters.push_back({"neon", toRGB565Neon, toXRGB8888Neon, fromRGB565Neon});
+#endif // PIXEL_NEON
+    return converters;
+}
+
+const PixelConverter &getPixelConverter()
+{
+    static const PixelConverter converter = getPixelConverters().back();
+    return converter;
+}
+
+PixelConverter::Kernel getPixelKernel(PixelSource source, const PixelLayout &layout)
+{
+    // the layouts produced by the vectorized kernels
+    const auto &converter = getPixelConverter();
+    if (layout == RGB565<true>::kLayout)
+    {
+        return source == PixelSource::RGBA8888 ? converter.toRGB565 : converter.fromRGB565;
+    }
+    if (layout == XRGB8888<false>::kLayout && source == PixelSource::RGBA8888)
+    {
+        return converter.toXRGB8888;
+    }
+    return getSpecializedPixelKernel(source, layout);
+}
+
+PixelConverter::Kernel getSpecializedPixelKernel(PixelSource source, const PixelLayout &layout)
+{
+    for (const auto &specialization : getSpecializations())
+    {
+        if (specialization.source == source && specialization.layout == layout)
+        {
+            return specialization.kernel;
+        }
+    }
+    return nullptr;
+}
+
+std::vector<PixelLayout> getSupportedPixelLayouts()
+{
+    std::vector<PixelLayout> layouts;
+    for (const auto &specialization : getSpecializations())
+    {
+        if (specialization.source == PixelSource::RGBA8888)
+        {
+            layouts.push_back(specialization.layout);
+        }
+    }
+    return layouts;
+}
+
+void convertFrame(PixelConverter::Kernel kernel, const uint8_t *src, size_t srcPixelSize, size_t width, size_t height, uint8_t *dst, size_t dstStride)
+{
+    const size_t srcLineLen = width * srcPixelSize;
+    for (const uint8_t *srcLine = src + srcLineLen * height; srcLine > src; dst += dstStride)
+    {
+        srcLine -= srcLineLen;
+        kernel(srcLine, dst, width);
+    }
+}
+
+void convertFrame(PixelConverter::Kernel kernel,
+                  const uint8_t *src,
+                  size_t srcPixelSize,
+                  const Rect &region,
+                  size_t frameWidth,
+                  size_t frameHeight,
+                  const PixelTransform &transform,
+                  uint8_t *dst,
+                  size_t dstPixelSize,
+                  size_t dstStride)
+{
+    // 1 pixel of the frame on the screen
+    const ptrdiff_t stepX = transform.scale * dstPixelSize;
+    const ptrdiff_t stepY = transform.scale * dstStride;
+    const ptrdiff_t width = frameWidth;
+    const ptrdiff_t height = frameHeight;
+
+    // position on the screen of the pixel (x, y) of the frame, y from the top
+    ptrdiff_t originX = 0;
+    ptrdiff_t originY = 0;
+    ptrdiff_t stepColumn = stepX;
+    ptrdiff_t stepLine = stepY;
+    auto getScreen = [&](ptrdiff_t x, ptrdiff_t y) {
+        return dst + originX + originY + x * stepColumn + y * stepLine;
+    };
+    switch (transform.rotation90Degree & 3)
+    {
+    case 1:
+        // X = height - 1 - y, Y = x
+        originX = (height - 1) * stepX;
+        stepColumn = stepY;
+        stepLine = -stepX;
+        break;
+    case 2:
+        // X = width - 1 - x, Y = height - 1 - y
+        originX = (width - 1) * stepX;
+        originY = (height - 1) * stepY;
+        stepColumn = -stepX;
+        stepLine = -stepY;
+        break;
+    case 3:
+        // X = y, Y = width - 1 - x
+        originY = (width - 1) * stepY;
+        stepColumn = -stepY;
+        stepLine = stepX;
+        break;
+    default:
+        break;
+    }
+
+    const size_t regionWidth = region.width;
+    const size_t regionHeight = region.height;
+    const size_t regionTop = frameHeight - (region.y + region.height);
+    const size_t srcLineLen = regionWidth * srcPixelSize;
+    alignas(32) std::array<uint8_t, kTileSize * kTileSize * 4> tile;
+
+    for (size_t tileY = 0; tileY < regionHeight; tileY += kTileSize)
+    {
+        const size_t tileHeight = std::min(kTileSize, regionHeight - tileY);
+        for (size_t tileX = 0; tileX < regionWidth; tileX += kTileSize)
+        {
+            const size_t tileWidth = std::min(kTileSize, regionWidth - tileX);
+            for (size_t i = 0; i < tileHeight; ++i)
+            {
+                // src's 1st line is the bottom one
+                const uint8_t *srcLine = src + (regionHeight - 1 - (tileY + i)) * srcLineLen;
+                kernel(srcLine + tileX * srcPixelSize, tile.data() + i * kTileSize * dstPixelSize, tileWidth);
+            }
+
+            uint8_t *const tileDst = getScreen(region.x + tileX, regionTop + tileY);
+            if (dstPixelSize == 2)
+            {
+                writeTile(reinterpret_cast<const uint16_t *>(tile.data()), tileWidth, tileHeight, tileDst, stepLine, stepColumn, transform.scale, dstStride);
+            }
+            else if (dstPixelSize == 3)
+            {
+                writeTile(reinterpret_cast<const Pixel24 *>(tile.data()), tileWidth, tileHeight, tileDst, stepLine, stepColumn, transform.scale, dstStride);
+            }
+            else
+            {
+                writeTile(reinterpret_cast<const uint32_t *>(tile.data()), tileWidth, tileHeight, tileDst, stepLine, stepColumn, transform.scale, dstStride);
+            }
+        }
+    }
+}
@@ -0,0 +1,171 @@
+#pragma once
+
+/**
+ * @file
+ *
+ * This file is to convert the frame read from OpenGL (RGBA8888 or RGB565, 1st line at the bottom) into the Linux
+ * framebuffer formats (1st line at the top). Any 16, 24 or 32 bpp layout of fb_var_screeninfo has its own kernel
+ */
+
+#include "toolbox_rect.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Conversion kernels of 1 instruction set
+ *
+ * All the kernels produce exactly the same bytes. Only the speed differs
+ */
+struct PixelConverter
+{
+    /**
+     * Convert 1 line
+     *
+     * @param src pixels as read by glReadPixels()
+     * @param dst converted pixels
+     * @param count number of pixels
+     */
+    using Kernel = void (*)(const uint8_t *src, uint8_t *dst, size_t count);
+
+    /**
+     * Name of the instruction set: scalar, sse2, avx2, neon
+     */
+    const char *name;
+
+    /**
+     * RGBA8888 -> RGB565, big endian. count must be even
+     */
+    Kernel toRGB565;
+
+    /**
+     * RGBA8888 -> XRGB8888, little endian (bytes: B, G, R, 0)
+     */
+    Kernel toXRGB8888;
+
+    /**
+     * RGB565 in the CPU's endianness (GL_RGB + GL_UNSIGNED_SHORT_5_6_5) -> RGB565, big endian
+     */
+    Kernel fromRGB565;
+};
+
+/**
+ * @brief Layout of the frame on the screen
+ */
+struct PixelTransform
+{
+    int rotation90Degree = 0; ///< clockwise, in range [0,3] (0: no rotation, 1: 90deg, 2: 180deg, 3: 270deg)
+    int scale = 1;            ///< integer upscaling, at least 1
+};
+
+/**
+ * @brief Format of the frame read from OpenGL
+ */
+enum class PixelSource
+{
+    RGBA8888, ///< GL_RGBA + GL_UNSIGNED_BYTE
+    RGB565    ///< GL_RGB + GL_UNSIGNED_SHORT_5_6_5, in the CPU's endianness
+};
+
+/**
+ * @brief Bitfields of a framebuffer pixel, as described by fb_var_screeninfo
+ *
+ * The offsets are in the pixel value, which is stored in bitsPerPixel / 8 bytes in the bigEndian byte order
+ */
+struct PixelLayout
+{
+    int bitsPerPixel = 32; ///< 16, 24 or 32
+    int redOffset = 16;
+    int redLength = 8;
+    int greenOffset = 8;
+    int greenLength = 8;
+    int blueOffset = 0;
+    int blueLength = 8;
+    bool bigEndian = false;
+
+    constexpr bool operator==(const PixelLayout &other) const
+    {
+        return bitsPerPixel == other.bitsPerPixel && redOffset == other.redOffset && redLength == other.redLength &&
+               greenOffset == other.greenOffset && greenLength == other.greenLength && blueOffset == other.blueOffset &&
+               blueLength == other.blueLength && bigEndian == other.bigEndian;
+    }
+
+    constexpr bool operator!=(const PixelLayout &other) const
+    {
+        return !(*this == other);
+    }
+};
+
+/**
+ * All the converters the CPU can run. The portable scalar one is the 1st, the fastest one is the last
+ */
+std::vector<PixelConverter> getPixelConverters();
+
+/**
+ * Fastest converter for this CPU. Selected at the 1st call
+ */
+const PixelConverter &getPixelConverter();
+
+/**
+ * Kernel converting from source to layout, to select once at startup
+ *
+ * The vectorized kernels of getPixelConverter() are used for the layouts they produce, the portable kernel specialized
+ * for this layout otherwise
+ *
+ * @return nullptr if the layout is not supported
+ */
+PixelConverter::Kernel getPixelKernel(PixelSource source, const PixelLayout &layout);
+
+/**
+ * Portable kernel specialized at compile time for exactly this source and layout: the inner loop has no branch
+ *
+ * @return nullptr if the layout is not supported
+ */
+PixelConverter::Kernel getSpecializedPixelKernel(PixelSource source, const PixelLayout &layout);
+
+/**
+ * Layouts supported by getPixelKernel(): RGB565, BGR565, RGB555, RGB888, BGR888, XRGB8888, XBGR8888, RGBX8888,
+ * BGRX8888, each in both byte orders
+ */
+std::vector<PixelLayout> getSupportedPixelLayouts();
+
+/**
+ * Convert a whole frame and flip it vertically
+ *
+ * @param kernel one of the PixelConverter's kernels
+ * @param src lines, without padding. The 1st line is the bottom one
+ * @param srcPixelSize 4 for RGBA8888, 2 for RGB565
+ * @param width number of pixels per line
+ * @param height number of lines
+ * @param dst where to write the 1st line, which is the top one
+ * @param dstStride bytes between 2 lines in dst
+ */
+void convertFrame(PixelConverter::Kernel kernel, const uint8_t *src, size_t srcPixelSize, size_t width, size_t height, uint8_t *dst, size_t dstStride);
+
+/**
+ * Convert a part of a frame, flip it vertically, then rotate and upscale it
+ *
+ * The frame is processed by tiles which fit in the cache, so the rotated writes stay close to each other
+ *
+ * @param kernel one of the PixelConverter's kernels
+ * @param src lines of the region, without padding. The 1st line is the bottom one
+ * @param srcPixelSize 4 for RGBA8888, 2 for RGB565
+ * @param region part of the frame in src, in OpenGL coordinates (origin down left)
+ * @param frameWidth width of the whole frame
+ * @param frameHeight height of the whole frame
+ * @param transform rotation and scale
+ * @param dst where the top left pixel of the whole transformed frame is
+ * @param dstPixelSize bitsPerPixel / 8 of the PixelLayout
+ * @param dstStride bytes between 2 lines in dst
+ */
+void convertFrame(PixelConverter::Kernel kernel,
+                  const uint8_t *src,
+                  size_t srcPixelSize,
+                  const Rect &region,
+                  size_t frameWidth,
+                  size_t frameHeight,
+                  const PixelTransform &transform,
+                  uint8_t *dst,
+                  size_t dstPixelSize,
+                  size_t dstStride);
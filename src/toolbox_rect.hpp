@@ -0,0 +1,74 @@
+#pragma once
+
+/**
+ * @file
+ *
+ * This file is to provide a basic rectangle type and its operations
+ */
+
+#include <algorithm>
+
+/**
+ * @brief Axis aligned rectangle
+ *
+ * The unit depends on the user (logical position on screen, pixels...).
+ * The origin is down left, like in OpenGL
+ */
+struct Rect
+{
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+
+    constexpr bool empty() const
+    {
+        return width <= 0 || height <= 0;
+    }
+
+    constexpr bool operator==(const Rect &other) const
+    {
+        return x == other.x && y == other.y && width == other.width && height == other.height;
+    }
+
+    constexpr bool operator!=(const Rect &other) const
+    {
+        return !(*this == other);
+    }
+
+    /**
+     * Smallest rectangle containing both rectangles. The empty rectangles are ignored
+     */
+    constexpr Rect united(const Rect &other) const
+    {
+        if (empty())
+        {
+            return other;
+        }
+        if (other.empty())
+        {
+            return *this;
+        }
+        const int left = std::min(x, other.x);
+        const int bottom = std::min(y, other.y);
+        const int right = std::max(x + width, other.x + other.width);
+        const int top = std::max(y + height, other.y + other.height);
+        return {left, bottom, right - left, top - bottom};
+    }
+
+    /**
+     * Common part of both rectangles. May be empty
+     */
+    constexpr Rect intersected(const Rect &other) const
+    {
+        const int left = std::max(x, other.x);
+        const int bottom = std::max(y, other.y);
+        const int right = std::min(x + width, other.x + other.width);
+        const int top = std::min(y + height, other.y + other.height);
+        if (right <= left || top <= bottom)
+        {
+            return {};
+        }
+        return {left, bottom, right - left, top - bottom};
+    }
+};
@@ -0,0 +1,131 @@
+#include "toolbox_sdf.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+
+// squared distance of the pixels without feature, large but finite for the computations of transform()
+constexpr double kFar = 1e20;
+
+/**
+ * 1D squared distance transform of f, from "Distance Transforms of Sampled Functions", Felzenszwalb & Huttenlocher
+ */
+void transform(const std::vector<double> &f, std::vector<double> &d, std::vector<int> &v, std::vector<double> &z)
+{
+    const int n = static_cast<int>(f.size());
+    const auto intersection = [&f](int q, int p) {
+        return ((f[q] + q * q) - (f[p] + p * p)) / (2. * (q - p));
+    };
+
+    // lower envelope of the parabolas
+    int k = 0;
+    v[0] = 0;
+    z[0] = -std::numeric_limits<double>::infinity();
+    z[1] = std::numeric_limits<double>::infinity();
+    for (int q = 1; q < n; ++q)
+    {
+        double s = intersection(q, v[k]);
+        while (s <= z[k])
+        {
+            --k;
+            s = intersection(q, v[k]);
+        }
+        ++k;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = std::numeric_limits<double>::infinity();
+    }
+
+    k = 0;
+    for (int q = 0; q < n; ++q)
+    {
+        while (z[k + 1] < q)
+        {
+            ++k;
+        }
+        d[q] = (q - v[k]) * (q - v[k]) + f[v[k]];
+    }
+}
+
+/**
+ * Euclidean distance of each pixel to the nearest pixel inside (or outside) the glyphs
+ */
+std::vector<double> getDistances(const uint8_t *pixels, int width, int height, bool inside)
+{
+    std::vector<double> grid(static_cast<size_t>(width) * height);
+    for (size_t i = 0; i < grid.size(); ++i)
+    {
+        grid[i] = (pixels[i] >= 128) == inside ? 0. : kFar;
+    }
+
+    const int size = std::max(width, height);
+    std::vector<double> f;
+    std::vector<double> d;
+    std::vector<int> v(size);
+    std::vector<double> z(size + 1);
+
+    // columns, then lines
+    f.resize(height);
+    d.resize(height);
+    for (int x = 0; x < width; ++x)
+    {
+        for (int y = 0; y < height; ++y)
+        {
+            f[y] = grid[y * width + x];
+        }
+        transform(f, d, v, z);
+        for (int y = 0; y < height; ++y)
+        {
+            grid[y * width + x] = d[y];
+        }
+    }
+    f.resize(width);
+    d.resize(width);
+    for (int y = 0; y < height; ++y)
+    {
+        std::copy_n(&grid[y * width], width, f.begin());
+        transform(f, d, v, z);
+        std::copy_n(d.begin(), width, &grid[y * width]);
+    }
+
+    for (double &distance : grid)
+    {
+        distance = std::sqrt(distance);
+    }
+    return grid;
+}
+
+} // namespace
+
+std::vector<uint8_t> getSignedDistanceField(const uint8_t *pixels, int width, int height, int scale, double spread)
+{
+    const std::vector<double> toInside = getDistances(pixels, width, height, true);
+    const std::vector<double> toOutside = getDistances(pixels, width, height, false);
+
+    const int outputWidth = width / scale;
+    const int outputHeight = height / scale;
+    std::vector<uint8_t> output(static_cast<size_t>(outputWidth) * outputHeight);
+    for (int y = 0; y < outputHeight; ++y)
+    {
+        for (int x = 0; x < outputWidth; ++x)
+        {
+            // average of the input block, positive inside, the edges are between the pixels
+            double sum = 0;
+            for (int j = 0; j < scale; ++j)
+            {
+                for (int i = 0; i < scale; ++i)
+                {
+                    const size_t index = static_cast<size_t>(y * scale + j) * width + x * scale + i;
+                    sum += toOutside[index] > 0 ? toOutside[index] - .5 : .5 - toInside[index];
+                }
+            }
+            const double distance = sum / (scale * scale) / scale;
+            const double value = std::clamp(.5 + distance / (2 * spread), 0., 1.);
+            output[static_cast<size_t>(y) * outputWidth + x] = static_cast<uint8_t>(std::lround(value * 255));
+        }
+    }
+    return output;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+/**
+ * @file
+ *
+ * This file is to provide the signed distance fields of the font, computed at build time by tools/font_sdf.cpp and at
+ * runtime by RendererGlyphCache
+ */
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Signed distance field of a grey image, scale times smaller
+ *
+ * The pixels >= 128 are inside. The output is 128 on the edges, 255 at spread output pixels inside, 0 at spread output
+ * pixels outside, like font_sdf.dds. The distances are exact (Euclidean distance transform).
+ * @param pixels width * height, 1 byte per pixel
+ * @return (width / scale) * (height / scale) bytes
+ */
+std::vector<uint8_t> getSignedDistanceField(const uint8_t *pixels, int width, int height, int scale, double spread);
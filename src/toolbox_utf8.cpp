@@ -0,0 +1,70 @@
+#include "toolbox_utf8.hpp"
+
+char32_t popUtf8(std::string_view &text)
+{
+    const auto first = static_cast<unsigned char>(text.front());
+    text.remove_prefix(1);
+    // fast path
+    if (first < 0x80)
+    {
+        return first;
+    }
+
+    size_t continuation;
+    char32_t codePoint;
+    char32_t minimum;
+    if ((first & 0xe0) == 0xc0)
+    {
+        continuation = 1;
+        codePoint = first & 0x1f;
+        minimum = 0x80;
+    }
+    else if ((first & 0xf0) == 0xe0)
+    {
+        continuation = 2;
+        codePoint = first & 0x0f;
+        minimum = 0x800;
+    }
+    else if ((first & 0xf8) == 0xf0)
+    {
+        continuation = 3;
+        codePoint = first & 0x07;
+        minimum = 0x10000;
+    }
+    else
+    {
+        return kUtf8Replacement;
+    }
+
+    if (text.size() < continuation)
+    {
+        return kUtf8Replacement;
+    }
+    for (size_t i = 0; i < continuation; ++i)
+    {
+        const auto c = static_cast<unsigned char>(text[i]);
+        if ((c & 0xc0) != 0x80)
+        {
+            return kUtf8Replacement;
+        }
+        codePoint = codePoint << 6 | (c & 0x3f);
+    }
+
+    // overlong encodings, surrogates and out of Unicode
+    if (codePoint < minimum || (codePoint >= 0xd800 && codePoint <= 0xdfff) || codePoint > 0x10ffff)
+    {
+        return kUtf8Replacement;
+    }
+    text.remove_prefix(continuation);
+    return codePoint;
+}
+
+size_t getUtf8Length(std::string_view text)
+{
+    size_t length = 0;
+    for (; !text.empty(); ++length)
+    {
+        popUtf8(text);
+    }
+    return length;
+}
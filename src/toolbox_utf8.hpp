@@ -0,0 +1,29 @@
+#pragma once
+
+/**
+ * @file
+ *
+ * This file is to provide some tools to read UTF-8 texts, e.g. the translations
+ */
+
+#include <cstddef>
+#include <string_view>
+
+/**
+ * Replacement of the invalid sequences
+ */
+constexpr char32_t kUtf8Replacement = 0xfffd;
+
+/**
+ * Decode the first code point of the text and remove it from the text
+ *
+ * The ASCII characters are a single byte. An invalid or truncated sequence gives kUtf8Replacement and only its 1st
+ * byte is removed
+ * @pre !text.empty()
+ */
+char32_t popUtf8(std::string_view &text);
+
+/**
+ * Number of code points of the text
+ */
+size_t getUtf8Length(std::string_view text);
@@ -1,3 +1,21 @@
 #include "window.hpp"
 
 Window::~Window() = default;
+
+void Window::setDamage(const Rect &)
+{
+}
+
+bool Window::setRotation(int rotation90Degree)
+{
+    return rotation90Degree == 0;
+}
+
+bool Window::isSoftware() const
+{
+    return false;
+}
+
+void Window::setSoftwareFrame(const uint8_t *)
+{
+}
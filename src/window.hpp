@@ -1,5 +1,8 @@
 #pragma once
 
+#include "toolbox_rect.hpp"
+
+#include <cstdint>
 #include <iosfwd>
 #include <memory>
 #include <optional>
@@ -24,6 +27,36 @@ public:
      */
     virtual void end() = 0;
 
+    /**
+     * Part of the OpenGL surface (in pixels) which has changed since the previous frame. Empty if nothing has changed
+     *
+     * To be called before end(). Only valid for the next frame.
+     * By default, the whole surface is refreshed
+     */
+    virtual void setDamage(const Rect &damage);
+
+    /**
+     * Rotate the display clockwise. To be called before the 1st frame
+     *
+     * @param rotation90Degree is in range [0,3] (0: no rotation, 1: 90deg, 2: 180deg, 3: 270deg)
+     * @return false if the window cannot rotate the display. By default, only 0 is supported
+     */
+    virtual bool setRotation(int rotation90Degree);
+
+    /**
+     * The window has no OpenGL context: the frame is drawn by the CPU (RendererSoftware)
+     *
+     * By default, false
+     */
+    virtual bool isSoftware() const;
+
+    /**
+     * Frame drawn by the CPU, if isSoftware(). To be called before the 1st frame: it is read at each end()
+     *
+     * @param frame RGBA8888 of the size of the window, 1st line at the bottom like glReadPixels()
+     */
+    virtual void setSoftwareFrame(const uint8_t *frame);
+
     /**
      * Create the events from the WindowManager
      */
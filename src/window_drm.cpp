@@ -0,0 +1,547 @@
+#include "window_drm.hpp"
+
+#ifdef USE_WINDOW_DRM
+
+#include "windowevent_linux.hpp"
+
+#include "egl_error.hpp"
+#include "toolbox_gl.hpp"
+#include "toolbox_io.hpp"
+#include "toolbox_pixel.hpp"
+
+#include <EGL/egl.h>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <xf86drm.h>
+#include <xf86drmMode.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <optional>
+#include <vector>
+
+namespace
+{
+
+using DrmResources = std::unique_ptr<drmModeRes, decltype(&drmModeFreeResources)>;
+using DrmConnector = std::unique_ptr<drmModeConnector, decltype(&drmModeFreeConnector)>;
+using DrmEncoder = std::unique_ptr<drmModeEncoder, decltype(&drmModeFreeEncoder)>;
+using DrmCrtc = std::unique_ptr<drmModeCrtc, decltype(&drmModeFreeCrtc)>;
+
+// the page flip event should come at the next vertical blank
+constexpr int kFlipTimeoutMs = 1000;
+
+/**
+ * @brief Output found on a DRM device
+ */
+struct Output
+{
+    uint32_t connectorId = 0;
+    uint32_t crtcId = 0;
+    drmModeModeInfo mode;
+};
+
+/**
+ * 1st connected connector with a CRTC, in its preferred mode
+ */
+std::optional<Output> findOutput(int fd)
+{
+    const DrmResources resources{drmModeGetResources(fd), &drmModeFreeResources};
+    if (resources == nullptr)
+    {
+        // not a KMS device
+        return std::nullopt;
+    }
+
+    for (int i = 0; i < resources->count_connectors; ++i)
+    {
+        const DrmConnector connector{drmModeGetConnector(fd, resources->connectors[i]), &drmModeFreeConnector};
+        if (connector == nullptr || connector->connection != DRM_MODE_CONNECTED || connector->count_modes == 0)
+        {
+            continue;
+        }
+
+        Output output;
+        output.connectorId = connector->connector_id;
+        output.mode = connector->modes[0];
+        for (int mode = 0; mode < connector->count_modes; ++mode)
+        {
+            if (connector->modes[mode].type & DRM_MODE_TYPE_PREFERRED)
+            {
+                output.mode = connector->modes[mode];
+                break;
+            }
+        }
+
+        // keep the current CRTC if there is one, otherwise the 1st compatible one
+        const DrmEncoder current{drmModeGetEncoder(fd, connector->encoder_id), &drmModeFreeEncoder};
+        if (current && current->crtc_id)
+        {
+            output.crtcId = current->crtc_id;
+            return output;
+        }
+        for (int j = 0; j < connector->count_encoders; ++j)
+        {
+            const DrmEncoder encoder{drmModeGetEncoder(fd, connector->encoders[j]), &drmModeFreeEncoder};
+            for (int crtc = 0; encoder && crtc < resources->count_crtcs; ++crtc)
+            {
+                if (encoder->possible_crtcs & (1u << crtc))
+                {
+                    output.crtcId = resources->crtcs[crtc];
+                    return output;
+                }
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+/**
+ * Get a config for RGB888 pbuffers
+ */
+EGLConfig chooseConfig(EGLDisplay display)
+{
+    static constexpr EGLint eglConfigAttributes[] = {
+        EGL_RED_SIZE, 8,
+        EGL_GREEN_SIZE, 8,
+        EGL_BLUE_SIZE, 8,
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
+        EGL_NONE};
+    EGLConfig eglConfig = nullptr;
+    EGLint numConfig = 0;
+    if (eglChooseConfig(display, eglConfigAttributes, &eglConfig, 1, &numConfig) == EGL_FALSE)
+    {
+        throw EGLError{"eglChooseConfig() failed"};
+    }
+    if (numConfig == 0)
+    {
+        throw EGLError{"No EGL config for RGB888"};
+    }
+    return eglConfig;
+}
+
+} // namespace
+
+struct WindowDrm::Impl
+{
+    /**
+     * @brief Dumb buffer scanned out by the CRTC: XRGB8888, little endian
+     */
+    struct Buffer
+    {
+        uint32_t handle = 0;
+        uint32_t fbId = 0;
+        uint32_t stride = 0;
+        MmapFile mmaped;
+        // the layout has changed since it was written: cleared then fully written once it is not scanned out
+        bool outdated = true;
+    };
+
+    static void onPageFlip(int, unsigned int, unsigned int, unsigned int, void *userData)
+    {
+        Impl &impl = *static_cast<Impl *>(userData);
+        impl.flipPending = false;
+        ++impl.statistics.flipEvents;
+    }
+
+    ~Impl()
+    {
+        if (eglDisplay)
+        {
+            eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        }
+        if (eglContext)
+        {
+            eglDestroyContext(eglDisplay, eglContext);
+        }
+        if (eglSurface)
+        {
+            eglDestroySurface(eglDisplay, eglSurface);
+        }
+        if (eglDisplay)
+        {
+            eglTerminate(eglDisplay);
+        }
+
+        if (fd.fd < 0)
+        {
+            return;
+        }
+        // the buffer must not be removed while it is displayed
+        try
+        {
+            waitFlip();
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << e.what() << std::endl;
+        }
+        if (savedCrtc)
+        {
+            drmModeSetCrtc(fd.fd, savedCrtc->crtc_id, savedCrtc->buffer_id, savedCrtc->x, savedCrtc->y, &output.connectorId, 1, &savedCrtc->mode);
+        }
+        for (auto &buffer : buffers)
+        {
+            buffer.mmaped = MmapFile{};
+            if (buffer.fbId)
+            {
+                drmModeRmFB(fd.fd, buffer.fbId);
+            }
+            if (buffer.handle)
+            {
+                drm_mode_destroy_dumb destroy{};
+                destroy.handle = buffer.handle;
+                drmIoctl(fd.fd, DRM_IOCTL_MODE_DESTROY_DUMB, &destroy);
+            }
+        }
+    }
+
+    /**
+     * Open the device if it has a connected output
+     */
+    bool openDevice(const std::string &filename)
+    {
+        FileUnix card{open(filename.c_str(), O_RDWR | O_CLOEXEC)};
+        if (card.fd < 0)
+        {
+            return false;
+        }
+        uint64_t hasDumb = 0;
+        if (drmGetCap(card.fd, DRM_CAP_DUMB_BUFFER, &hasDumb) || hasDumb == 0)
+        {
+            return false;
+        }
+        const auto found = findOutput(card.fd);
+        if (!found)
+        {
+            return false;
+        }
+        device = filename;
+        fd = std::move(card);
+        output = *found;
+        return true;
+    }
+
+    /**
+     * Open the 1st DRM device which has a connected output
+     */
+    void openFirstDevice()
+    {
+        for (int cardNumber = 0; cardNumber < 16; ++cardNumber)
+        {
+            if (openDevice("/dev/dri/card" + std::to_string(cardNumber)))
+            {
+                return;
+            }
+        }
+        throw std::runtime_error{"WindowDrm: no DRM device with a connected output"};
+    }
+
+    void createBuffer(Buffer &buffer)
+    {
+        drm_mode_create_dumb create{};
+        create.width = output.mode.hdisplay;
+        create.height = output.mode.vdisplay;
+        create.bpp = 32;
+        if (drmIoctl(fd.fd, DRM_IOCTL_MODE_CREATE_DUMB, &create))
+        {
+            throw std::runtime_error{"ioctl(DRM_IOCTL_MODE_CREATE_DUMB) failed"};
+        }
+        buffer.handle = create.handle;
+        buffer.stride = create.pitch;
+
+        if (drmModeAddFB(fd.fd, create.width, create.height, 24, 32, create.pitch, create.handle, &buffer.fbId))
+        {
+            throw std::runtime_error{"drmModeAddFB() failed"};
+        }
+
+        drm_mode_map_dumb map{};
+        map.handle = create.handle;
+        if (drmIoctl(fd.fd, DRM_IOCTL_MODE_MAP_DUMB, &map))
+        {
+            throw std::runtime_error{"ioctl(DRM_IOCTL_MODE_MAP_DUMB) failed"};
+        }
+        buffer.mmaped = MmapFile{mmap(nullptr, create.size, PROT_READ | PROT_WRITE, MAP_SHARED, fd.fd, map.offset), create.size};
+        std::memset(buffer.mmaped.content, 0, buffer.mmaped.size);
+    }
+
+    /**
+     * Block until the last page flip has happened: the back buffer is not scanned out anymore
+     */
+    void waitFlip()
+    {
+        drmEventContext context{};
+        context.version = 2;
+        context.page_flip_handler = &Impl::onPageFlip;
+        while (flipPending)
+        {
+            pollfd event{fd.fd, POLLIN, 0};
+            const int result = poll(&event, 1, kFlipTimeoutMs);
+            if (result < 0 && errno != EINTR)
+            {
+                throw std::runtime_error{"poll() on the DRM device failed"};
+            }
+            if (result == 0)
+            {
+                std::cerr << "WindowDrm: no page flip event after " << kFlipTimeoutMs << "ms" << std::endl;
+                flipPending = false;
+                ++statistics.flipTimeouts;
+            }
+            else if (result > 0)
+            {
+                drmHandleEvent(fd.fd, &context);
+            }
+        }
+    }
+
+    /**
+     * Place the rotated frame in the middle of the screen, upscaled as much as possible
+     *
+     * @return false if the rotated frame is larger than the screen: the layout is not changed
+     */
+    bool setLayout(int rotation90Degree)
+    {
+        const uint32_t screenWidth = output.mode.hdisplay;
+        const uint32_t screenHeight = output.mode.vdisplay;
+        const uint32_t rotatedWidth = rotation90Degree % 2 ? height : width;
+        const uint32_t rotatedHeight = rotation90Degree % 2 ? width : height;
+        if (screenWidth < rotatedWidth || screenHeight < rotatedHeight)
+        {
+            return false;
+        }
+
+        transform.rotation90Degree = rotation90Degree;
+        transform.scale = std::min(screenWidth / rotatedWidth, screenHeight / rotatedHeight);
+        marginX = (screenWidth - rotatedWidth * transform.scale) / 2;
+        marginY = (screenHeight - rotatedHeight * transform.scale) / 2;
+
+        // the margins are never written. The front buffer is scanned out: both are cleared by end(), when they are back
+        for (auto &buffer : buffers)
+        {
+            buffer.outdated = true;
+        }
+        return true;
+    }
+
+    /**
+     * Read the damaged part of the surface into the back buffer
+     */
+    void readback(const Rect &damage)
+    {
+        Buffer &buffer = buffers[backBuffer];
+        uint8_t *const origin = reinterpret_cast<uint8_t *>(buffer.mmaped.content) + marginY * buffer.stride + marginX * kPixelSize;
+
+        glReadPixels(damage.x, damage.y, damage.width, damage.height, GL_RGBA, GL_UNSIGNED_BYTE, glFrame.data());
+        if (transform.rotation90Degree == 0 && transform.scale == 1)
+        {
+            // OpenGL's origin is down left, the dumb buffer's one is up left
+            convertFrame(kernel,
+                         glFrame.data(),
+                         4,
+                         damage.width,
+                         damage.height,
+                         origin + (height - (damage.y + damage.height)) * buffer.stride + damage.x * kPixelSize,
+                         buffer.stride);
+        }
+        else
+        {
+            convertFrame(kernel, glFrame.data(), 4, damage, width, height, transform, origin, kPixelSize, buffer.stride);
+        }
+    }
+
+    static constexpr uint32_t kPixelSize = 4;
+
+    uint32_t height = 0;
+    uint32_t width = 0;
+    std::string device;
+    FileUnix fd;
+    Output output;
+    // to restore the console at exit
+    DrmCrtc savedCrtc{nullptr, &drmModeFreeCrtc};
+    // the CRTC scans out 1 buffer while the other one is written
+    std::array<Buffer, 2> buffers;
+    uint32_t backBuffer = 1;
+    bool flipPending = false;
+    Statistics statistics;
+    // the part of the surface which has changed in the displayed buffer but not in the back one
+    Rect lastDamage;
+    // where the frame is written in the buffers
+    PixelTransform transform;
+    uint32_t marginX = 0;
+    uint32_t marginY = 0;
+    PixelConverter::Kernel kernel = nullptr;
+
+    std::vector<uint8_t> glFrame;
+    // nothing means the whole surface
+    std::optional<Rect> damage;
+
+    EGLDisplay eglDisplay = nullptr;
+    EGLSurface eglSurface = nullptr;
+    EGLContext eglContext = nullptr;
+};
+
+WindowDrm::WindowDrm(int width, int height)
+    : WindowDrm{width, height, std::string{}}
+{
+}
+
+WindowDrm::WindowDrm(int width, int height, const std::string &device)
+    : pimpl{std::make_unique<Impl>()}
+{
+    pimpl->width = width;
+    pimpl->height = height;
+    if (device.empty())
+    {
+        pimpl->openFirstDevice();
+    }
+    else if (!pimpl->openDevice(device))
+    {
+        throw std::runtime_error{"WindowDrm: no connected output on " + device};
+    }
+
+    for (auto &buffer : pimpl->buffers)
+    {
+        pimpl->createBuffer(buffer);
+    }
+    pimpl->kernel = getPixelKernel(PixelSource::RGBA8888, PixelLayout{});
+    if (pimpl->setLayout(0) == false)
+    {
+        throw std::runtime_error{pimpl->device + "=" + std::to_string(pimpl->output.mode.hdisplay) + "*" + std::to_string(pimpl->output.mode.vdisplay) + " is smaller than " + std::to_string(width) + "*" + std::to_string(height)};
+    }
+
+    pimpl->savedCrtc.reset(drmModeGetCrtc(pimpl->fd.fd, pimpl->output.crtcId));
+    if (drmModeSetCrtc(pimpl->fd.fd, pimpl->output.crtcId, pimpl->buffers[0].fbId, 0, 0, &pimpl->output.connectorId, 1, &pimpl->output.mode))
+    {
+        // another process is the DRM master, like a display server
+        throw std::runtime_error{"drmModeSetCrtc() failed on " + pimpl->device};
+    }
+
+    pimpl->eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (pimpl->eglDisplay == EGL_NO_DISPLAY)
+    {
+        throw EGLError{"eglGetDisplay() failed"};
+    }
+    if (eglInitialize(pimpl->eglDisplay, nullptr, nullptr) == EGL_FALSE)
+    {
+        throw EGLError{"eglInitialize() failed"};
+    }
+
+    const EGLConfig eglConfig = chooseConfig(pimpl->eglDisplay);
+    const EGLint pbufferAttribs[] = {
+        EGL_WIDTH, width,
+        EGL_HEIGHT, height,
+        EGL_NONE};
+    pimpl->eglSurface = eglCreatePbufferSurface(pimpl->eglDisplay, eglConfig, pbufferAttribs);
+    if (pimpl->eglSurface == EGL_NO_SURFACE)
+    {
+        throw EGLError{"eglCreatePbufferSurface() failed"};
+    }
+
+    if (eglBindAPI(EGL_OPENGL_ES_API) == EGL_FALSE)
+    {
+        throw EGLError{"eglBindAPI() failed"};
+    }
+
+    static constexpr EGLint eglContextAttributes[] = {
+        EGL_CONTEXT_CLIENT_VERSION, 2,
+        EGL_NONE};
+    pimpl->eglContext = eglCreateContext(pimpl->eglDisplay, eglConfig, EGL_NO_CONTEXT, eglContextAttributes);
+    if (pimpl->eglContext == EGL_NO_CONTEXT)
+    {
+        throw EGLError{"eglCreateContext() failed"};
+    }
+    if (eglMakeCurrent(pimpl->eglDisplay, pimpl->eglSurface, pimpl->eglSurface, pimpl->eglContext) == EGL_FALSE)
+    {
+        throw EGLError{"eglMakeCurrent() failed"};
+    }
+
+    pimpl->glFrame.resize(width * height * 4);
+}
+
+WindowDrm::~WindowDrm() = default;
+
+void WindowDrm::begin()
+{
+}
+
+bool WindowDrm::setRotation(int rotation90Degree)
+{
+    pimpl->waitFlip();
+    return pimpl->setLayout(rotation90Degree);
+}
+
+void WindowDrm::setDamage(const Rect &damage)
+{
+    pimpl->damage = damage;
+}
+
+void WindowDrm::end()
+{
+    const Rect surface{0, 0, static_cast<int>(pimpl->width), static_cast<int>(pimpl->height)};
+    Rect damage = pimpl->damage.value_or(surface);
+    pimpl->damage.reset();
+
+    damage = damage.intersected(surface);
+    if (damage.empty())
+    {
+        // the screen already displays this frame
+        return;
+    }
+    // the back buffer is 2 frames late
+    const Rect frameDamage = damage;
+    damage = damage.united(pimpl->lastDamage);
+    pimpl->lastDamage = frameDamage;
+
+    // the back buffer is still scanned out until the previous flip: this paces the loop at the refresh rate
+    pimpl->waitFlip();
+    Impl::Buffer &buffer = pimpl->buffers[pimpl->backBuffer];
+    if (buffer.outdated)
+    {
+        std::memset(buffer.mmaped.content, 0, buffer.mmaped.size);
+        buffer.outdated = false;
+        damage = surface;
+    }
+    pimpl->readback(damage);
+
+    if (drmModePageFlip(pimpl->fd.fd, pimpl->output.crtcId, buffer.fbId, DRM_MODE_PAGE_FLIP_EVENT, pimpl.get()))
+    {
+        throw std::runtime_error{"drmModePageFlip() failed"};
+    }
+    pimpl->flipPending = true;
+    ++pimpl->statistics.flips;
+    pimpl->backBuffer ^= 1;
+}
+
+std::unique_ptr<WindowEvent> WindowDrm::createDefaultEvent()
+{
+    return std::make_unique<WindowEventLinux>();
+}
+
+const WindowDrm::Statistics &WindowDrm::getStatistics() const
+{
+    return pimpl->statistics;
+}
+
+std::ostream &WindowDrm::toStream(std::ostream &str) const
+{
+    const auto &mode = pimpl->output.mode;
+    str << "\nWindow DRM " << pimpl->device << ": " << pimpl->width << 'x' << pimpl->height
+        << "\nMode " << mode.name << ": " << mode.hdisplay << 'x' << mode.vdisplay << '@' << mode.vrefresh << "Hz, connector " << pimpl->output.connectorId << ", crtc " << pimpl->output.crtcId
+        << "\nScreen: rotation " << pimpl->transform.rotation90Degree * 90 << "deg, scale x" << pimpl->transform.scale
+        << "\nPage flips: " << pimpl->statistics.flips << ", " << pimpl->statistics.flipEvents << " events, " << pimpl->statistics.flipTimeouts << " timeouts"
+        << "\nEGL info:\n - EGL_CLIENT_APIS: " << eglQueryString(pimpl->eglDisplay, EGL_CLIENT_APIS)
+        << "\n - EGL_VENDOR: " << eglQueryString(pimpl->eglDisplay, EGL_VENDOR)
+        << "\n - EGL_VERSION: " << eglQueryString(pimpl->eglDisplay, EGL_VERSION)
+        << "\n - EGL_EXTENSIONS: " << eglQueryString(pimpl->eglDisplay, EGL_EXTENSIONS);
+
+    return str;
+}
+
+#endif // USE_WINDOW_DRM
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "window.hpp"
+
+#ifdef USE_WINDOW_DRM
+
+#include <memory>
+#include <string>
+
+/**
+ * @brief Window to output to a DRM/KMS device, without any display server
+ *
+ * The frame is rendered into an EGL pbuffer, then converted into 2 DRM dumb buffers which are page flipped at the
+ * vertical blank: no tearing, and end() waits for the previous flip, which paces the main loop at the refresh rate.
+ *
+ * Like the framebuffer, the frame is rotated, upscaled by the largest integer factor and centered in the mode of the
+ * 1st connected connector. It runs on any KMS driver, including the virtual vkms (modprobe vkms)
+ */
+class WindowDrm : public Window
+{
+public:
+    struct Impl;
+
+    /**
+     * @brief Page flips since the creation
+     */
+    struct Statistics
+    {
+        size_t flips = 0;        ///< drmModePageFlip() calls
+        size_t flipEvents = 0;   ///< flips completed at a vertical blank
+        size_t flipTimeouts = 0; ///< flips without any event after a second
+    };
+
+    WindowDrm(int width, int height);
+
+    /**
+     * @param device like /dev/dri/card0. If empty, the 1st DRM device with a connected output
+     */
+    WindowDrm(int width, int height, const std::string &device);
+    ~WindowDrm() override;
+
+    void begin() override;
+    void end() override;
+
+    /**
+     * Only the damaged part is read from OpenGL and converted into the dumb buffer
+     */
+    void setDamage(const Rect &damage) override;
+
+    /**
+     * The frame is rotated and upscaled while it is converted into the dumb buffer
+     */
+    bool setRotation(int rotation90Degree) override;
+
+    /**
+     * WindowEventLinux
+     */
+    std::unique_ptr<WindowEvent> createDefaultEvent() override;
+
+    const Statistics &getStatistics() const;
+
+protected:
+    std::ostream &toStream(std::ostream &str) const override;
+
+private:
+    std::unique_ptr<Impl> pimpl;
+};
+
+#endif // USE_WINDOW_DRM
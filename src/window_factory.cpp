@@ -1,6 +1,8 @@
 #include "window_factory.hpp"
 
+#include "window_drm.hpp"
 #include "window_framebuffer.hpp"
+#include "window_headless.hpp"
 #include "window_raspberrypi_dispmanx.hpp"
 #include "window_sdl.hpp"
 #include "window_wayland.hpp"
@@ -18,6 +20,7 @@ namespace
 constexpr char kEventDefault[] = "default";
 constexpr char kEventDummy[] = "dummy";
 constexpr char kEventLinux[] = "linux";
+constexpr char kDriverHeadless[] = "headless";
 
 /**
  * Helper to create a window to have a single signature as std::make_unique<> is not ok
@@ -28,6 +31,32 @@ std::unique_ptr<Window> createWindow(int width, int height)
     return std::make_unique<W>(width, height);
 }
 
+#ifdef USE_WINDOW_FRAMEBUFFER
+std::unique_ptr<Window> createWindowFramebufferPipelined(int width, int height)
+{
+    return std::make_unique<WindowFramebuffer>(width, height, WindowFramebuffer::Mode::Pipelined);
+}
+
+std::unique_ptr<Window> createWindowFramebufferSoftware(int width, int height)
+{
+    return std::make_unique<WindowFramebuffer>(width, height, WindowFramebuffer::Mode::Software);
+}
+#endif
+
+#ifdef USE_WINDOW_HEADLESS
+std::unique_ptr<Window> createWindowHeadless(int width, int height)
+{
+    return std::make_unique<WindowHeadless>(width, height, WindowHeadless::getEnvironmentOptions());
+}
+
+std::unique_ptr<Window> createWindowHeadlessSoftware(int width, int height)
+{
+    auto options = WindowHeadless::getEnvironmentOptions();
+    options.software = true;
+    return std::make_unique<WindowHeadless>(width, height, options);
+}
+#endif
+
 /**
  * Type for kDrivers:
  * std::tuple<name, create function, default eventDriver>
@@ -40,6 +69,11 @@ using DriverData = std::tuple<const char *, std::unique_ptr<Window> (*)(int, int
 constexpr DriverData kDrivers[] = {
 #ifdef USE_WINDOW_FRAMEBUFFER
     {"framebuffer", &createWindow<WindowFramebuffer>},
+    {"framebuffer_pipelined", &createWindowFramebufferPipelined},
+    {"framebuffer_software", &createWindowFramebufferSoftware},
+#endif
+#ifdef USE_WINDOW_DRM
+    {"drm", &createWindow<WindowDrm>},
 #endif
 #ifdef USE_WINDOW_DISPMANX
     {"raspberrypi_dispmanx", &createWindow<WindowRaspberryPiDispmanx>},
@@ -50,6 +84,10 @@ constexpr DriverData kDrivers[] = {
 #ifdef USE_WINDOW_WAYLAND
     {"wayland", &createWindow<WindowWayland>},
 #endif
+#ifdef USE_WINDOW_HEADLESS
+    {kDriverHeadless, &createWindowHeadless},
+    {"headless_software", &createWindowHeadlessSoftware},
+#endif
 };
 
 static_assert(sizeof(kDrivers) > 0, "There must be at least 1 driver");
@@ -111,7 +149,7 @@ const EventData *getEventData(std::string_view driver)
 WindowFactory::WindowFactory() = default;
 WindowFactory::~WindowFactory() = default;
 
-void WindowFactory::create(std::string_view displayDriver, std::string_view eventDriver, int width, int height)
+void WindowFactory::create(std::string_view displayDriver, std::string_view eventDriver, int width, int height, int rotation)
 {
     clear();
 
@@ -122,6 +160,10 @@ void WindowFactory::create(std::string_view displayDriver, std::string_view even
     }
     const auto createWindow = std::get<1>(*driverData);
     window = (*createWindow)(width, height);
+    if (rotation % 90 != 0 || window->setRotation((rotation / 90) & 3) == false)
+    {
+        std::cerr << "display_rotation " << rotation << " is not supported by " << displayDriver << ", the frame is not rotated" << std::endl;
+    }
 
     const auto eventData = getEventData(eventDriver);
     const auto createEvent = std::get<1>(*eventData);
@@ -166,6 +208,11 @@ std::string_view WindowFactory::getDriver(size_t index)
     return std::get<0>(kDrivers[index]);
 }
 
+std::string_view WindowFactory::getHeadlessDriver()
+{
+    return getDriverData(kDriverHeadless) ? kDriverHeadless : getDriver(0);
+}
+
 std::ostream &WindowFactory::toStream(std::ostream &str) const
 {
     str << "Drivers:";
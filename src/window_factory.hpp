@@ -18,8 +18,10 @@ public:
 
     /**
      * Create a window given the driver name
+     *
+     * @param rotation clockwise rotation of the display in degrees: 0, 90, 180 or 270
      */
-    void create(std::string_view displayDriver, std::string_view eventDriver, int width, int height);
+    void create(std::string_view displayDriver, std::string_view eventDriver, int width, int height, int rotation = 0);
 
     /**
      * Get the current window
@@ -50,6 +52,11 @@ public:
      */
     static std::string_view getDriver(size_t index);
 
+    /**
+     * Driver which needs no screen, to run the tests anywhere: "headless" if compiled, the default driver otherwise
+     */
+    static std::string_view getHeadlessDriver();
+
     friend std::ostream &operator<<(std::ostream &str, const WindowFactory &obj)
     {
         return obj.toStream(str);
@@ -14,20 +14,27 @@
 #include "egl_error.hpp"
 #include "toolbox_gl.hpp"
 #include "toolbox_io.hpp"
+#include "toolbox_pixel.hpp"
 #include "toolbox_time.hpp"
 
 #include <EGL/egl.h>
+#include <EGL/eglext.h>
 
-#include <endian.h>
 #include <fcntl.h>
 #include <linux/fb.h>
 #include <sys/ioctl.h>
 #include <sys/mman.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <array>
+#include <condition_variable>
 #include <cstring>
+#include <exception>
 #include <iostream>
+#include <mutex>
+#include <optional>
+#include <thread>
 #include <vector>
 
 namespace
@@ -35,10 +42,6 @@ namespace
 
 using FramebufferFilename_t = std::array<char, sizeof("/dev/fb99")>;
 
-constexpr GLenum glType = GL_UNSIGNED_BYTE;
-constexpr GLenum glFormat = GL_RGBA;
-constexpr uint32_t glPixelSize = 4;
-
 // not very accurate... but should be OK for Raspberry (either /dev/fb1 if HDMI is plugged in or /dev/fb0)
 FramebufferFilename_t getLastFb()
 {
@@ -59,23 +62,91 @@ FramebufferFilename_t getLastFb()
     }
 }
 
+/**
+ * Get a config whose color buffer is exactly R, G, B bits. EGL sorts the configs by decreasing color depth
+ *
+ * @return nullptr if there is none
+ */
+EGLConfig chooseConfig(EGLDisplay display, EGLint red, EGLint green, EGLint blue)
+{
+    const EGLint eglConfigAttributes[] = {
+        EGL_RED_SIZE, red,
+        EGL_GREEN_SIZE, green,
+        EGL_BLUE_SIZE, blue,
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
+        EGL_NONE};
+    std::array<EGLConfig, 64> eglConfigs;
+    EGLint numConfig = 0;
+    if (eglChooseConfig(display, eglConfigAttributes, eglConfigs.data(), eglConfigs.size(), &numConfig) == EGL_FALSE)
+    {
+        throw EGLError{"eglChooseConfig() failed"};
+    }
+
+    for (EGLint i = 0; i < numConfig; ++i)
+    {
+        EGLint configRed = 0;
+        EGLint configGreen = 0;
+        EGLint configBlue = 0;
+        eglGetConfigAttrib(display, eglConfigs[i], EGL_RED_SIZE, &configRed);
+        eglGetConfigAttrib(display, eglConfigs[i], EGL_GREEN_SIZE, &configGreen);
+        eglGetConfigAttrib(display, eglConfigs[i], EGL_BLUE_SIZE, &configBlue);
+        if (configRed == red && configGreen == green && configBlue == blue)
+        {
+            return eglConfigs[i];
+        }
+    }
+    return nullptr;
+}
+
 } // namespace
 
 struct WindowFramebuffer::Impl
 {
+    /**
+     * @brief Surface to read back by the read thread
+     */
+    struct Readback
+    {
+        EGLSurface surface;
+        EGLSyncKHR fence; ///< signaled when the GPU has rendered the surface
+        Rect damage;
+    };
+
     ~Impl()
     {
+        if (readThread.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock{mutex};
+                quit = true;
+            }
+            condition.notify_all();
+            readThread.join();
+        }
+        if (readbackRequest)
+        {
+            destroySync(eglDisplay, readbackRequest->fence);
+        }
+
         if (eglDisplay)
         {
-            eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_DISPLAY);
+            eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
         }
         if (eglContext)
         {
             eglDestroyContext(eglDisplay, eglContext);
         }
-        if (eglSurface)
+        if (eglReadContext)
+        {
+            eglDestroyContext(eglDisplay, eglReadContext);
+        }
+        for (const EGLSurface eglSurface : eglSurfaces)
         {
-            eglDestroySurface(eglDisplay, eglSurface);
+            if (eglSurface)
+            {
+                eglDestroySurface(eglDisplay, eglSurface);
+            }
         }
         if (eglDisplay)
         {
@@ -83,57 +154,316 @@ struct WindowFramebuffer::Impl
         }
     }
 
+    /**
+     * Read the damaged part of the current surface, then convert it into the framebuffer
+     */
+    void readback(const Rect &damage)
+    {
+        // double buffering: the hidden buffer
+        uint8_t *const origin = frameOrigin + backBuffer * screenHeight * frameBufferStride;
+
+        if (software)
+        {
+            // same layout as glReadPixels()
+            for (int y = 0; y < damage.height; ++y)
+            {
+                std::memcpy(glFrame.data() + y * damage.width * glPixelSize,
+                            softwareFrame + ((damage.y + y) * width + damage.x) * glPixelSize,
+                            damage.width * glPixelSize);
+            }
+        }
+        else
+        {
+            // ~2.5ms in RGB for the whole surface
+            glReadPixels(damage.x, damage.y, damage.width, damage.height, glFormat, glType, glFrame.data());
+        }
+        // convert + flip vertical
+        // ~5.5ms from RGBA8888 to RGB565 for the whole surface with the scalar converter
+        if (transform.rotation90Degree == 0 && transform.scale == 1)
+        {
+            // OpenGL's origin is down left, the framebuffer's one is up left
+            convertFrame(kernel,
+                         reinterpret_cast<const uint8_t *>(glFrame.data()),
+                         glPixelSize,
+                         damage.width,
+                         damage.height,
+                         origin + (height - (damage.y + damage.height)) * frameBufferStride + damage.x * frameBufferPixelSize,
+                         frameBufferStride);
+        }
+        else
+        {
+            convertFrame(kernel,
+                         reinterpret_cast<const uint8_t *>(glFrame.data()),
+                         glPixelSize,
+                         damage,
+                         width,
+                         height,
+                         transform,
+                         origin,
+                         frameBufferPixelSize,
+                         frameBufferStride);
+        }
+        present();
+    }
+
+    /**
+     * Double buffering: display the buffer which has just been written
+     */
+    void present()
+    {
+        if (bufferCount == 1)
+        {
+            return;
+        }
+
+        screenInfo.yoffset = backBuffer * screenHeight;
+        if (ioctl(fd.fd, FBIOPAN_DISPLAY, &screenInfo))
+        {
+            throw std::runtime_error{"ioctl(FBIOPAN_DISPLAY) failed"};
+        }
+        // the previous buffer is written at the next frame: it must not be displayed anymore
+        if (waitForVsync)
+        {
+            uint32_t crtc = 0;
+            ioctl(fd.fd, FBIO_WAITFORVSYNC, &crtc);
+        }
+        backBuffer ^= 1;
+    }
+
+    /**
+     * Place the rotated frame in the middle of the screen, upscaled as much as possible
+     *
+     * @return false if the rotated frame is larger than the screen: the layout is not changed
+     */
+    bool setLayout(int rotation90Degree)
+    {
+        const uint32_t rotatedWidth = rotation90Degree % 2 ? height : width;
+        const uint32_t rotatedHeight = rotation90Degree % 2 ? width : height;
+        if (screenWidth < rotatedWidth || screenHeight < rotatedHeight)
+        {
+            return false;
+        }
+
+        transform.rotation90Degree = rotation90Degree;
+        transform.scale = std::min(screenWidth / rotatedWidth, screenHeight / rotatedHeight);
+        const uint32_t marginX = (screenWidth - rotatedWidth * transform.scale) / 2;
+        const uint32_t marginY = (screenHeight - rotatedHeight * transform.scale) / 2;
+        frameOrigin = reinterpret_cast<uint8_t *>(mmaped.content) + marginY * frameBufferStride + marginX * frameBufferPixelSize;
+
+        // the margins are never written
+        std::memset(mmaped.content, 0, bufferCount * screenHeight * frameBufferStride);
+        lastDamage = Rect{0, 0, static_cast<int>(width), static_cast<int>(height)};
+        return true;
+    }
+
+    /**
+     * Pipelined mode: hand over the rendered surface to the read thread, then render the next frame in the other
+     * surface. Only waits if the read thread has not finished with the other surface yet
+     */
+    void submitReadback(const Rect &damage)
+    {
+        const EGLSyncKHR fence = createSync(eglDisplay, EGL_SYNC_FENCE_KHR, nullptr);
+        if (fence == EGL_NO_SYNC_KHR)
+        {
+            throw EGLError{"eglCreateSyncKHR() failed"};
+        }
+        // the fence is only sent to the GPU at the next flush
+        glFlush();
+
+        const EGLSurface rendered = eglSurfaces[renderSurface];
+        renderSurface ^= 1;
+
+        std::unique_lock<std::mutex> lock{mutex};
+        condition.wait(lock, [this] { return !readbackRequest; });
+        if (readbackError)
+        {
+            destroySync(eglDisplay, fence);
+            std::rethrow_exception(readbackError);
+        }
+        if (eglMakeCurrent(eglDisplay, eglSurfaces[renderSurface], eglSurfaces[renderSurface], eglContext) == EGL_FALSE)
+        {
+            destroySync(eglDisplay, fence);
+            throw EGLError{"eglMakeCurrent() failed"};
+        }
+        readbackRequest = Readback{rendered, fence, damage};
+        condition.notify_all();
+    }
+
+    /**
+     * Body of the read thread, with its own EGL context
+     */
+    void readbackLoop()
+    {
+        try
+        {
+            eglBindAPI(EGL_OPENGL_ES_API);
+            std::unique_lock<std::mutex> lock{mutex};
+            for (;;)
+            {
+                condition.wait(lock, [this] { return quit || readbackRequest; });
+                if (quit)
+                {
+                    break;
+                }
+                const Readback request = *readbackRequest;
+                lock.unlock();
+
+                if (eglMakeCurrent(eglDisplay, request.surface, request.surface, eglReadContext) == EGL_FALSE)
+                {
+                    throw EGLError{"eglMakeCurrent() failed"};
+                }
+                clientWaitSync(eglDisplay, request.fence, 0, EGL_FOREVER_KHR);
+                destroySync(eglDisplay, request.fence);
+                readback(request.damage);
+                // the main thread renders into this surface again at the next frame
+                eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+
+                lock.lock();
+                readbackRequest.reset();
+                condition.notify_all();
+            }
+        }
+        catch (...)
+        {
+            // like the normal path: the context is not left current on a thread which stops
+            eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+
+            std::lock_guard<std::mutex> lock{mutex};
+            readbackError = std::current_exception();
+            readbackRequest.reset();
+            condition.notify_all();
+        }
+    }
+
     uint32_t height = 0;
     uint32_t width = 0;
     uint32_t frameBufferPixelSize = 0;
     uint32_t frameBufferStride = 0;
+    PixelLayout frameBufferLayout;
     FramebufferFilename_t framebuffer;
+    FileUnix fd;
+    struct fb_var_screeninfo screenInfo;
     MmapFile mmaped;
+    // double buffering: the screen displays 1 buffer while the other one is written
+    uint32_t bufferCount = 1;
+    uint32_t backBuffer = 0;
+    bool waitForVsync = false;
+    // double buffering: the part of the surface which has changed in the displayed buffer but not in the hidden one
+    Rect lastDamage;
+    // visible size of the framebuffer
+    uint32_t screenWidth = 0;
+    uint32_t screenHeight = 0;
+    // where the frame is written in the framebuffer
+    PixelTransform transform;
+    uint8_t *frameOrigin = nullptr;
 
     std::vector<char> glFrame;
+    // format of glReadPixels(): RGBA8888 is always supported, RGB565 if the driver supports it
+    GLenum glFormat = GL_RGBA;
+    GLenum glType = GL_UNSIGNED_BYTE;
+    uint32_t glPixelSize = 4;
+    // from glReadPixels() to frameBufferLayout, selected once
+    PixelConverter::Kernel kernel = nullptr;
+    // nothing means the whole surface
+    std::optional<Rect> damage;
+
+    // drawn by the CPU, RGBA8888 like glReadPixels()
+    bool software = false;
+    const uint8_t *softwareFrame = nullptr;
 
     EGLDisplay eglDisplay = nullptr;
-    EGLSurface eglSurface = nullptr;
+    // eglSurfaces[renderSurface] is the one being rendered. The 2nd one is only used in pipelined mode
+    std::array<EGLSurface, 2> eglSurfaces{};
+    unsigned int renderSurface = 0;
     EGLContext eglContext = nullptr;
+
+    // pipelined mode
+    bool pipelined = false;
+    EGLContext eglReadContext = nullptr;
+    PFNEGLCREATESYNCKHRPROC createSync = nullptr;
+    PFNEGLDESTROYSYNCKHRPROC destroySync = nullptr;
+    PFNEGLCLIENTWAITSYNCKHRPROC clientWaitSync = nullptr;
+    std::thread readThread;
+    std::mutex mutex;
+    std::condition_variable condition;
+    // pending or in progress
+    std::optional<Readback> readbackRequest;
+    bool quit = false;
+    std::exception_ptr readbackError;
 };
 
-WindowFramebuffer::WindowFramebuffer(int width, int height)
+WindowFramebuffer::WindowFramebuffer(int width, int height, Mode mode)
     : pimpl{std::make_unique<Impl>()}
 {
     pimpl->width = width;
     pimpl->height = height;
     pimpl->framebuffer = getLastFb();
-    const FileUnix fd{open(pimpl->framebuffer.data(), O_RDWR)};
-    if (fd.fd < 0)
+    pimpl->fd = FileUnix{open(pimpl->framebuffer.data(), O_RDWR)};
+    const int fd = pimpl->fd.fd;
+    if (fd < 0)
     {
         throw std::runtime_error{"Could not open " + std::string{pimpl->framebuffer.data()}};
     }
 
     struct fb_fix_screeninfo finfo;
-    if (ioctl(fd.fd, FBIOGET_FSCREENINFO, &finfo))
+    if (ioctl(fd, FBIOGET_FSCREENINFO, &finfo))
     {
         throw std::runtime_error{"ioctl(FBIOGET_FSCREENINFO) failed"};
     }
 
-    struct fb_var_screeninfo vinfo;
-    if (ioctl(fd.fd, FBIOGET_VSCREENINFO, &vinfo))
+    struct fb_var_screeninfo &vinfo = pimpl->screenInfo;
+    if (ioctl(fd, FBIOGET_VSCREENINFO, &vinfo))
     {
         throw std::runtime_error{"ioctl(FBIOGET_VSCREENINFO) failed"};
     }
-    if (vinfo.bits_per_pixel != 16 && vinfo.bits_per_pixel != 32)
+    // RGB565 has always been written big endian, the other layouts in little endian
+    const PixelLayout layout{static_cast<int>(vinfo.bits_per_pixel),
+                             static_cast<int>(vinfo.red.offset), static_cast<int>(vinfo.red.length),
+                             static_cast<int>(vinfo.green.offset), static_cast<int>(vinfo.green.length),
+                             static_cast<int>(vinfo.blue.offset), static_cast<int>(vinfo.blue.length),
+                             vinfo.bits_per_pixel == 16};
+    if (getSpecializedPixelKernel(PixelSource::RGBA8888, layout) == nullptr)
     {
-        throw std::runtime_error{std::string{pimpl->framebuffer.data()} + " is " + std::to_string(vinfo.bits_per_pixel) + "bpp"};
+        throw std::runtime_error{std::string{pimpl->framebuffer.data()} + " is " + std::to_string(vinfo.bits_per_pixel) + "bpp with an unsupported layout (red " +
+                                 std::to_string(vinfo.red.offset) + '/' + std::to_string(vinfo.red.length) + ", green " +
+                                 std::to_string(vinfo.green.offset) + '/' + std::to_string(vinfo.green.length) + ", blue " +
+                                 std::to_string(vinfo.blue.offset) + '/' + std::to_string(vinfo.blue.length) + ')'};
     }
+    pimpl->frameBufferLayout = layout;
     pimpl->frameBufferPixelSize = vinfo.bits_per_pixel >> 3;
     pimpl->frameBufferStride = finfo.line_length;
 
-    if (vinfo.xres < pimpl->width || vinfo.yres < pimpl->height)
+    pimpl->screenWidth = vinfo.xres;
+    pimpl->screenHeight = vinfo.yres;
+
+    // double buffering if the driver has room for 2 screens and can pan between them
+    if (vinfo.yres_virtual >= 2 * vinfo.yres && finfo.smem_len >= 2 * vinfo.yres * finfo.line_length)
     {
-        throw std::runtime_error{std::string{pimpl->framebuffer.data()} + "=" + std::to_string(vinfo.xres) + "*" + std::to_string(vinfo.yres) + " is smaller than " + std::to_string(pimpl->width) + "*" + std::to_string(pimpl->height)};
+        vinfo.xoffset = 0;
+        vinfo.yoffset = 0;
+        if (ioctl(fd, FBIOPAN_DISPLAY, &vinfo) == 0)
+        {
+            pimpl->bufferCount = 2;
+            pimpl->backBuffer = 1;
+            uint32_t crtc = 0;
+            pimpl->waitForVsync = ioctl(fd, FBIO_WAITFORVSYNC, &crtc) == 0;
+        }
     }
 
-    pimpl->mmaped = MmapFile{mmap(nullptr, finfo.smem_len, PROT_READ | PROT_WRITE, MAP_SHARED, fd.fd, 0),
+    pimpl->mmaped = MmapFile{mmap(nullptr, finfo.smem_len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0),
                              finfo.smem_len};
+    if (pimpl->setLayout(0) == false)
+    {
+        throw std::runtime_error{std::string{pimpl->framebuffer.data()} + "=" + std::to_string(pimpl->screenWidth) + "*" + std::to_string(pimpl->screenHeight) + " is smaller than " + std::to_string(width) + "*" + std::to_string(height)};
+    }
+
+    if (mode == Mode::Software)
+    {
+        pimpl->software = true;
+        pimpl->glFrame.resize(pimpl->width * pimpl->height * pimpl->glPixelSize);
+        pimpl->kernel = getPixelKernel(PixelSource::RGBA8888, layout);
+        return;
+    }
 
     pimpl->eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
     if (pimpl->eglDisplay == EGL_NO_DISPLAY)
@@ -146,26 +476,23 @@ WindowFramebuffer::WindowFramebuffer(int width, int height)
         throw EGLError{"eglInitialize() failed"};
     }
 
-    static constexpr EGLint eglConfigAttributes[] = {
-        EGL_RED_SIZE, 8,
-        EGL_GREEN_SIZE, 8,
-        EGL_BLUE_SIZE, 8,
-        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
-        EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
-        EGL_NONE};
-    EGLConfig eglConfig = nullptr;
-    EGLint numConfig = 0;
-    if (eglChooseConfig(pimpl->eglDisplay, eglConfigAttributes, &eglConfig, 1, &numConfig) == EGL_FALSE)
+    // render natively in the framebuffer's format to skip the CPU conversion
+    EGLConfig eglConfig = pimpl->frameBufferPixelSize == 2 ? chooseConfig(pimpl->eglDisplay, 5, 6, 5) : nullptr;
+    if (eglConfig == nullptr)
     {
-        throw EGLError{"eglChooseConfig() failed"};
+        eglConfig = chooseConfig(pimpl->eglDisplay, 8, 8, 8);
+    }
+    if (eglConfig == nullptr)
+    {
+        throw EGLError{"No EGL config for RGB888"};
     }
 
     const EGLint pbufferAttribs[] = {
         EGL_WIDTH, static_cast<EGLint>(pimpl->width),
         EGL_HEIGHT, static_cast<EGLint>(pimpl->height),
         EGL_NONE};
-    pimpl->eglSurface = eglCreatePbufferSurface(pimpl->eglDisplay, eglConfig, pbufferAttribs);
-    if (pimpl->eglSurface == EGL_NO_SURFACE)
+    pimpl->eglSurfaces[0] = eglCreatePbufferSurface(pimpl->eglDisplay, eglConfig, pbufferAttribs);
+    if (pimpl->eglSurfaces[0] == EGL_NO_SURFACE)
     {
         throw EGLError{"eglCreatePbufferSurface() failed"};
     }
@@ -183,12 +510,54 @@ WindowFramebuffer::WindowFramebuffer(int width, int height)
     {
         throw EGLError{"eglCreateContext() failed"};
     }
-    if (eglMakeCurrent(pimpl->eglDisplay, pimpl->eglSurface, pimpl->eglSurface, pimpl->eglContext) == EGL_FALSE)
+    if (eglMakeCurrent(pimpl->eglDisplay, pimpl->eglSurfaces[0], pimpl->eglSurfaces[0], pimpl->eglContext) == EGL_FALSE)
     {
         throw EGLError{"eglMakeCurrent() failed"};
     }
 
-    pimpl->glFrame.resize(pimpl->width * pimpl->height * glPixelSize);
+    if (pimpl->frameBufferPixelSize == 2)
+    {
+        GLint readFormat = 0;
+        GLint readType = 0;
+        glGetIntegerv(GL_IMPLEMENTATION_COLOR_READ_FORMAT, &readFormat);
+        glGetIntegerv(GL_IMPLEMENTATION_COLOR_READ_TYPE, &readType);
+        if (readFormat == GL_RGB && readType == GL_UNSIGNED_SHORT_5_6_5)
+        {
+            pimpl->glFormat = GL_RGB;
+            pimpl->glType = GL_UNSIGNED_SHORT_5_6_5;
+            pimpl->glPixelSize = 2;
+        }
+    }
+
+    pimpl->glFrame.resize(pimpl->width * pimpl->height * pimpl->glPixelSize);
+    pimpl->kernel = getPixelKernel(pimpl->glType == GL_UNSIGNED_SHORT_5_6_5 ? PixelSource::RGB565 : PixelSource::RGBA8888, layout);
+
+    // the read thread waits for the GPU with a fence. Without it, stay in the serial mode
+    const char *const eglExtensions = eglQueryString(pimpl->eglDisplay, EGL_EXTENSIONS);
+    if (mode == Mode::Pipelined && eglExtensions && std::strstr(eglExtensions, "EGL_KHR_fence_sync"))
+    {
+        pimpl->createSync = reinterpret_cast<PFNEGLCREATESYNCKHRPROC>(eglGetProcAddress("eglCreateSyncKHR"));
+        pimpl->destroySync = reinterpret_cast<PFNEGLDESTROYSYNCKHRPROC>(eglGetProcAddress("eglDestroySyncKHR"));
+        pimpl->clientWaitSync = reinterpret_cast<PFNEGLCLIENTWAITSYNCKHRPROC>(eglGetProcAddress("eglClientWaitSyncKHR"));
+        if (pimpl->createSync == nullptr || pimpl->destroySync == nullptr || pimpl->clientWaitSync == nullptr)
+        {
+            throw EGLError{"EGL_KHR_fence_sync is advertised but not available"};
+        }
+
+        pimpl->eglSurfaces[1] = eglCreatePbufferSurface(pimpl->eglDisplay, eglConfig, pbufferAttribs);
+        if (pimpl->eglSurfaces[1] == EGL_NO_SURFACE)
+        {
+            throw EGLError{"eglCreatePbufferSurface() failed"};
+        }
+        pimpl->eglReadContext = eglCreateContext(pimpl->eglDisplay, eglConfig, EGL_NO_CONTEXT, eglContextAttributes);
+        if (pimpl->eglReadContext == EGL_NO_CONTEXT)
+        {
+            throw EGLError{"eglCreateContext() failed"};
+        }
+
+        pimpl->pipelined = true;
+        pimpl->readThread = std::thread{&Impl::readbackLoop, pimpl.get()};
+    }
 }
 
 WindowFramebuffer::~WindowFramebuffer() = default;
@@ -197,62 +566,66 @@ void WindowFramebuffer::begin()
 {
 }
 
-void WindowFramebuffer::end()
+bool WindowFramebuffer::setRotation(int rotation90Degree)
 {
-    // ~1.3ms in RGB
-    glFinish();
-    // ~2.5ms in RGB
-    glReadPixels(0, 0, pimpl->width, pimpl->height, glFormat, glType, pimpl->glFrame.data());
-    const auto glBegin = reinterpret_cast<const uint8_t *>(pimpl->glFrame.data());
-    const auto glLineLen = pimpl->width * glPixelSize;
-    const auto frameBufferStride = pimpl->frameBufferStride;
+    return pimpl->setLayout(rotation90Degree);
+}
 
-    auto glLineEnd = reinterpret_cast<uint8_t *>(pimpl->glFrame.data() + glLineLen * pimpl->height);
-    auto fbLineBegin = reinterpret_cast<uint8_t *>(pimpl->mmaped.content);
+bool WindowFramebuffer::isSoftware() const
+{
+    return pimpl->software;
+}
 
-    if (pimpl->frameBufferPixelSize == 4)
-    {
-        while (glLineEnd > glBegin)
-        {
-            const auto glLineBegin = glLineEnd - glLineLen;
+void WindowFramebuffer::setSoftwareFrame(const uint8_t *frame)
+{
+    pimpl->softwareFrame = frame;
+}
 
-            auto fbPixel = reinterpret_cast<uint32_t *>(fbLineBegin);
-            auto glPixel = reinterpret_cast<uint32_t *>(glLineBegin);
-            while (glPixel < reinterpret_cast<const uint32_t*>(glLineEnd))
-            {
-                *fbPixel = htobe32((*glPixel) << 8);
-                ++glPixel;
-                ++fbPixel;
-            }
+void WindowFramebuffer::setDamage(const Rect &damage)
+{
+    pimpl->damage = damage;
+}
 
-            glLineEnd = glLineBegin;
-            fbLineBegin += frameBufferStride;
-        }
+void WindowFramebuffer::end()
+{
+    const Rect surface{0, 0, static_cast<int>(pimpl->width), static_cast<int>(pimpl->height)};
+    Rect damage = pimpl->damage.value_or(surface);
+    pimpl->damage.reset();
+
+    // the vectorized RGBA8888 -> RGB565 conversion works on 2 pixels at once
+    if (pimpl->kernel == getPixelConverter().toRGB565)
+    {
+        const int right = damage.x + damage.width;
+        damage.x &= ~1;
+        damage.width = ((right + 1) & ~1) - damage.x;
     }
-    else if (pimpl->frameBufferPixelSize == 2)
+    damage = damage.intersected(surface);
+    if (damage.empty() || (pimpl->software && pimpl->softwareFrame == nullptr))
     {
-        // convert RGBA8888 -> RGB565 + flip vertical
-        // ~5.5ms in RGB
-        while (glLineEnd > glBegin)
-        {
-            const auto glLineBegin = glLineEnd - glLineLen;
-
-            auto fbPixel = reinterpret_cast<uint32_t *>(fbLineBegin);
-            auto glPixel = glLineBegin;
-            while (glPixel < glLineEnd)
-            {
-                const uint32_t r = glPixel[0] << 16 | glPixel[glPixelSize];
-                const uint32_t g = glPixel[1] << 16 | glPixel[glPixelSize + 1];
-                const uint32_t b = glPixel[2] << 16 | glPixel[glPixelSize + 2];
-                *fbPixel = htobe32((r & 0x00f800f8) << 8 | ((g & 0x00fc00fc) << 3) | ((b & 0x00f800f8) >> 3));
-
-                glPixel += glPixelSize * 2;
-                ++fbPixel;
-            }
+        // the framebuffer already displays this frame
+        return;
+    }
+    if (pimpl->bufferCount == 2)
+    {
+        // the hidden buffer is 2 frames late
+        const Rect frameDamage = damage;
+        damage = damage.united(pimpl->lastDamage);
+        pimpl->lastDamage = frameDamage;
+    }
 
-            glLineEnd = glLineBegin;
-            fbLineBegin += frameBufferStride;
+    if (pimpl->pipelined)
+    {
+        // converted by the read thread while the next frame is rendered
+        pimpl->submitReadback(damage);
+    }
+    else
+    {
+        if (!pimpl->software)
+        {
+            // ~1.3ms in RGB
+            glFinish();
         }
+        pimpl->readback(damage);
     }
 }
 
@@ -264,10 +637,21 @@ std::unique_ptr<WindowEvent> WindowFramebuffer::createDefaultEvent()
 std::ostream &WindowFramebuffer::toStream(std::ostream &str) const
 {
     str << "\nWindow Framebuffer " << pimpl->framebuffer.data() << ": " << pimpl->width << 'x' << pimpl->height << ' ' << (pimpl->frameBufferPixelSize << 3) << "bpp"
-        << "\nEGL info:\n - EGL_CLIENT_APIS: " << eglQueryString(pimpl->eglDisplay, EGL_CLIENT_APIS)
-        << "\n - EGL_VENDOR: " << eglQueryString(pimpl->eglDisplay, EGL_VENDOR)
-        << "\n - EGL_VERSION: " << eglQueryString(pimpl->eglDisplay, EGL_VERSION)
-        << "\n - EGL_EXTENSIONS: " << eglQueryString(pimpl->eglDisplay, EGL_EXTENSIONS);
+        << " (red " << pimpl->frameBufferLayout.redOffset << '/' << pimpl->frameBufferLayout.redLength
+        << ", green " << pimpl->frameBufferLayout.greenOffset << '/' << pimpl->frameBufferLayout.greenLength
+        << ", blue " << pimpl->frameBufferLayout.blueOffset << '/' << pimpl->frameBufferLayout.blueLength
+        << (pimpl->frameBufferLayout.bigEndian ? ", big endian)" : ", little endian)")
+        << "\nBuffers: " << pimpl->bufferCount << (pimpl->waitForVsync ? " with vsync" : " without vsync")
+        << "\nScreen " << pimpl->screenWidth << 'x' << pimpl->screenHeight << ": rotation " << pimpl->transform.rotation90Degree * 90 << "deg, scale x" << pimpl->transform.scale
+        << "\nReadback: " << (pimpl->software ? "software RGBA8888 converted" : pimpl->glType == GL_UNSIGNED_SHORT_5_6_5 ? "RGB565 native" : "RGBA8888 converted") << " by " << (pimpl->kernel == getSpecializedPixelKernel(pimpl->glType == GL_UNSIGNED_SHORT_5_6_5 ? PixelSource::RGB565 : PixelSource::RGBA8888, pimpl->frameBufferLayout) ? "specialized scalar" : getPixelConverter().name)
+        << (pimpl->pipelined ? ", pipelined" : ", serial");
+    if (pimpl->eglDisplay)
+    {
+        str << "\nEGL info:\n - EGL_CLIENT_APIS: " << eglQueryString(pimpl->eglDisplay, EGL_CLIENT_APIS)
+            << "\n - EGL_VENDOR: " << eglQueryString(pimpl->eglDisplay, EGL_VENDOR)
+            << "\n - EGL_VERSION: " << eglQueryString(pimpl->eglDisplay, EGL_VERSION)
+            << "\n - EGL_EXTENSIONS: " << eglQueryString(pimpl->eglDisplay, EGL_EXTENSIONS);
+    }
 
     return str;
 }
@@ -8,18 +8,51 @@
 
 /**
  * @brief Window to output to the Linux Framebuffer
+ *
+ * The frame is upscaled by the largest integer factor which fits in the framebuffer, and centered.
+ * On the boards without any GPU, the frame can be drawn by the CPU instead of OpenGL (Mode::Software)
  */
 class WindowFramebuffer : public Window
 {
 public:
     struct Impl;
 
-    explicit WindowFramebuffer(int width, int height);
+    /**
+     * @brief How the frame gets into the framebuffer
+     */
+    enum class Mode
+    {
+        Serial,    ///< rendered by OpenGL, then read back and converted
+        Pipelined, ///< the frame is read back and converted by a thread while the next one is rendered. The display has 1 more frame of latency. Needs EGL_KHR_fence_sync, or falls back to Serial
+        Software,  ///< drawn by the CPU (RendererSoftware), then converted. No EGL at all
+    };
+
+    explicit WindowFramebuffer(int width, int height, Mode mode = Mode::Serial);
     ~WindowFramebuffer() override;
 
     void begin() override;
     void end() override;
 
+    /**
+     * Only the damaged part is read from OpenGL and converted into the framebuffer
+     */
+    void setDamage(const Rect &damage) override;
+
+    /**
+     * The frame is rotated and upscaled while it is converted into the framebuffer
+     */
+    bool setRotation(int rotation90Degree) override;
+
+    /**
+     * Mode::Software
+     */
+    bool isSoftware() const override;
+
+    /**
+     * Only the damaged part is converted into the framebuffer
+     */
+    void setSoftwareFrame(const uint8_t *frame) override;
+
     /**
      * WindowEventLinux
      */
@@ -0,0 +1,367 @@
+#include "window_headless.hpp"
+
+#ifdef USE_WINDOW_HEADLESS
+
+#include "windowevent_dummy.hpp"
+
+#include "egl_error.hpp"
+#include "toolbox_gl.hpp"
+#include "toolbox_io.hpp"
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+
+constexpr char kEnvironmentDump[] = "ALARM_HEADLESS_DUMP";
+constexpr char kEnvironmentGolden[] = "ALARM_HEADLESS_GOLDEN";
+constexpr char kEnvironmentTolerance[] = "ALARM_HEADLESS_TOLERANCE";
+
+/**
+ * Surfaceless platform of Mesa if available: no X11, Wayland or DRM device is needed
+ */
+EGLDisplay getDisplay()
+{
+#ifdef EGL_PLATFORM_SURFACELESS_MESA
+    const char *const clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    if (clientExtensions && std::strstr(clientExtensions, "EGL_MESA_platform_surfaceless"))
+    {
+        const auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+        if (getPlatformDisplay)
+        {
+            const EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+            if (display != EGL_NO_DISPLAY)
+            {
+                return display;
+            }
+        }
+    }
+#endif // EGL_PLATFORM_SURFACELESS_MESA
+    return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+}
+
+/**
+ * Name of the frame in the dump and golden folders
+ */
+std::string getFrameFilename(const std::string &folder, size_t frame)
+{
+    std::array<char, sizeof("/frame_99999999.ppm")> filename;
+    std::snprintf(filename.data(), filename.size(), "/frame_%05zu.ppm", frame);
+    return folder + filename.data();
+}
+
+/**
+ * Write RGB pixels, 1st line at the top, as binary PPM
+ */
+void writePpm(const std::string &filename, const std::vector<uint8_t> &rgb, int width, int height)
+{
+    FILEUnique file{std::fopen(filename.c_str(), "wb")};
+    if (file == nullptr)
+    {
+        throw std::runtime_error{"Cannot write " + filename};
+    }
+    std::fprintf(file.get(), "P6\n%d %d\n255\n", width, height);
+    if (std::fwrite(rgb.data(), 1, rgb.size(), file.get()) != rgb.size())
+    {
+        throw std::runtime_error{"Cannot write " + filename};
+    }
+}
+
+/**
+ * Read a binary PPM written by writePpm()
+ *
+ * @return empty if the file does not exist or has another size
+ */
+std::vector<uint8_t> readPpm(const std::string &filename, int width, int height)
+{
+    FILEUnique file{std::fopen(filename.c_str(), "rb")};
+    int fileWidth = 0;
+    int fileHeight = 0;
+    int maxValue = 0;
+    if (file == nullptr || std::fscanf(file.get(), "P6 %d %d %d", &fileWidth, &fileHeight, &maxValue) != 3 ||
+        fileWidth != width || fileHeight != height || maxValue != 255 || std::fgetc(file.get()) == EOF)
+    {
+        return {};
+    }
+    std::vector<uint8_t> rgb(width * height * 3);
+    if (std::fread(rgb.data(), 1, rgb.size(), file.get()) != rgb.size())
+    {
+        return {};
+    }
+    return rgb;
+}
+
+} // namespace
+
+struct WindowHeadless::Impl
+{
+    ~Impl()
+    {
+        if (eglDisplay)
+        {
+            eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        }
+        if (eglContext)
+        {
+            eglDestroyContext(eglDisplay, eglContext);
+        }
+        if (eglSurface)
+        {
+            eglDestroySurface(eglDisplay, eglSurface);
+        }
+        if (eglDisplay)
+        {
+            eglTerminate(eglDisplay);
+        }
+    }
+
+    /**
+     * Dump and/or compare the frame which has just been read back
+     */
+    void processFrame(size_t frame)
+    {
+        // RGBA8888 1st line at the bottom -> RGB888 1st line at the top
+        for (int y = 0; y < height; ++y)
+        {
+            const uint8_t *src = glFrame.data() + (height - 1 - y) * width * 4;
+            uint8_t *dst = rgbFrame.data() + y * width * 3;
+            for (int x = 0; x < width; ++x, src += 4, dst += 3)
+            {
+                std::copy_n(src, 3, dst);
+            }
+        }
+
+        if (!options.dumpFolder.empty())
+        {
+            writePpm(getFrameFilename(options.dumpFolder, frame), rgbFrame, width, height);
+        }
+
+        if (!options.goldenFolder.empty())
+        {
+            const std::string filename = getFrameFilename(options.goldenFolder, frame);
+            const auto golden = readPpm(filename, width, height);
+            if (golden.empty())
+            {
+                return;
+            }
+            ++statistics.goldenFrames;
+            int maxDifference = 0;
+            for (size_t i = 0; i < golden.size(); ++i)
+            {
+                maxDifference = std::max(maxDifference, std::abs(golden[i] - rgbFrame[i]));
+            }
+            if (maxDifference > options.tolerance)
+            {
+                ++statistics.goldenMismatches;
+                std::cerr << "WindowHeadless: frame " << frame << " differs from " << filename << " by " << maxDifference << std::endl;
+            }
+        }
+    }
+
+    int width = 0;
+    int height = 0;
+    Options options;
+    Statistics statistics;
+    std::vector<uint8_t> glFrame;
+    std::vector<uint8_t> rgbFrame;
+    const uint8_t *softwareFrame = nullptr;
+
+    EGLDisplay eglDisplay = nullptr;
+    EGLSurface eglSurface = nullptr;
+    EGLContext eglContext = nullptr;
+};
+
+WindowHeadless::WindowHeadless(int width, int height)
+    : WindowHeadless{width, height, Options{}}
+{
+}
+
+WindowHeadless::WindowHeadless(int width, int height, const Options &options)
+    : pimpl{std::make_unique<Impl>()}
+{
+    if (width <= 0 || height <= 0)
+    {
+        throw std::runtime_error{"WindowHeadless: invalid size " + std::to_string(width) + 'x' + std::to_string(height)};
+    }
+    pimpl->width = width;
+    pimpl->height = height;
+    pimpl->options = options;
+    pimpl->glFrame.resize(width * height * 4);
+    pimpl->rgbFrame.resize(width * height * 3);
+    if (options.software)
+    {
+        return;
+    }
+
+    pimpl->eglDisplay = getDisplay();
+    if (pimpl->eglDisplay == EGL_NO_DISPLAY)
+    {
+        throw EGLError{"eglGetDisplay() failed"};
+    }
+    if (eglInitialize(pimpl->eglDisplay, nullptr, nullptr) == EGL_FALSE)
+    {
+        throw EGLError{"eglInitialize() failed"};
+    }
+
+    static constexpr EGLint eglConfigAttributes[] = {
+        EGL_RED_SIZE, 8,
+        EGL_GREEN_SIZE, 8,
+        EGL_BLUE_SIZE, 8,
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
+        EGL_NONE};
+    EGLConfig eglConfig = nullptr;
+    EGLint numConfig = 0;
+    if (eglChooseConfig(pimpl->eglDisplay, eglConfigAttributes, &eglConfig, 1, &numConfig) == EGL_FALSE)
+    {
+        throw EGLError{"eglChooseConfig() failed"};
+    }
+    if (numConfig == 0)
+    {
+        throw EGLError{"No EGL config for RGB888"};
+    }
+
+    const EGLint pbufferAttribs[] = {
+        EGL_WIDTH, width,
+        EGL_HEIGHT, height,
+        EGL_NONE};
+    pimpl->eglSurface = eglCreatePbufferSurface(pimpl->eglDisplay, eglConfig, pbufferAttribs);
+    if (pimpl->eglSurface == EGL_NO_SURFACE)
+    {
+        throw EGLError{"eglCreatePbufferSurface() failed"};
+    }
+
+    if (eglBindAPI(EGL_OPENGL_ES_API) == EGL_FALSE)
+    {
+        throw EGLError{"eglBindAPI() failed"};
+    }
+
+    static constexpr EGLint eglContextAttributes[] = {
+        EGL_CONTEXT_CLIENT_VERSION, 2,
+        EGL_NONE};
+    pimpl->eglContext = eglCreateContext(pimpl->eglDisplay, eglConfig, EGL_NO_CONTEXT, eglContextAttributes);
+    if (pimpl->eglContext == EGL_NO_CONTEXT)
+    {
+        throw EGLError{"eglCreateContext() failed"};
+    }
+    if (eglMakeCurrent(pimpl->eglDisplay, pimpl->eglSurface, pimpl->eglSurface, pimpl->eglContext) == EGL_FALSE)
+    {
+        throw EGLError{"eglMakeCurrent() failed"};
+    }
+}
+
+WindowHeadless::~WindowHeadless() = default;
+
+WindowHeadless::Options WindowHeadless::getEnvironmentOptions()
+{
+    Options options;
+    if (const char *const dump = std::getenv(kEnvironmentDump))
+    {
+        options.dumpFolder = dump;
+    }
+    if (const char *const golden = std::getenv(kEnvironmentGolden))
+    {
+        options.goldenFolder = golden;
+    }
+    if (const char *const tolerance = std::getenv(kEnvironmentTolerance))
+    {
+        options.tolerance = std::atoi(tolerance);
+    }
+    return options;
+}
+
+void WindowHeadless::begin()
+{
+}
+
+void WindowHeadless::end()
+{
+    auto &statistics = pimpl->statistics;
+    const size_t frame = statistics.frames++;
+
+    const auto start = Clock::now();
+    if (!pimpl->options.software)
+    {
+        glFinish();
+    }
+    const auto rendered = Clock::now();
+    if (!pimpl->options.software)
+    {
+        glReadPixels(0, 0, pimpl->width, pimpl->height, GL_RGBA, GL_UNSIGNED_BYTE, pimpl->glFrame.data());
+    }
+    else if (pimpl->softwareFrame)
+    {
+        std::copy_n(pimpl->softwareFrame, pimpl->glFrame.size(), pimpl->glFrame.data());
+    }
+    const auto read = Clock::now();
+
+    statistics.gpu += rendered - start;
+    statistics.gpuMax = std::max(statistics.gpuMax, rendered - start);
+    statistics.readback += read - rendered;
+    statistics.readbackMax = std::max(statistics.readbackMax, read - rendered);
+
+    if (!pimpl->options.dumpFolder.empty() || !pimpl->options.goldenFolder.empty())
+    {
+        pimpl->processFrame(frame);
+    }
+}
+
+const WindowHeadless::Statistics &WindowHeadless::getStatistics() const
+{
+    return pimpl->statistics;
+}
+
+bool WindowHeadless::isSoftware() const
+{
+    return pimpl->options.software;
+}
+
+void WindowHeadless::setSoftwareFrame(const uint8_t *frame)
+{
+    pimpl->softwareFrame = frame;
+}
+
+std::unique_ptr<WindowEvent> WindowHeadless::createDefaultEvent()
+{
+    return std::make_unique<WindowEventDummy>();
+}
+
+std::ostream &WindowHeadless::toStream(std::ostream &str) const
+{
+    using Microseconds = std::chrono::duration<double, std::micro>;
+    const auto &statistics = pimpl->statistics;
+    const double frames = std::max<size_t>(statistics.frames, 1);
+    str << "\nWindow Headless: " << pimpl->width << 'x' << pimpl->height
+        << "\nFrames: " << statistics.frames
+        << "\nGPU per frame: " << Microseconds{statistics.gpu}.count() / frames << "us, max " << Microseconds{statistics.gpuMax}.count() << "us"
+        << "\nReadback per frame: " << Microseconds{statistics.readback}.count() / frames << "us, max " << Microseconds{statistics.readbackMax}.count() << "us";
+    if (!pimpl->options.dumpFolder.empty())
+    {
+        str << "\nDump: " << pimpl->options.dumpFolder;
+    }
+    if (!pimpl->options.goldenFolder.empty())
+    {
+        str << "\nGolden: " << pimpl->options.goldenFolder << ", " << statistics.goldenMismatches << " mismatches in " << statistics.goldenFrames << " frames, tolerance " << pimpl->options.tolerance;
+    }
+    if (pimpl->options.software)
+    {
+        str << "\nSoftware: drawn by the CPU";
+        return str;
+    }
+    str << "\nEGL info:\n - EGL_CLIENT_APIS: " << eglQueryString(pimpl->eglDisplay, EGL_CLIENT_APIS)
+        << "\n - EGL_VENDOR: " << eglQueryString(pimpl->eglDisplay, EGL_VENDOR)
+        << "\n - EGL_VERSION: " << eglQueryString(pimpl->eglDisplay, EGL_VERSION)
+        << "\n - EGL_EXTENSIONS: " << eglQueryString(pimpl->eglDisplay, EGL_EXTENSIONS);
+
+    return str;
+}
+
+#endif // USE_WINDOW_HEADLESS
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "window.hpp"
+
+#ifdef USE_WINDOW_HEADLESS
+
+#include "toolbox_time.hpp"
+
+#include <memory>
+#include <string>
+
+/**
+ * @brief Window without any screen, to run the tests and the benchmarks anywhere
+ *
+ * The frame is rendered into an EGL pbuffer, on the surfaceless platform when available (Mesa's llvmpipe does not
+ * need any GPU). Like a real display, each frame is read back. The frames can be dumped as PPM, or compared with
+ * golden images.
+ *
+ * With Options::software, there is no EGL at all: the frame is drawn by the CPU (RendererSoftware).
+ */
+class WindowHeadless : public Window
+{
+public:
+    struct Impl;
+
+    /**
+     * @brief What to do with the frames
+     */
+    struct Options
+    {
+        std::string dumpFolder;   ///< if not empty, each frame is written there as frame_00000.ppm, frame_00001.ppm...
+        std::string goldenFolder; ///< if not empty, each frame is compared with the PPM of the same name there
+        int tolerance = 0;        ///< maximum difference of a channel with the golden image
+        bool software = false;    ///< the frame is drawn by the CPU instead of OpenGL
+    };
+
+    /**
+     * @brief Timings of all the frames since the creation
+     */
+    struct Statistics
+    {
+        size_t frames = 0;
+        Clock::duration gpu{};         ///< glFinish() in end(): the GPU finishes the frame. 0 in software
+        Clock::duration gpuMax{};      ///< slowest frame
+        Clock::duration readback{};    ///< glReadPixels(), or the copy of the software frame
+        Clock::duration readbackMax{}; ///< slowest frame
+        size_t goldenFrames = 0;       ///< frames which had a golden image
+        size_t goldenMismatches = 0;   ///< frames which differ from their golden image
+    };
+
+    WindowHeadless(int width, int height);
+    WindowHeadless(int width, int height, const Options &options);
+    ~WindowHeadless() override;
+
+    /**
+     * Options from the environment variables ALARM_HEADLESS_DUMP, ALARM_HEADLESS_GOLDEN and ALARM_HEADLESS_TOLERANCE
+     */
+    static Options getEnvironmentOptions();
+
+    void begin() override;
+    void end() override;
+
+    const Statistics &getStatistics() const;
+
+    /**
+     * Options::software
+     */
+    bool isSoftware() const override;
+
+    void setSoftwareFrame(const uint8_t *frame) override;
+
+    /**
+     * WindowEventDummy
+     */
+    std::unique_ptr<WindowEvent> createDefaultEvent() override;
+
+protected:
+    std::ostream &toStream(std::ostream &str) const override;
+
+private:
+    std::unique_ptr<Impl> pimpl;
+};
+
+#endif // USE_WINDOW_HEADLESS
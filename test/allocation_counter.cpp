@@ -0,0 +1,180 @@
+#include "allocation_counter.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+
+// trivial type: no initialization of the thread local storage, which may itself allocate
+thread_local size_t threadAllocations = 0;
+
+void *allocate(std::size_t size)
+{
+    void *const result = std::malloc(size ? size : 1);
+    threadAllocations += result != nullptr;
+    return result;
+}
+
+void *allocate(std::size_t size, std::align_val_t alignment)
+{
+    // aligned_alloc() requires a multiple of the alignment
+    const auto align = static_cast<std::size_t>(alignment);
+    void *const result = std::aligned_alloc(align, std::max((size + align - 1) / align * align, align));
+    threadAllocations += result != nullptr;
+    return result;
+}
+
+/**
+ * Like the default operator new: the new handler is called until the allocation succeeds, std::bad_alloc without it
+ */
+template <typename... Args>
+void *allocateOrThrow(Args... args)
+{
+    for (;;)
+    {
+        if (void *const result = allocate(args...))
+        {
+            return result;
+        }
+        const std::new_handler handler = std::get_new_handler();
+        if (!handler)
+        {
+            throw std::bad_alloc{};
+        }
+        handler();
+    }
+}
+
+/**
+ * Like allocateOrThrow(), std::bad_alloc caught
+ */
+template <typename... Args>
+void *allocateNoThrow(Args... args) noexcept
+{
+    try
+    {
+        return allocateOrThrow(args...);
+    }
+    catch (const std::bad_alloc &)
+    {
+        return nullptr;
+    }
+}
+
+/**
+ * malloc() and aligned_alloc() are both released by free()
+ */
+void release(void *ptr)
+{
+    std::free(ptr);
+}
+
+} // namespace
+
+size_t getThreadAllocations()
+{
+    return threadAllocations;
+}
+
+// each one is replaced: the default ones are not required to call a replaced operator new
+void *operator new(std::size_t size)
+{
+    return allocateOrThrow(size);
+}
+
+void *operator new[](std::size_t size)
+{
+    return allocateOrThrow(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    return allocateNoThrow(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    return allocateNoThrow(size);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    return allocateOrThrow(size, alignment);
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return allocateOrThrow(size, alignment);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return allocateNoThrow(size, alignment);
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return allocateNoThrow(size, alignment);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    release(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    release(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    release(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept
+{
+    release(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept
+{
+    release(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept
+{
+    release(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept
+{
+    release(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t) noexcept
+{
+    release(ptr);
+}
+
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept
+{
+    release(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept
+{
+    release(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t, const std::nothrow_t &) noexcept
+{
+    release(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t, const std::nothrow_t &) noexcept
+{
+    release(ptr);
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+/**
+ * @file
+ *
+ * This file is to count the heap allocations of the calling thread. It is linked only into the unit tests: the global
+ * operator new and delete are replaced there, the application keeps the default ones
+ */
+
+#include <cstddef>
+
+/**
+ * Calls of the calling thread to any operator new since its start, the array, nothrow and aligned ones included
+ *
+ * malloc() called directly, e.g. by the C libraries, is not counted
+ */
+size_t getThreadAllocations();
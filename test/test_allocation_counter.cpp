@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+
+#include "allocation_counter.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+struct alignas(64) Aligned
+{
+    char data[64];
+};
+
+} // namespace
+
+TEST(TestAllocationCounter, CountAllOverloads)
+{
+    const size_t before = getThreadAllocations();
+    auto single = std::make_unique<int>(0);
+    auto array = std::make_unique<int[]>(4);
+    std::unique_ptr<int> nothrow{new (std::nothrow) int{0}};
+    auto aligned = std::make_unique<Aligned>();
+    auto alignedArray = std::make_unique<Aligned[]>(2);
+
+    EXPECT_EQ(5, getThreadAllocations() - before);
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(aligned.get()) % alignof(Aligned));
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(alignedArray.get()) % alignof(Aligned));
+}
+
+TEST(TestAllocationCounter, NewHandler)
+{
+    static int calls = 0;
+    calls = 0;
+    const std::new_handler previous = std::set_new_handler([] {
+        ++calls;
+        std::set_new_handler(nullptr);
+    });
+
+    // too large for malloc(): the handler is called once, then std::bad_alloc
+    volatile size_t size = SIZE_MAX / 2;
+    EXPECT_THROW(static_cast<void>(operator new(size)), std::bad_alloc);
+    EXPECT_EQ(1, calls);
+    EXPECT_EQ(nullptr, operator new(size, std::nothrow));
+
+    std::set_new_handler(previous);
+}
+
+TEST(TestAllocationCounter, OtherThread)
+{
+    const size_t before = getThreadAllocations();
+    size_t allocations = 0;
+    std::thread thread{[&allocations] {
+        const size_t start = getThreadAllocations();
+        std::vector<char> allocated(1000);
+        allocations = getThreadAllocations() - start;
+    }};
+    thread.join();
+
+    // std::thread allocates its state in this thread, not the vector
+    EXPECT_EQ(1, allocations);
+    EXPECT_GT(2, getThreadAllocations() - before);
+}
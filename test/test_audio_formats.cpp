@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include "audio_formats.hpp"
+
+#include <cstring>
+#include <ostream>
+#include <stdexcept>
+
+namespace
+{
+
+int loadedLibraries = 0;
+
+/**
+ * @brief Decoder without any library, to count the loads and the unloads
+ */
+template <char kExtension>
+struct AudioReadStub : public AudioRead
+{
+    struct Library
+    {
+        Library() { ++loadedLibraries; }
+        ~Library() { --loadedLibraries; }
+    };
+
+    static std::shared_ptr<Library> loadLib(std::ostream &)
+    {
+        if (kExtension == 'x')
+        {
+            throw std::runtime_error{"missing library"};
+        }
+        return std::make_shared<Library>();
+    }
+
+    static bool isSupported(FILEUnique &, const char *extension)
+    {
+        return extension != nullptr && extension[0] == kExtension;
+    }
+
+    static std::unique_ptr<AudioRead> create(const std::shared_ptr<Library> &library, FILEUnique &, const char *)
+    {
+        auto result = std::make_unique<AudioReadStub>();
+        result->library = library;
+        return result;
+    }
+
+    int getChannels() const override { return 2; }
+    uint64_t getSamples() const override { return 0; }
+    int getRate() const override { return 44100; }
+    size_t readBuffer(char *, size_t, bool) override { return 0; }
+
+    std::shared_ptr<Library> library;
+
+private:
+    std::ostream &toStream(std::ostream &str) const override { return str << "stub"; }
+};
+
+using StubFormats = AudioFormats<AudioReadStub<'a'>, AudioReadStub<'b'>, AudioReadStub<'x'>, AudioEnd>;
+
+} // namespace
+
+class TestAudioFormats : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        loadedLibraries = 0;
+    }
+
+    FILEUnique file;
+    const Clock::time_point start = Clock::now();
+};
+
+TEST_F(TestAudioFormats, LoadOnFirstUse)
+{
+    StubFormats formats;
+    EXPECT_EQ(0, loadedLibraries);
+
+    EXPECT_TRUE(formats.create(file, "b", start));
+    EXPECT_EQ(1, loadedLibraries);
+    EXPECT_TRUE(formats.create(file, "b", start));
+    EXPECT_EQ(1, loadedLibraries);
+
+    // unsupported, then missing library
+    EXPECT_FALSE(formats.create(file, "c", start));
+    EXPECT_FALSE(formats.create(file, "x", start));
+    EXPECT_EQ(1, loadedLibraries);
+}
+
+TEST_F(TestAudioFormats, UnloadIdle)
+{
+    StubFormats formats;
+    auto stream = formats.create(file, "a", start);
+    ASSERT_TRUE(stream);
+
+    // still played: kept whatever the time
+    formats.unloadIdle(start + 2 * kDecoderIdleTime);
+    EXPECT_EQ(1, loadedLibraries);
+
+    // playback stopped: the idle time starts at the last use
+    stream.reset();
+    const Clock::time_point stopped = start + 2 * kDecoderIdleTime;
+    formats.unloadIdle(stopped + kDecoderIdleTime / 2);
+    EXPECT_EQ(1, loadedLibraries);
+    formats.unloadIdle(stopped + kDecoderIdleTime);
+    EXPECT_EQ(0, loadedLibraries);
+
+    // loaded again
+    EXPECT_TRUE(formats.create(file, "a", stopped));
+    EXPECT_EQ(1, loadedLibraries);
+}
@@ -38,38 +38,49 @@ protected:
     void SetUp() override
     {
         std::ostringstream str;
-        AudioReadMod::loadLib(str);
+        library = AudioReadMod::loadLib(str);
+        ASSERT_TRUE(library);
         ASSERT_TRUE(str.str().empty());
     }
 
     void TearDown() override
     {
-        AudioReadMod::unloadLib();
+        library.reset();
 
         unlink(kDummyFilename);
     }
+
+    std::shared_ptr<AudioReadMod::Library> library;
 };
 
 TEST_F(TestAudioReadMod, wrongExtension)
 {
     auto file = getModFile();
 
-    const auto audio = AudioReadMod::create(file, "mp3");
+    const auto audio = AudioReadMod::create(library, file, "mp3");
     EXPECT_FALSE(audio);
     EXPECT_TRUE(file);
 }
 
+TEST_F(TestAudioReadMod, isSupported)
+{
+    auto file = getModFile();
+    EXPECT_TRUE(AudioReadMod::isSupported(file, "xm"));
+    EXPECT_TRUE(AudioReadMod::isSupported(file, "MOD"));
+    EXPECT_FALSE(AudioReadMod::isSupported(file, "mp3"));
+}
+
 TEST_F(TestAudioReadMod, nullFile)
 {
     FILEUnique file;
-    const auto audio = AudioReadMod::create(file, "mod");
+    const auto audio = AudioReadMod::create(library, file, "mod");
     EXPECT_FALSE(audio);
 }
 
 TEST_F(TestAudioReadMod, devnullFile)
 {
     FILEUnique file{std::fopen("/dev/null", "rb")};
-    const auto audio = AudioReadMod::create(file, "mod");
+    const auto audio = AudioReadMod::create(library, file, "mod");
     EXPECT_FALSE(audio);
 }
 
@@ -77,7 +88,7 @@ TEST_F(TestAudioReadMod, wrongContent)
 {
     auto file = createDummyFile("Wrong content");
 
-    const auto audio = AudioReadMod::create(file, "mod");
+    const auto audio = AudioReadMod::create(library, file, "mod");
     EXPECT_FALSE(audio);
     EXPECT_TRUE(file);
 }
@@ -85,7 +96,7 @@ TEST_F(TestAudioReadMod, wrongContent)
 TEST_F(TestAudioReadMod, read)
 {
     auto file = getModFile();
-    const auto audio = AudioReadMod::create(file, "mod");
+    const auto audio = AudioReadMod::create(library, file, "mod");
 
     EXPECT_FALSE(file);
     ASSERT_TRUE(audio);
@@ -28,7 +28,8 @@ protected:
     void SetUp() override
     {
         std::ostringstream str;
-        AudioReadMp3::loadLib(str);
+        library = AudioReadMp3::loadLib(str);
+        ASSERT_TRUE(library);
         ASSERT_FALSE(str.str().empty());
 
         // generate the test file on the fly
@@ -39,32 +40,42 @@ protected:
 
     void TearDown() override
     {
-        AudioReadMp3::unloadLib();
+        library.reset();
 
         unlink(kFilename);
     }
+
+    std::shared_ptr<AudioReadMp3::Library> library;
 };
 
 TEST_F(TestAudioReadMp3, wrongExtension)
 {
     auto file = createFile();
 
-    const auto audio = AudioReadMp3::create(file, "bin");
+    const auto audio = AudioReadMp3::create(library, file, "bin");
     EXPECT_FALSE(audio);
     EXPECT_TRUE(file);
 }
 
+TEST_F(TestAudioReadMp3, isSupported)
+{
+    auto file = createFile();
+    EXPECT_TRUE(AudioReadMp3::isSupported(file, "MP3"));
+    EXPECT_FALSE(AudioReadMp3::isSupported(file, "ogg"));
+    EXPECT_FALSE(AudioReadMp3::isSupported(file, nullptr));
+}
+
 TEST_F(TestAudioReadMp3, nullFile)
 {
     FILEUnique file;
-    const auto audio = AudioReadMp3::create(file, "mp3");
+    const auto audio = AudioReadMp3::create(library, file, "mp3");
     EXPECT_FALSE(audio);
 }
 
 TEST_F(TestAudioReadMp3, devnullFile)
 {
     FILEUnique file{std::fopen("/dev/null", "rb")};
-    const auto audio = AudioReadMp3::create(file, "mp3");
+    const auto audio = AudioReadMp3::create(library, file, "mp3");
     EXPECT_FALSE(audio);
 }
 
@@ -73,7 +84,7 @@ TEST_F(TestAudioReadMp3, wrongContent)
     std::ofstream{kFilename} << "Wrong content";
     auto file = createFile();
 
-    const auto audio = AudioReadMp3::create(file, "mp3");
+    const auto audio = AudioReadMp3::create(library, file, "mp3");
     EXPECT_FALSE(audio);
     EXPECT_TRUE(file);
 }
@@ -81,7 +92,7 @@ TEST_F(TestAudioReadMp3, wrongContent)
 TEST_F(TestAudioReadMp3, read)
 {
     auto file = createFile();
-    const auto audio = AudioReadMp3::create(file, "mp3");
+    const auto audio = AudioReadMp3::create(library, file, "mp3");
 
     EXPECT_FALSE(file);
     ASSERT_TRUE(audio);
@@ -27,7 +27,8 @@ protected:
     void SetUp() override
     {
         std::ostringstream str;
-        AudioReadOgg::loadLib(str);
+        library = AudioReadOgg::loadLib(str);
+        ASSERT_TRUE(library);
         ASSERT_TRUE(str.str().empty());
 
         // generate the test file on the fly
@@ -38,10 +39,12 @@ protected:
 
     void TearDown() override
     {
-        AudioReadOgg::unloadLib();
+        library.reset();
 
         unlink(kFilename);
     }
+
+    std::shared_ptr<AudioReadOgg::Library> library;
 };
 
 TEST_F(TestAudioReadOgg, wrongExtension)
@@ -49,15 +52,30 @@ TEST_F(TestAudioReadOgg, wrongExtension)
     // there is a "fast" check to know if it is an OGG container, no check on extension
     auto file = createFile();
 
-    const auto audioNullOgg = AudioReadOgg::create(file, "weirdEntension");
+    const auto audioNullOgg = AudioReadOgg::create(library, file, "weirdEntension");
     EXPECT_TRUE(audioNullOgg);
     EXPECT_FALSE(file);
 }
 
+TEST_F(TestAudioReadOgg, isSupported)
+{
+    // the container is checked without the library
+    auto file = createFile();
+    EXPECT_TRUE(AudioReadOgg::isSupported(file, "weirdEntension"));
+    EXPECT_TRUE(AudioReadOgg::create(library, file, "ogg"));
+
+    std::ofstream{kFilename} << "dummy content";
+    auto dummyFile = createFile();
+    EXPECT_FALSE(AudioReadOgg::isSupported(dummyFile, "ogg"));
+
+    FILEUnique nullFile;
+    EXPECT_FALSE(AudioReadOgg::isSupported(nullFile, "ogg"));
+}
+
 TEST_F(TestAudioReadOgg, nullFile)
 {
     FILEUnique file;
-    const auto audioNullOgg = AudioReadOgg::create(file, "ogg");
+    const auto audioNullOgg = AudioReadOgg::create(library, file, "ogg");
     EXPECT_FALSE(audioNullOgg);
 }
 
@@ -67,7 +85,7 @@ TEST_F(TestAudioReadOgg, wrongContent)
     std::ofstream{kFilename} << "dummy content";
 
     auto file = createFile();
-    const auto audioNullOgg = AudioReadOgg::create(file, "ogg");
+    const auto audioNullOgg = AudioReadOgg::create(library, file, "ogg");
     EXPECT_FALSE(audioNullOgg);
     EXPECT_TRUE(file);
 }
@@ -75,7 +93,7 @@ TEST_F(TestAudioReadOgg, wrongContent)
 TEST_F(TestAudioReadOgg, read)
 {
     auto file = createFile();
-    const auto audio = AudioReadOgg::create(file, "ogg");
+    const auto audio = AudioReadOgg::create(library, file, "ogg");
 
     EXPECT_FALSE(file);
     ASSERT_TRUE(audio);
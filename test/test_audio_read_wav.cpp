@@ -0,0 +1,141 @@
+#include "audio_read_wav.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+
+constexpr char kFilename[] = "test.wav";
+
+void writeInteger(std::ostream &str, uint32_t value, size_t size)
+{
+    for (size_t i = 0; i < size; ++i)
+    {
+        str.put(static_cast<char>(value >> (8 * i)));
+    }
+}
+
+} // namespace
+
+class TestAudioReadWav : public ::testing::Test
+{
+protected:
+    static constexpr int kChannels = 2;
+    static constexpr int kRate = 44100;
+    static constexpr int kSamples = 1000;
+
+    FILEUnique createFile()
+    {
+        FILEUnique result{std::fopen(kFilename, "rb")};
+        EXPECT_TRUE(result);
+        return result;
+    }
+
+    /**
+     * Header with a chunk to skip before the data, samples counting from 0
+     */
+    void write(uint16_t bitsPerSample)
+    {
+        std::ofstream str{kFilename, std::ios::binary};
+        const uint32_t dataSize = kSamples * kChannels * sizeof(int16_t);
+        str << "RIFF";
+        writeInteger(str, 4 + 8 + 16 + 8 + 3 + 1 + 8 + dataSize, 4);
+        str << "WAVE" << "fmt ";
+        writeInteger(str, 16, 4);
+        writeInteger(str, 1, 2);
+        writeInteger(str, kChannels, 2);
+        writeInteger(str, kRate, 4);
+        writeInteger(str, kRate * kChannels * bitsPerSample / 8, 4);
+        writeInteger(str, kChannels * bitsPerSample / 8, 2);
+        writeInteger(str, bitsPerSample, 2);
+        // odd size: padded
+        str << "LIST";
+        writeInteger(str, 3, 4);
+        str << "abc" << '\0';
+        str << "data";
+        writeInteger(str, dataSize, 4);
+        for (int i = 0; i < kSamples * kChannels; ++i)
+        {
+            writeInteger(str, i, 2);
+        }
+    }
+
+    void SetUp() override
+    {
+        std::ostringstream str;
+        library = AudioReadWav::loadLib(str);
+        ASSERT_TRUE(library);
+        ASSERT_TRUE(str.str().empty());
+        write(16);
+    }
+
+    void TearDown() override
+    {
+        library.reset();
+
+        unlink(kFilename);
+    }
+
+    std::shared_ptr<AudioReadWav::Library> library;
+};
+
+TEST_F(TestAudioReadWav, isSupported)
+{
+    auto file = createFile();
+    EXPECT_TRUE(AudioReadWav::isSupported(file, "weirdEntension"));
+
+    std::ofstream{kFilename} << "dummy content";
+    auto dummyFile = createFile();
+    EXPECT_FALSE(AudioReadWav::isSupported(dummyFile, "wav"));
+    EXPECT_FALSE(AudioReadWav::create(library, dummyFile, "wav"));
+    EXPECT_TRUE(dummyFile);
+
+    FILEUnique nullFile;
+    EXPECT_FALSE(AudioReadWav::isSupported(nullFile, "wav"));
+    EXPECT_FALSE(AudioReadWav::create(library, nullFile, "wav"));
+}
+
+TEST_F(TestAudioReadWav, wrongFormat)
+{
+    write(8);
+
+    auto file = createFile();
+    EXPECT_FALSE(AudioReadWav::create(library, file, "wav"));
+    EXPECT_TRUE(file);
+}
+
+TEST_F(TestAudioReadWav, read)
+{
+    auto file = createFile();
+    const auto audio = AudioReadWav::create(library, file, "wav");
+
+    EXPECT_FALSE(file);
+    ASSERT_TRUE(audio);
+
+    EXPECT_EQ(kChannels, audio->getChannels());
+    EXPECT_EQ(kRate, audio->getRate());
+    EXPECT_EQ(kSamples, audio->getSamples());
+
+    // the end of the file, then its beginning
+    std::vector<int16_t> samples(kSamples * kChannels);
+    EXPECT_EQ(samples.size() * sizeof(int16_t) - 8, audio->readBuffer(reinterpret_cast<char *>(samples.data()), samples.size() * sizeof(int16_t) - 8, true));
+    EXPECT_EQ(0, samples.front());
+    EXPECT_EQ(16, audio->readBuffer(reinterpret_cast<char *>(samples.data()), 16, true));
+    EXPECT_EQ(kSamples * kChannels - 4, samples[0]);
+    EXPECT_EQ(kSamples * kChannels - 1, samples[3]);
+    EXPECT_EQ(0, samples[4]);
+    EXPECT_EQ(3, samples[7]);
+
+    // no loop
+    EXPECT_EQ(samples.size() * sizeof(int16_t) - 8, audio->readBuffer(reinterpret_cast<char *>(samples.data()), samples.size() * sizeof(int16_t), false));
+    EXPECT_EQ(0, audio->readBuffer(reinterpret_cast<char *>(samples.data()), 16, false));
+
+    std::ostringstream str;
+    str << *audio;
+    EXPECT_FALSE(str.str().empty());
+}
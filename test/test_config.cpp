@@ -4,11 +4,15 @@
 #include "config_alarm.hpp"
 
 #include "serializer_rapidjson.hpp"
+#include "toolbox_filesystem.hpp"
+#include "toolbox_io.hpp"
 
 #include <rapidjson/document.h>
 #include <rapidjson/prettywriter.h>
 #include <rapidjson/stringbuffer.h>
 
+#include <fstream>
+
 class TestConfig : public ::testing::Test
 {
 protected:
@@ -66,6 +70,10 @@ TEST_F(TestConfig, full)
 {
     config.setDisplayDriver("driver");
     config.setSensorThermal("/dev/null");
+    config.setShaderCacheFolder("/var/cache/alarm");
+    config.setDisplayRotation(90);
+    config.setRenderThread(false);
+    config.setScreenCacheGpuKb(0);
     config.getAlarms().emplace_back();
     config.getAlarms().emplace_back();
     test(R"({
@@ -74,10 +82,14 @@ TEST_F(TestConfig, full)
     "display_driver": "driver",
     "display_width": 320,
     "display_height": 240,
+    "display_rotation": 90,
     "display_seconds": true,
     "event_driver": "default",
     "frames_per_second": 20,
+    "render_thread": false,
     "sensor_thermal": "/dev/null",
+    "shader_cache_folder": "/var/cache/alarm",
+    "screen_cache_gpu_kb": 0,
     "hand_clock_color": [
         255,
         0,
@@ -107,3 +119,18 @@ TEST_F(TestConfig, helpers)
     EXPECT_EQ("folder/textures/blip.dds", config.getTexture("blip.dds"));
     EXPECT_EQ("folder/messages", config.getMessages());
 }
+
+TEST_F(TestConfig, openTexture)
+{
+    // not embedded: read from the assets folder
+    fs::create_directories("folder/textures");
+    std::ofstream{"folder/textures/test_config.dds"} << "DDS";
+
+    EXPECT_TRUE(config.hasTexture("test_config.dds"));
+    EXPECT_FALSE(config.hasTexture("missing.dds"));
+    const MmapFile file = config.openTexture("test_config.dds");
+    EXPECT_EQ("DDS", std::string(static_cast<const char *>(file.content), file.size));
+    EXPECT_THROW(config.openTexture("missing.dds"), std::runtime_error);
+
+    fs::remove_all("folder");
+}
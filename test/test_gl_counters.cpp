@@ -0,0 +1,25 @@
+#include <gtest/gtest.h>
+
+#include "gl_counters.hpp"
+
+TEST(TestGlCounters, Count)
+{
+    const GlCounters previous = GlCounters::get();
+    GlCounters::count(GlCounters::Call::Draw);
+    GlCounters::count(GlCounters::Call::Upload, 10);
+    GlCounters::count(GlCounters::Call::TextureUpload, 20);
+
+    const GlCounters difference = GlCounters::get() - previous;
+    EXPECT_EQ(3, difference.calls);
+    EXPECT_EQ(1, difference.draws);
+    EXPECT_EQ(0, difference.binds);
+    EXPECT_EQ(1, difference.uploads);
+    EXPECT_EQ(10, difference.uploadedBytes);
+    EXPECT_EQ(1, difference.textureUploads);
+    EXPECT_EQ(20, difference.textureBytes);
+
+    GlCounters sum = difference;
+    sum += difference;
+    EXPECT_EQ(6, sum.calls);
+    EXPECT_EQ(20, GlCounters::max(sum, difference).uploadedBytes);
+}
@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+
+#include "error.hpp"
+#include "gl_program_cache.hpp"
+#include "gl_shader.hpp"
+#include "toolbox_filesystem.hpp"
+#include "window.hpp"
+#include "window_factory.hpp"
+
+#include <fstream>
+
+namespace
+{
+constexpr char kFragment[] = R"(\
+#version 100
+
+precision mediump float;
+
+uniform vec4 u_color;
+void main()
+{
+    gl_FragColor = u_color;
+})";
+
+constexpr char kVertex[] = R"(\
+#version 100
+
+attribute vec4 a_position;
+void main()
+{
+    gl_Position = a_position;
+})";
+
+constexpr char kOtherVertex[] = R"(\
+#version 100
+
+attribute vec4 a_position;
+void main()
+{
+    gl_Position = a_position * 0.5;
+})";
+
+constexpr char kInvalidShader[] = "#pragma once";
+
+} // namespace
+
+class TestGlProgramCache : public ::testing::Test
+{
+public:
+    WindowFactory factory;
+    const fs::path folder = fs::temp_directory_path() / "alarm_test_gl_program_cache";
+
+    void SetUp() override
+    {
+        fs::remove_all(folder);
+        factory.create(factory.getHeadlessDriver(), "dummy", 320, 240);
+        factory.get().begin();
+    }
+
+    void TearDown() override
+    {
+        factory.get().end();
+        factory.clear();
+        fs::remove_all(folder);
+    }
+
+    /**
+     * Files of the disk cache
+     */
+    std::vector<fs::path> getFiles() const
+    {
+        std::vector<fs::path> result;
+        if (fs::exists(folder))
+        {
+            for (const auto &entry : fs::directory_iterator{folder})
+            {
+                result.push_back(entry.path());
+            }
+        }
+        return result;
+    }
+};
+
+TEST_F(TestGlProgramCache, SameSources)
+{
+    GlProgramCache cache;
+    EXPECT_FALSE(cache.isDiskCacheEnabled());
+
+    GlProgram &program = cache.get(kVertex, kFragment);
+    EXPECT_EQ(&program, &cache.get(kVertex, kFragment));
+    EXPECT_NE(-1, program.getUniformLocation("u_color"));
+
+    EXPECT_EQ(1, cache.getStatistics().compiled);
+    EXPECT_EQ(1, cache.getStatistics().hits);
+    EXPECT_EQ(0, cache.getStatistics().stored);
+}
+
+TEST_F(TestGlProgramCache, DifferentSources)
+{
+    GlProgramCache cache;
+    EXPECT_NE(&cache.get(kVertex, kFragment), &cache.get(kOtherVertex, kFragment));
+    EXPECT_EQ(2, cache.getStatistics().compiled);
+    EXPECT_EQ(0, cache.getStatistics().hits);
+}
+
+TEST_F(TestGlProgramCache, InvalidSources)
+{
+    GlProgramCache cache;
+    EXPECT_THROW(cache.get(kInvalidShader, kFragment), Error);
+    // not cached
+    EXPECT_THROW(cache.get(kInvalidShader, kFragment), Error);
+    EXPECT_EQ(0, cache.getStatistics().compiled);
+}
+
+TEST_F(TestGlProgramCache, Disk)
+{
+    if (!GlProgram::isBinarySupported())
+    {
+        GTEST_SKIP() << "No OES_get_program_binary";
+    }
+
+    {
+        GlProgramCache cache{folder.native()};
+        ASSERT_TRUE(cache.isDiskCacheEnabled());
+        cache.get(kVertex, kFragment);
+        EXPECT_EQ(1, cache.getStatistics().compiled);
+        EXPECT_EQ(1, cache.getStatistics().stored);
+    }
+    EXPECT_EQ(1, getFiles().size());
+
+    // next run
+    GlProgramCache cache{folder.native()};
+    GlProgram &program = cache.get(kVertex, kFragment);
+    EXPECT_EQ(0, cache.getStatistics().compiled);
+    EXPECT_EQ(1, cache.getStatistics().loaded);
+    EXPECT_NE(-1, program.getUniformLocation("u_color"));
+    EXPECT_NE(-1, program.getAttribLocation("a_position"));
+}
+
+TEST_F(TestGlProgramCache, DiskInvalid)
+{
+    if (!GlProgram::isBinarySupported())
+    {
+        GTEST_SKIP() << "No OES_get_program_binary";
+    }
+
+    {
+        GlProgramCache cache{folder.native()};
+        cache.get(kVertex, kFragment);
+    }
+    const auto files = getFiles();
+    ASSERT_EQ(1, files.size());
+    std::ofstream{files.front(), std::ios::binary | std::ios::trunc} << "garbage";
+
+    // compiled again, then replaced
+    {
+        GlProgramCache cache{folder.native()};
+        cache.get(kVertex, kFragment);
+        EXPECT_EQ(1, cache.getStatistics().compiled);
+        EXPECT_EQ(1, cache.getStatistics().stored);
+    }
+
+    GlProgramCache cache{folder.native()};
+    cache.get(kVertex, kFragment);
+    EXPECT_EQ(1, cache.getStatistics().loaded);
+}
@@ -41,7 +41,7 @@ public:
 
     void SetUp() override
     {
-        factory.create(factory.getDriver(0), "dummy", 320, 240);
+        factory.create(factory.getHeadlessDriver(), "dummy", 320, 240);
         factory.get().begin();
     }
 
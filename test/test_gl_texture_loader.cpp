@@ -0,0 +1,228 @@
+#include <gtest/gtest.h>
+
+#include "gl_texture_loader.hpp"
+#include "toolbox_filesystem.hpp"
+#include "toolbox_gl.hpp"
+#include "toolbox_io.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace
+{
+
+// masks as stored in the file by the DDS writers
+constexpr uint32_t kMasksRgba[] = {0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000};
+constexpr uint32_t kMasksBgra[] = {0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000};
+
+/**
+ * 32 bits uncompressed DDS, pixel i of each mipmap is {i, level, 0x80, 0xff} in the file
+ */
+std::string getDds(uint32_t size, uint32_t mipmapCount, const uint32_t (&masks)[4])
+{
+    std::vector<uint32_t> header(32, 0);
+    std::memcpy(&header[0], "DDS ", 4);
+    header[1] = 124; // dwSize
+    header[2] = 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000; // DDSD_CAPS | HEIGHT | WIDTH | PIXELFORMAT | MIPMAPCOUNT
+    header[3] = size; // dwHeight
+    header[4] = size; // dwWidth
+    header[7] = mipmapCount; // dwMipMapCount
+    header[19] = 32; // ddspf.dwSize
+    header[20] = 0x40 | 0x1; // DDPF_RGB | DDPF_ALPHAPIXELS
+    header[22] = 32; // ddspf.dwRGBBitCount
+    std::copy(std::begin(masks), std::end(masks), &header[23]);
+    header[27] = 0x1000; // DDSCAPS_TEXTURE
+
+    std::string result(reinterpret_cast<const char *>(header.data()), header.size() * sizeof(uint32_t));
+    for (uint32_t level = 0; level < mipmapCount; ++level, size >>= 1)
+    {
+        for (uint32_t i = 0; i < size * size; ++i)
+        {
+            result += {static_cast<char>(i), static_cast<char>(level), static_cast<char>(0x80), static_cast<char>(0xff)};
+        }
+    }
+    return result;
+}
+
+/**
+ * KTX with 1 ETC1 block of 8 bytes per 4x4 pixels, filled with the level
+ */
+std::string getKtx(uint32_t size, uint32_t mipmapCount, bool swap = false)
+{
+    constexpr char kIdentifier[] = "\xAB\x4B\x54\x58\x20\x31\x31\xBB\x0D\x0A\x1A\x0A";
+    const auto get = [swap](uint32_t value) {
+        return swap ? __builtin_bswap32(value) : value;
+    };
+
+    std::string result{kIdentifier, 12};
+    const std::string keyValue = "abcd";
+    for (const uint32_t value : {0x04030201u, 0u, 1u, 0u, static_cast<uint32_t>(GL_ETC1_RGB8_OES), static_cast<uint32_t>(GL_RGB),
+                                 size, size, 0u, 0u, 1u, mipmapCount, static_cast<uint32_t>(keyValue.size())})
+    {
+        const uint32_t field = get(value);
+        result.append(reinterpret_cast<const char *>(&field), sizeof(field));
+    }
+    result += keyValue;
+
+    for (uint32_t level = 0; level < mipmapCount; ++level, size >>= 1)
+    {
+        const uint32_t blocks = std::max<uint32_t>(size / 4, 1);
+        const uint32_t imageSize = get(blocks * blocks * 8);
+        result.append(reinterpret_cast<const char *>(&imageSize), sizeof(imageSize));
+        result.append(blocks * blocks * 8, static_cast<char>(level));
+    }
+    return result;
+}
+
+} // namespace
+
+class TestGlTextureLoader : public ::testing::Test
+{
+protected:
+    const std::string filename = (fs::temp_directory_path() / "alarm_test_gl_texture_loader.dds").native();
+
+    void write(const std::string &content)
+    {
+        std::ofstream{filename, std::ios::binary | std::ios::trunc} << content;
+    }
+
+    void TearDown() override
+    {
+        fs::remove(filename);
+    }
+};
+
+TEST_F(TestGlTextureLoader, Rgba)
+{
+    write(getDds(4, 3, kMasksRgba));
+    const GlTextureLoader loader{filename.c_str()};
+
+    EXPECT_FALSE(loader.isCompressed());
+    EXPECT_EQ(GL_RGBA, loader.getGlFormat());
+    EXPECT_EQ(GL_UNSIGNED_BYTE, loader.getGlType());
+    ASSERT_EQ(3, loader.getMipmapCount());
+    for (uint32_t level = 0; level < 3; ++level)
+    {
+        const uint32_t size = 4 >> level;
+        EXPECT_EQ(size, loader.getMipmapWidth(level));
+        EXPECT_EQ(size, loader.getMipmapHeight(level));
+        EXPECT_EQ(size * size * 4, loader.getMipmapSize(level));
+        const char *data = loader.getMipmap(level);
+        EXPECT_EQ(static_cast<char>(level), data[1]);
+        EXPECT_EQ(static_cast<char>(0x80), data[2]);
+    }
+    EXPECT_EQ(nullptr, loader.getMipmap(3));
+}
+
+TEST_F(TestGlTextureLoader, Bgra)
+{
+    const std::string content = getDds(4, 3, kMasksBgra);
+    write(content);
+    {
+        const GlTextureLoader loader{filename.c_str()};
+        EXPECT_EQ(GL_RGBA, loader.getGlFormat());
+
+        // reordered: the 1st and 3rd bytes are swapped
+        const char *data = loader.getMipmap(1);
+        EXPECT_EQ(static_cast<char>(0x80), data[4]);
+        EXPECT_EQ(1, data[5]);
+        EXPECT_EQ(1, data[6]);
+        EXPECT_EQ(static_cast<char>(0xff), data[7]);
+    }
+
+    // only in memory
+    EXPECT_EQ(content, readFile(filename));
+}
+
+TEST_F(TestGlTextureLoader, Luminance)
+{
+    std::string content = getDds(4, 1, kMasksRgba);
+    // 8 bits DDPF_LUMINANCE, only the red mask, 1 byte per pixel
+    std::vector<uint32_t> header(32);
+    std::memcpy(header.data(), content.data(), 128);
+    header[20] = 0x20000;
+    header[22] = 8;
+    std::fill(&header[24], &header[27], 0);
+    content.replace(0, 128, reinterpret_cast<const char *>(header.data()), 128);
+    content.resize(128 + 4 * 4);
+    write(content);
+
+    const GlTextureLoader loader{filename.c_str()};
+    EXPECT_EQ(GL_LUMINANCE, loader.getGlFormat());
+    EXPECT_EQ(GL_UNSIGNED_BYTE, loader.getGlType());
+    EXPECT_EQ(16, loader.getMipmapSize(0));
+    // the 1st pixel of getDds(), read byte per byte
+    EXPECT_EQ(0, loader.getMipmap(0)[0]);
+    EXPECT_EQ(static_cast<char>(0x80), loader.getMipmap(0)[2]);
+}
+
+TEST_F(TestGlTextureLoader, MaxMipmapCount)
+{
+    write(getDds(4, 3, kMasksBgra));
+    const GlTextureLoader loader{filename.c_str(), 1};
+
+    EXPECT_EQ(1, loader.getMipmapCount());
+    EXPECT_EQ(4, loader.getMipmapWidth(0));
+    EXPECT_EQ(static_cast<char>(0x80), loader.getMipmap(0)[0]);
+    EXPECT_EQ(0, loader.getMipmapSize(1));
+}
+
+TEST_F(TestGlTextureLoader, Invalid)
+{
+    const std::string content = getDds(4, 3, kMasksRgba);
+    // last mipmap truncated
+    write(content.substr(0, content.size() - 1));
+    EXPECT_THROW(GlTextureLoader{filename.c_str()}, std::runtime_error);
+    // only the complete mipmaps
+    EXPECT_NO_THROW(GlTextureLoader(filename.c_str(), 2));
+
+    write("DDS");
+    EXPECT_THROW(GlTextureLoader{filename.c_str()}, std::runtime_error);
+
+    write(std::string(128, 'A'));
+    EXPECT_THROW(GlTextureLoader{filename.c_str()}, std::runtime_error);
+}
+
+TEST_F(TestGlTextureLoader, Ktx)
+{
+    for (const bool swap : {false, true})
+    {
+        write(getKtx(8, 4, swap));
+        const GlTextureLoader loader{filename.c_str()};
+
+        EXPECT_TRUE(loader.isCompressed());
+        EXPECT_EQ(GL_ETC1_RGB8_OES, loader.getGlFormat());
+        ASSERT_EQ(4, loader.getMipmapCount());
+        EXPECT_EQ(32, loader.getMipmapSize(0));
+        EXPECT_EQ(8, loader.getMipmapSize(1));
+        // the blocks are 4x4, even for the smaller mipmaps
+        EXPECT_EQ(8, loader.getMipmapSize(3));
+        EXPECT_EQ(1, loader.getMipmapWidth(3));
+        for (uint32_t level = 0; level < 4; ++level)
+        {
+            EXPECT_EQ(static_cast<char>(level), loader.getMipmap(level)[0]) << swap;
+        }
+    }
+}
+
+TEST_F(TestGlTextureLoader, KtxMaxMipmapCount)
+{
+    write(getKtx(8, 4));
+    const GlTextureLoader loader{filename.c_str(), 1};
+    EXPECT_EQ(1, loader.getMipmapCount());
+}
+
+TEST_F(TestGlTextureLoader, KtxInvalid)
+{
+    const std::string content = getKtx(8, 2);
+    write(content.substr(0, content.size() - 1));
+    EXPECT_THROW(GlTextureLoader{filename.c_str()}, std::runtime_error);
+
+    // uncompressed: glType is not 0
+    std::string uncompressed = content;
+    uncompressed[16] = 1;
+    write(uncompressed);
+    EXPECT_THROW(GlTextureLoader{filename.c_str()}, std::runtime_error);
+}
@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+
+#include "gl_vbo.hpp"
+#include "toolbox_gl.hpp"
+#include "window.hpp"
+#include "window_factory.hpp"
+
+#include <optional>
+#include <vector>
+
+class TestGlVbo : public ::testing::Test
+{
+public:
+    WindowFactory factory;
+
+    static constexpr GLfloat kVertices[] = {0.f, 1.f, 2.f, 3.f, 4.f, 5.f};
+    static constexpr GLushort kIndices[] = {0, 1, 2};
+
+    void SetUp() override
+    {
+        factory.create(factory.getHeadlessDriver(), "dummy", 320, 240);
+        factory.get().begin();
+    }
+
+    void TearDown() override
+    {
+        factory.get().end();
+        factory.clear();
+    }
+};
+
+TEST_F(TestGlVbo, PoolSharesBlocks)
+{
+    GlVboPool pool{1024};
+    GlVboArrayStatic first{pool, kVertices, 6};
+    GlVboArrayStatic second{pool, kVertices, 3};
+
+    EXPECT_EQ(first.get(), second.get());
+    EXPECT_EQ(0, first.getOffset());
+    // aligned
+    EXPECT_EQ(32, second.getOffset());
+
+    const GlVboPool::Statistics statistics = pool.getStatistics();
+    EXPECT_EQ(1, statistics.blocks);
+    EXPECT_EQ(1024, statistics.capacity);
+    EXPECT_EQ(48, statistics.used);
+    EXPECT_EQ(2, statistics.ranges);
+    EXPECT_EQ(GL_NO_ERROR, glGetError());
+}
+
+TEST_F(TestGlVbo, PoolSeparatesTargets)
+{
+    GlVboPool pool;
+    GlVboArrayStatic vertices{pool, kVertices, 6};
+    GlVboArrayDynamic dynamic{pool, kVertices, 6};
+    GlVboElementArray indices{pool, kIndices, 3};
+
+    EXPECT_NE(vertices.get(), dynamic.get());
+    EXPECT_NE(vertices.get(), indices.get());
+    EXPECT_EQ(3, pool.getStatistics().blocks);
+    EXPECT_EQ(GL_NO_ERROR, glGetError());
+}
+
+TEST_F(TestGlVbo, PoolRecycles)
+{
+    GlVboPool pool{1024};
+    {
+        // like a screen, entered then left
+        std::vector<GlVboArrayStatic> vbos;
+        for (int i = 0; i < 16; ++i)
+        {
+            vbos.emplace_back(pool, kVertices, 6);
+        }
+        EXPECT_EQ(16 * 32, pool.getStatistics().used);
+    }
+    EXPECT_EQ(0, pool.getStatistics().used);
+    EXPECT_EQ(1, pool.getStatistics().holes);
+
+    // the next screen fits in the same block
+    GlVboArrayStatic vbo{pool, kVertices, 6};
+    EXPECT_EQ(0, vbo.getOffset());
+    EXPECT_EQ(1, pool.getStatistics().blocks);
+}
+
+TEST_F(TestGlVbo, PoolFragmentation)
+{
+    GlVboPool pool{256};
+    std::vector<std::optional<GlVboArrayStatic>> vbos(8);
+    for (auto &vbo : vbos)
+    {
+        vbo.emplace(pool, kVertices, 6);
+    }
+    EXPECT_EQ(0.f, pool.getStatistics().getFragmentation());
+
+    // every other range: 4 holes of 32 bytes
+    for (size_t i = 0; i < vbos.size(); i += 2)
+    {
+        vbos[i].reset();
+    }
+    GlVboPool::Statistics statistics = pool.getStatistics();
+    EXPECT_EQ(4, statistics.holes);
+    EXPECT_EQ(32, statistics.largestHole);
+    EXPECT_EQ(32, statistics.contiguous);
+    EXPECT_FLOAT_EQ(.75f, statistics.getFragmentation());
+
+    // too large for the holes: new block
+    const std::vector<GLfloat> large(16);
+    GlVboArrayStatic vbo{pool, large.data(), large.size()};
+    EXPECT_EQ(2, pool.getStatistics().blocks);
+
+    // the neighbours are merged
+    for (auto &vbo : vbos)
+    {
+        vbo.reset();
+    }
+    statistics = pool.getStatistics();
+    EXPECT_EQ(2, statistics.holes);
+    EXPECT_EQ(256, statistics.largestHole);
+    // 1 hole per block
+    EXPECT_EQ(0.f, statistics.getFragmentation());
+}
+
+TEST_F(TestGlVbo, PoolLargerThanBlock)
+{
+    GlVboPool pool{64};
+    const std::vector<GLfloat> large(100);
+    GlVboArrayStatic vbo{pool, large.data(), large.size()};
+    EXPECT_EQ(1, pool.getStatistics().blocks);
+    EXPECT_EQ(400, pool.getStatistics().capacity);
+}
+
+TEST_F(TestGlVbo, MoveAssign)
+{
+    GlVboPool pool;
+    GlVboArrayStatic first{pool, kVertices, 6};
+    GlVboArrayStatic second{pool, kVertices, 6};
+    first = std::move(second);
+    EXPECT_EQ(32, first.getOffset());
+    EXPECT_EQ(2, pool.getStatistics().ranges);
+
+    // standalone VBO
+    GlVboArrayStatic standalone{kVertices};
+    EXPECT_EQ(0, standalone.getOffset());
+    EXPECT_NE(first.get(), standalone.get());
+}
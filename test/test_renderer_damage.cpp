@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+
+#include "renderer_damage.hpp"
+
+class TestRendererDamage : public ::testing::Test
+{
+protected:
+    /**
+     * Logical size == surface size: only the 1 pixel margin is added
+     */
+    RendererDamage damage{320, 240, 320, 240};
+
+    /**
+     * End the 1st frame, which is always fully damaged
+     */
+    void skipFirstFrame(const RendererDamage::Item &item)
+    {
+        damage.begin();
+        damage.add(item);
+        EXPECT_EQ((Rect{0, 0, 320, 240}), damage.end());
+    }
+};
+
+TEST_F(TestRendererDamage, Rect)
+{
+    constexpr Rect a{0, 0, 10, 10};
+    constexpr Rect b{5, 5, 10, 10};
+
+    EXPECT_TRUE(Rect{}.empty());
+    EXPECT_EQ((Rect{0, 0, 15, 15}), a.united(b));
+    EXPECT_EQ((Rect{5, 5, 5, 5}), a.intersected(b));
+    EXPECT_EQ(a, a.united(Rect{}));
+    EXPECT_TRUE(a.intersected(Rect{20, 20, 1, 1}).empty());
+}
+
+TEST_F(TestRendererDamage, Unchanged)
+{
+    const auto item = damage.createItem(Rect{10, 10, 20, 20});
+    skipFirstFrame(item);
+
+    damage.begin();
+    damage.add(item);
+    EXPECT_TRUE(damage.end().empty());
+}
+
+TEST_F(TestRendererDamage, Changed)
+{
+    auto item = damage.createItem(Rect{10, 10, 20, 20});
+    const auto other = damage.createItem(Rect{100, 100, 20, 20});
+    skipFirstFrame(item);
+
+    // new version
+    ++item.version;
+    damage.begin();
+    damage.add(item);
+    EXPECT_EQ((Rect{9, 9, 22, 22}), damage.end());
+
+    // new element
+    damage.begin();
+    damage.add(item);
+    damage.add(other);
+    EXPECT_EQ((Rect{99, 99, 22, 22}), damage.end());
+
+    // removed element
+    damage.begin();
+    damage.add(other);
+    EXPECT_EQ((Rect{9, 9, 22, 22}), damage.end());
+}
+
+TEST_F(TestRendererDamage, Tracking)
+{
+    const auto item = damage.createItem(Rect{10, 10, 20, 20});
+    const auto offscreen = damage.createItem(Rect{100, 100, 20, 20});
+    skipFirstFrame(item);
+
+    damage.begin();
+    damage.setTracking(false);
+    damage.add(offscreen);
+    damage.setTracking(true);
+    damage.add(item);
+    EXPECT_TRUE(damage.end().empty());
+
+    damage.invalidate();
+    damage.begin();
+    damage.add(item);
+    EXPECT_EQ((Rect{0, 0, 320, 240}), damage.end());
+}
+
+TEST_F(TestRendererDamage, Scale)
+{
+    RendererDamage scaled{320, 240, 640, 480};
+    const auto item = scaled.createItem(Rect{10, 10, 20, 20});
+    scaled.begin();
+    scaled.end();
+
+    scaled.begin();
+    scaled.add(item);
+    EXPECT_EQ((Rect{19, 19, 42, 42}), scaled.end());
+
+    // clipped to the surface
+    const auto border = scaled.createItem(Rect{310, 230, 20, 20});
+    scaled.begin();
+    scaled.add(item);
+    scaled.add(border);
+    EXPECT_EQ((Rect{619, 459, 21, 21}), scaled.end());
+}
@@ -0,0 +1,115 @@
+// correct testing of OpenGL is very hardware dependent... this is not really a unittest
+
+#include <gtest/gtest.h>
+
+#include "config.hpp"
+#include "gl_counters.hpp"
+#include "renderer_glyph_cache.hpp"
+#include "window_headless.hpp"
+
+// these tests must be disabled in release mode due to a wrong assets default path
+#ifndef RELEASE_MODE
+#define ONLY_DEBUG_MODE(x) x
+#else
+#define ONLY_DEBUG_MODE(x) DISABLED_##x
+#endif
+
+// the glyphs out of ASCII need FreeType
+#ifndef NO_FREETYPE
+#define ONLY_FREETYPE(x) ONLY_DEBUG_MODE(x)
+#else
+#define ONLY_FREETYPE(x) DISABLED_##x
+#endif
+
+namespace
+{
+
+constexpr int kFallbackCell = '?' - 0x20;
+
+} // namespace
+
+class TestRendererGlyphCache : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        window = std::make_unique<WindowHeadless>(config.getDisplayWidth(), config.getDisplayHeight(), WindowHeadless::Options{});
+    }
+
+    Config config;
+    std::unique_ptr<WindowHeadless> window;
+};
+
+TEST_F(TestRendererGlyphCache, ONLY_DEBUG_MODE(Ascii))
+{
+    RendererGlyphCache cache{config};
+    EXPECT_EQ(0, cache.acquire(U' '));
+    EXPECT_EQ('A' - 0x20, cache.acquire(U'A'));
+    EXPECT_EQ('~' - 0x20, cache.acquire(U'~'));
+    // control characters are blank
+    EXPECT_EQ(0, cache.acquire(U'\t'));
+
+    const RendererGlyphCache::Statistics statistics = cache.getStatistics();
+    EXPECT_EQ(0u, statistics.hits + statistics.misses + statistics.fallbacks + statistics.used);
+    EXPECT_EQ(RendererGlyphCache::kCapacity, statistics.capacity);
+}
+
+TEST_F(TestRendererGlyphCache, ONLY_FREETYPE(MissThenHit))
+{
+    RendererGlyphCache cache{config};
+
+    const GlCounters before = GlCounters::get();
+    const int cell = cache.acquire(U'é');
+    EXPECT_LE(0x7f - 0x20, cell);
+    EXPECT_EQ(1u, (GlCounters::get() - before).textureUploads);
+    EXPECT_EQ(18u * 32u, (GlCounters::get() - before).textureBytes);
+
+    // already uploaded
+    EXPECT_EQ(cell, cache.acquire(U'é'));
+    EXPECT_EQ(1u, (GlCounters::get() - before).textureUploads);
+
+    const RendererGlyphCache::Statistics statistics = cache.getStatistics();
+    EXPECT_EQ(1u, statistics.misses);
+    EXPECT_EQ(1u, statistics.hits);
+    EXPECT_EQ(1u, statistics.used);
+}
+
+TEST_F(TestRendererGlyphCache, ONLY_DEBUG_MODE(Fallback))
+{
+    RendererGlyphCache cache{config};
+    // not in the font
+    EXPECT_EQ(kFallbackCell, cache.acquire(U'€'));
+    EXPECT_EQ(1u, cache.getStatistics().fallbacks);
+    EXPECT_EQ(0u, cache.getStatistics().used);
+}
+
+TEST_F(TestRendererGlyphCache, ONLY_FREETYPE(Eviction))
+{
+    RendererGlyphCache cache{config, 2};
+    const int e = cache.acquire(U'é');
+    const int a = cache.acquire(U'à');
+    cache.release(e);
+    cache.release(a);
+    // é is used again: à is the least recently used
+    cache.release(cache.acquire(U'é'));
+
+    EXPECT_EQ(a, cache.acquire(U'ç'));
+    EXPECT_EQ(1u, cache.getStatistics().evictions);
+    EXPECT_EQ(e, cache.acquire(U'é'));
+    EXPECT_EQ(2u, cache.getStatistics().used);
+}
+
+TEST_F(TestRendererGlyphCache, ONLY_FREETYPE(Pinned))
+{
+    RendererGlyphCache cache{config, 2};
+    const int e = cache.acquire(U'é');
+    cache.acquire(U'à');
+
+    // every cell is displayed
+    EXPECT_EQ(kFallbackCell, cache.acquire(U'ç'));
+    EXPECT_EQ(0u, cache.getStatistics().evictions);
+
+    cache.release(e);
+    EXPECT_EQ(e, cache.acquire(U'ç'));
+    EXPECT_EQ(1u, cache.getStatistics().evictions);
+}
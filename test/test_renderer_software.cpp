@@ -0,0 +1,191 @@
+#include <gtest/gtest.h>
+
+#include "renderer_software.hpp"
+
+namespace
+{
+
+using Pixel = std::array<uint8_t, 4>;
+
+constexpr Pixel kBlack{0, 0, 0, 255};
+constexpr Pixel kRed{255, 0, 0, 255};
+constexpr Pixel kGreen{0, 255, 0, 255};
+constexpr Pixel kBlue{0, 0, 255, 255};
+constexpr Pixel kWhite{255, 255, 255, 255};
+
+/**
+ * 2x2 image, 1st line at the top: red green / blue white
+ */
+SoftwareImage getImage(uint8_t alpha = 255)
+{
+    SoftwareImage image{2, 2, {}};
+    for (Pixel pixel : {kRed, kGreen, kBlue, kWhite})
+    {
+        pixel[3] = alpha;
+        image.pixels.insert(image.pixels.end(), pixel.begin(), pixel.end());
+    }
+    return image;
+}
+
+/**
+ * Number of pixels of a color
+ */
+int count(const SoftwareCanvas &canvas, const Pixel &pixel)
+{
+    int result = 0;
+    for (int y = 0; y < canvas.getHeight(); ++y)
+    {
+        for (int x = 0; x < canvas.getWidth(); ++x)
+        {
+            result += canvas.getPixel(x, y) == pixel;
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+class TestRendererSoftware : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        canvas.fill(SoftwareColor{}, canvas.getRect());
+    }
+
+    SoftwareCanvas canvas{8, 8};
+};
+
+TEST_F(TestRendererSoftware, InvalidSize)
+{
+    EXPECT_THROW(SoftwareCanvas(0, 8), std::runtime_error);
+    EXPECT_THROW(SoftwareCanvas(8, -1), std::runtime_error);
+}
+
+TEST_F(TestRendererSoftware, Fill)
+{
+    EXPECT_EQ(64, count(canvas, kBlack));
+
+    canvas.fill(SoftwareColor{255, 0, 0}, Rect{6, 6, 4, 4});
+    EXPECT_EQ(4, count(canvas, kRed));
+    EXPECT_EQ(kRed, canvas.getPixel(7, 7));
+    EXPECT_EQ(kBlack, canvas.getPixel(5, 7));
+}
+
+TEST_F(TestRendererSoftware, Blit)
+{
+    const auto image = getImage();
+    canvas.blit(image, SoftwareBox{0, 0, 2, 2}, SoftwareBox{2, 2, 2, 2}, 0, canvas.getRect());
+
+    // the 1st line of the canvas is at the bottom
+    EXPECT_EQ(kRed, canvas.getPixel(2, 3));
+    EXPECT_EQ(kGreen, canvas.getPixel(3, 3));
+    EXPECT_EQ(kBlue, canvas.getPixel(2, 2));
+    EXPECT_EQ(kWhite, canvas.getPixel(3, 2));
+    EXPECT_EQ(60, count(canvas, kBlack));
+}
+
+TEST_F(TestRendererSoftware, BlitUpscale)
+{
+    const auto image = getImage();
+    canvas.blit(image, SoftwareBox{0, 0, 2, 2}, SoftwareBox{0, 0, 8, 8}, 0, canvas.getRect());
+
+    EXPECT_EQ(16, count(canvas, kRed));
+    EXPECT_EQ(16, count(canvas, kGreen));
+    EXPECT_EQ(16, count(canvas, kBlue));
+    EXPECT_EQ(16, count(canvas, kWhite));
+    EXPECT_EQ(kRed, canvas.getPixel(0, 7));
+    EXPECT_EQ(kWhite, canvas.getPixel(7, 0));
+}
+
+TEST_F(TestRendererSoftware, BlitSource)
+{
+    const auto image = getImage();
+    // only the right column
+    canvas.blit(image, SoftwareBox{1, 0, 1, 2}, SoftwareBox{0, 0, 1, 2}, 0, canvas.getRect());
+
+    EXPECT_EQ(kGreen, canvas.getPixel(0, 1));
+    EXPECT_EQ(kWhite, canvas.getPixel(0, 0));
+}
+
+TEST_F(TestRendererSoftware, BlitRotation)
+{
+    const auto image = getImage();
+    // the top left corner of the image goes clockwise
+    constexpr std::array<std::array<int, 2>, 4> kRedPosition{{{0, 1}, {1, 1}, {1, 0}, {0, 0}}};
+    for (int rotation = 0; rotation < 4; ++rotation)
+    {
+        canvas.blit(image, SoftwareBox{0, 0, 2, 2}, SoftwareBox{0, 0, 2, 2}, rotation, canvas.getRect());
+        EXPECT_EQ(kRed, canvas.getPixel(kRedPosition[rotation][0], kRedPosition[rotation][1])) << rotation;
+    }
+}
+
+TEST_F(TestRendererSoftware, BlitAlpha)
+{
+    canvas.fill(SoftwareColor{0, 0, 255}, canvas.getRect());
+    canvas.blit(getImage(128), SoftwareBox{0, 0, 2, 2}, SoftwareBox{0, 0, 2, 2}, 0, canvas.getRect());
+
+    // red over blue, half transparent
+    EXPECT_EQ((Pixel{128, 0, 127, 191}), canvas.getPixel(0, 1));
+
+    // fully transparent: unchanged
+    canvas.blit(getImage(0), SoftwareBox{0, 0, 2, 2}, SoftwareBox{4, 4, 2, 2}, 0, canvas.getRect());
+    EXPECT_EQ(kBlue, canvas.getPixel(4, 4));
+}
+
+TEST_F(TestRendererSoftware, BlitClip)
+{
+    const auto image = getImage();
+    canvas.blit(image, SoftwareBox{0, 0, 2, 2}, SoftwareBox{0, 0, 8, 8}, 0, Rect{0, 0, 2, 8});
+
+    EXPECT_EQ(8, count(canvas, kRed));
+    EXPECT_EQ(8, count(canvas, kBlue));
+    EXPECT_EQ(48, count(canvas, kBlack));
+
+    // outside of the canvas
+    canvas.blit(image, SoftwareBox{0, 0, 2, 2}, SoftwareBox{-4, 6, 8, 8}, 0, canvas.getRect());
+}
+
+TEST_F(TestRendererSoftware, FillQuad)
+{
+    // square of 4x4 pixels
+    canvas.fillQuad({2, 6, 2, 2, 6, 2, 6, 6}, SoftwareColor{255, 255, 255}, canvas.getRect());
+    EXPECT_EQ(16, count(canvas, kWhite));
+    EXPECT_EQ(kWhite, canvas.getPixel(2, 2));
+    EXPECT_EQ(kWhite, canvas.getPixel(5, 5));
+    EXPECT_EQ(kBlack, canvas.getPixel(6, 6));
+
+    // the same square turned by 90 degrees: same pixels
+    canvas.fill(SoftwareColor{}, canvas.getRect());
+    canvas.fillQuad({6, 6, 2, 6, 2, 2, 6, 2}, SoftwareColor{255, 255, 255}, canvas.getRect());
+    EXPECT_EQ(16, count(canvas, kWhite));
+}
+
+TEST_F(TestRendererSoftware, FillQuadRotated)
+{
+    // diamond centered in the canvas: the pixels whose center is inside
+    canvas.fillQuad({4, 8, 0, 4, 4, 0, 8, 4}, SoftwareColor{255, 255, 255}, canvas.getRect());
+    EXPECT_EQ(32, count(canvas, kWhite));
+    EXPECT_EQ(kWhite, canvas.getPixel(3, 0));
+    EXPECT_EQ(kWhite, canvas.getPixel(0, 4));
+    EXPECT_EQ(kBlack, canvas.getPixel(0, 0));
+    EXPECT_EQ(kBlack, canvas.getPixel(7, 7));
+}
+
+TEST_F(TestRendererSoftware, FillQuadClip)
+{
+    canvas.fillQuad({-10, 20, -10, -10, 20, -10, 20, 20}, SoftwareColor{255, 255, 255}, Rect{0, 0, 8, 2});
+    EXPECT_EQ(16, count(canvas, kWhite));
+}
+
+TEST_F(TestRendererSoftware, Copy)
+{
+    SoftwareCanvas other{8, 8};
+    other.fill(SoftwareColor{0, 255, 0}, other.getRect());
+
+    canvas.copy(other, Rect{4, 4, 8, 8});
+    EXPECT_EQ(16, count(canvas, kGreen));
+
+    SoftwareCanvas small{4, 4};
+    EXPECT_THROW(canvas.copy(small, canvas.getRect()), std::runtime_error);
+}
@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+
+#include "gl_command_buffer.hpp"
+#include "renderer_thread.hpp"
+#include "toolbox_gl.hpp"
+#include "window.hpp"
+#include "window_factory.hpp"
+
+#include <stdexcept>
+#include <thread>
+
+class TestRendererThread : public ::testing::Test
+{
+public:
+    WindowFactory factory;
+
+    void SetUp() override
+    {
+        factory.create(factory.getHeadlessDriver(), "dummy", 320, 240);
+    }
+
+    void TearDown() override
+    {
+        factory.clear();
+    }
+
+    static uint32_t readPixel()
+    {
+        uint32_t pixel = 0;
+        glReadPixels(0, 0, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, &pixel);
+        return pixel;
+    }
+};
+
+TEST_F(TestRendererThread, Record)
+{
+    factory.get().begin();
+    glClearColor(0, 0, 0, 1);
+    glClear(GL_COLOR_BUFFER_BIT);
+    const uint32_t black = readPixel();
+
+    GlCommandBuffer buffer;
+    {
+        GlCommandBuffer::Recording recording{buffer};
+        EXPECT_EQ(&buffer, GlCommandBuffer::getRecording());
+        glClearColor(1, 0, 0, 1);
+        GlCommandBuffer::clearColor();
+        const uint8_t data[] = {1, 2, 3};
+        GlCommandBuffer::bufferSubData(GL_ARRAY_BUFFER, 0, sizeof(data), data);
+    }
+    EXPECT_EQ(nullptr, GlCommandBuffer::getRecording());
+    EXPECT_EQ(2, buffer.size());
+    // not called yet
+    EXPECT_EQ(black, readPixel());
+
+    buffer.replay();
+    EXPECT_NE(black, readPixel());
+    // no buffer bound for bufferSubData()
+    EXPECT_EQ(GL_INVALID_OPERATION, glGetError());
+
+    buffer.clear();
+    EXPECT_EQ(0, buffer.size());
+    factory.get().end();
+}
+
+TEST_F(TestRendererThread, Frames)
+{
+    RendererThread renderThread;
+    constexpr int kFrames = 5;
+
+    std::thread logic{[&] {
+        for (int frame = 0; frame < kFrames && renderThread.beginFrame(); ++frame)
+        {
+            EXPECT_NE(nullptr, GlCommandBuffer::getRecording());
+            GlCommandBuffer::clearColor();
+            renderThread.endFrame(Rect{0, 0, 320, 240});
+        }
+        EXPECT_EQ(nullptr, GlCommandBuffer::getRecording());
+        renderThread.stop();
+    }};
+
+    int frames = 0;
+    while (renderThread.renderFrame(factory.get()))
+    {
+        ++frames;
+    }
+    logic.join();
+    EXPECT_EQ(kFrames, frames);
+}
+
+TEST_F(TestRendererThread, Invoke)
+{
+    RendererThread renderThread;
+    const auto renderThreadId = std::this_thread::get_id();
+    int frames = 0;
+
+    std::thread logic{[&] {
+        renderThread.invoke([&] {
+            EXPECT_EQ(renderThreadId, std::this_thread::get_id());
+        });
+        EXPECT_THROW(renderThread.invoke([] { throw std::runtime_error{"task"}; }), std::runtime_error);
+
+        // the recorded frame before the task
+        EXPECT_TRUE(renderThread.beginFrame());
+        renderThread.endFrame(Rect{});
+        renderThread.invoke([&] { EXPECT_EQ(1, frames); });
+
+        renderThread.stop();
+        EXPECT_FALSE(renderThread.beginFrame());
+        EXPECT_THROW(renderThread.invoke([] {}), std::runtime_error);
+    }};
+
+    while (renderThread.dropFrame())
+    {
+        ++frames;
+    }
+    logic.join();
+    EXPECT_EQ(1, frames);
+
+    // called by the render thread
+    bool called = false;
+    renderThread.invoke([&] { called = true; });
+    EXPECT_TRUE(called);
+}
@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+
+#include "screen_cache.hpp"
+
+#include <vector>
+
+namespace
+{
+
+constexpr size_t kGpuBytes = 100;
+
+size_t gpuMemory = 0;
+
+/**
+ * @brief Screen which holds kGpuBytes of fake GPU memory while warm
+ */
+struct StubScreen
+{
+    void enter()
+    {
+        if (!warm)
+        {
+            warm = true;
+            gpuMemory += kGpuBytes;
+        }
+        ++enters;
+    }
+
+    void leave()
+    {
+        ++leaves;
+    }
+
+    void release()
+    {
+        warm = false;
+        gpuMemory -= kGpuBytes;
+    }
+
+    bool warm = false;
+    int enters = 0;
+    int leaves = 0;
+};
+
+} // namespace
+
+class TestScreenCache : public ::testing::Test
+{
+protected:
+    static constexpr size_t kNoBudget = 1024 * 1024 * 1024;
+
+    void SetUp() override
+    {
+        gpuMemory = 0;
+    }
+
+    std::vector<bool> getWarm() const
+    {
+        std::vector<bool> result;
+        for (const StubScreen &screen : screens)
+        {
+            result.push_back(screen.warm);
+        }
+        return result;
+    }
+
+    StubScreen screens[4];
+    int tasks = 0;
+    ScreenCache<StubScreen> cache{
+        {&screens[0], &screens[1], &screens[2], &screens[3]},
+        [this](const std::function<void()> &task) {
+            ++tasks;
+            task();
+        },
+        [] { return gpuMemory; }};
+};
+
+TEST_F(TestScreenCache, Statistics)
+{
+    EXPECT_FALSE(cache.getCurrent());
+
+    cache.setCurrent(0, kNoBudget);
+    cache.setCurrent(1, kNoBudget);
+    cache.setCurrent(0, kNoBudget);
+    ASSERT_EQ(0, cache.getCurrent());
+
+    // enter() and release() run on the context
+    EXPECT_EQ(3, tasks);
+    EXPECT_EQ(2, screens[0].enters);
+    EXPECT_EQ(1, screens[0].leaves);
+    EXPECT_EQ(1, screens[1].leaves);
+
+    const ScreenCacheStatistics statistics = cache.getStatistics();
+    EXPECT_EQ(1, statistics.hits);
+    EXPECT_EQ(2, statistics.misses);
+    EXPECT_EQ(0, statistics.evictions);
+    EXPECT_EQ(2, statistics.warm);
+    EXPECT_FLOAT_EQ(1.f / 3, statistics.getHitRate());
+
+    // only the inactive screen is held
+    EXPECT_EQ(kGpuBytes, statistics.gpuMemory);
+}
+
+TEST_F(TestScreenCache, LeastRecentlyUsedFirst)
+{
+    static constexpr size_t kGpuBudget = 2 * kGpuBytes + kGpuBytes / 2;
+
+    for (size_t idx = 0; idx < 4; ++idx)
+    {
+        cache.setCurrent(idx, kGpuBudget);
+    }
+    // 3 inactive screens: the 1st one is released
+    EXPECT_EQ((std::vector<bool>{false, true, true, true}), getWarm());
+    EXPECT_EQ(1, cache.getStatistics().evictions);
+
+    // 1 becomes the most recently used, then the 2nd one is the oldest
+    cache.setCurrent(1, kGpuBudget);
+    cache.setCurrent(0, kGpuBudget);
+    EXPECT_EQ((std::vector<bool>{true, true, false, true}), getWarm());
+
+    const ScreenCacheStatistics statistics = cache.getStatistics();
+    EXPECT_EQ(2, statistics.evictions);
+    EXPECT_EQ(1, statistics.hits);
+    EXPECT_EQ(5, statistics.misses);
+    EXPECT_EQ(2 * kGpuBytes, statistics.gpuMemory);
+}
+
+TEST_F(TestScreenCache, BudgetZero)
+{
+    cache.setCurrent(0, 0);
+    cache.setCurrent(1, 0);
+    cache.setCurrent(2, 0);
+    EXPECT_EQ((std::vector<bool>{false, false, true, false}), getWarm());
+
+    const ScreenCacheStatistics statistics = cache.getStatistics();
+    EXPECT_EQ(2, statistics.evictions);
+    EXPECT_EQ(1, statistics.warm);
+    EXPECT_EQ(0, statistics.gpuMemory);
+
+    // the current screen is kept
+    cache.setCurrent(2, 0);
+    EXPECT_EQ((std::vector<bool>{false, false, true, false}), getWarm());
+    EXPECT_EQ(1, cache.getStatistics().hits);
+}
+
+TEST_F(TestScreenCache, Clear)
+{
+    cache.setCurrent(0, kNoBudget);
+    cache.setCurrent(1, kNoBudget);
+    cache.setCurrent(2, kNoBudget);
+
+    cache.clear();
+    EXPECT_EQ((std::vector<bool>{false, false, true, false}), getWarm());
+
+    // released by clear(), not evicted over a budget
+    const ScreenCacheStatistics statistics = cache.getStatistics();
+    EXPECT_EQ(0, statistics.evictions);
+    EXPECT_EQ(1, statistics.warm);
+    EXPECT_EQ(0, statistics.gpuMemory);
+    EXPECT_EQ(kGpuBytes, gpuMemory);
+
+    // built again
+    cache.setCurrent(0, kNoBudget);
+    EXPECT_EQ(4, cache.getStatistics().misses);
+}
@@ -0,0 +1,289 @@
+#include <gtest/gtest.h>
+
+#include "alarm.hpp"
+#include "allocation_counter.hpp"
+#include "audio.hpp"
+#include "config.hpp"
+#include "config_alarm.hpp"
+#include "context.hpp"
+#include "gl_counters.hpp"
+#include "renderer.hpp"
+#include "renderer_software.hpp"
+#include "sensor.hpp"
+#include "sensor_factory.hpp"
+#include "serializer.hpp"
+#include "toolbox_filesystem.hpp"
+#include "toolbox_io.hpp"
+#include "toolbox_time.hpp"
+#include "window_headless.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+// these tests must be disabled in release mode due to a wrong assets default path
+#ifndef RELEASE_MODE
+#define ONLY_DEBUG_MODE(x) x
+#else
+#define ONLY_DEBUG_MODE(x) DISABLED_##x
+#endif
+
+namespace
+{
+
+/**
+ * @brief Count the heap allocations of the current thread during its lifetime
+ */
+class AllocationCounter
+{
+public:
+    size_t get() const
+    {
+        return getThreadAllocations() - start;
+    }
+
+private:
+    const size_t start = getThreadAllocations();
+};
+
+/**
+ * @brief Nothing is saved: the config is set by the test
+ */
+class NoPersistence : public SerializationHandler
+{
+public:
+    bool load(Serializable &) override
+    {
+        return false;
+    }
+    void save(const Serializable &) override
+    {
+    }
+};
+
+/**
+ * One second of 16 bits PCM stereo at 44100 Hz, played in loop by the alarm
+ */
+void writeWave(const fs::path &filename)
+{
+    constexpr uint32_t kRate = 44100;
+    constexpr uint32_t kDataSize = kRate * 2 * sizeof(int16_t);
+    constexpr uint32_t kHeader[] = {
+        0x46464952, 36 + kDataSize, 0x45564157, // RIFF, WAVE
+        0x20746d66, 16, 0x00020001, kRate, kRate * 4, 0x00100004, // fmt : PCM, stereo, 16 bits
+        0x61746164, kDataSize, // data
+    };
+    static_assert(BYTE_ORDER == LITTLE_ENDIAN, "the header is written in the CPU order");
+
+    std::ofstream str{filename, std::ios::binary};
+    str.write(reinterpret_cast<const char *>(kHeader), sizeof(kHeader));
+    for (uint32_t i = 0; i < kDataSize / sizeof(int16_t); ++i)
+    {
+        const int16_t sample = static_cast<int16_t>(i % 100 * 200);
+        str.write(reinterpret_cast<const char *>(&sample), sizeof(sample));
+    }
+}
+
+} // namespace
+
+/**
+ * @brief The frames of the main screen, through Context::run() like the application does
+ *
+ * The alarm plays a WAVE file on the ALSA "null" device, or is silent without any audio device, and the thermal sensor
+ * reads a temporary file.
+ * Not covered, their allocations may still happen in a frame:
+ * - the allocations with malloc() instead of operator new, e.g. inside ALSA or the C library, see getThreadAllocations()
+ * - the other threads: App's render thread (RendererThread), the startup workers
+ * - the OGG, MOD and MP3 decoders: their libraries may be missing, only the WAVE reader is played
+ * - the window backends other than WindowHeadless (DRM, framebuffer, SDL, Wayland) and the events of a touch screen
+ * - the other screens than ScreenMain and the screen changes
+ */
+class TestSteadyState : public ::testing::TestWithParam<bool>
+{
+protected:
+    // the alarm starts within the 1st minute
+    static constexpr int kWarmUpFrames = 16;
+    static constexpr int kFrames = 120;
+    static constexpr std::chrono::seconds kFrameTime{5};
+    static constexpr char kSensorName[] = "steady_state";
+
+    /**
+     * Files of the alarm and of the sensor
+     */
+    void SetUp() override
+    {
+        fs::remove_all(folder);
+        fs::create_directories(folder / "thermal_zone0");
+        writeWave(folder / "alarm.wav");
+        std::ofstream{folder / "thermal_zone0" / "type"} << kSensorName;
+        std::ofstream{folder / "thermal_zone0" / "temp"} << "40000";
+    }
+
+    void TearDown() override
+    {
+        context.reset();
+        renderer.reset();
+        window.reset();
+        fs::remove_all(folder);
+    }
+
+    /**
+     * @return nullptr if the ALSA null device is missing
+     */
+    static std::unique_ptr<Audio> openNullAudio()
+    {
+        try
+        {
+            std::ostringstream log;
+            return std::make_unique<Audio>("null", log);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << e.what() << std::endl;
+            return nullptr;
+        }
+    }
+
+    /**
+     * Create the renderer and the context, then render the warm up frames: the alarm starts during them
+     *
+     * @param audio nullptr: the alarm is silent
+     */
+    void enter(bool software, std::unique_ptr<Audio> audio)
+    {
+        config.setDisplaySeconds(true);
+        config.setSensorThermal(kSensorName);
+
+        // the next minute, at least a second after the 1st frame
+        start = Clock::now();
+        const struct tm alarmTime = getLocalTime(start + std::chrono::minutes{1});
+        ConfigAlarm &alarm = config.getAlarms().emplace_back();
+        alarm.setActive(true);
+        alarm.setHours(alarmTime.tm_hour);
+        alarm.setMinutes(alarmTime.tm_min);
+        alarm.setDurationMinutes(60);
+        alarm.setFile((folder / "alarm.wav").native());
+
+        WindowHeadless::Options options;
+        options.software = software;
+        window = std::make_unique<WindowHeadless>(config.getDisplayWidth(), config.getDisplayHeight(), options);
+        renderer = std::make_unique<Renderer>(config, software);
+        if (RendererSoftware *const rendererSoftware = renderer->getSoftware())
+        {
+            window->setSoftwareFrame(rendererSoftware->getCanvas().data());
+        }
+
+        context = std::make_unique<Context>(config, persistence, *renderer, std::move(audio),
+                                            std::make_unique<SensorFactory>(folder.native()));
+
+        for (int frame = 0; frame < kWarmUpFrames; ++frame)
+        {
+            renderFrame(frame);
+        }
+    }
+
+    Clock::time_point getTime(int frame) const
+    {
+        return start + frame * kFrameTime;
+    }
+
+    void renderFrame(int frame)
+    {
+        window->begin();
+        renderer->begin();
+        context->run(getTime(frame));
+        renderer->end();
+        window->setDamage(renderer->getDamagedRect());
+        window->end();
+    }
+
+    /**
+     * A new temperature for the next refresh of the sensor, written without any allocation
+     */
+    void setTemperature(int frame)
+    {
+        char buffer[8];
+        const int size = std::snprintf(buffer, sizeof(buffer), "%d", 40000 + frame % 50 * 200);
+        ASSERT_EQ(size, pwrite(temperature.fd, buffer, size, 0));
+    }
+
+    const fs::path folder = fs::temp_directory_path() / "alarm_test_steady_state";
+    Clock::time_point start;
+    FileUnix temperature;
+
+    // destroyed in the reverse order: the context before the renderer
+    Config config;
+    NoPersistence persistence;
+    std::unique_ptr<WindowHeadless> window;
+    std::unique_ptr<Renderer> renderer;
+    std::unique_ptr<Context> context;
+};
+
+TEST_P(TestSteadyState, ONLY_DEBUG_MODE(NoAllocation))
+{
+    std::unique_ptr<Audio> audio = openNullAudio();
+    if (!audio)
+    {
+        // a configuration error, not a pass: alsa-lib always defines pcm.null
+        FAIL() << "no ALSA null device: the steady state is not checked";
+    }
+    enter(GetParam(), std::move(audio));
+
+    // the frames run the alarm, the screen and the sensor
+    ASSERT_TRUE(context->getAlarm().isActive());
+    ASSERT_FALSE(context->getAlarm().getNextRun());
+    ASSERT_TRUE(context->getTemperatureSensor());
+    temperature.fd = open((folder / "thermal_zone0" / "temp").c_str(), O_WRONLY);
+    ASSERT_LE(0, temperature.fd);
+
+    int refreshes = 0;
+    {
+        AllocationCounter counter;
+        for (int frame = kWarmUpFrames; frame < kWarmUpFrames + kFrames; ++frame)
+        {
+            setTemperature(frame);
+            const float previous = context->getTemperatureSensor()->get();
+            renderFrame(frame);
+            refreshes += context->getTemperatureSensor()->get() != previous;
+        }
+        EXPECT_EQ(0, counter.get());
+    }
+    EXPECT_TRUE(context->getAlarm().isActive());
+    EXPECT_LT(0, refreshes);
+}
+
+TEST_F(TestSteadyState, ONLY_DEBUG_MODE(GlBudget))
+{
+    // the time, alarm and thermal texts change: a few indices are uploaded, never a texture. ScreenMain uploads them
+    // at most once a frame, 32 bytes
+    static constexpr size_t kMaxDraws = 8;
+    static constexpr size_t kMaxBinds = 32;
+    static constexpr size_t kMaxUploads = 1;
+    static constexpr size_t kMaxUploadedBytes = 32;
+
+    // the audio does not change the frames
+    enter(false, nullptr);
+    ASSERT_TRUE(context->getAlarm().isActive());
+
+    GlCounters max;
+    for (int frame = kWarmUpFrames; frame < kWarmUpFrames + kFrames; ++frame)
+    {
+        const GlCounters previous = GlCounters::get();
+        renderFrame(frame);
+        max = GlCounters::max(max, GlCounters::get() - previous);
+    }
+    EXPECT_LE(max.draws, kMaxDraws);
+    EXPECT_LE(max.binds, kMaxBinds);
+    EXPECT_LE(max.uploads, kMaxUploads);
+    EXPECT_LE(max.uploadedBytes, kMaxUploadedBytes);
+    EXPECT_EQ(0, max.textureUploads);
+}
+
+INSTANTIATE_TEST_SUITE_P(Renderers, TestSteadyState, ::testing::Values(false, true), [](const auto &info) {
+    return info.param ? "Software" : "Gl";
+});
@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+
+#include "config.hpp"
+#include "toolbox_assets.hpp"
+#include "toolbox_io.hpp"
+
+// these tests must be disabled in release mode due to a wrong assets default path
+#ifndef RELEASE_MODE
+#define ONLY_DEBUG_MODE(x) x
+#else
+#define ONLY_DEBUG_MODE(x) DISABLED_##x
+#endif
+
+TEST(TestToolboxAssets, ONLY_DEBUG_MODE(Shader))
+{
+    const std::string_view content = getEmbeddedAsset("shader/print_text.vert");
+#ifdef USE_EMBEDDED_ASSETS
+    // the same as the file, page aligned
+    EXPECT_EQ(readFile(Config{}.getShader("print_text.vert")), content);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(content.data()) % kEmbeddedAssetsAlignment);
+#else
+    EXPECT_TRUE(content.empty());
+#endif
+    EXPECT_TRUE(getEmbeddedAsset("shader/missing.vert").empty());
+    EXPECT_TRUE(getEmbeddedAsset("print_text.vert").empty());
+}
+
+TEST(TestToolboxAssets, ONLY_DEBUG_MODE(Prefetch))
+{
+    const Config config;
+    EXPECT_LT(0u, prefetchAssets({config.getShader(), config.getTexture()}));
+#ifndef USE_EMBEDDED_ASSETS
+    EXPECT_EQ(0u, prefetchAssets({"/my/non/existing/path"}));
+#endif
+}
+
+TEST(TestToolboxAssets, ONLY_DEBUG_MODE(PrefetchFromDisk))
+{
+    // like Config::openShader(): the folders instead of the embedded blob
+    setenv("ALARM_ASSETS_FROM_DISK", "1", 1);
+    EXPECT_FALSE(hasEmbeddedAssets());
+    EXPECT_EQ(0u, prefetchAssets({"/my/non/existing/path"}));
+    const Config config;
+    EXPECT_LT(0u, prefetchAssets({config.getShader()}));
+    unsetenv("ALARM_ASSETS_FROM_DISK");
+
+#ifdef USE_EMBEDDED_ASSETS
+    EXPECT_TRUE(hasEmbeddedAssets());
+#else
+    EXPECT_FALSE(hasEmbeddedAssets());
+#endif
+}
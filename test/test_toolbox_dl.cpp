@@ -0,0 +1,38 @@
+#include <gtest/gtest.h>
+
+#include "toolbox_dl.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+
+/**
+ * @brief Functions of the math library, like the decoders do with theirs
+ */
+struct MathLibrary
+{
+    SharedLibrary library{"libm.so.6"};
+    SHARED_LIBRARY_SYMBOL(cos);
+};
+
+} // namespace
+
+TEST(TestToolboxDl, Symbol)
+{
+    const MathLibrary math;
+    EXPECT_DOUBLE_EQ(1.0, math.cos(0.0));
+    EXPECT_DOUBLE_EQ(-1.0, math.cos(M_PI));
+}
+
+TEST(TestToolboxDl, MissingLibrary)
+{
+    EXPECT_THROW(SharedLibrary{"libmissing_alarm_codec.so.0"}, std::runtime_error);
+}
+
+TEST(TestToolboxDl, MissingSymbol)
+{
+    const SharedLibrary library{"libm.so.6"};
+    EXPECT_THROW(library.getSymbol<void()>("missing_alarm_function"), std::runtime_error);
+}
@@ -94,3 +94,17 @@ TEST_F(TestToolboxIo, mmap_NotMmap)
     {
     }
 }
+
+TEST_F(TestToolboxIo, mmap_FromMemory)
+{
+    char memory[] = "BGRA";
+    MmapFile mmapped = MmapFile::fromMemory(memory);
+    ASSERT_EQ(memory, mmapped.content);
+    ASSERT_EQ(4u, mmapped.size);
+
+    // written in a copy: the memory is shared
+    mmapped.setCopyOnWrite();
+    static_cast<char *>(mmapped.content)[0] = 'R';
+    EXPECT_STREQ("BGRA", memory);
+    EXPECT_FALSE(std::memcmp("RGRA", mmapped.content, mmapped.size));
+}
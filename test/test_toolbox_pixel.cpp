@@ -0,0 +1,312 @@
+#include <gtest/gtest.h>
+
+#include "toolbox_pixel.hpp"
+#include "toolbox_time.hpp"
+
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <tuple>
+
+namespace
+{
+
+constexpr size_t kWidth = 320;
+constexpr size_t kHeight = 240;
+
+std::vector<uint8_t> getRandomFrame(size_t width, size_t height)
+{
+    std::mt19937 generator{42};
+    std::uniform_int_distribution<int> distribution{0, 255};
+    std::vector<uint8_t> frame(width * height * 4);
+    for (auto &byte : frame)
+    {
+        byte = distribution(generator);
+    }
+    return frame;
+}
+
+/**
+ * Reference conversion of 1 pixel, with the layout known at runtime
+ */
+void convertPixel(PixelSource source, const PixelLayout &layout, const uint8_t *src, uint8_t *dst)
+{
+    uint32_t r = src[0];
+    uint32_t g = src[1];
+    uint32_t b = src[2];
+    if (source == PixelSource::RGB565)
+    {
+        uint16_t pixel;
+        std::memcpy(&pixel, src, sizeof(pixel));
+        const auto expand = [](uint32_t value, int length) {
+            return (value << (8 - length)) | (value >> (2 * length - 8));
+        };
+        r = expand(pixel >> 11, 5);
+        g = expand((pixel >> 5) & 0x3f, 6);
+        b = expand(pixel & 0x1f, 5);
+    }
+    const uint32_t value = (r >> (8 - layout.redLength)) << layout.redOffset |
+                           (g >> (8 - layout.greenLength)) << layout.greenOffset |
+                           (b >> (8 - layout.blueLength)) << layout.blueOffset;
+    const int size = layout.bitsPerPixel / 8;
+    for (int i = 0; i < size; ++i)
+    {
+        const int byte = layout.bigEndian ? size - 1 - i : i;
+        dst[i] = value >> (8 * byte);
+    }
+}
+
+std::string getName(const ::testing::TestParamInfo<std::tuple<PixelSource, PixelLayout>> &info)
+{
+    const auto &layout = std::get<1>(info.param);
+    std::ostringstream name;
+    name << (std::get<0>(info.param) == PixelSource::RGBA8888 ? "RGBA8888" : "RGB565") << "_to_" << layout.bitsPerPixel << "bpp"
+         << "_R" << layout.redOffset << '_' << layout.redLength
+         << "_G" << layout.greenOffset << '_' << layout.greenLength
+         << "_B" << layout.blueOffset << '_' << layout.blueLength
+         << (layout.bigEndian ? "_BE" : "_LE");
+    return name.str();
+}
+
+} // namespace
+
+class TestToolboxPixel : public ::testing::Test
+{
+protected:
+    const std::vector<PixelConverter> converters = getPixelConverters();
+};
+
+TEST_F(TestToolboxPixel, Scalar)
+{
+    ASSERT_FALSE(converters.empty());
+    const auto &scalar = converters.front();
+    EXPECT_STREQ("scalar", scalar.name);
+
+    // R, G, B, A
+    const uint8_t src[] = {0xff, 0x00, 0x00, 0xff, 0x12, 0x34, 0x56, 0x78};
+
+    uint8_t rgb565[4] = {};
+    scalar.toRGB565(src, rgb565, 2);
+    EXPECT_EQ(0xf8, rgb565[0]);
+    EXPECT_EQ(0x00, rgb565[1]);
+    // 00010 001101 01010
+    EXPECT_EQ(0x11, rgb565[2]);
+    EXPECT_EQ(0xaa, rgb565[3]);
+
+    uint8_t xrgb8888[8] = {};
+    scalar.toXRGB8888(src, xrgb8888, 2);
+    const uint8_t expected[] = {0x00, 0x00, 0xff, 0x00, 0x56, 0x34, 0x12, 0x00};
+    for (size_t i = 0; i < sizeof(expected); ++i)
+    {
+        EXPECT_EQ(expected[i], xrgb8888[i]) << i;
+    }
+
+    const uint16_t native565[] = {0xf800, 0x11aa};
+    uint8_t bigEndian565[4] = {};
+    scalar.fromRGB565(reinterpret_cast<const uint8_t *>(native565), bigEndian565, 2);
+    EXPECT_EQ(0xf8, bigEndian565[0]);
+    EXPECT_EQ(0x00, bigEndian565[1]);
+    EXPECT_EQ(0x11, bigEndian565[2]);
+    EXPECT_EQ(0xaa, bigEndian565[3]);
+}
+
+TEST_F(TestToolboxPixel, BitExact)
+{
+    // odd multiples of 2 to test the remaining pixels after the vectorized part
+    for (const size_t width : {2, 6, 14, 30, 62, 320, 322})
+    {
+        const auto src = getRandomFrame(width, 3);
+        const size_t stride = width * 4;
+        const auto &scalar = converters.front();
+        std::vector<uint8_t> expected565(stride * 3);
+        std::vector<uint8_t> expected8888(stride * 3);
+        std::vector<uint8_t> expectedNative565(stride * 3);
+        convertFrame(scalar.toRGB565, src.data(), 4, width, 3, expected565.data(), stride);
+        convertFrame(scalar.toXRGB8888, src.data(), 4, width, 3, expected8888.data(), stride);
+        convertFrame(scalar.fromRGB565, src.data(), 2, width, 3, expectedNative565.data(), stride);
+
+        for (const auto &converter : converters)
+        {
+            std::vector<uint8_t> result(stride * 3);
+            convertFrame(converter.toRGB565, src.data(), 4, width, 3, result.data(), stride);
+            EXPECT_EQ(expected565, result) << converter.name << " RGB565 width " << width;
+
+            convertFrame(converter.toXRGB8888, src.data(), 4, width, 3, result.data(), stride);
+            EXPECT_EQ(expected8888, result) << converter.name << " XRGB8888 width " << width;
+
+            std::fill(result.begin(), result.end(), 0);
+            convertFrame(converter.fromRGB565, src.data(), 2, width, 3, result.data(), stride);
+            EXPECT_EQ(expectedNative565, result) << converter.name << " native RGB565 width " << width;
+        }
+    }
+}
+
+TEST_F(TestToolboxPixel, Layouts)
+{
+    // the layouts of the vectorized kernels
+    EXPECT_EQ(getPixelConverter().toRGB565, getPixelKernel(PixelSource::RGBA8888, PixelLayout{16, 11, 5, 5, 6, 0, 5, true}));
+    EXPECT_EQ(getPixelConverter().fromRGB565, getPixelKernel(PixelSource::RGB565, PixelLayout{16, 11, 5, 5, 6, 0, 5, true}));
+    EXPECT_EQ(getPixelConverter().toXRGB8888, getPixelKernel(PixelSource::RGBA8888, PixelLayout{}));
+    EXPECT_EQ(nullptr, getPixelKernel(PixelSource::RGBA8888, PixelLayout{8, 5, 3, 2, 3, 0, 2, false}));
+    EXPECT_EQ(nullptr, getPixelKernel(PixelSource::RGBA8888, PixelLayout{32, 0, 10, 10, 10, 20, 10, false}));
+}
+
+TEST_F(TestToolboxPixel, Flip)
+{
+    const auto src = getRandomFrame(2, 3);
+    std::vector<uint8_t> dst(3 * 16);
+    convertFrame(converters.front().toXRGB8888, src.data(), 4, 2, 3, dst.data(), 16);
+
+    // the last line of src is the 1st one of dst
+    EXPECT_EQ(src[2 * 8 + 0], dst[2]);
+    EXPECT_EQ(src[2 * 8 + 2], dst[0]);
+    // the 1st line of src is the last one of dst
+    EXPECT_EQ(src[0], dst[2 * 16 + 2]);
+    EXPECT_EQ(src[2], dst[2 * 16 + 0]);
+}
+
+TEST_F(TestToolboxPixel, Transform)
+{
+    constexpr size_t kFrameWidth = 40;
+    constexpr size_t kFrameHeight = 22;
+    const auto frame = getRandomFrame(kFrameWidth, kFrameHeight);
+    const auto &scalar = converters.front();
+
+    // reference: whole frame converted, 1st line at the top
+    std::vector<uint32_t> converted(kFrameWidth * kFrameHeight);
+    convertFrame(scalar.toXRGB8888, frame.data(), 4, kFrameWidth, kFrameHeight, reinterpret_cast<uint8_t *>(converted.data()), kFrameWidth * 4);
+
+    // not aligned on the tiles
+    const Rect region{6, 2, 30, 18};
+    std::vector<uint8_t> src;
+    for (int line = region.y; line < region.y + region.height; ++line)
+    {
+        const auto begin = frame.begin() + (line * kFrameWidth + region.x) * 4;
+        src.insert(src.end(), begin, begin + region.width * 4);
+    }
+
+    for (int rotation = 0; rotation < 4; ++rotation)
+    {
+        for (int scale = 1; scale <= 3; ++scale)
+        {
+            const size_t screenWidth = (rotation % 2 ? kFrameHeight : kFrameWidth) * scale;
+            const size_t screenHeight = (rotation % 2 ? kFrameWidth : kFrameHeight) * scale;
+            std::vector<uint32_t> screen(screenWidth * screenHeight);
+            convertFrame(scalar.toXRGB8888, src.data(), 4, region, kFrameWidth, kFrameHeight, PixelTransform{rotation, scale},
+                         reinterpret_cast<uint8_t *>(screen.data()), 4, screenWidth * 4);
+
+            for (size_t screenY = 0; screenY < screenHeight; ++screenY)
+            {
+                for (size_t screenX = 0; screenX < screenWidth; ++screenX)
+                {
+                    const size_t X = screenX / scale;
+                    const size_t Y = screenY / scale;
+                    // back to the frame, y from the top
+                    size_t x = X;
+                    size_t y = Y;
+                    switch (rotation)
+                    {
+                    case 1:
+                        x = Y;
+                        y = kFrameHeight - 1 - X;
+                        break;
+                    case 2:
+                        x = kFrameWidth - 1 - X;
+                        y = kFrameHeight - 1 - Y;
+                        break;
+                    case 3:
+                        x = kFrameWidth - 1 - Y;
+                        y = X;
+                        break;
+                    }
+                    const int glY = kFrameHeight - 1 - y;
+                    const bool inRegion = static_cast<int>(x) >= region.x && static_cast<int>(x) < region.x + region.width && glY >= region.y && glY < region.y + region.height;
+                    const uint32_t expected = inRegion ? converted[y * kFrameWidth + x] : 0;
+                    ASSERT_EQ(expected, screen[screenY * screenWidth + screenX]) << "rotation " << rotation << " scale " << scale << " at " << screenX << 'x' << screenY;
+                }
+            }
+        }
+    }
+}
+
+class TestToolboxPixelLayout : public ::testing::TestWithParam<std::tuple<PixelSource, PixelLayout>>
+{
+};
+
+TEST_P(TestToolboxPixelLayout, Specialized)
+{
+    const auto [source, layout] = GetParam();
+    const auto kernel = getSpecializedPixelKernel(source, layout);
+    ASSERT_NE(nullptr, kernel);
+
+    const size_t srcPixelSize = source == PixelSource::RGBA8888 ? 4 : 2;
+    const size_t dstPixelSize = layout.bitsPerPixel / 8;
+    // odd width, all the values of each byte
+    constexpr size_t kCount = 257;
+    const auto src = getRandomFrame(kCount, 1);
+    std::vector<uint8_t> result(kCount * dstPixelSize);
+    kernel(src.data(), result.data(), kCount);
+
+    std::vector<uint8_t> expected(kCount * dstPixelSize);
+    for (size_t i = 0; i < kCount; ++i)
+    {
+        convertPixel(source, layout, src.data() + i * srcPixelSize, expected.data() + i * dstPixelSize);
+    }
+    EXPECT_EQ(expected, result);
+
+    // the kernel selected at startup gives the same bytes, vectorized or not
+    std::fill(result.begin(), result.end(), 0);
+    getPixelKernel(source, layout)(src.data(), result.data(), kCount - 1);
+    EXPECT_TRUE(std::equal(result.begin(), result.end() - dstPixelSize, expected.begin()));
+}
+
+INSTANTIATE_TEST_SUITE_P(All,
+                         TestToolboxPixelLayout,
+                         ::testing::Combine(::testing::Values(PixelSource::RGBA8888, PixelSource::RGB565),
+                                            ::testing::ValuesIn(getSupportedPixelLayouts())),
+                         getName);
+
+TEST_F(TestToolboxPixel, Benchmark)
+{
+    constexpr int kFrames = 50;
+    const auto src = getRandomFrame(kWidth, kHeight);
+    std::vector<uint8_t> dst(kWidth * kHeight * 4);
+
+    for (const auto &converter : converters)
+    {
+        const struct
+        {
+            const char *name;
+            PixelConverter::Kernel kernel;
+            size_t srcPixelSize;
+            size_t dstPixelSize;
+        } kernels[] = {
+            {"RGBA8888 -> RGB565", converter.toRGB565, 4, 2},
+            {"RGBA8888 -> XRGB8888", converter.toXRGB8888, 4, 4},
+            {"native RGB565 -> RGB565", converter.fromRGB565, 2, 2},
+        };
+        for (const auto &kernel : kernels)
+        {
+            const auto start = Clock::now();
+            for (int i = 0; i < kFrames; ++i)
+            {
+                convertFrame(kernel.kernel, src.data(), kernel.srcPixelSize, kWidth, kHeight, dst.data(), kWidth * kernel.dstPixelSize);
+            }
+            const std::chrono::duration<double, std::micro> duration = Clock::now() - start;
+            std::cout << converter.name << ' ' << kernel.name << ": "
+                      << duration.count() / kFrames << "us per " << kWidth << 'x' << kHeight << " frame" << std::endl;
+        }
+    }
+
+    // scale x2 + 90deg rotation, like a 480x640 screen
+    const auto &converter = converters.back();
+    std::vector<uint8_t> screen(kWidth * kHeight * 2 * 2 * 2);
+    const auto start = Clock::now();
+    for (int i = 0; i < kFrames; ++i)
+    {
+        convertFrame(converter.toRGB565, src.data(), 4, Rect{0, 0, kWidth, kHeight}, kWidth, kHeight, PixelTransform{1, 2}, screen.data(), 2, kHeight * 2 * 2);
+    }
+    const std::chrono::duration<double, std::micro> duration = Clock::now() - start;
+    std::cout << converter.name << " RGBA8888 -> RGB565 x2 90deg: " << duration.count() / kFrames << "us per " << kWidth << 'x' << kHeight << " frame" << std::endl;
+}
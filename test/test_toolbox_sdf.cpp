@@ -0,0 +1,28 @@
+#include <gtest/gtest.h>
+
+#include "toolbox_sdf.hpp"
+
+TEST(TestToolboxSdf, Square)
+{
+    // 32x32 white square in the middle of 64x64, 4 times smaller
+    constexpr int kSize = 64;
+    std::vector<uint8_t> pixels(kSize * kSize, 0);
+    for (int y = 16; y < 48; ++y)
+    {
+        for (int x = 16; x < 48; ++x)
+        {
+            pixels[y * kSize + x] = 255;
+        }
+    }
+
+    const std::vector<uint8_t> sdf = getSignedDistanceField(pixels.data(), kSize, kSize, 4, 2);
+    ASSERT_EQ(16u * 16u, sdf.size());
+    // inside, at more than spread pixels from the edges
+    EXPECT_EQ(255, sdf[8 * 16 + 8]);
+    // outside, far from the square
+    EXPECT_EQ(0, sdf[0]);
+    // around the edge
+    EXPECT_NEAR(128, sdf[8 * 16 + 4], 40);
+    // symmetric
+    EXPECT_EQ(sdf[8 * 16 + 4], sdf[8 * 16 + 11]);
+}
@@ -0,0 +1,39 @@
+#include <gtest/gtest.h>
+
+#include "toolbox_utf8.hpp"
+
+TEST(TestToolboxUtf8, Ascii)
+{
+    std::string_view text{"A~"};
+    EXPECT_EQ(U'A', popUtf8(text));
+    EXPECT_EQ(U'~', popUtf8(text));
+    EXPECT_TRUE(text.empty());
+}
+
+TEST(TestToolboxUtf8, MultiBytes)
+{
+    // é, €, 𝄞
+    std::string_view text{"\xc3\xa9\xe2\x82\xac\xf0\x9d\x84\x9e!"};
+    EXPECT_EQ(4, getUtf8Length(text));
+    EXPECT_EQ(U'é', popUtf8(text));
+    EXPECT_EQ(U'€', popUtf8(text));
+    EXPECT_EQ(U'\U0001d11e', popUtf8(text));
+    EXPECT_EQ(U'!', popUtf8(text));
+}
+
+TEST(TestToolboxUtf8, Invalid)
+{
+    // continuation byte alone, truncated sequence, overlong '/', surrogate
+    std::string_view text{"\x80" "a\xc3" "b\xc0\xaf\xed\xa0\x80"};
+    EXPECT_EQ(kUtf8Replacement, popUtf8(text));
+    EXPECT_EQ(U'a', popUtf8(text));
+    // only the 1st byte is skipped: the next character is kept
+    EXPECT_EQ(kUtf8Replacement, popUtf8(text));
+    EXPECT_EQ(U'b', popUtf8(text));
+    EXPECT_EQ(kUtf8Replacement, popUtf8(text));
+    EXPECT_EQ(kUtf8Replacement, popUtf8(text));
+    EXPECT_EQ(kUtf8Replacement, popUtf8(text));
+    EXPECT_EQ(kUtf8Replacement, popUtf8(text));
+    EXPECT_EQ(kUtf8Replacement, popUtf8(text));
+    EXPECT_TRUE(text.empty());
+}
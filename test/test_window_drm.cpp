@@ -0,0 +1,121 @@
+#include "window_drm.hpp"
+
+#ifdef USE_WINDOW_DRM
+
+#include <gtest/gtest.h>
+
+#include "toolbox_gl.hpp"
+#include "toolbox_io.hpp"
+
+#include <fcntl.h>
+#include <xf86drm.h>
+
+#include <cstring>
+#include <memory>
+#include <string>
+
+namespace
+{
+
+constexpr int kWidth = 320;
+constexpr int kHeight = 240;
+constexpr int kFrames = 10;
+
+/**
+ * The device of the virtual KMS driver (modprobe vkms), empty if it is not loaded
+ */
+std::string findVkms()
+{
+    for (int cardNumber = 0; cardNumber < 16; ++cardNumber)
+    {
+        const std::string device = "/dev/dri/card" + std::to_string(cardNumber);
+        const FileUnix card{open(device.c_str(), O_RDWR | O_CLOEXEC)};
+        if (card.fd < 0)
+        {
+            continue;
+        }
+        const std::unique_ptr<drmVersion, decltype(&drmFreeVersion)> version{drmGetVersion(card.fd), &drmFreeVersion};
+        if (version && std::strcmp(version->name, "vkms") == 0)
+        {
+            return device;
+        }
+    }
+    return {};
+}
+
+/**
+ * 1 frame of a uniform color, the whole surface damaged
+ */
+void render(WindowDrm &window, float red)
+{
+    window.begin();
+    glClearColor(red, 0.f, 1.f, 1.f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    window.setDamage(Rect{0, 0, kWidth, kHeight});
+    window.end();
+}
+
+} // namespace
+
+class TestWindowDrm : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        device = findVkms();
+        if (device.empty())
+        {
+            GTEST_SKIP() << "no vkms device: modprobe vkms, with the rights on /dev/dri";
+        }
+    }
+
+    std::string device;
+};
+
+TEST_F(TestWindowDrm, PageFlips)
+{
+    WindowDrm window{kWidth, kHeight, device};
+    for (int frame = 0; frame < kFrames; ++frame)
+    {
+        render(window, static_cast<float>(frame) / kFrames);
+    }
+
+    // end() waits for the previous flip: only the last one may still be pending
+    const WindowDrm::Statistics &statistics = window.getStatistics();
+    EXPECT_EQ(kFrames, statistics.flips);
+    EXPECT_LE(kFrames - 1, statistics.flipEvents);
+    EXPECT_EQ(0, statistics.flipTimeouts);
+}
+
+TEST_F(TestWindowDrm, Rotation)
+{
+    WindowDrm window{kWidth, kHeight, device};
+    render(window, 0.f);
+    render(window, 0.f);
+
+    // the layout changes while a buffer is scanned out
+    ASSERT_TRUE(window.setRotation(1));
+    for (int frame = 0; frame < kFrames; ++frame)
+    {
+        render(window, 1.f);
+    }
+
+    const WindowDrm::Statistics &statistics = window.getStatistics();
+    EXPECT_EQ(kFrames + 2, statistics.flips);
+    EXPECT_LE(kFrames + 1, statistics.flipEvents);
+    EXPECT_EQ(0, statistics.flipTimeouts);
+}
+
+TEST_F(TestWindowDrm, NoDamage)
+{
+    WindowDrm window{kWidth, kHeight, device};
+    render(window, 0.f);
+
+    // nothing changed: no flip
+    window.begin();
+    window.setDamage(Rect{});
+    window.end();
+    EXPECT_EQ(1, window.getStatistics().flips);
+}
+
+#endif // USE_WINDOW_DRM
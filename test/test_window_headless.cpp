@@ -0,0 +1,142 @@
+#include "window_headless.hpp"
+
+#ifdef USE_WINDOW_HEADLESS
+
+#include <gtest/gtest.h>
+
+#include "toolbox_gl.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+namespace
+{
+
+constexpr char kFolder[] = "test_headless";
+constexpr int kWidth = 32;
+constexpr int kHeight = 16;
+
+} // namespace
+
+class TestWindowHeadless : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        std::filesystem::remove_all(kFolder);
+        std::filesystem::create_directory(kFolder);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(kFolder);
+    }
+
+    /**
+     * 1 frame: the bottom half is red, the top half is blue
+     */
+    static void render(WindowHeadless &window, float blue)
+    {
+        window.begin();
+        glEnable(GL_SCISSOR_TEST);
+        glScissor(0, 0, kWidth, kHeight / 2);
+        glClearColor(1.f, 0.f, 0.f, 1.f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        glScissor(0, kHeight / 2, kWidth, kHeight / 2);
+        glClearColor(0.f, 0.f, blue, 1.f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        glDisable(GL_SCISSOR_TEST);
+        window.end();
+    }
+};
+
+TEST_F(TestWindowHeadless, Statistics)
+{
+    WindowHeadless window{kWidth, kHeight};
+    render(window, 1.f);
+    render(window, 1.f);
+
+    const auto &statistics = window.getStatistics();
+    EXPECT_EQ(2u, statistics.frames);
+    EXPECT_GE(statistics.gpu, statistics.gpuMax);
+    EXPECT_GE(statistics.readback, statistics.readbackMax);
+    EXPECT_EQ(0u, statistics.goldenFrames);
+}
+
+TEST_F(TestWindowHeadless, Dump)
+{
+    {
+        WindowHeadless window{kWidth, kHeight, WindowHeadless::Options{kFolder, "", 0}};
+        render(window, 1.f);
+    }
+
+    std::ifstream file{std::string{kFolder} + "/frame_00000.ppm", std::ios_base::binary};
+    ASSERT_TRUE(file);
+    const std::string content{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+    const std::string header = "P6\n32 16\n255\n";
+    ASSERT_EQ(header.size() + kWidth * kHeight * 3, content.size());
+    EXPECT_EQ(header, content.substr(0, header.size()));
+
+    // 1st line at the top: blue, last line: red
+    const auto pixel = [&](int x, int y) {
+        return content.substr(header.size() + (y * kWidth + x) * 3, 3);
+    };
+    EXPECT_EQ(std::string("\x00\x00\xff", 3), pixel(0, 0));
+    EXPECT_EQ(std::string("\xff\x00\x00", 3), pixel(kWidth - 1, kHeight - 1));
+}
+
+TEST_F(TestWindowHeadless, Golden)
+{
+    {
+        WindowHeadless window{kWidth, kHeight, WindowHeadless::Options{kFolder, "", 0}};
+        render(window, 1.f);
+        render(window, 1.f);
+    }
+
+    WindowHeadless window{kWidth, kHeight, WindowHeadless::Options{"", kFolder, 8}};
+    render(window, 1.f);
+    // slightly different: within the tolerance
+    render(window, 0.99f);
+    // very different
+    render(window, 0.5f);
+
+    const auto &statistics = window.getStatistics();
+    // the 3rd frame has no golden image
+    EXPECT_EQ(2u, statistics.goldenFrames);
+    EXPECT_EQ(0u, statistics.goldenMismatches);
+
+    WindowHeadless other{kWidth, kHeight, WindowHeadless::Options{"", kFolder, 8}};
+    render(other, 0.5f);
+    EXPECT_EQ(1u, other.getStatistics().goldenMismatches);
+}
+
+TEST_F(TestWindowHeadless, Software)
+{
+    // RGBA8888, 1st line at the bottom: the bottom half is red, the top half is blue
+    std::vector<uint8_t> frame(kWidth * kHeight * 4);
+    for (size_t i = 0; i < frame.size(); i += 4)
+    {
+        const bool bottom = i < frame.size() / 2;
+        frame[i] = bottom ? 255 : 0;
+        frame[i + 2] = bottom ? 0 : 255;
+        frame[i + 3] = 255;
+    }
+
+    {
+        WindowHeadless window{kWidth, kHeight, WindowHeadless::Options{kFolder, "", 0, true}};
+        EXPECT_TRUE(window.isSoftware());
+        window.setSoftwareFrame(frame.data());
+        window.begin();
+        window.end();
+    }
+
+    WindowHeadless window{kWidth, kHeight, WindowHeadless::Options{"", kFolder, 0}};
+    render(window, 1.f);
+    EXPECT_FALSE(window.isSoftware());
+    EXPECT_EQ(1u, window.getStatistics().goldenFrames);
+    EXPECT_EQ(0u, window.getStatistics().goldenMismatches);
+}
+
+#endif // USE_WINDOW_HEADLESS
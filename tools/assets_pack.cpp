@@ -0,0 +1,122 @@
+/**
+ * Build tool: pack the compiled assets into a blob, linked into the executable
+ *
+ * Usage: assets_pack output.bin root file...
+ *
+ * The assets are named by their path relative to root, e.g. "shader/print_text.vert" for
+ * build/assets/shader/print_text.vert. See toolbox_assets.hpp for the format.
+ */
+
+#include "toolbox_assets.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+/**
+ * @brief Asset to pack
+ */
+struct Asset
+{
+    std::string name;
+    std::vector<char> content;
+};
+
+std::vector<char> readFile(const std::string &filename)
+{
+    std::ifstream file{filename, std::ios::binary};
+    if (!file)
+    {
+        throw std::runtime_error{"Cannot read " + filename};
+    }
+    return std::vector<char>{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+}
+
+size_t align(size_t offset)
+{
+    return (offset + kEmbeddedAssetsAlignment - 1) / kEmbeddedAssetsAlignment * kEmbeddedAssetsAlignment;
+}
+
+void writeBlob(const char *filename, std::vector<Asset> &assets)
+{
+    // looked up by dichotomy
+    std::sort(assets.begin(), assets.end(), [](const Asset &a, const Asset &b) { return a.name < b.name; });
+
+    EmbeddedAssetsHeader header{};
+    std::memcpy(header.magic, kEmbeddedAssetsMagic, sizeof(header.magic));
+    header.count = assets.size();
+
+    std::vector<EmbeddedAssetsEntry> entries(assets.size());
+    size_t offset = sizeof(header) + entries.size() * sizeof(EmbeddedAssetsEntry);
+    for (size_t i = 0; i < assets.size(); ++i)
+    {
+        entries[i].nameOffset = offset;
+        entries[i].nameSize = assets[i].name.size();
+        offset += assets[i].name.size();
+    }
+    for (size_t i = 0; i < assets.size(); ++i)
+    {
+        offset = align(offset);
+        entries[i].offset = offset;
+        entries[i].size = assets[i].content.size();
+        offset += assets[i].content.size();
+    }
+
+    std::vector<char> blob(offset, '\0');
+    std::memcpy(blob.data(), &header, sizeof(header));
+    std::memcpy(blob.data() + sizeof(header), entries.data(), entries.size() * sizeof(EmbeddedAssetsEntry));
+    for (size_t i = 0; i < assets.size(); ++i)
+    {
+        std::copy(assets[i].name.begin(), assets[i].name.end(), blob.begin() + entries[i].nameOffset);
+        std::copy(assets[i].content.begin(), assets[i].content.end(), blob.begin() + entries[i].offset);
+    }
+
+    std::ofstream file{filename, std::ios::binary | std::ios::trunc};
+    file.write(blob.data(), blob.size());
+    if (!file)
+    {
+        throw std::runtime_error{std::string{"Cannot write "} + filename};
+    }
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+    {
+        std::cout << "Usage:\n\t" << argv[0] << " output.bin root file..." << std::endl;
+        std::cout << "The assets are named by their path relative to root" << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        const std::string root = std::string{argv[2]} + '/';
+        std::vector<Asset> assets;
+        for (int i = 3; i < argc; ++i)
+        {
+            const std::string filename = argv[i];
+            if (filename.compare(0, root.size(), root) != 0)
+            {
+                throw std::runtime_error{filename + " is not in " + root};
+            }
+            assets.push_back(Asset{filename.substr(root.size()), readFile(filename)});
+        }
+        writeBlob(argv[1], assets);
+        return 0;
+    }
+    catch (std::exception &e)
+    {
+        std::cerr << "std::exception: " << e.what() << std::endl;
+    }
+    return -1;
+}
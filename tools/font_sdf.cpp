@@ -0,0 +1,129 @@
+/**
+ * Build tool: signed distance field of a font atlas
+ *
+ * Usage: font_sdf input.pgm scale spread output.dds
+ *
+ * The input is the atlas rendered scale times larger than the output, white glyphs on black, as written by
+ * ImageMagick. The output is an uncompressed 8 bits luminance DDS: 128 on the edges of the glyphs, 255 spread pixels
+ * inside, 0 spread pixels outside, see getSignedDistanceField(). The shader print_text_sdf.frag renders it crisply at any
+ * size.
+ */
+
+#include "toolbox_sdf.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+/**
+ * @brief 8 bits grey image
+ */
+struct Image
+{
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> pixels;
+};
+
+/**
+ * Binary PGM (P5), 8 or 16 bits
+ */
+Image readPgm(const char *filename)
+{
+    std::ifstream file{filename, std::ios::binary};
+    std::string magic;
+    int maxValue = 0;
+    Image image;
+    file >> magic >> image.width >> image.height >> maxValue;
+    file.get();
+    if (!file || magic != "P5" || image.width <= 0 || image.height <= 0 || maxValue <= 0 || maxValue > 65535)
+    {
+        throw std::runtime_error{std::string{"Invalid PGM file: "} + filename};
+    }
+
+    const size_t count = static_cast<size_t>(image.width) * image.height;
+    const size_t bytesPerPixel = maxValue > 255 ? 2 : 1;
+    std::vector<uint8_t> raw(count * bytesPerPixel);
+    if (!file.read(reinterpret_cast<char *>(raw.data()), raw.size()))
+    {
+        throw std::runtime_error{std::string{"Truncated PGM file: "} + filename};
+    }
+
+    image.pixels.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        // big endian when 16 bits
+        const int value = bytesPerPixel == 2 ? raw[2 * i] << 8 | raw[2 * i + 1] : raw[i];
+        image.pixels[i] = static_cast<uint8_t>(value * 255 / maxValue);
+    }
+    return image;
+}
+
+/**
+ * Uncompressed DDS, 8 bits luminance, no mipmap
+ */
+void writeDds(const char *filename, const Image &image)
+{
+    std::vector<uint32_t> header(32, 0);
+    std::memcpy(header.data(), "DDS ", 4);
+    header[1] = 124; // dwSize
+    header[2] = 0x1 | 0x2 | 0x4 | 0x8 | 0x1000; // DDSD_CAPS | HEIGHT | WIDTH | PITCH | PIXELFORMAT
+    header[3] = image.height; // dwHeight
+    header[4] = image.width; // dwWidth
+    header[5] = image.width; // dwPitchOrLinearSize
+    header[19] = 32; // ddspf.dwSize
+    header[20] = 0x20000; // DDPF_LUMINANCE
+    header[22] = 8; // ddspf.dwRGBBitCount
+    header[23] = 0xff; // ddspf.dwRBitMask
+    header[27] = 0x1000; // DDSCAPS_TEXTURE
+
+    std::ofstream file{filename, std::ios::binary | std::ios::trunc};
+    file.write(reinterpret_cast<const char *>(header.data()), header.size() * sizeof(uint32_t));
+    file.write(reinterpret_cast<const char *>(image.pixels.data()), image.pixels.size());
+    if (!file)
+    {
+        throw std::runtime_error{std::string{"Cannot write "} + filename};
+    }
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (argc != 5)
+    {
+        std::cout << "Usage:\n\t" << argv[0] << " input.pgm scale spread output.dds" << std::endl;
+        std::cout << "The output is scale times smaller, the distances are clamped to spread output pixels" << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        const int scale = std::atoi(argv[2]);
+        const double spread = std::atof(argv[3]);
+        if (scale <= 0 || spread <= 0)
+        {
+            throw std::runtime_error{"Invalid scale or spread"};
+        }
+        const Image input = readPgm(argv[1]);
+        Image output;
+        output.width = input.width / scale;
+        output.height = input.height / scale;
+        output.pixels = getSignedDistanceField(input.pixels.data(), input.width, input.height, scale, spread);
+        writeDds(argv[4], output);
+        return 0;
+    }
+    catch (std::exception &e)
+    {
+        std::cerr << "std::exception: " << e.what() << std::endl;
+    }
+    return -1;
+}